@@ -172,6 +172,9 @@ OPENMP_LIB =
 # Used when MFEM_TIMER_TYPE = 2
 POSIX_CLOCKS_LIB = -lrt
 
+# Threads library, used by DataCollection::SaveAsync()
+THREADS_LIB = -lpthread
+
 # SUNDIALS library configuration
 SUNDIALS_DIR = @MFEM_DIR@/../sundials-3.0.0
 SUNDIALS_OPT = -I$(SUNDIALS_DIR)/include
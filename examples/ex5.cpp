@@ -8,6 +8,8 @@
 //               ex5 -m ../data/beam-hex.mesh
 //               ex5 -m ../data/escher.mesh
 //               ex5 -m ../data/fichera.mesh
+//               ex5 -m ../data/star.mesh -pa
+//               ex5 -m ../data/beam-hex.mesh -pa
 //
 // Description:  This example code solves a simple 2D/3D mixed Darcy problem
 //               corresponding to the saddle point system
@@ -19,9 +21,11 @@
 //               finite elements (velocity u) and piecewise discontinuous
 //               polynomials (pressure p).
 //
-//               The example demonstrates the use of the BlockMatrix class, as
+//               The example demonstrates the use of the BlockOperator class, as
 //               well as the collective saving of several grid functions in a
-//               VisIt (visit.llnl.gov) visualization format.
+//               VisIt (visit.llnl.gov) visualization format. On quadrilateral
+//               and hexahedral meshes, the operators can be applied without
+//               assembling matrices using partial assembly (-pa).
 //
 //               We recommend viewing examples 1-4 before viewing this example.
 
@@ -47,6 +51,7 @@ int main(int argc, char *argv[])
    // 1. Parse command-line options.
    const char *mesh_file = "../data/star.mesh";
    int order = 1;
+   bool pa = false;
    bool visualization = 1;
 
    OptionsParser args(argc, argv);
@@ -54,6 +59,8 @@ int main(int argc, char *argv[])
                   "Mesh file to use.");
    args.AddOption(&order, "-o", "--order",
                   "Finite element order (polynomial degree).");
+   args.AddOption(&pa, "-pa", "--partial-assembly", "-no-pa",
+                  "--no-partial-assembly", "Enable Partial Assembly.");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
                   "--no-visualization",
                   "Enable or disable GLVis visualization.");
@@ -143,25 +150,27 @@ int main(int argc, char *argv[])
    //
    //     M = \int_\Omega k u_h \cdot v_h d\Omega   u_h, v_h \in R_h
    //     B   = -\int_\Omega \div u_h q_h d\Omega   u_h \in R_h, q_h \in W_h
+   //
+   //     With partial assembly, M and B are applied without assembling their
+   //     matrices and the action of B^T is computed from that of B.
    BilinearForm *mVarf(new BilinearForm(R_space));
    MixedBilinearForm *bVarf(new MixedBilinearForm(R_space, W_space));
 
+   if (pa) { mVarf->SetAssemblyLevel(AssemblyLevel::PARTIAL); }
    mVarf->AddDomainIntegrator(new VectorFEMassIntegrator(k));
    mVarf->Assemble();
-   mVarf->Finalize();
-   SparseMatrix &M(mVarf->SpMat());
+   if (!pa) { mVarf->Finalize(); }
 
+   if (pa) { bVarf->SetAssemblyLevel(AssemblyLevel::PARTIAL); }
    bVarf->AddDomainIntegrator(new VectorFEDivergenceIntegrator);
    bVarf->Assemble();
-   bVarf->Finalize();
-   SparseMatrix & B(bVarf->SpMat());
-   B *= -1.;
-   SparseMatrix *BT = Transpose(B);
+   if (!pa) { bVarf->Finalize(); }
+
+   BlockOperator darcyOp(block_offsets);
 
-   BlockMatrix darcyMatrix(block_offsets);
-   darcyMatrix.SetBlock(0,0, &M);
-   darcyMatrix.SetBlock(0,1, BT);
-   darcyMatrix.SetBlock(1,0, &B);
+   Operator *BT = NULL;
+   SparseMatrix *MinvBt = NULL, *S = NULL;
+   Solver *invM, *invS;
 
    // 9. Construct the operators for preconditioner
    //
@@ -169,23 +178,59 @@ int main(int argc, char *argv[])
    //                     [  0       B diag(M)^-1 B^T ]
    //
    //     Here we use Symmetric Gauss-Seidel to approximate the inverse of the
-   //     pressure Schur Complement
-   SparseMatrix *MinvBt = Transpose(B);
-   Vector Md(M.Height());
-   M.GetDiag(Md);
-   for (int i = 0; i < Md.Size(); i++)
+   //     pressure Schur Complement. With partial assembly, both diagonal blocks
+   //     are approximated with Jacobi smoothers, using the diagonals of M and
+   //     of B diag(M)^-1 B^T computed without assembling the matrices.
+   if (pa)
    {
-      MinvBt->ScaleRow(i, 1./Md(i));
+      BT = new TransposeOperator(bVarf);
+
+      darcyOp.SetBlock(0,0, mVarf);
+      darcyOp.SetBlock(0,1, BT, -1.0);
+      darcyOp.SetBlock(1,0, bVarf, -1.0);
+
+      Vector Md(mVarf->Height());
+      mVarf->AssembleDiagonal(Md);
+      Vector invMd(Md.Size());
+      for (int i = 0; i < Md.Size(); i++)
+      {
+         invMd(i) = 1.0 / Md(i);
+      }
+      Vector BMBt_diag(bVarf->Height());
+      bVarf->AssembleDiagonal_ADAt(invMd, BMBt_diag);
+
+      Array<int> ess_tdof_list; // empty
+      invM = new OperatorJacobiSmoother(Md, ess_tdof_list);
+      invS = new OperatorJacobiSmoother(BMBt_diag, ess_tdof_list);
    }
-   SparseMatrix *S = Mult(B, *MinvBt);
+   else
+   {
+      SparseMatrix &M(mVarf->SpMat());
+      SparseMatrix &B(bVarf->SpMat());
+      B *= -1.;
+      SparseMatrix *Bt = Transpose(B);
+      BT = Bt;
+
+      darcyOp.SetBlock(0,0, &M);
+      darcyOp.SetBlock(0,1, Bt);
+      darcyOp.SetBlock(1,0, &B);
+
+      MinvBt = Transpose(B);
+      Vector Md(M.Height());
+      M.GetDiag(Md);
+      for (int i = 0; i < Md.Size(); i++)
+      {
+         MinvBt->ScaleRow(i, 1./Md(i));
+      }
+      S = Mult(B, *MinvBt);
 
-   Solver *invM, *invS;
-   invM = new DSmoother(M);
+      invM = new DSmoother(M);
 #ifndef MFEM_USE_SUITESPARSE
-   invS = new GSSmoother(*S);
+      invS = new GSSmoother(*S);
 #else
-   invS = new UMFPackSolver(*S);
+      invS = new UMFPackSolver(*S);
 #endif
+   }
 
    invM->iterative_mode = false;
    invS->iterative_mode = false;
@@ -206,7 +251,7 @@ int main(int argc, char *argv[])
    solver.SetAbsTol(atol);
    solver.SetRelTol(rtol);
    solver.SetMaxIter(maxIter);
-   solver.SetOperator(darcyMatrix);
+   solver.SetOperator(darcyOp);
    solver.SetPreconditioner(darcyPrec);
    solver.SetPrintLevel(1);
    x = 0.0;
@@ -15,6 +15,7 @@
 //    ex9 -m ../data/disc-nurbs.mesh -p 2 -r 3 -dt 0.005 -tf 9
 //    ex9 -m ../data/periodic-square.mesh -p 3 -r 4 -dt 0.0025 -tf 9 -vs 20
 //    ex9 -m ../data/periodic-cube.mesh -p 0 -r 2 -o 2 -dt 0.02 -tf 8
+//    ex9 -m ../data/periodic-hexagon.mesh -p 1 -r 2 -dt 0.005 -tf 9 -pa
 //
 // Description:  This example code solves the time-dependent advection equation
 //               du/dt + v.grad(u) = 0, where v is a given fluid velocity, and
@@ -61,7 +62,8 @@ Vector bb_min, bb_max;
 class FE_Evolution : public TimeDependentOperator
 {
 private:
-   SparseMatrix &M, &K;
+   SparseMatrix &M;
+   Operator &K;
    const Vector &b;
    DSmoother M_prec;
    CGSolver M_solver;
@@ -69,7 +71,7 @@ private:
    mutable Vector z;
 
 public:
-   FE_Evolution(SparseMatrix &_M, SparseMatrix &_K, const Vector &_b);
+   FE_Evolution(SparseMatrix &_M, Operator &_K, const Vector &_b);
 
    virtual void Mult(const Vector &x, Vector &y) const;
 
@@ -87,6 +89,7 @@ int main(int argc, char *argv[])
    int ode_solver_type = 4;
    double t_final = 10.0;
    double dt = 0.01;
+   bool pa = false;
    bool visualization = true;
    bool visit = false;
    bool binary = false;
@@ -111,6 +114,8 @@ int main(int argc, char *argv[])
                   "Final time; start time is 0.");
    args.AddOption(&dt, "-dt", "--time-step",
                   "Time step.");
+   args.AddOption(&pa, "-pa", "--partial-assembly", "-no-pa",
+                  "--no-partial-assembly", "Enable Partial Assembly.");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
                   "--no-visualization",
                   "Enable or disable GLVis visualization.");
@@ -173,7 +178,8 @@ int main(int argc, char *argv[])
 
    // 6. Set up and assemble the bilinear and linear forms corresponding to the
    //    DG discretization. The DGTraceIntegrator involves integrals over mesh
-   //    interior faces.
+   //    interior faces. With partial assembly, the convection operator is
+   //    applied matrix-free; this requires a conforming tensor-product mesh.
    VectorFunctionCoefficient velocity(dim, velocity_function);
    FunctionCoefficient inflow(inflow_function);
    FunctionCoefficient u0(u0_function);
@@ -181,6 +187,7 @@ int main(int argc, char *argv[])
    BilinearForm m(&fes);
    m.AddDomainIntegrator(new MassIntegrator);
    BilinearForm k(&fes);
+   if (pa) { k.SetAssemblyLevel(AssemblyLevel::PARTIAL); }
    k.AddDomainIntegrator(new ConvectionIntegrator(velocity, -1.0));
    k.AddInteriorFaceIntegrator(
       new TransposeIntegrator(new DGTraceIntegrator(velocity, 1.0, -0.5)));
@@ -195,7 +202,17 @@ int main(int argc, char *argv[])
    m.Finalize();
    int skip_zeros = 0;
    k.Assemble(skip_zeros);
-   k.Finalize(skip_zeros);
+   OperatorHandle K;
+   if (pa)
+   {
+      Array<int> no_ess_tdofs;
+      k.FormSystemMatrix(no_ess_tdofs, K);
+   }
+   else
+   {
+      k.Finalize(skip_zeros);
+      K.Reset(&k.SpMat(), false);
+   }
    b.Assemble();
 
    // 7. Define the initial conditions, save the corresponding grid function to
@@ -264,7 +281,7 @@ int main(int argc, char *argv[])
    // 8. Define the time-dependent evolution operator describing the ODE
    //    right-hand side, and perform time-integration (looping over the time
    //    iterations, ti, with a time-step dt).
-   FE_Evolution adv(m.SpMat(), k.SpMat(), b);
+   FE_Evolution adv(m.SpMat(), *K, b);
 
    double t = 0.0;
    adv.SetTime(t);
@@ -314,7 +331,7 @@ int main(int argc, char *argv[])
 
 
 // Implementation of class FE_Evolution
-FE_Evolution::FE_Evolution(SparseMatrix &_M, SparseMatrix &_K, const Vector &_b)
+FE_Evolution::FE_Evolution(SparseMatrix &_M, Operator &_K, const Vector &_b)
    : TimeDependentOperator(_M.Size()), M(_M), K(_K), b(_b), z(_M.Size())
 {
    M_solver.SetPreconditioner(M_prec);
@@ -74,6 +74,7 @@ BilinearForm::BilinearForm(FiniteElementSpace * f)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = 0;
+   threaded_assembly = false;
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::FULL;
@@ -92,6 +93,7 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = ps;
+   threaded_assembly = bf->threaded_assembly;
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::FULL;
@@ -122,19 +124,19 @@ void BilinearForm::SetAssemblyLevel(AssemblyLevel assembly_level)
    switch (assembly)
    {
       case AssemblyLevel::FULL:
-         // ext = new FABilinearFormExtension(this);
-         // Use the original BilinearForm implementation for now
+         // Use the original BilinearForm implementation
+         break;
+      case AssemblyLevel::DEVICEFULL:
+         ext = new FABilinearFormExtension(this);
          break;
       case AssemblyLevel::ELEMENT:
-         mfem_error("Element assembly not supported yet... stay tuned!");
-         // ext = new EABilinearFormExtension(this);
+         ext = new EABilinearFormExtension(this);
          break;
       case AssemblyLevel::PARTIAL:
          ext = new PABilinearFormExtension(this);
          break;
       case AssemblyLevel::NONE:
-         mfem_error("Matrix-free action not supported yet... stay tuned!");
-         // ext = new MFBilinearFormExtension(this);
+         ext = new MFBilinearFormExtension(this);
          break;
       default:
          mfem_error("Unknown assembly level");
@@ -338,6 +340,130 @@ void BilinearForm::AssembleBdrElementMatrix(
    }
 }
 
+// Create a finalized SparseMatrix, with zero entries, whose sparsity pattern
+// contains the couplings between the vdofs of each element of 'fes'.
+static SparseMatrix *ElementSparsity(const FiniteElementSpace &fes)
+{
+   const int NE = fes.GetNE(), size = fes.GetVSize();
+   Table elem_vdof, vdof_elem, vdof_vdof;
+   Array<int> vdofs;
+   elem_vdof.MakeI(NE);
+   for (int i = 0; i < NE; i++)
+   {
+      fes.GetElementVDofs(i, vdofs);
+      elem_vdof.AddColumnsInRow(i, vdofs.Size());
+   }
+   elem_vdof.MakeJ();
+   for (int i = 0; i < NE; i++)
+   {
+      fes.GetElementVDofs(i, vdofs);
+      for (int j = 0; j < vdofs.Size(); j++)
+      {
+         if (vdofs[j] < 0) { vdofs[j] = -1-vdofs[j]; }
+      }
+      elem_vdof.AddConnections(i, vdofs.GetData(), vdofs.Size());
+   }
+   elem_vdof.ShiftUpI();
+   Transpose(elem_vdof, vdof_elem, size);
+   mfem::Mult(vdof_elem, elem_vdof, vdof_vdof);
+   vdof_vdof.SortRows();
+
+   double *data = new double[vdof_vdof.Size_of_connections()];
+   SparseMatrix *A = new SparseMatrix(vdof_vdof.GetI(), vdof_vdof.GetJ(), data,
+                                      size, size, true, true, true);
+   *A = 0.0;
+   vdof_vdof.LoseData();
+   return A;
+}
+
+// Add the element matrix 'elmat' with signed 'vdofs' to the finalized CSR
+// matrix (I, J, A). The entries of 'col_pos' must be -1 on input and they are
+// reset on output. Different threads can add element matrices concurrently if
+// their vdofs are different.
+static void AddElementMatrix(const int *I, const int *J, double *A,
+                             const Array<int> &vdofs, const DenseMatrix &elmat,
+                             Array<int> &col_pos)
+{
+   const int n = vdofs.Size();
+   for (int r = 0; r < n; r++)
+   {
+      const int row = (vdofs[r] >= 0) ? vdofs[r] : -1-vdofs[r];
+      for (int k = I[row]; k < I[row+1]; k++) { col_pos[J[k]] = k; }
+      for (int c = 0; c < n; c++)
+      {
+         const int col = (vdofs[c] >= 0) ? vdofs[c] : -1-vdofs[c];
+         const int k = col_pos[col];
+         MFEM_VERIFY(k >= 0, "entry (" << row << "," << col << ") is not in "
+                     "the sparsity pattern of the matrix");
+         const bool flip = (vdofs[r] < 0) != (vdofs[c] < 0);
+         A[k] += flip ? -elmat(r,c) : elmat(r,c);
+      }
+      for (int k = I[row]; k < I[row+1]; k++) { col_pos[J[k]] = -1; }
+   }
+}
+
+bool BilinearForm::ThreadedDomainAssembly() const
+{
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+   // The element matrices are added to the rows of a finalized matrix, so an
+   // unfinalized matrix has to be empty and it is replaced by one with the
+   // sparsity pattern of the elements, which misses the face couplings.
+   return threaded_assembly && !element_matrices && !static_cond &&
+          !hybridization && !fes->GetNURBSext() &&
+          (mat->Finalized() ||
+           (fbfi.Size() == 0 && mat->NumNonZeroElems() == 0));
+#else
+   return false;
+#endif
+}
+
+void BilinearForm::AssembleDomainThreaded()
+{
+   if (!mat->Finalized())
+   {
+      delete mat;
+      mat = ElementSparsity(*fes);
+   }
+   const Table &colors = fes->GetElementColoring();
+   const int *I = mat->GetI(), *J = mat->GetJ();
+   double *A = mat->GetData();
+   Mesh *mesh = fes->GetMesh();
+   if (mesh->GetNodes()) { mesh->GetNodes()->HostRead(); }
+
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+   #pragma omp parallel
+#endif
+   {
+      IsoparametricTransformation eltrans;
+      DenseMatrix elmat, elmat_k;
+      Array<int> el_vdofs, col_pos(width);
+      col_pos = -1;
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *elems = colors.GetRow(c);
+         // The elements of one color do not share vdofs; the implicit barrier
+         // at the end of the loop separates the colors.
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+         #pragma omp for schedule(dynamic, 16)
+#endif
+         for (int j = 0; j < colors.RowSize(c); j++)
+         {
+            const int i = elems[j];
+            const FiniteElement &fe = *fes->GetFE(i);
+            fes->GetElementVDofs(i, el_vdofs);
+            fes->GetElementTransformation(i, &eltrans);
+            dbfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
+            for (int k = 1; k < dbfi.Size(); k++)
+            {
+               dbfi[k]->AssembleElementMatrix(fe, eltrans, elmat_k);
+               elmat += elmat_k;
+            }
+            AddElementMatrix(I, J, A, el_vdofs, elmat, col_pos);
+         }
+      }
+   }
+}
+
 void BilinearForm::Assemble(int skip_zeros)
 {
    if (ext)
@@ -364,7 +490,11 @@ void BilinearForm::Assemble(int skip_zeros)
    }
 #endif
 
-   if (dbfi.Size())
+   if (dbfi.Size() && ThreadedDomainAssembly())
+   {
+      AssembleDomainThreaded();
+   }
+   else if (dbfi.Size())
    {
       for (int i = 0; i < fes -> GetNE(); i++)
       {
@@ -581,7 +711,7 @@ void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list, Vector &x,
 {
    const SparseMatrix *P = fes->GetConformingProlongation();
 
-   if (ext)
+   if (ext && !ext->AssemblesSparseMatrix())
    {
       ext->FormLinearSystem(ess_tdof_list, x, b, A, X, B, copy_interior);
       return;
@@ -649,7 +779,7 @@ void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list, Vector &x,
 void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
                                     OperatorHandle &A)
 {
-   if (ext)
+   if (ext && !ext->AssemblesSparseMatrix())
    {
       ext->FormSystemMatrix(ess_tdof_list, A);
       return;
@@ -689,10 +819,39 @@ void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
    }
 }
 
+void BilinearForm::AssembleDiagonal(Vector &diag) const
+{
+   MFEM_VERIFY(!static_cond && !hybridization, "static condensation and "
+               "hybridization are not supported");
+   const Operator *P = fes->GetProlongationMatrix();
+   diag.SetSize(fes->GetTrueVSize());
+   if (ext)
+   {
+      if (!P) { ext->AssembleDiagonal(diag); return; }
+      Vector local_diag(fes->GetVSize(), Device::GetMemoryType());
+      ext->AssembleDiagonal(local_diag);
+      P->MultTranspose(local_diag, diag);
+      return;
+   }
+   MFEM_VERIFY(mat, "the BilinearForm is not assembled");
+   // The matrix may already be transformed by ConformingAssemble()
+   const bool local = P && mat->Height() != diag.Size();
+   Vector local_diag;
+   Vector &mat_diag = local ? local_diag : diag;
+   const SparseMatrix &A = *mat;
+   if (A.Finalized()) { A.GetDiag(mat_diag); }
+   else
+   {
+      mat_diag.SetSize(A.Height());
+      for (int i = 0; i < A.Height(); i++) { mat_diag(i) = A(i,i); }
+   }
+   if (local) { P->MultTranspose(local_diag, diag); }
+}
+
 void BilinearForm::RecoverFEMSolution(const Vector &X,
                                       const Vector &b, Vector &x)
 {
-   if (ext)
+   if (ext && !ext->AssemblesSparseMatrix())
    {
       ext->RecoverFEMSolution(X, b, x);
       return;
@@ -1003,6 +1162,8 @@ MixedBilinearForm::MixedBilinearForm (FiniteElementSpace *tr_fes,
    test_fes = te_fes;
    mat = NULL;
    extern_bfs = 0;
+   assembly = AssemblyLevel::FULL;
+   ext = NULL;
 }
 
 MixedBilinearForm::MixedBilinearForm (FiniteElementSpace *tr_fes,
@@ -1014,6 +1175,8 @@ MixedBilinearForm::MixedBilinearForm (FiniteElementSpace *tr_fes,
    test_fes = te_fes;
    mat = NULL;
    extern_bfs = 1;
+   assembly = AssemblyLevel::FULL;
+   ext = NULL;
 
    // Copy the pointers to the integrators
    dom = mbf->dom;
@@ -1021,6 +1184,32 @@ MixedBilinearForm::MixedBilinearForm (FiniteElementSpace *tr_fes,
    skt = mbf->skt;
 }
 
+void MixedBilinearForm::SetAssemblyLevel(AssemblyLevel assembly_level)
+{
+   if (ext)
+   {
+      MFEM_ABORT("the assembly level has already been set!");
+   }
+   assembly = assembly_level;
+   switch (assembly)
+   {
+      case AssemblyLevel::FULL:
+         // Use the original MixedBilinearForm implementation
+         break;
+      case AssemblyLevel::PARTIAL:
+         ext = new PAMixedBilinearFormExtension(this);
+         break;
+      case AssemblyLevel::DEVICEFULL:
+      case AssemblyLevel::ELEMENT:
+      case AssemblyLevel::NONE:
+         MFEM_ABORT("this assembly level is not supported by "
+                    "MixedBilinearForm yet");
+         break;
+      default:
+         mfem_error("Unknown assembly level");
+   }
+}
+
 double & MixedBilinearForm::Elem (int i, int j)
 {
    return (*mat)(i, j);
@@ -1033,18 +1222,28 @@ const double & MixedBilinearForm::Elem (int i, int j) const
 
 void MixedBilinearForm::Mult (const Vector & x, Vector & y) const
 {
+   if (ext) { ext->Mult(x, y); return; }
    mat -> Mult (x, y);
 }
 
 void MixedBilinearForm::AddMult (const Vector & x, Vector & y,
                                  const double a) const
 {
+   if (ext) { ext->AddMult(x, y, a); return; }
    mat -> AddMult (x, y, a);
 }
 
+void MixedBilinearForm::MultTranspose (const Vector & x, Vector & y) const
+{
+   if (ext) { ext->MultTranspose(x, y); return; }
+   y = 0.0;
+   AddMultTranspose (x, y);
+}
+
 void MixedBilinearForm::AddMultTranspose (const Vector & x, Vector & y,
                                           const double a) const
 {
+   if (ext) { ext->AddMultTranspose(x, y, a); return; }
    mat -> AddMultTranspose (x, y, a);
 }
 
@@ -1055,6 +1254,7 @@ MatrixInverse * MixedBilinearForm::Inverse() const
 
 void MixedBilinearForm::Finalize (int skip_zeros)
 {
+   if (ext) { return; }
    mat -> Finalize (skip_zeros);
 }
 
@@ -1094,6 +1294,12 @@ void MixedBilinearForm::Assemble (int skip_zeros)
 
    Mesh *mesh = test_fes -> GetMesh();
 
+   if (ext)
+   {
+      ext->Assemble();
+      return;
+   }
+
    if (mat == NULL)
    {
       mat = new SparseMatrix(height, width);
@@ -1245,17 +1451,48 @@ void MixedBilinearForm::EliminateTestDofs (const Array<int> &bdr_attr_is_ess)
       }
 }
 
+void MixedBilinearForm::AssembleDiagonal_ADAt(const Vector &D,
+                                              Vector &diag) const
+{
+   MFEM_VERIFY(D.Size() == width, "invalid size of D");
+   diag.SetSize(height);
+   if (ext)
+   {
+      ext->AssembleDiagonal_ADAt(D, diag);
+      return;
+   }
+   MFEM_VERIFY(mat && mat->Finalized(), "the MixedBilinearForm is not "
+               "assembled and finalized");
+   MFEM_VERIFY(mat->Width() == width, "the matrix was transformed by "
+               "ConformingAssemble(), which is not supported");
+   const int *I = mat->GetI(), *J = mat->GetJ();
+   const double *A = mat->GetData();
+   const double *h_D = D.HostRead();
+   double *h_diag = diag.HostWrite();
+   for (int i = 0; i < height; i++)
+   {
+      double d = 0.0;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         d += A[k] * A[k] * h_D[J[k]];
+      }
+      h_diag[i] = d;
+   }
+}
+
 void MixedBilinearForm::Update()
 {
    delete mat;
    mat = NULL;
    height = test_fes->GetVSize();
    width = trial_fes->GetVSize();
+   if (ext) { ext->Update(); }
 }
 
 MixedBilinearForm::~MixedBilinearForm()
 {
    if (mat) { delete mat; }
+   delete ext;
    if (!extern_bfs)
    {
       int i;
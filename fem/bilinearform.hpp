@@ -30,8 +30,13 @@ namespace mfem
 enum class AssemblyLevel
 {
    /// Fully assembled form, i.e. a global sparse matrix in MFEM, Hypre or PETSC
-   /// format.
+   /// format. The matrix is assembled element by element on the host. This is
+   /// the default assembly level.
    FULL,
+   /// Fully assembled form, i.e. a global sparse matrix in MFEM, Hypre or PETSC
+   /// format. The element matrices are computed in batches and summed into a
+   /// precomputed sparsity pattern using the device/OpenMP backends.
+   DEVICEFULL,
    /// Form assembled at element level, which computes and stores dense element
    /// matrices.
    ELEMENT,
@@ -48,6 +53,8 @@ enum class AssemblyLevel
     BLFIntegrators. */
 class BilinearForm : public Matrix
 {
+   friend class FABilinearFormExtension;
+
 protected:
    /// Sparse matrix to be associated with the form. Owned.
    SparseMatrix *mat;
@@ -107,6 +114,13 @@ protected:
    // Allocate appropriate SparseMatrix and assign it to mat
    void AllocMat();
 
+   /// Assemble the domain integrators with threads, see UseThreadedAssembly().
+   bool threaded_assembly;
+   // Can the domain integrators be assembled with threads in the current state?
+   bool ThreadedDomainAssembly() const;
+   // Threaded version of the domain integrator loop in Assemble()
+   void AssembleDomainThreaded();
+
    void ConformingAssemble();
 
    // may be used in the construction of derived classes
@@ -116,6 +130,7 @@ protected:
       mat = mat_e = NULL; extern_bfs = 0; element_matrices = NULL;
       static_cond = NULL; hybridization = NULL;
       precompute_sparsity = 0;
+      threaded_assembly = false;
       diag_policy = DIAG_KEEP;
       assembly = AssemblyLevel::FULL;
       batch = 1;
@@ -149,8 +164,9 @@ public:
    /// Get the size of the BilinearForm as a square matrix.
    int Size() const { return height; }
 
-   /// Set the desired assembly level. The default is AssemblyLevel::FULL.
-   /** This method must be called before assembly. */
+   /// Set the desired assembly level.
+   /** The default is AssemblyLevel::FULL. This method must be called
+       before assembly. */
    void SetAssemblyLevel(AssemblyLevel assembly_level);
 
    /** Enable the use of static condensation. For details see the description
@@ -179,6 +195,24 @@ public:
        present in the bilinear form. */
    void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
 
+   /** @brief Assemble the domain integrators with OpenMP threads, see
+       Assemble(). */
+   /** This option has an effect only when MFEM is built with MFEM_USE_OPENMP
+       and MFEM_THREAD_SAFE; in the latter mode the integrators that keep their
+       work arrays as class members, marked with MFEM_THREAD_SAFE in their
+       declarations, use local arrays instead. The elements are processed one
+       color at a time, see FiniteElementSpace::GetElementColoring(), and each
+       thread uses its own ElementTransformation, so the element matrices of one
+       color can be added concurrently to the rows of the matrix. The matrix is
+       allocated in CSR format with the sparsity pattern of the element dofs,
+       unless it is already finalized, e.g. with UsePrecomputedSparsity(), which
+       is needed for interior face integrators.
+
+       The domain integrators and their coefficients must be thread-safe. The
+       domain integrators are assembled serially with static condensation,
+       hybridization, precomputed element matrices and NURBS spaces. */
+   void UseThreadedAssembly(bool use = true) { threaded_assembly = use; }
+
    /** @brief Use the given CSR sparsity pattern to allocate the internal
        SparseMatrix.
 
@@ -227,7 +261,14 @@ public:
    virtual const double &Elem(int i, int j) const;
 
    /// Matrix vector multiplication.
-   virtual void Mult(const Vector &x, Vector &y) const { mat->Mult(x, y); }
+   /** With every assembly level except AssemblyLevel::FULL, the action is
+       computed by the extension #ext on L-vectors, without essential boundary
+       conditions. */
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      if (ext) { ext->Mult(x, y); }
+      else { mat->Mult(x, y); }
+   }
 
    void FullMult(const Vector &x, Vector &y) const
    { mat->Mult(x, y); mat_e->AddMult(x, y); }
@@ -246,7 +287,10 @@ public:
    { mat->AddMultTranspose(x, y); mat_e->AddMultTranspose(x, y); }
 
    virtual void MultTranspose(const Vector & x, Vector & y) const
-   { y = 0.0; AddMultTranspose (x, y); }
+   {
+      if (ext) { ext->MultTranspose(x, y); return; }
+      y = 0.0; AddMultTranspose (x, y);
+   }
 
    double InnerProduct(const Vector &x, const Vector &y) const
    { return mat->InnerProduct (x, y); }
@@ -364,7 +408,8 @@ public:
        reference will be invalidated when SetOperatorType(), Update(), or the
        destructor is called.
 
-       Currently, this method can be used only with AssemblyLevel::FULL. */
+       Currently, this method can be used only with AssemblyLevel::FULL
+       and AssemblyLevel::DEVICEFULL. */
    template <typename OpType>
    void FormLinearSystem(const Array<int> &ess_tdof_list, Vector &x, Vector &b,
                          OpType &A, Vector &X, Vector &B,
@@ -388,7 +433,8 @@ public:
        reference will be invalidated when SetOperatorType(), Update(), or the
        destructor is called.
 
-       Currently, this method can be used only with AssemblyLevel::FULL. */
+       Currently, this method can be used only with AssemblyLevel::FULL
+       and AssemblyLevel::DEVICEFULL. */
    template <typename OpType>
    void FormSystemMatrix(const Array<int> &ess_tdof_list, OpType &A)
    {
@@ -399,6 +445,22 @@ public:
       A.MakeRef(*A_ptr);
    }
 
+   /** @brief Assemble the diagonal of the bilinear form into @a diag, which is
+       resized to the number of true dofs, GetTrueVSize(). */
+   /** With AssemblyLevel::PARTIAL and ELEMENT, the diagonal is computed
+       without assembling the matrix, see
+       BilinearFormIntegrator::AssembleDiagonalPA(). The local (L-vector)
+       diagonal is reduced to the true dofs with the transpose of the
+       prolongation, which gives the exact diagonal of the operator returned by
+       FormSystemMatrix() only when the prolongation is a boolean matrix, e.g.
+       for conforming meshes; with non-conforming meshes the result is an
+       approximation, suitable for Jacobi-type smoothers.
+
+       The essential dofs are not treated, i.e. the diagonal is that of the
+       operator before the elimination of the essential boundary conditions.
+       Static condensation and hybridization are not supported. */
+   virtual void AssembleDiagonal(Vector &diag) const;
+
    /// Recover the solution of a linear system formed with FormLinearSystem().
    /** Call this method after solving a linear system constructed using the
        FormLinearSystem() method to recover the solution as a GridFunction-size
@@ -524,6 +586,12 @@ protected:
    /// Trace face (skeleton) integrators.
    Array<BilinearFormIntegrator*> skt;
 
+   /// The form assembly level (full, partial, etc.)
+   AssemblyLevel assembly;
+   /** Extension for supporting Partial Assembly (PA); NULL with
+       AssemblyLevel::FULL. Owned. */
+   MixedBilinearFormExtension *ext;
+
 private:
    /// Copy construction is not supported; body is undefined.
    MixedBilinearForm(const MixedBilinearForm &);
@@ -552,6 +620,27 @@ public:
                      FiniteElementSpace *te_fes,
                      MixedBilinearForm *mbf);
 
+   /// Set the desired assembly level.
+   /** The default is AssemblyLevel::FULL; AssemblyLevel::PARTIAL is also
+       supported, for domain integrators only. This method must be called
+       before assembly.
+
+       With partial assembly, the form is an Operator acting on the local
+       (L-vector) dofs of the trial and test spaces; no SparseMatrix is
+       assembled, so SpMat() and the methods of the Matrix interface that
+       access the entries are not available. */
+   void SetAssemblyLevel(AssemblyLevel assembly_level);
+
+   /// Return the trial FiniteElementSpace.
+   FiniteElementSpace *TrialFESpace() { return trial_fes; }
+   /// Read-only access to the trial FiniteElementSpace.
+   const FiniteElementSpace *TrialFESpace() const { return trial_fes; }
+
+   /// Return the test FiniteElementSpace.
+   FiniteElementSpace *TestFESpace() { return test_fes; }
+   /// Read-only access to the test FiniteElementSpace.
+   const FiniteElementSpace *TestFESpace() const { return test_fes; }
+
    virtual double &Elem(int i, int j);
 
    virtual const double &Elem(int i, int j) const;
@@ -564,8 +653,7 @@ public:
    virtual void AddMultTranspose(const Vector & x, Vector & y,
                                  const double a = 1.0) const;
 
-   virtual void MultTranspose(const Vector & x, Vector & y) const
-   { y = 0.0; AddMultTranspose (x, y); }
+   virtual void MultTranspose(const Vector & x, Vector & y) const;
 
    virtual MatrixInverse *Inverse() const;
 
@@ -606,6 +694,19 @@ public:
 
    void Assemble(int skip_zeros = 1);
 
+   /** @brief Assemble the diagonal of A D A^T into @a diag, where A is the
+       operator of this form and D is the diagonal matrix with entries @a D. */
+   /** The vectors @a D and @a diag are local (L-vector) vectors of the trial
+       and test spaces, respectively. This is the diagonal used, e.g., by Jacobi
+       preconditioners of the Schur complement B diag(M)^{-1} B^T of mixed
+       problems.
+
+       With AssemblyLevel::PARTIAL the diagonal is computed element by element,
+       see BilinearFormIntegrator::AssembleDiagonalPA_ADAt(), which is exact
+       when each test dof belongs to a single element, e.g. for L2 test spaces,
+       and neglects the coupling between elements otherwise. */
+   void AssembleDiagonal_ADAt(const Vector &D, Vector &diag) const;
+
    /** For partially conforming trial and/or test FE spaces, complete the
        assembly process by performing A := P2^t A P1 where A is the internal
        sparse matrix; P1 and P2 are the conforming prolongation matrices of the
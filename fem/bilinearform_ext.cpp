@@ -10,7 +10,8 @@
 // Software Foundation) version 2.1 dated February 1999.
 
 // Implementations of classes FABilinearFormExtension, EABilinearFormExtension,
-// PABilinearFormExtension and MFBilinearFormExtension.
+// PABilinearFormExtension, MFBilinearFormExtension and
+// PAMixedBilinearFormExtension.
 
 #include "../general/forall.hpp"
 #include "bilinearform.hpp"
@@ -34,11 +35,17 @@ const Operator *BilinearFormExtension::GetRestriction() const
    return a->GetRestriction();
 }
 
+void BilinearFormExtension::AssembleDiagonal(Vector &) const
+{
+   MFEM_ABORT("AssembleDiagonal() is not supported by this assembly level");
+}
+
 
 // Data and methods for partially-assembled bilinear forms
 PABilinearFormExtension::PABilinearFormExtension(BilinearForm *form)
    : BilinearFormExtension(form),
-     trialFes(a->FESpace()), testFes(a->FESpace())
+     trialFes(a->FESpace()), testFes(a->FESpace()),
+     int_face_restrict(NULL), bdr_face_restrict(NULL)
 {
    elem_restrict_lex = trialFes->GetElementRestriction(
                           ElementDofOrdering::LEXICOGRAPHIC);
@@ -58,6 +65,36 @@ void PABilinearFormExtension::Assemble()
    {
       integrators[i]->AssemblePA(*a->FESpace());
    }
+
+   // The face integrators act on face E-vectors
+   Array<BilinearFormIntegrator*> &intFaceIntegrators = *a->GetFBFI();
+   Array<BilinearFormIntegrator*> &bdrFaceIntegrators = *a->GetBFBFI();
+   if (intFaceIntegrators.Size() > 0)
+   {
+      int_face_restrict = static_cast<const FaceRestriction*>(
+                             trialFes->GetFaceRestriction(FaceType::Interior));
+      faceIntX.SetSize(int_face_restrict->Height(), Device::GetMemoryType());
+      faceIntY.SetSize(int_face_restrict->Height(), Device::GetMemoryType());
+      faceIntY.UseDevice(true);
+   }
+   for (int i = 0; i < intFaceIntegrators.Size(); ++i)
+   {
+      intFaceIntegrators[i]->AssemblePAInteriorFaces(*a->FESpace());
+   }
+   if (bdrFaceIntegrators.Size() > 0)
+   {
+      bdr_face_restrict = static_cast<const FaceRestriction*>(
+                             trialFes->GetFaceRestriction(FaceType::Boundary));
+      faceBdrX.SetSize(bdr_face_restrict->Height(), Device::GetMemoryType());
+      faceBdrY.SetSize(bdr_face_restrict->Height(), Device::GetMemoryType());
+      faceBdrY.UseDevice(true);
+   }
+   for (int i = 0; i < bdrFaceIntegrators.Size(); ++i)
+   {
+      MFEM_VERIFY((*a->GetBFBFI_Marker())[i] == NULL, "boundary markers are "
+                  "not supported by the partially assembled face integrators");
+      bdrFaceIntegrators[i]->AssemblePABoundaryFaces(*a->FESpace());
+   }
 }
 
 void PABilinearFormExtension::Update()
@@ -66,6 +103,7 @@ void PABilinearFormExtension::Update()
    height = width = fes->GetVSize();
    trialFes = fes;
    testFes = fes;
+   int_face_restrict = bdr_face_restrict = NULL;
    elem_restrict_lex = trialFes->GetElementRestriction(
                           ElementDofOrdering::LEXICOGRAPHIC);
    if (elem_restrict_lex)
@@ -97,6 +135,50 @@ void PABilinearFormExtension::FormLinearSystem(const Array<int> &ess_tdof_list,
    A.Reset(oper); // A will own oper
 }
 
+void PABilinearFormExtension::AddMultFaces(const Vector &x, Vector &y,
+                                           const bool transpose) const
+{
+   Array<BilinearFormIntegrator*> &intFaceIntegrators = *a->GetFBFI();
+   const int iFISz = intFaceIntegrators.Size();
+   if (int_face_restrict && iFISz > 0)
+   {
+      int_face_restrict->Mult(x, faceIntX);
+      faceIntY = 0.0;
+      for (int i = 0; i < iFISz; ++i)
+      {
+         if (transpose)
+         {
+            intFaceIntegrators[i]->AddMultTransposePA(faceIntX, faceIntY);
+         }
+         else
+         {
+            intFaceIntegrators[i]->AddMultPA(faceIntX, faceIntY);
+         }
+      }
+      int_face_restrict->AddMultTranspose(faceIntY, y);
+   }
+
+   Array<BilinearFormIntegrator*> &bdrFaceIntegrators = *a->GetBFBFI();
+   const int bFISz = bdrFaceIntegrators.Size();
+   if (bdr_face_restrict && bFISz > 0)
+   {
+      bdr_face_restrict->Mult(x, faceBdrX);
+      faceBdrY = 0.0;
+      for (int i = 0; i < bFISz; ++i)
+      {
+         if (transpose)
+         {
+            bdrFaceIntegrators[i]->AddMultTransposePA(faceBdrX, faceBdrY);
+         }
+         else
+         {
+            bdrFaceIntegrators[i]->AddMultPA(faceBdrX, faceBdrY);
+         }
+      }
+      bdr_face_restrict->AddMultTranspose(faceBdrY, y);
+   }
+}
+
 void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
@@ -121,6 +203,7 @@ void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
          integrators[i]->AddMultPA(x, y);
       }
    }
+   AddMultFaces(x, y, false);
 }
 
 void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
@@ -146,6 +229,385 @@ void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
          integrators[i]->AddMultTransposePA(x, y);
       }
    }
+   AddMultFaces(x, y, true);
+}
+
+void PABilinearFormExtension::AssembleDiagonal(Vector &diag) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int iSz = integrators.Size();
+   if (elem_restrict_lex)
+   {
+      localY = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AssembleDiagonalPA(localY);
+      }
+      // The diagonal entries do not depend on the signs of the DOFs
+      const ElementRestriction *restr =
+         static_cast<const ElementRestriction*>(elem_restrict_lex);
+      restr->MultTransposeUnsigned(localY, diag);
+   }
+   else
+   {
+      diag.UseDevice(true);
+      diag = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AssembleDiagonalPA(diag);
+      }
+   }
+}
+
+
+// Data and methods for element-assembled bilinear forms
+EABilinearFormExtension::EABilinearFormExtension(BilinearForm *form)
+   : PABilinearFormExtension(form),
+     ne(0),
+     elemDofs(0)
+{
+   // empty
+}
+
+void EABilinearFormExtension::Assemble()
+{
+   MFEM_VERIFY(a->GetBBFI()->Size() == 0 && a->GetFBFI()->Size() == 0 &&
+               a->GetBFBFI()->Size() == 0, "AssemblyLevel::ELEMENT supports "
+               "only domain integrators, use AssemblyLevel::PARTIAL");
+
+   FiniteElementSpace &fes = *a->FESpace();
+   ne = fes.GetNE();
+   elemDofs = ne > 0 ? fes.GetFE(0)->GetDof() * fes.GetVDim() : 0;
+   ea_data.SetSize(ne*elemDofs*elemDofs, Device::GetMemoryType());
+   ea_data.UseDevice(true);
+
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int integratorCount = integrators.Size();
+   if (integratorCount == 0) { ea_data = 0.0; }
+   for (int i = 0; i < integratorCount; ++i)
+   {
+      integrators[i]->AssembleEA(fes, ea_data, i > 0);
+   }
+}
+
+void EABilinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   // Apply the element restriction
+   const bool useRestrict = elem_restrict_lex;
+   if (useRestrict) { elem_restrict_lex->Mult(x, localX); }
+   // Apply the element matrices
+   const int NE = ne;
+   const int NDOFS = elemDofs;
+   auto X = Reshape(useRestrict ? localX.Read() : x.Read(), NDOFS, NE);
+   auto Y = Reshape(useRestrict ? localY.Write() : y.Write(), NDOFS, NE);
+   auto A = Reshape(ea_data.Read(), NDOFS, NDOFS, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int i = 0; i < NDOFS; i++) { Y(i,e) = 0.0; }
+      for (int j = 0; j < NDOFS; j++)
+      {
+         const double x_j = X(j,e);
+         for (int i = 0; i < NDOFS; i++)
+         {
+            Y(i,e) += A(i,j,e) * x_j;
+         }
+      }
+   });
+   // Apply the element restriction transposed
+   if (useRestrict) { elem_restrict_lex->MultTranspose(localY, y); }
+}
+
+void EABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
+{
+   // Apply the element restriction
+   const bool useRestrict = elem_restrict_lex;
+   if (useRestrict) { elem_restrict_lex->Mult(x, localX); }
+   // Apply the transposed element matrices
+   const int NE = ne;
+   const int NDOFS = elemDofs;
+   auto X = Reshape(useRestrict ? localX.Read() : x.Read(), NDOFS, NE);
+   auto Y = Reshape(useRestrict ? localY.Write() : y.Write(), NDOFS, NE);
+   auto A = Reshape(ea_data.Read(), NDOFS, NDOFS, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int j = 0; j < NDOFS; j++)
+      {
+         double res = 0.0;
+         for (int i = 0; i < NDOFS; i++)
+         {
+            res += A(i,j,e) * X(i,e);
+         }
+         Y(j,e) = res;
+      }
+   });
+   // Apply the element restriction transposed
+   if (useRestrict) { elem_restrict_lex->MultTranspose(localY, y); }
+}
+
+void EABilinearFormExtension::AssembleDiagonal(Vector &diag) const
+{
+   // Extract the diagonals of the element matrices
+   const bool useRestrict = elem_restrict_lex;
+   const int NE = ne;
+   const int NDOFS = elemDofs;
+   if (!useRestrict) { diag.UseDevice(true); }
+   auto D = Reshape(useRestrict ? localY.Write() : diag.Write(), NDOFS, NE);
+   auto A = Reshape(ea_data.Read(), NDOFS, NDOFS, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int i = 0; i < NDOFS; i++) { D(i,e) = A(i,i,e); }
+   });
+   // Sum the contributions of the elements
+   if (useRestrict)
+   {
+      const ElementRestriction *restr =
+         static_cast<const ElementRestriction*>(elem_restrict_lex);
+      restr->MultTransposeUnsigned(localY, diag);
+   }
+}
+
+
+// Data and methods for fully-assembled bilinear forms
+FABilinearFormExtension::FABilinearFormExtension(BilinearForm *form)
+   : EABilinearFormExtension(form),
+     fa_mat(NULL),
+     fa_sequence(-1)
+{
+   // empty
+}
+
+void FABilinearFormExtension::Assemble()
+{
+   MFEM_VERIFY(a->bbfi.Size() == 0 && a->fbfi.Size() == 0 &&
+               a->bfbfi.Size() == 0, "AssemblyLevel::DEVICEFULL supports only "
+               "domain integrators, use AssemblyLevel::FULL");
+   MFEM_VERIFY(elem_restrict_lex, "discontinuous spaces are not supported");
+
+   EABilinearFormExtension::Assemble();
+
+   FiniteElementSpace &fes = *a->FESpace();
+   const ElementRestriction *restr =
+      static_cast<const ElementRestriction*>(elem_restrict_lex);
+   // Build the sparsity pattern only if the matrix is not the one created by a
+   // previous call, e.g. after a full BilinearForm::Update().
+   if (a->mat == NULL || a->mat != fa_mat ||
+       fa_sequence != fes.GetSequence() || a->mat->Height() != fes.GetVSize())
+   {
+      delete a->mat;
+      a->mat = restr->NewSparseMatrix();
+      fa_mat = a->mat;
+      fa_sequence = fes.GetSequence();
+   }
+   restr->FillSparseMatrix(ea_data, *a->mat);
+}
+
+void FABilinearFormExtension::FormSystemMatrix(const Array<int> &ess_tdof_list,
+                                               OperatorHandle &A)
+{
+   a->FormSystemMatrix(ess_tdof_list, A);
+}
+
+void FABilinearFormExtension::FormLinearSystem(const Array<int> &ess_tdof_list,
+                                               Vector &x, Vector &b,
+                                               OperatorHandle &A,
+                                               Vector &X, Vector &B,
+                                               int copy_interior)
+{
+   a->FormLinearSystem(ess_tdof_list, x, b, A, X, B, copy_interior);
+}
+
+void FABilinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   a->SpMat().Mult(x, y);
+}
+
+void FABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
+{
+   a->SpMat().MultTranspose(x, y);
+}
+
+
+// Data and methods for matrix-free bilinear forms
+MFBilinearFormExtension::MFBilinearFormExtension(BilinearForm *form)
+   : PABilinearFormExtension(form)
+{
+   // empty
+}
+
+void MFBilinearFormExtension::Assemble()
+{
+   MFEM_VERIFY(a->GetBBFI()->Size() == 0 && a->GetFBFI()->Size() == 0 &&
+               a->GetBFBFI()->Size() == 0, "AssemblyLevel::NONE supports only "
+               "domain integrators, use AssemblyLevel::PARTIAL");
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int integratorCount = integrators.Size();
+   for (int i = 0; i < integratorCount; ++i)
+   {
+      integrators[i]->AssembleMF(*a->FESpace());
+   }
 }
 
-} // namespace mfem
+void MFBilinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int iSz = integrators.Size();
+   MFEM_VERIFY(elem_restrict_lex, "discontinuous spaces are not supported");
+   elem_restrict_lex->Mult(x, localX);
+   localY = 0.0;
+   for (int i = 0; i < iSz; ++i)
+   {
+      integrators[i]->AddMultMF(localX, localY);
+   }
+   elem_restrict_lex->MultTranspose(localY, y);
+}
+
+void MFBilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int iSz = integrators.Size();
+   MFEM_VERIFY(elem_restrict_lex, "discontinuous spaces are not supported");
+   elem_restrict_lex->Mult(x, localX);
+   localY = 0.0;
+   for (int i = 0; i < iSz; ++i)
+   {
+      integrators[i]->AddMultTransposeMF(localX, localY);
+   }
+   elem_restrict_lex->MultTranspose(localY, y);
+}
+
+void MFBilinearFormExtension::AssembleDiagonal(Vector &) const
+{
+   MFEM_ABORT("AssembleDiagonal() is not supported with matrix-free assembly, "
+              "use AssemblyLevel::PARTIAL");
+}
+
+
+MixedBilinearFormExtension::MixedBilinearFormExtension(MixedBilinearForm *form)
+   : Operator(form->Height(), form->Width()), a(form)
+{
+   // empty
+}
+
+
+// Data and methods for partially-assembled mixed bilinear forms
+PAMixedBilinearFormExtension::PAMixedBilinearFormExtension(
+   MixedBilinearForm *form)
+   : MixedBilinearFormExtension(form),
+     trialFes(form->TrialFESpace()),
+     testFes(form->TestFESpace())
+{
+   SetupRestrictions();
+}
+
+void PAMixedBilinearFormExtension::SetupRestrictions()
+{
+   elem_restrict_trial = trialFes->GetElementRestriction(
+                            ElementDofOrdering::LEXICOGRAPHIC);
+   elem_restrict_test = testFes->GetElementRestriction(
+                           ElementDofOrdering::LEXICOGRAPHIC);
+   if (elem_restrict_trial)
+   {
+      localTrial.SetSize(elem_restrict_trial->Height(),
+                         Device::GetMemoryType());
+      localTrial.UseDevice(true);
+   }
+   if (elem_restrict_test)
+   {
+      localTest.SetSize(elem_restrict_test->Height(), Device::GetMemoryType());
+      localTest.UseDevice(true);
+   }
+}
+
+void PAMixedBilinearFormExtension::Assemble()
+{
+   MFEM_VERIFY(a->GetBBFI()->Size() == 0 && a->GetTFBFI()->Size() == 0,
+               "only domain integrators are supported with partial assembly");
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   for (int i = 0; i < integrators.Size(); ++i)
+   {
+      integrators[i]->AssemblePA(*trialFes, *testFes);
+   }
+}
+
+void PAMixedBilinearFormExtension::Update()
+{
+   height = testFes->GetVSize();
+   width = trialFes->GetVSize();
+   SetupRestrictions();
+}
+
+void PAMixedBilinearFormExtension::MultInternal(const Vector &x, Vector &y,
+                                                const bool transpose) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const Operator *in_restrict =
+      transpose ? elem_restrict_test : elem_restrict_trial;
+   const Operator *out_restrict =
+      transpose ? elem_restrict_trial : elem_restrict_test;
+   Vector &localIn = transpose ? localTest : localTrial;
+   Vector &localOut = transpose ? localTrial : localTest;
+
+   if (in_restrict) { in_restrict->Mult(x, localIn); }
+   const Vector &xe = in_restrict ? localIn : x;
+   Vector &ye = out_restrict ? localOut : y;
+   ye.UseDevice(true);
+   ye = 0.0;
+   for (int i = 0; i < integrators.Size(); ++i)
+   {
+      if (transpose) { integrators[i]->AddMultTransposePA(xe, ye); }
+      else { integrators[i]->AddMultPA(xe, ye); }
+   }
+   if (out_restrict) { out_restrict->MultTranspose(localOut, y); }
+}
+
+void PAMixedBilinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   MultInternal(x, y, false);
+}
+
+void PAMixedBilinearFormExtension::MultTranspose(const Vector &x,
+                                                 Vector &y) const
+{
+   MultInternal(x, y, true);
+}
+
+void PAMixedBilinearFormExtension::AddMult(const Vector &x, Vector &y,
+                                           const double c) const
+{
+   tempY.SetSize(height, Device::GetMemoryType());
+   MultInternal(x, tempY, false);
+   y.Add(c, tempY);
+}
+
+void PAMixedBilinearFormExtension::AddMultTranspose(const Vector &x, Vector &y,
+                                                    const double c) const
+{
+   tempY.SetSize(width, Device::GetMemoryType());
+   MultInternal(x, tempY, true);
+   y.Add(c, tempY);
+}
+
+void PAMixedBilinearFormExtension::AssembleDiagonal_ADAt(const Vector &D,
+                                                         Vector &diag) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   // The entries of D and of the diagonal do not depend on the signs of the
+   // DOFs, so the restrictions are applied without signs.
+   const ElementRestriction *trial_restrict =
+      static_cast<const ElementRestriction*>(elem_restrict_trial);
+   const ElementRestriction *test_restrict =
+      static_cast<const ElementRestriction*>(elem_restrict_test);
+
+   if (trial_restrict) { trial_restrict->MultUnsigned(D, localTrial); }
+   const Vector &De = trial_restrict ? localTrial : D;
+   Vector &de = test_restrict ? localTest : diag;
+   de.UseDevice(true);
+   de = 0.0;
+   for (int i = 0; i < integrators.Size(); ++i)
+   {
+      integrators[i]->AssembleDiagonalPA_ADAt(De, de);
+   }
+   if (test_restrict) { test_restrict->MultTransposeUnsigned(localTest, diag); }
+}
+
+}
@@ -20,6 +20,7 @@ namespace mfem
 {
 
 class BilinearForm;
+class MixedBilinearForm;
 
 
 /** @brief Class extending the BilinearForm class to support the different
@@ -49,58 +50,93 @@ public:
                                  OperatorHandle &A, Vector &X, Vector &B,
                                  int copy_interior = 0) = 0;
    virtual void Update() = 0;
+
+   /** @brief Compute the diagonal of the operator, without the finite element
+       space prolongation, i.e. as an L-vector, see
+       BilinearForm::AssembleDiagonal(). */
+   virtual void AssembleDiagonal(Vector &diag) const;
+
+   /// Does Assemble() produce the SparseMatrix of the BilinearForm?
+   /** In that case, the BilinearForm forms the linear system and recovers the
+       solution using its SparseMatrix, as without an extension. */
+   virtual bool AssemblesSparseMatrix() const { return false; }
 };
 
-/// Data and methods for fully-assembled bilinear forms
-class FABilinearFormExtension : public BilinearFormExtension
+/// Data and methods for partially-assembled bilinear forms
+class PABilinearFormExtension : public BilinearFormExtension
 {
+protected:
+   const FiniteElementSpace *trialFes, *testFes; // Not owned
+   mutable Vector localX, localY;
+   const Operator *elem_restrict_lex; // Not owned
+   /// Face restrictions, set in Assemble() if there are face integrators.
+   const FaceRestriction *int_face_restrict, *bdr_face_restrict; // Not owned
+   mutable Vector faceIntX, faceIntY, faceBdrX, faceBdrY;
+
+   /// Add the action (or its transpose) of the face integrators to @a y.
+   void AddMultFaces(const Vector &x, Vector &y, const bool transpose) const;
+
 public:
-   FABilinearFormExtension(BilinearForm *form)
-      : BilinearFormExtension(form) { }
+   PABilinearFormExtension(BilinearForm*);
 
-   /// TODO
-   void Assemble() {}
-   void FormSystemMatrix(const Array<int> &ess_tdof_list, OperatorHandle &A) {}
+   void Assemble();
+   void FormSystemMatrix(const Array<int> &ess_tdof_list, OperatorHandle &A);
    void FormLinearSystem(const Array<int> &ess_tdof_list,
                          Vector &x, Vector &b,
                          OperatorHandle &A, Vector &X, Vector &B,
-                         int copy_interior = 0) {}
-   void Mult(const Vector &x, Vector &y) const {}
-   void MultTranspose(const Vector &x, Vector &y) const {}
-   void Update() {}
-   ~FABilinearFormExtension() {}
+                         int copy_interior = 0);
+
+   void Mult(const Vector &x, Vector &y) const;
+   void MultTranspose(const Vector &x, Vector &y) const;
+   void Update();
+
+   /** The element diagonals are computed by the domain integrators, see
+       BilinearFormIntegrator::AssembleDiagonalPA(), and summed with the
+       transpose of the element restriction. */
+   void AssembleDiagonal(Vector &diag) const;
 };
 
 /// Data and methods for element-assembled bilinear forms
-class EABilinearFormExtension : public BilinearFormExtension
+/** The dense element matrices are computed by the domain integrators, see
+    BilinearFormIntegrator::AssembleEA(), and stored contiguously in the layout
+    ND x ND x NE. The action is computed as a batched small matrix-vector
+    product between the element restriction and its transpose. */
+class EABilinearFormExtension : public PABilinearFormExtension
 {
+protected:
+   int ne;
+   int elemDofs;
+   Vector ea_data;
+
 public:
-   EABilinearFormExtension(BilinearForm *form)
-      : BilinearFormExtension(form) { }
+   EABilinearFormExtension(BilinearForm *form);
 
-   /// TODO
-   void Assemble() {}
-   void FormSystemMatrix(const Array<int> &ess_tdof_list, OperatorHandle &A) {}
-   void FormLinearSystem(const Array<int> &ess_tdof_list,
-                         Vector &x, Vector &b,
-                         OperatorHandle &A, Vector &X, Vector &B,
-                         int copy_interior = 0) {}
-   void Mult(const Vector &x, Vector &y) const {}
-   void MultTranspose(const Vector &x, Vector &y) const {}
-   void Update() {}
-   ~EABilinearFormExtension() {}
+   void Assemble();
+   void Mult(const Vector &x, Vector &y) const;
+   void MultTranspose(const Vector &x, Vector &y) const;
+   void AssembleDiagonal(Vector &diag) const;
+
+   /// Access the assembled element matrices, see AssembleEA().
+   const Vector &GetElementMatrices() const { return ea_data; }
 };
 
-/// Data and methods for partially-assembled bilinear forms
-class PABilinearFormExtension : public BilinearFormExtension
+/// Data and methods for fully-assembled bilinear forms
+/** The element matrices are computed as in EABilinearFormExtension and then
+    summed, in parallel, into the SparseMatrix of the BilinearForm. The sparsity
+    pattern is computed once, from the element restriction, and reused by
+    subsequent calls to Assemble() as long as the FiniteElementSpace does not
+    change. The resulting matrix is used by the BilinearForm in the same way as
+    the matrix assembled with AssemblyLevel::FULL. */
+class FABilinearFormExtension : public EABilinearFormExtension
 {
 protected:
-   const FiniteElementSpace *trialFes, *testFes; // Not owned
-   mutable Vector localX, localY;
-   const Operator *elem_restrict_lex; // Not owned
+   /// The SparseMatrix whose sparsity pattern was created here. Not owned.
+   const SparseMatrix *fa_mat;
+   /// The FiniteElementSpace sequence used to create the sparsity of #fa_mat.
+   long fa_sequence;
 
 public:
-   PABilinearFormExtension(BilinearForm*);
+   FABilinearFormExtension(BilinearForm *form);
 
    void Assemble();
    void FormSystemMatrix(const Array<int> &ess_tdof_list, OperatorHandle &A);
@@ -108,30 +144,93 @@ public:
                          Vector &x, Vector &b,
                          OperatorHandle &A, Vector &X, Vector &B,
                          int copy_interior = 0);
-
    void Mult(const Vector &x, Vector &y) const;
    void MultTranspose(const Vector &x, Vector &y) const;
-   void Update();
+   bool AssemblesSparseMatrix() const { return true; }
 };
 
 /// Data and methods for matrix-free bilinear forms
-class MFBilinearFormExtension : public BilinearFormExtension
+/** Unlike PABilinearFormExtension, the geometric factors and the coefficients
+    at the quadrature points are recomputed during each application of the
+    operator, so only the mesh nodes (as an E-vector) are stored by the
+    integrators. */
+class MFBilinearFormExtension : public PABilinearFormExtension
 {
 public:
-   MFBilinearFormExtension(BilinearForm *form)
-      : BilinearFormExtension(form) { }
+   MFBilinearFormExtension(BilinearForm *form);
 
-   /// TODO
-   void Assemble() {}
-   void FormSystemMatrix(const Array<int> &ess_tdof_list, OperatorHandle &A) {}
-   void FormLinearSystem(const Array<int> &ess_tdof_list,
-                         Vector &x, Vector &b,
-                         OperatorHandle &A, Vector &X, Vector &B,
-                         int copy_interior = 0) {}
-   void Mult(const Vector &x, Vector &y) const {}
-   void MultTranspose(const Vector &x, Vector &y) const {}
-   void Update() {}
-   ~MFBilinearFormExtension() {}
+   void Assemble();
+   void Mult(const Vector &x, Vector &y) const;
+   void MultTranspose(const Vector &x, Vector &y) const;
+   void AssembleDiagonal(Vector &diag) const;
+};
+
+
+/** @brief Class extending the MixedBilinearForm class to support the different
+    AssemblyLevel%s. */
+/** The extension acts on L-vectors: the input of Mult() is a vector of the
+    trial FiniteElementSpace and its output a vector of the test
+    FiniteElementSpace. */
+class MixedBilinearFormExtension : public Operator
+{
+protected:
+   MixedBilinearForm *a; ///< Not owned
+
+public:
+   MixedBilinearFormExtension(MixedBilinearForm *form);
+
+   virtual MemoryClass GetMemoryClass() const
+   { return Device::GetMemoryClass(); }
+
+   virtual void Assemble() = 0;
+   virtual void Update() = 0;
+
+   virtual void AddMult(const Vector &x, Vector &y,
+                        const double c = 1.0) const = 0;
+   virtual void AddMultTranspose(const Vector &x, Vector &y,
+                                 const double c = 1.0) const = 0;
+
+   /** @brief Compute the diagonal of A diag(@a D) A^T, see
+       MixedBilinearForm::AssembleDiagonal_ADAt(). */
+   virtual void AssembleDiagonal_ADAt(const Vector &D, Vector &diag) const = 0;
+};
+
+/// Data and methods for partially-assembled mixed bilinear forms
+/** The domain integrators are assembled with the two-space version of
+    BilinearFormIntegrator::AssemblePA(). Their actions map trial E-vectors to
+    test E-vectors and are combined with the lexicographic element restrictions
+    of the two spaces; spaces without an element restriction, e.g. L2 spaces,
+    use their L-vectors as E-vectors. */
+class PAMixedBilinearFormExtension : public MixedBilinearFormExtension
+{
+protected:
+   const FiniteElementSpace *trialFes, *testFes; // Not owned
+   const Operator *elem_restrict_trial, *elem_restrict_test; // Not owned
+   mutable Vector localTrial, localTest, tempY;
+
+   /// Set up the restrictions and the local vectors.
+   void SetupRestrictions();
+
+   /// Compute @a y = A @a x (or A^T @a x, if @a transpose is true).
+   void MultInternal(const Vector &x, Vector &y, const bool transpose) const;
+
+public:
+   PAMixedBilinearFormExtension(MixedBilinearForm *form);
+
+   void Assemble();
+   void Update();
+
+   void Mult(const Vector &x, Vector &y) const;
+   void MultTranspose(const Vector &x, Vector &y) const;
+   void AddMult(const Vector &x, Vector &y, const double c = 1.0) const;
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double c = 1.0) const;
+
+   /** The diagonals of the element matrices B_e diag(D) B_e^T are computed by
+       the domain integrators, see
+       BilinearFormIntegrator::AssembleDiagonalPA_ADAt(), and summed with the
+       transpose of the test element restriction. */
+   void AssembleDiagonal_ADAt(const Vector &D, Vector &diag) const;
 };
 
 }
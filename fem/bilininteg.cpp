@@ -12,6 +12,7 @@
 // Implementation of Bilinear Form Integrators
 
 #include "fem.hpp"
+#include "../general/forall.hpp"
 #include <cmath>
 #include <algorithm>
 
@@ -26,6 +27,13 @@ void BilinearFormIntegrator::AssemblePA(const FiniteElementSpace&)
                "   is not implemented for this class.");
 }
 
+void BilinearFormIntegrator::AssemblePA(const FiniteElementSpace&,
+                                        const FiniteElementSpace&)
+{
+   mfem_error ("BilinearFormIntegrator::AssemblePA (trial, test)\n"
+               "   is not implemented for this class.");
+}
+
 void BilinearFormIntegrator::AddMultPA(const Vector &, Vector &) const
 {
    mfem_error ("BilinearFormIntegrator::MultAssembled (...)\n"
@@ -38,6 +46,104 @@ void BilinearFormIntegrator::AddMultTransposePA(const Vector &, Vector &) const
                "   is not implemented for this class.");
 }
 
+void BilinearFormIntegrator::AddMultPAElements(const Vector &, Vector &,
+                                               const Array<int> &) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultPAElements (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleDiagonalPA(Vector &) const
+{
+   mfem_error ("BilinearFormIntegrator::AssembleDiagonalPA (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleDiagonalPA_ADAt(const Vector &,
+                                                     Vector &) const
+{
+   mfem_error ("BilinearFormIntegrator::AssembleDiagonalPA_ADAt (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssemblePAInteriorFaces(const FiniteElementSpace&)
+{
+   mfem_error ("BilinearFormIntegrator::AssemblePAInteriorFaces (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssemblePABoundaryFaces(const FiniteElementSpace&)
+{
+   mfem_error ("BilinearFormIntegrator::AssemblePABoundaryFaces (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleMF(const FiniteElementSpace&)
+{
+   mfem_error ("BilinearFormIntegrator::AssembleMF (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AddMultMF(const Vector &, Vector &) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultMF (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AddMultTransposeMF(const Vector &, Vector &) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultTransposeMF (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                        Vector &emat, const bool add)
+{
+   // Assuming the same element type
+   const int ne = fes.GetNE();
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const int nd = el.GetDof();
+   const int vdim = fes.GetVDim();
+   const int elmat_size = nd*vdim;
+   // Map the lexicographic local DOFs to the native ones, see the constructor
+   // of ElementRestriction.
+   const TensorBasisElement *tel = dynamic_cast<const TensorBasisElement*>(&el);
+   const int *dof_map = NULL;
+   if (tel && tel->GetDofMap().Size() > 0)
+   {
+      dof_map = tel->GetDofMap().GetData();
+   }
+   MFEM_VERIFY(emat.Size() == elmat_size*elmat_size*ne,
+               "invalid element matrices vector size");
+   double *data = add ? emat.HostReadWrite() : emat.HostWrite();
+   auto A = Reshape(data, nd, vdim, nd, vdim, ne);
+   DenseMatrix elmat;
+   for (int e = 0; e < ne; e++)
+   {
+      ElementTransformation *T = fes.GetElementTransformation(e);
+      AssembleElementMatrix(*fes.GetFE(e), *T, elmat);
+      MFEM_VERIFY(elmat.Height() == elmat_size && elmat.Width() == elmat_size,
+                  "unexpected element matrix size");
+      for (int cj = 0; cj < vdim; cj++)
+      {
+         for (int j = 0; j < nd; j++)
+         {
+            const int jj = (dof_map ? dof_map[j] : j) + nd*cj;
+            for (int ci = 0; ci < vdim; ci++)
+            {
+               for (int i = 0; i < nd; i++)
+               {
+                  const int ii = (dof_map ? dof_map[i] : i) + nd*ci;
+                  if (add) { A(i,ci,j,cj,e) += elmat(ii,jj); }
+                  else { A(i,ci,j,cj,e) = elmat(ii,jj); }
+               }
+            }
+         }
+      }
+   }
+}
+
 void BilinearFormIntegrator::AssembleElementMatrix (
    const FiniteElement &el, ElementTransformation &Trans,
    DenseMatrix &elmat )
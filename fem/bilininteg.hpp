@@ -44,6 +44,13 @@ public:
        used later in the methods AddMultPA() and AddMultTransposePA(). */
    virtual void AssemblePA(const FiniteElementSpace &fes);
 
+   /// Method defining partial assembly on different trial and test spaces.
+   /** Used by the mixed integrators of a MixedBilinearForm with
+       AssemblyLevel::PARTIAL. The methods AddMultPA() and AddMultTransposePA()
+       then map trial E-vectors to test E-vectors and vice versa. */
+   virtual void AssemblePA(const FiniteElementSpace &trial_fes,
+                           const FiniteElementSpace &test_fes);
+
    /// Method for partially assembled action.
    /** Perform the action of integrator on the input @a x and add the result to
        the output @a y. Both @a x and @a y are E-vectors, i.e. they represent
@@ -62,6 +69,86 @@ public:
        called. */
    virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
 
+   /// Method for partially assembled action on a subset of the elements.
+   /** Same as AddMultPA(), except that only the elements listed in @a elems
+       are processed: the entries of @a y for the other elements are not
+       modified and the entries of @a x for them are not read. Used to overlap
+       the parallel communication with the local work, see
+       ParBilinearForm::OverlapCommunication().
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AddMultPAElements(const Vector &x, Vector &y,
+                                  const Array<int> &elems) const;
+
+   /// Method for the diagonal of the partially assembled operator.
+   /** Add the diagonal of the element matrices of the integrator to the
+       E-vector @a diag, without assembling the matrices.
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   /// Method for the diagonal of B D B^T, for a mixed integrator.
+   /** Add the diagonal of B_e diag(@a D) B_e^T, where B_e are the element
+       matrices of the mixed integrator, to the test E-vector @a diag. The
+       trial E-vector @a D is given without the signs of the element
+       restriction. See MixedBilinearForm::AssembleDiagonal_ADAt().
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AssembleDiagonalPA_ADAt(const Vector &D, Vector &diag) const;
+
+   /// Method defining partial assembly on the interior faces of the mesh.
+   /** Used by face integrators, see BilinearForm::AddInteriorFaceIntegrator().
+       After this call, the methods AddMultPA() and AddMultTransposePA() act on
+       face E-vectors instead of element E-vectors, see FaceRestriction and
+       FiniteElementSpace::GetFaceRestriction() with FaceType::Interior. */
+   virtual void AssemblePAInteriorFaces(const FiniteElementSpace &fes);
+
+   /// Method defining partial assembly on the boundary faces of the mesh.
+   /** Same as AssemblePAInteriorFaces(), for the boundary faces, see
+       BilinearForm::AddBdrFaceIntegrator() and FaceType::Boundary. */
+   virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes);
+
+   /// Method defining matrix-free assembly.
+   /** Only the data needed to recompute the geometric factors and coefficients
+       at the quadrature points is set up here, i.e. no quadrature point data
+       is stored. It is used later in the methods AddMultMF() and
+       AddMultTransposeMF(). */
+   virtual void AssembleMF(const FiniteElementSpace &fes);
+
+   /// Method for matrix-free action.
+   /** Perform the action of integrator on the input @a x and add the result to
+       the output @a y. Both @a x and @a y are E-vectors, i.e. they represent
+       the element-wise discontinuous version of the FE space.
+
+       This method can be called only after the method AssembleMF() has been
+       called. */
+   virtual void AddMultMF(const Vector &x, Vector &y) const;
+
+   /// Method for matrix-free transposed action.
+   /** Perform the transpose action of integrator on the input @a x and add the
+       result to the output @a y. Both @a x and @a y are E-vectors, i.e. they
+       represent the element-wise discontinuous version of the FE space.
+
+       This method can be called only after the method AssembleMF() has been
+       called. */
+   virtual void AddMultTransposeMF(const Vector &x, Vector &y) const;
+
+   /// Method defining element assembly.
+   /** The result of the element assembly is added to (if @a add is true) or
+       written to (if @a add is false) the Vector @a emat which stores the
+       dense element matrices in the layout ND x ND x NE, where ND is the
+       number of degrees of freedom per element (times the vector dimension of
+       @a fes). The local DOFs use the same ordering as the E-vectors of
+       PABilinearFormExtension, i.e. lexicographic for tensor-product elements.
+
+       The default implementation calls AssembleElementMatrix() element by
+       element on the host; derived classes may provide batched kernels. */
+   virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
+                           const bool add = true);
+
    /// Given a particular Finite Element computes the element matrix elmat.
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
@@ -194,6 +281,25 @@ public:
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
 
+   virtual void AssemblePA(const FiniteElementSpace &fes)
+   { bfi->AssemblePA(fes); }
+
+   virtual void AssemblePA(const FiniteElementSpace &trial_fes,
+                           const FiniteElementSpace &test_fes)
+   { bfi->AssemblePA(test_fes, trial_fes); }
+
+   virtual void AssemblePAInteriorFaces(const FiniteElementSpace &fes)
+   { bfi->AssemblePAInteriorFaces(fes); }
+
+   virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes)
+   { bfi->AssemblePABoundaryFaces(fes); }
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const
+   { bfi->AddMultTransposePA(x, y); }
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { bfi->AddMultPA(x, y); }
+
    virtual ~TransposeIntegrator() { if (own_bfi) { delete bfi; } }
 };
 
@@ -1679,17 +1785,23 @@ private:
    int dim, ne, dofs1D, quad1D;
    Vector pa_data;
 
+   // MF extension
+   const DofToQuad *mf_node_maps; ///< Not owned
+   Vector mf_nodes;
+   double mf_coeff;
+
 public:
    /// Construct a diffusion integrator with coefficient Q = 1
-   DiffusionIntegrator() { Q = NULL; MQ = NULL; maps = NULL; geom = NULL; }
+   DiffusionIntegrator()
+   { Q = NULL; MQ = NULL; maps = NULL; geom = NULL; mf_node_maps = NULL; }
 
    /// Construct a diffusion integrator with a scalar coefficient q
    DiffusionIntegrator(Coefficient &q)
-      : Q(&q) { MQ = NULL; maps = NULL; geom = NULL; }
+      : Q(&q) { MQ = NULL; maps = NULL; geom = NULL; mf_node_maps = NULL; }
 
    /// Construct a diffusion integrator with a matrix coefficient q
    DiffusionIntegrator(MatrixCoefficient &q)
-      : MQ(&q) { Q = NULL; maps = NULL; geom = NULL; }
+      : MQ(&q) { Q = NULL; maps = NULL; geom = NULL; mf_node_maps = NULL; }
 
    /** Given a particular Finite Element
        computes the element stiffness matrix elmat. */
@@ -1721,6 +1833,21 @@ public:
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   virtual void AddMultPAElements(const Vector &x, Vector &y,
+                                  const Array<int> &elems) const;
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   virtual void AssembleMF(const FiniteElementSpace&);
+
+   virtual void AddMultMF(const Vector&, Vector&) const;
+
+   virtual void AddMultTransposeMF(const Vector &x, Vector &y) const
+   { AddMultMF(x, y); }
+
+   virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
+                           const bool add);
+
    static const IntegrationRule &GetRule(const FiniteElement &trial_fe,
                                          const FiniteElement &test_fe);
 };
@@ -1738,14 +1865,20 @@ protected:
    const DofToQuad *maps;         ///< Not owned
    const GeometricFactors *geom;  ///< Not owned
    int dim, ne, nq, dofs1D, quad1D;
+   // MF extension
+   const DofToQuad *mf_node_maps; ///< Not owned
+   Vector mf_nodes;
+   double mf_coeff;
 
 public:
    MassIntegrator(const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir) { Q = NULL; maps = NULL; geom = NULL; }
+      : BilinearFormIntegrator(ir)
+   { Q = NULL; maps = NULL; geom = NULL; mf_node_maps = NULL; }
 
    /// Construct a mass integrator with coefficient q
    MassIntegrator(Coefficient &q, const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir), Q(&q) { maps = NULL; geom = NULL; }
+      : BilinearFormIntegrator(ir), Q(&q)
+   { maps = NULL; geom = NULL; mf_node_maps = NULL; }
 
    /** Given a particular Finite Element
        computes the element mass matrix elmat. */
@@ -1761,6 +1894,21 @@ public:
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   virtual void AddMultPAElements(const Vector &x, Vector &y,
+                                  const Array<int> &elems) const;
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   virtual void AssembleMF(const FiniteElementSpace&);
+
+   virtual void AddMultMF(const Vector&, Vector&) const;
+
+   virtual void AddMultTransposeMF(const Vector &x, Vector &y) const
+   { AddMultMF(x, y); }
+
+   virtual void AssembleEA(const FiniteElementSpace &fes, Vector &emat,
+                           const bool add);
+
    static const IntegrationRule &GetRule(const FiniteElement &trial_fe,
                                          const FiniteElement &test_fe,
                                          ElementTransformation &Trans);
@@ -1791,13 +1939,24 @@ private:
    DenseMatrix dshape, adjJ, Q_ir;
    Vector shape, vec2, BdFidxT;
 #endif
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *maps;         ///< Not owned
+   const GeometricFactors *geom;  ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D;
 
 public:
    ConvectionIntegrator(VectorCoefficient &q, double a = 1.0)
-      : Q(&q) { alpha = a; }
+      : Q(&q) { alpha = a; maps = NULL; geom = NULL; }
    virtual void AssembleElementMatrix(const FiniteElement &,
                                       ElementTransformation &,
                                       DenseMatrix &);
+
+   virtual void AssemblePA(const FiniteElementSpace&);
+
+   virtual void AddMultPA(const Vector&, Vector&) const;
+
+   virtual void AddMultTransposePA(const Vector&, Vector&) const;
 };
 
 /// alpha (q . grad u, v) using the "group" FE discretization
@@ -1880,6 +2039,12 @@ class VectorFEDivergenceIntegrator : public BilinearFormIntegrator
 {
 protected:
    Coefficient *Q;
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *mapsO;         ///< Not owned. DOF-to-quad map, open.
+   const DofToQuad *L2mapsO;       ///< Not owned. DOF-to-quad map, test.
+   const DofToQuad *mapsC;         ///< Not owned. DOF-to-quad map, closed.
+   int dim, ne, nq, dofs1D, testdofs1D, quad1D;
 
 private:
 #ifndef MFEM_THREAD_SAFE
@@ -1887,8 +2052,10 @@ private:
 #endif
 
 public:
-   VectorFEDivergenceIntegrator() { Q = NULL; }
-   VectorFEDivergenceIntegrator(Coefficient &q) { Q = &q; }
+   VectorFEDivergenceIntegrator()
+   { Q = NULL; mapsO = L2mapsO = mapsC = NULL; }
+   VectorFEDivergenceIntegrator(Coefficient &q)
+   { Q = &q; mapsO = L2mapsO = mapsC = NULL; }
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat) { }
@@ -1896,6 +2063,18 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   /** @brief Partial assembly with Raviart-Thomas trial elements and nodal
+       (e.g. L2) test elements on quads and hexes, with a scalar
+       coefficient. */
+   virtual void AssemblePA(const FiniteElementSpace &trial_fes,
+                           const FiniteElementSpace &test_fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalPA_ADAt(const Vector &D, Vector &diag) const;
 };
 
 
@@ -1988,12 +2167,21 @@ private:
 protected:
    Coefficient *Q;
    MatrixCoefficient *MQ;
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *mapsO;         ///< Not owned. DOF-to-quad map, open.
+   const DofToQuad *mapsC;         ///< Not owned. DOF-to-quad map, closed.
+   const GeometricFactors *geom;   ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D;
 
 public:
-   CurlCurlIntegrator() { Q = NULL; MQ = NULL; }
+   CurlCurlIntegrator()
+   { Q = NULL; MQ = NULL; mapsO = mapsC = NULL; geom = NULL; }
    /// Construct a bilinear form integrator for Nedelec elements
-   CurlCurlIntegrator(Coefficient &q) : Q(&q) { MQ = NULL; }
-   CurlCurlIntegrator(MatrixCoefficient &m) : MQ(&m) { Q = NULL; }
+   CurlCurlIntegrator(Coefficient &q) : Q(&q)
+   { MQ = NULL; mapsO = mapsC = NULL; geom = NULL; }
+   CurlCurlIntegrator(MatrixCoefficient &m) : MQ(&m)
+   { Q = NULL; mapsO = mapsC = NULL; geom = NULL; }
 
    /* Given a particular Finite Element, compute the
       element curl-curl matrix elmat */
@@ -2009,6 +2197,12 @@ public:
    virtual double ComputeFluxEnergy(const FiniteElement &fluxelem,
                                     ElementTransformation &Trans,
                                     Vector &flux, Vector *d_energy = NULL);
+
+   /** @brief Partial assembly on Nedelec elements on quads and hexes, with a
+       scalar coefficient. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
 };
 
 /** Integrator for (curl u, curl v) for FE spaces defined by 'dim' copies of a
@@ -2043,7 +2237,10 @@ class VectorFEMassIntegrator: public BilinearFormIntegrator
 {
 private:
    void Init(Coefficient *q, VectorCoefficient *vq, MatrixCoefficient *mq)
-   { Q = q; VQ = vq; MQ = mq; }
+   {
+      Q = q; VQ = vq; MQ = mq; mapsO = mapsC = NULL; geom = NULL;
+      hdiv = false;
+   }
 
 #ifndef MFEM_THREAD_SAFE
    Vector shape;
@@ -2057,6 +2254,13 @@ protected:
    Coefficient *Q;
    VectorCoefficient *VQ;
    MatrixCoefficient *MQ;
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *mapsO;         ///< Not owned. DOF-to-quad map, open.
+   const DofToQuad *mapsC;         ///< Not owned. DOF-to-quad map, closed.
+   const GeometricFactors *geom;   ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D;
+   bool hdiv; ///< Raviart-Thomas (true) or Nedelec (false) elements
 
 public:
    VectorFEMassIntegrator() { Init(NULL, NULL, NULL); }
@@ -2074,6 +2278,14 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   /** @brief Partial assembly on Nedelec and Raviart-Thomas elements on
+       quads and hexes, with a scalar coefficient. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
 };
 
 /** Integrator for (Q div u, p) where u=(v1,...,vn) and all vi are in the same
@@ -2106,6 +2318,12 @@ class DivDivIntegrator: public BilinearFormIntegrator
 {
 protected:
    Coefficient *Q;
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *mapsO;         ///< Not owned. DOF-to-quad map, open.
+   const DofToQuad *mapsC;         ///< Not owned. DOF-to-quad map, closed.
+   const GeometricFactors *geom;   ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D;
 
 private:
 #ifndef MFEM_THREAD_SAFE
@@ -2113,12 +2331,19 @@ private:
 #endif
 
 public:
-   DivDivIntegrator() { Q = NULL; }
-   DivDivIntegrator(Coefficient &q) : Q(&q) { }
+   DivDivIntegrator() { Q = NULL; mapsO = mapsC = NULL; geom = NULL; }
+   DivDivIntegrator(Coefficient &q) : Q(&q)
+   { mapsO = mapsC = NULL; geom = NULL; }
 
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+
+   /** @brief Partial assembly on Raviart-Thomas elements on quads and hexes,
+       with a scalar coefficient. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
 };
 
 /** Integrator for
@@ -2225,6 +2450,16 @@ protected:
 
 private:
    Vector shape1, shape2;
+   // PA extension
+   Vector pa_data;
+   /// 1D basis functions at the 1D points of the face quadrature rule.
+   Array<double> B, Bt;
+   int dim, nf, nsides, dofs1D, quad1D;
+
+   /** Set up the PA data on the faces of the given @a type. One quadrature
+       rule is used for all faces: the rule set by SetIntRule() or else the
+       default rule of face 0, which is verified to match on all faces. */
+   void SetupPA(const FiniteElementSpace &fes, FaceType type);
 
 public:
    /// Construct integrator with rho = 1.
@@ -2240,6 +2475,14 @@ public:
                                    const FiniteElement &el2,
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
+
+   virtual void AssemblePAInteriorFaces(const FiniteElementSpace &fes);
+
+   virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector&, Vector&) const;
+
+   virtual void AddMultTransposePA(const Vector&, Vector&) const;
 };
 
 /** Integrator for the DG form:
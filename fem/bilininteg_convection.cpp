@@ -0,0 +1,712 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../general/forall.hpp"
+#include "bilininteg.hpp"
+#include "gridfunc.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA Convection Integrator
+
+// PA Convection Assemble 2D kernel
+static void PAConvectionSetup2D(const int NQ,
+                                const int NE,
+                                const Array<double> &w,
+                                const Vector &j,
+                                const Vector &vel,
+                                const double alpha,
+                                Vector &op)
+{
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, 2, 2, NE);
+   auto V = Reshape(vel.Read(), NQ, 2, NE);
+   auto y = Reshape(op.Write(), NQ, 2, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double J11 = J(q,0,0,e);
+         const double J21 = J(q,1,0,e);
+         const double J12 = J(q,0,1,e);
+         const double J22 = J(q,1,1,e);
+         const double w = alpha * W[q];
+         const double v0 = V(q,0,e);
+         const double v1 = V(q,1,e);
+         // w * adj(J) * v
+         y(q,0,e) = w * ( J22 * v0 - J12 * v1);
+         y(q,1,e) = w * (-J21 * v0 + J11 * v1);
+      }
+   });
+}
+
+// PA Convection Assemble 3D kernel
+static void PAConvectionSetup3D(const int NQ,
+                                const int NE,
+                                const Array<double> &w,
+                                const Vector &j,
+                                const Vector &vel,
+                                const double alpha,
+                                Vector &op)
+{
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, 3, 3, NE);
+   auto V = Reshape(vel.Read(), NQ, 3, NE);
+   auto y = Reshape(op.Write(), NQ, 3, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double J11 = J(q,0,0,e), J12 = J(q,0,1,e), J13 = J(q,0,2,e);
+         const double J21 = J(q,1,0,e), J22 = J(q,1,1,e), J23 = J(q,1,2,e);
+         const double J31 = J(q,2,0,e), J32 = J(q,2,1,e), J33 = J(q,2,2,e);
+         const double w = alpha * W[q];
+         const double v0 = V(q,0,e);
+         const double v1 = V(q,1,e);
+         const double v2 = V(q,2,e);
+         // adj(J)
+         const double A11 = (J22 * J33) - (J23 * J32);
+         const double A12 = (J13 * J32) - (J12 * J33);
+         const double A13 = (J12 * J23) - (J13 * J22);
+         const double A21 = (J23 * J31) - (J21 * J33);
+         const double A22 = (J11 * J33) - (J13 * J31);
+         const double A23 = (J13 * J21) - (J11 * J23);
+         const double A31 = (J21 * J32) - (J22 * J31);
+         const double A32 = (J12 * J31) - (J11 * J32);
+         const double A33 = (J11 * J22) - (J12 * J21);
+         // w * adj(J) * v
+         y(q,0,e) = w * (A11 * v0 + A12 * v1 + A13 * v2);
+         y(q,1,e) = w * (A21 * v0 + A22 * v1 + A23 * v2);
+         y(q,2,e) = w * (A31 * v0 + A32 * v1 + A33 * v2);
+      }
+   });
+}
+
+void ConvectionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   // Assuming the same element type
+   Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNE() == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   ElementTransformation &T = *mesh->GetElementTransformation(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      const int order = T.OrderGrad(&el) + T.Order() + el.GetOrder();
+      ir = &IntRules.Get(el.GetGeomType(), order);
+   }
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   nq = ir->GetNPoints();
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   pa_data.SetSize(dim*nq*ne, Device::GetMemoryType());
+   MFEM_VERIFY(Q->GetVDim() == dim, "invalid VectorCoefficient size");
+   Vector vel;
+   EvalCoefficientQVector(*Q, *mesh, *ir, vel);
+   if (dim == 2)
+   {
+      PAConvectionSetup2D(nq, ne, ir->GetWeights(), geom->J, vel, alpha,
+                          pa_data);
+   }
+   else if (dim == 3)
+   {
+      PAConvectionSetup3D(nq, ne, ir->GetWeights(), geom->J, vel, alpha,
+                          pa_data);
+   }
+   else
+   {
+      MFEM_ABORT("Not supported yet... stay tuned!");
+   }
+}
+
+// PA Convection Apply 2D kernel
+template<int T_D1D = 0, int T_Q1D = 0> static
+void PAConvectionApply2D(const int NE,
+                         const Array<double> &b,
+                         const Array<double> &g,
+                         const Array<double> &bt,
+                         const Vector &_op,
+                         const Vector &_x,
+                         Vector &_y,
+                         const int d1d = 0,
+                         const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 2, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      // reference gradient at the quadrature points
+      double grad[max_Q1D][max_Q1D][2];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            grad[qy][qx][0] = 0.0;
+            grad[qy][qx][1] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double gradX[max_Q1D][2];
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            gradX[qx][0] = 0.0;
+            gradX[qx][1] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const double s = x(dx,dy,e);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] += s * B(qx,dx);
+               gradX[qx][1] += s * G(qx,dx);
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double wy  = B(qy,dy);
+            const double wDy = G(qy,dy);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qy][qx][0] += gradX[qx][1] * wy;
+               grad[qy][qx][1] += gradX[qx][0] * wDy;
+            }
+         }
+      }
+      // contract with the velocity and apply the test functions
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double Zx[max_D1D];
+         for (int dx = 0; dx < D1D; ++dx) { Zx[dx] = 0.0; }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double z = op(qx,qy,0,e) * grad[qy][qx][0] +
+                             op(qx,qy,1,e) * grad[qy][qx][1];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               Zx[dx] += z * Bt(dx,qx);
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double wy = Bt(dy,qy);
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               y(dx,dy,e) += Zx[dx] * wy;
+            }
+         }
+      }
+   });
+}
+
+// PA Convection Apply 3D kernel
+template<int T_D1D = 0, int T_Q1D = 0> static
+void PAConvectionApply3D(const int NE,
+                         const Array<double> &b,
+                         const Array<double> &g,
+                         const Array<double> &bt,
+                         const Vector &_op,
+                         const Vector &_x,
+                         Vector &_y,
+                         const int d1d = 0,
+                         const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 3, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      // reference gradient at the quadrature points
+      double grad[max_Q1D][max_Q1D][max_Q1D][3];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qz][qy][qx][0] = 0.0;
+               grad[qz][qy][qx][1] = 0.0;
+               grad[qz][qy][qx][2] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double gradXY[max_Q1D][max_Q1D][3];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradXY[qy][qx][0] = 0.0;
+               gradXY[qy][qx][1] = 0.0;
+               gradXY[qy][qx][2] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double gradX[max_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] = 0.0;
+               gradX[qx][1] = 0.0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double s = x(dx,dy,dz,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] += s * B(qx,dx);
+                  gradX[qx][1] += s * G(qx,dx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = B(qy,dy);
+               const double wDy = G(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradXY[qy][qx][0] += gradX[qx][1] * wy;
+                  gradXY[qy][qx][1] += gradX[qx][0] * wDy;
+                  gradXY[qy][qx][2] += gradX[qx][0] * wy;
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz  = B(qz,dz);
+            const double wDz = G(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  grad[qz][qy][qx][0] += gradXY[qy][qx][0] * wz;
+                  grad[qz][qy][qx][1] += gradXY[qy][qx][1] * wz;
+                  grad[qz][qy][qx][2] += gradXY[qy][qx][2] * wDz;
+               }
+            }
+         }
+      }
+      // contract with the velocity and apply the test functions
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double ZXY[max_D1D][max_D1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx) { ZXY[dy][dx] = 0.0; }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double ZX[max_D1D];
+            for (int dx = 0; dx < D1D; ++dx) { ZX[dx] = 0.0; }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double z = op(qx,qy,qz,0,e) * grad[qz][qy][qx][0] +
+                                op(qx,qy,qz,1,e) * grad[qz][qy][qx][1] +
+                                op(qx,qy,qz,2,e) * grad[qz][qy][qx][2];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  ZX[dx] += z * Bt(dx,qx);
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy = Bt(dy,qy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  ZXY[dy][dx] += ZX[dx] * wy;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz = Bt(dz,qz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  y(dx,dy,dz,e) += ZXY[dy][dx] * wz;
+               }
+            }
+         }
+      }
+   });
+}
+
+// PA Convection Apply Transpose 2D kernel
+template<int T_D1D = 0, int T_Q1D = 0> static
+void PAConvectionApplyT2D(const int NE,
+                          const Array<double> &b,
+                          const Array<double> &bt,
+                          const Array<double> &gt,
+                          const Vector &_op,
+                          const Vector &_x,
+                          Vector &_y,
+                          const int d1d = 0,
+                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt.Read(), D1D, Q1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 2, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      // values at the quadrature points
+      double u[max_Q1D][max_Q1D];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx) { u[qy][qx] = 0.0; }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double uX[max_Q1D];
+         for (int qx = 0; qx < Q1D; ++qx) { uX[qx] = 0.0; }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const double s = x(dx,dy,e);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               uX[qx] += s * B(qx,dx);
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double wy = B(qy,dy);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               u[qy][qx] += uX[qx] * wy;
+            }
+         }
+      }
+      // multiply by the velocity and apply the test function gradients
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double gradX[max_D1D][2];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            gradX[dx][0] = 0.0;
+            gradX[dx][1] = 0.0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double z0 = op(qx,qy,0,e) * u[qy][qx];
+            const double z1 = op(qx,qy,1,e) * u[qy][qx];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradX[dx][0] += z0 * Gt(dx,qx);
+               gradX[dx][1] += z1 * Bt(dx,qx);
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double wy  = Bt(dy,qy);
+            const double wDy = Gt(dy,qy);
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               y(dx,dy,e) += gradX[dx][0] * wy + gradX[dx][1] * wDy;
+            }
+         }
+      }
+   });
+}
+
+// PA Convection Apply Transpose 3D kernel
+template<int T_D1D = 0, int T_Q1D = 0> static
+void PAConvectionApplyT3D(const int NE,
+                          const Array<double> &b,
+                          const Array<double> &bt,
+                          const Array<double> &gt,
+                          const Vector &_op,
+                          const Vector &_x,
+                          Vector &_y,
+                          const int d1d = 0,
+                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt.Read(), D1D, Q1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 3, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      // values at the quadrature points
+      double u[max_Q1D][max_Q1D][max_Q1D];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx) { u[qz][qy][qx] = 0.0; }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double uXY[max_Q1D][max_Q1D];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx) { uXY[qy][qx] = 0.0; }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double uX[max_Q1D];
+            for (int qx = 0; qx < Q1D; ++qx) { uX[qx] = 0.0; }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double s = x(dx,dy,dz,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  uX[qx] += s * B(qx,dx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = B(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  uXY[qy][qx] += uX[qx] * wy;
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz = B(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  u[qz][qy][qx] += uXY[qy][qx] * wz;
+               }
+            }
+         }
+      }
+      // multiply by the velocity and apply the test function gradients
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double gradXY[max_D1D][max_D1D][3];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradXY[dy][dx][0] = 0.0;
+               gradXY[dy][dx][1] = 0.0;
+               gradXY[dy][dx][2] = 0.0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double gradX[max_D1D][3];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradX[dx][0] = 0.0;
+               gradX[dx][1] = 0.0;
+               gradX[dx][2] = 0.0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double s = u[qz][qy][qx];
+               const double z0 = op(qx,qy,qz,0,e) * s;
+               const double z1 = op(qx,qy,qz,1,e) * s;
+               const double z2 = op(qx,qy,qz,2,e) * s;
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradX[dx][0] += z0 * Gt(dx,qx);
+                  gradX[dx][1] += z1 * Bt(dx,qx);
+                  gradX[dx][2] += z2 * Bt(dx,qx);
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy  = Bt(dy,qy);
+               const double wDy = Gt(dy,qy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradXY[dy][dx][0] += gradX[dx][0] * wy;
+                  gradXY[dy][dx][1] += gradX[dx][1] * wDy;
+                  gradXY[dy][dx][2] += gradX[dx][2] * wy;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz  = Bt(dz,qz);
+            const double wDz = Gt(dz,qz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  y(dx,dy,dz,e) += (gradXY[dy][dx][0] +
+                                    gradXY[dy][dx][1]) * wz +
+                                   gradXY[dy][dx][2] * wDz;
+               }
+            }
+         }
+      }
+   });
+}
+
+static void PAConvectionApply(const int dim,
+                              const int D1D,
+                              const int Q1D,
+                              const int NE,
+                              const Array<double> &B,
+                              const Array<double> &G,
+                              const Array<double> &Bt,
+                              const Vector &op,
+                              const Vector &x,
+                              Vector &y)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22: return PAConvectionApply2D<2,2>(NE,B,G,Bt,op,x,y);
+         case 0x33: return PAConvectionApply2D<3,3>(NE,B,G,Bt,op,x,y);
+         case 0x44: return PAConvectionApply2D<4,4>(NE,B,G,Bt,op,x,y);
+         case 0x55: return PAConvectionApply2D<5,5>(NE,B,G,Bt,op,x,y);
+         case 0x66: return PAConvectionApply2D<6,6>(NE,B,G,Bt,op,x,y);
+         case 0x77: return PAConvectionApply2D<7,7>(NE,B,G,Bt,op,x,y);
+         case 0x88: return PAConvectionApply2D<8,8>(NE,B,G,Bt,op,x,y);
+         case 0x99: return PAConvectionApply2D<9,9>(NE,B,G,Bt,op,x,y);
+         default:   return PAConvectionApply2D(NE,B,G,Bt,op,x,y,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23: return PAConvectionApply3D<2,3>(NE,B,G,Bt,op,x,y);
+         case 0x34: return PAConvectionApply3D<3,4>(NE,B,G,Bt,op,x,y);
+         case 0x45: return PAConvectionApply3D<4,5>(NE,B,G,Bt,op,x,y);
+         case 0x56: return PAConvectionApply3D<5,6>(NE,B,G,Bt,op,x,y);
+         case 0x67: return PAConvectionApply3D<6,7>(NE,B,G,Bt,op,x,y);
+         case 0x78: return PAConvectionApply3D<7,8>(NE,B,G,Bt,op,x,y);
+         case 0x89: return PAConvectionApply3D<8,9>(NE,B,G,Bt,op,x,y);
+         default:   return PAConvectionApply3D(NE,B,G,Bt,op,x,y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+static void PAConvectionApplyTranspose(const int dim,
+                                       const int D1D,
+                                       const int Q1D,
+                                       const int NE,
+                                       const Array<double> &B,
+                                       const Array<double> &Bt,
+                                       const Array<double> &Gt,
+                                       const Vector &op,
+                                       const Vector &x,
+                                       Vector &y)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22: return PAConvectionApplyT2D<2,2>(NE,B,Bt,Gt,op,x,y);
+         case 0x33: return PAConvectionApplyT2D<3,3>(NE,B,Bt,Gt,op,x,y);
+         case 0x44: return PAConvectionApplyT2D<4,4>(NE,B,Bt,Gt,op,x,y);
+         case 0x55: return PAConvectionApplyT2D<5,5>(NE,B,Bt,Gt,op,x,y);
+         case 0x66: return PAConvectionApplyT2D<6,6>(NE,B,Bt,Gt,op,x,y);
+         case 0x77: return PAConvectionApplyT2D<7,7>(NE,B,Bt,Gt,op,x,y);
+         case 0x88: return PAConvectionApplyT2D<8,8>(NE,B,Bt,Gt,op,x,y);
+         case 0x99: return PAConvectionApplyT2D<9,9>(NE,B,Bt,Gt,op,x,y);
+         default:   return PAConvectionApplyT2D(NE,B,Bt,Gt,op,x,y,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23: return PAConvectionApplyT3D<2,3>(NE,B,Bt,Gt,op,x,y);
+         case 0x34: return PAConvectionApplyT3D<3,4>(NE,B,Bt,Gt,op,x,y);
+         case 0x45: return PAConvectionApplyT3D<4,5>(NE,B,Bt,Gt,op,x,y);
+         case 0x56: return PAConvectionApplyT3D<5,6>(NE,B,Bt,Gt,op,x,y);
+         case 0x67: return PAConvectionApplyT3D<6,7>(NE,B,Bt,Gt,op,x,y);
+         case 0x78: return PAConvectionApplyT3D<7,8>(NE,B,Bt,Gt,op,x,y);
+         case 0x89: return PAConvectionApplyT3D<8,9>(NE,B,Bt,Gt,op,x,y);
+         default:   return PAConvectionApplyT3D(NE,B,Bt,Gt,op,x,y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Convection Apply kernel
+void ConvectionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   PAConvectionApply(dim, dofs1D, quad1D, ne,
+                     maps->B, maps->G, maps->Bt,
+                     pa_data, x, y);
+}
+
+// PA Convection Apply Transpose kernel
+void ConvectionIntegrator::AddMultTransposePA(const Vector &x,
+                                              Vector &y) const
+{
+   PAConvectionApplyTranspose(dim, dofs1D, quad1D, ne,
+                              maps->B, maps->Bt, maps->Gt,
+                              pa_data, x, y);
+}
+
+} // namespace mfem
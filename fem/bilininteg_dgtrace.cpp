@@ -0,0 +1,389 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../general/forall.hpp"
+#include "bilininteg.hpp"
+#include "gridfunc.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA DG Trace Integrator
+
+// PA DG Trace Assemble kernel: the quadrature point data is computed on the
+// host, face by face, as in AssembleFaceMatrix().
+// Default quadrature order on the face @a tr, assuming order(u)==order(mesh)
+static int DGTraceFaceOrder(FaceElementTransformations &tr,
+                            const FiniteElement &el, const int nsides)
+{
+   return (nsides == 2) ?
+          min(tr.Elem1->OrderW(), tr.Elem2->OrderW()) + 2*el.GetOrder() :
+          tr.Elem1->OrderW() + 2*el.GetOrder();
+}
+
+void DGTraceIntegrator::SetupPA(const FiniteElementSpace &fes, FaceType type)
+{
+   const FaceRestriction *restr =
+      static_cast<const FaceRestriction*>(fes.GetFaceRestriction(type));
+   Mesh *mesh = fes.GetMesh();
+   dim = mesh->Dimension();
+   nf = restr->GetNFaces();
+   nsides = (type == FaceType::Interior) ? 2 : 1;
+   if (nf == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const TensorBasisElement *tel =
+      dynamic_cast<const TensorBasisElement*>(&el);
+   MFEM_VERIFY(tel, "tensor-product elements are required");
+   FaceElementTransformations *tr = restr->GetFaceTransformations(0);
+   // The same rule is used on all faces, see the check below
+   const IntegrationRule *ir = IntRule;
+   const int order = DGTraceFaceOrder(*tr, el, nsides);
+   if (ir == NULL)
+   {
+      ir = &IntRules.Get(tr->FaceGeom, order);
+   }
+   MFEM_VERIFY(ir->IsTensorProduct(dim-1),
+               "the face integration rule is not a tensor product rule");
+   const int nq = ir->GetNPoints();
+   dofs1D = el.GetOrder() + 1;
+   quad1D = (dim == 2) ? nq : (int)floor(sqrt((double)nq) + 0.5);
+   MFEM_VERIFY(quad1D <= MAX_Q1D, "");
+
+   // The face rule is a tensor product, its first quad1D points give the 1D
+   // rule.
+   const Poly_1D::Basis &basis1d = tel->GetBasis1D();
+   B.SetSize(quad1D*dofs1D, Device::GetMemoryType());
+   Bt.SetSize(dofs1D*quad1D, Device::GetMemoryType());
+   auto h_B = Reshape(B.HostWrite(), quad1D, dofs1D);
+   auto h_Bt = Reshape(Bt.HostWrite(), dofs1D, quad1D);
+   Vector shape1d(dofs1D);
+   for (int q = 0; q < quad1D; q++)
+   {
+      basis1d.Eval(ir->IntPoint(q).x, shape1d);
+      for (int d = 0; d < dofs1D; d++)
+      {
+         h_B(q,d) = h_Bt(d,q) = shape1d(d);
+      }
+   }
+
+   pa_data.SetSize(nq*2*nf, Device::GetMemoryType());
+   auto op = Reshape(pa_data.HostWrite(), nq, 2, nf);
+   Vector vu(dim), nor(dim);
+   for (int f = 0; f < nf; f++)
+   {
+      tr = restr->GetFaceTransformations(f);
+      MFEM_VERIFY(IntRule || DGTraceFaceOrder(*tr, el, nsides) == order,
+                  "the default quadrature order differs between faces, use "
+                  "SetIntRule()");
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(q);
+         IntegrationPoint eip1, eip2;
+         tr->Loc1.Transform(ip, eip1);
+         if (nsides == 2)
+         {
+            tr->Loc2.Transform(ip, eip2);
+         }
+         tr->Face->SetIntPoint(&ip);
+         tr->Elem1->SetIntPoint(&eip1);
+
+         u->Eval(vu, *tr->Elem1, eip1);
+         CalcOrtho(tr->Face->Jacobian(), nor);
+
+         const double un = vu * nor;
+         double a = 0.5 * alpha * un;
+         double b = beta * fabs(un);
+         if (rho)
+         {
+            double rho_p;
+            if (un >= 0.0 && nsides == 2)
+            {
+               tr->Elem2->SetIntPoint(&eip2);
+               rho_p = rho->Eval(*tr->Elem2, eip2);
+            }
+            else
+            {
+               rho_p = rho->Eval(*tr->Elem1, eip1);
+            }
+            a *= rho_p;
+            b *= rho_p;
+         }
+         op(q,0,f) = ip.weight * (a+b);
+         op(q,1,f) = ip.weight * (b-a);
+      }
+   }
+}
+
+void DGTraceIntegrator::AssemblePAInteriorFaces(const FiniteElementSpace &fes)
+{
+   SetupPA(fes, FaceType::Interior);
+}
+
+void DGTraceIntegrator::AssemblePABoundaryFaces(const FiniteElementSpace &fes)
+{
+   SetupPA(fes, FaceType::Boundary);
+}
+
+// PA DG Trace Apply 2D kernel: the faces are segments
+template<int T_D1D = 0, int T_Q1D = 0> static
+void PADGTraceApply2D(const int NF,
+                      const int NS,
+                      const Array<double> &b,
+                      const Array<double> &bt,
+                      const Vector &_op,
+                      const Vector &_x,
+                      Vector &_y,
+                      const bool transpose,
+                      const int d1d = 0,
+                      const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto op = Reshape(_op.Read(), Q1D, 2, NF);
+   auto x = Reshape(_x.Read(), D1D, NS, NF);
+   auto y = Reshape(_y.ReadWrite(), D1D, NS, NF);
+   MFEM_FORALL(f, NF,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      double u[2][max_Q1D] = {{0.0}};
+      for (int s = 0; s < NS; s++)
+      {
+         for (int q = 0; q < Q1D; ++q)
+         {
+            double val = 0.0;
+            for (int d = 0; d < D1D; ++d)
+            {
+               val += B(q,d) * x(d,s,f);
+            }
+            u[s][q] = val;
+         }
+      }
+      // the flux at the quadrature points, see AssembleFaceMatrix()
+      for (int q = 0; q < Q1D; ++q)
+      {
+         const double op0 = op(q,0,f), op1 = op(q,1,f);
+         if (NS == 1)
+         {
+            u[0][q] *= op0;
+         }
+         else if (!transpose)
+         {
+            const double r = op0 * u[0][q] - op1 * u[1][q];
+            u[0][q] = r;
+            u[1][q] = -r;
+         }
+         else
+         {
+            const double jump = u[0][q] - u[1][q];
+            u[0][q] = op0 * jump;
+            u[1][q] = -op1 * jump;
+         }
+      }
+      for (int s = 0; s < NS; s++)
+      {
+         for (int d = 0; d < D1D; ++d)
+         {
+            double val = 0.0;
+            for (int q = 0; q < Q1D; ++q)
+            {
+               val += Bt(d,q) * u[s][q];
+            }
+            y(d,s,f) += val;
+         }
+      }
+   });
+}
+
+// PA DG Trace Apply 3D kernel: the faces are squares
+template<int T_D1D = 0, int T_Q1D = 0> static
+void PADGTraceApply3D(const int NF,
+                      const int NS,
+                      const Array<double> &b,
+                      const Array<double> &bt,
+                      const Vector &_op,
+                      const Vector &_x,
+                      Vector &_y,
+                      const bool transpose,
+                      const int d1d = 0,
+                      const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 2, NF);
+   auto x = Reshape(_x.Read(), D1D, D1D, NS, NF);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NS, NF);
+   MFEM_FORALL(f, NF,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      double u[2][max_Q1D][max_Q1D] = {{{0.0}}};
+      for (int s = 0; s < NS; s++)
+      {
+         double uX[max_D1D][max_Q1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               double val = 0.0;
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  val += B(qx,dx) * x(dx,dy,s,f);
+               }
+               uX[dy][qx] = val;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               double val = 0.0;
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  val += B(qy,dy) * uX[dy][qx];
+               }
+               u[s][qy][qx] = val;
+            }
+         }
+      }
+      // the flux at the quadrature points, see AssembleFaceMatrix()
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double op0 = op(qx,qy,0,f), op1 = op(qx,qy,1,f);
+            if (NS == 1)
+            {
+               u[0][qy][qx] *= op0;
+            }
+            else if (!transpose)
+            {
+               const double r = op0 * u[0][qy][qx] - op1 * u[1][qy][qx];
+               u[0][qy][qx] = r;
+               u[1][qy][qx] = -r;
+            }
+            else
+            {
+               const double jump = u[0][qy][qx] - u[1][qy][qx];
+               u[0][qy][qx] = op0 * jump;
+               u[1][qy][qx] = -op1 * jump;
+            }
+         }
+      }
+      for (int s = 0; s < NS; s++)
+      {
+         double uX[max_Q1D][max_D1D];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double val = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  val += Bt(dx,qx) * u[s][qy][qx];
+               }
+               uX[qy][dx] = val;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double val = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  val += Bt(dy,qy) * uX[qy][dx];
+               }
+               y(dx,dy,s,f) += val;
+            }
+         }
+      }
+   });
+}
+
+static void PADGTraceApply(const int dim,
+                           const int D1D,
+                           const int Q1D,
+                           const int NF,
+                           const int NS,
+                           const Array<double> &B,
+                           const Array<double> &Bt,
+                           const Vector &op,
+                           const Vector &x,
+                           Vector &y,
+                           const bool transpose)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22: return PADGTraceApply2D<2,2>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x33: return PADGTraceApply2D<3,3>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x44: return PADGTraceApply2D<4,4>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x55: return PADGTraceApply2D<5,5>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x66: return PADGTraceApply2D<6,6>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x77: return PADGTraceApply2D<7,7>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x88: return PADGTraceApply2D<8,8>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x99: return PADGTraceApply2D<9,9>(NF,NS,B,Bt,op,x,y,transpose);
+         default:   return PADGTraceApply2D(NF,NS,B,Bt,op,x,y,transpose,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23: return PADGTraceApply3D<2,3>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x34: return PADGTraceApply3D<3,4>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x45: return PADGTraceApply3D<4,5>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x56: return PADGTraceApply3D<5,6>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x67: return PADGTraceApply3D<6,7>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x78: return PADGTraceApply3D<7,8>(NF,NS,B,Bt,op,x,y,transpose);
+         case 0x89: return PADGTraceApply3D<8,9>(NF,NS,B,Bt,op,x,y,transpose);
+         default:   return PADGTraceApply3D(NF,NS,B,Bt,op,x,y,transpose,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA DG Trace Apply kernel
+void DGTraceIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (nf == 0) { return; }
+   PADGTraceApply(dim, dofs1D, quad1D, nf, nsides, B, Bt, pa_data, x, y,
+                  false);
+}
+
+// PA DG Trace Apply Transpose kernel
+void DGTraceIntegrator::AddMultTransposePA(const Vector &x, Vector &y) const
+{
+   if (nf == 0) { return; }
+   PADGTraceApply(dim, dofs1D, quad1D, nf, nsides, B, Bt, pa_data, x, y,
+                  true);
+}
+
+} // namespace mfem
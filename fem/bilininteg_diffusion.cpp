@@ -75,17 +75,32 @@ static void OccaPADiffusionSetup3D(const int D1D,
 }
 #endif // MFEM_USE_OCCA
 
+// Layout of the coefficient Q-vector of the PA diffusion setup kernels: a
+// constant (size 1), a scalar (NQ x NE) or a symmetric matrix (NQ x DIM x DIM x
+// NE).
+enum PADiffusionCoeffLayout
+{
+   PA_DIFFUSION_CONST_COEFF,
+   PA_DIFFUSION_SCALAR_COEFF,
+   PA_DIFFUSION_MATRIX_COEFF
+};
+
 // PA Diffusion Assemble 2D kernel
 static void PADiffusionSetup2D(const int Q1D,
                                const int NE,
                                const Array<double> &w,
                                const Vector &j,
-                               const double COEFF,
+                               const Vector &c,
+                               const PADiffusionCoeffLayout layout,
                                Vector &op)
 {
    const int NQ = Q1D*Q1D;
+   const bool const_c = layout == PA_DIFFUSION_CONST_COEFF;
+   const bool matrix_c = layout == PA_DIFFUSION_MATRIX_COEFF;
+   const int MD = matrix_c ? 2 : 1;
    auto W = w.Read();
-
+   auto C = const_c ? Reshape(c.Read(), 1, 1, 1, 1) :
+            Reshape(c.Read(), NQ, MD, MD, NE);
    auto J = Reshape(j.Read(), NQ, 2, 2, NE);
    auto y = Reshape(op.Write(), NQ, 3, NE);
 
@@ -97,10 +112,30 @@ static void PADiffusionSetup2D(const int Q1D,
          const double J21 = J(q,1,0,e);
          const double J12 = J(q,0,1,e);
          const double J22 = J(q,1,1,e);
-         const double c_detJ = W[q] * COEFF / ((J11*J22)-(J21*J12));
-         y(q,0,e) =  c_detJ * (J12*J12 + J22*J22); // 1,1
-         y(q,1,e) = -c_detJ * (J12*J11 + J22*J21); // 1,2
-         y(q,2,e) =  c_detJ * (J11*J11 + J21*J21); // 2,2
+         const double w_detJ = W[q] / ((J11*J22)-(J21*J12));
+         if (matrix_c)
+         {
+            // w/detJ adj(J) M adj(J)^T
+            const double A[2][2] = {{ J22, -J12}, {-J21, J11}};
+            double AM[2][2];
+            for (int i = 0; i < 2; i++)
+            {
+               for (int l = 0; l < 2; l++)
+               {
+                  AM[i][l] = A[i][0]*C(q,0,l,e) + A[i][1]*C(q,1,l,e);
+               }
+            }
+            y(q,0,e) = w_detJ * (AM[0][0]*A[0][0] + AM[0][1]*A[0][1]); // 1,1
+            y(q,1,e) = w_detJ * (AM[0][0]*A[1][0] + AM[0][1]*A[1][1]); // 1,2
+            y(q,2,e) = w_detJ * (AM[1][0]*A[1][0] + AM[1][1]*A[1][1]); // 2,2
+         }
+         else
+         {
+            const double c_detJ = w_detJ * (const_c ? C(0,0,0,0) : C(q,0,0,e));
+            y(q,0,e) =  c_detJ * (J12*J12 + J22*J22); // 1,1
+            y(q,1,e) = -c_detJ * (J12*J11 + J22*J21); // 1,2
+            y(q,2,e) =  c_detJ * (J11*J11 + J21*J21); // 2,2
+         }
       }
    });
 }
@@ -110,11 +145,17 @@ static void PADiffusionSetup3D(const int Q1D,
                                const int NE,
                                const Array<double> &w,
                                const Vector &j,
-                               const double COEFF,
+                               const Vector &c,
+                               const PADiffusionCoeffLayout layout,
                                Vector &op)
 {
    const int NQ = Q1D*Q1D*Q1D;
+   const bool const_c = layout == PA_DIFFUSION_CONST_COEFF;
+   const bool matrix_c = layout == PA_DIFFUSION_MATRIX_COEFF;
+   const int MD = matrix_c ? 3 : 1;
    auto W = w.Read();
+   auto C = const_c ? Reshape(c.Read(), 1, 1, 1, 1) :
+            Reshape(c.Read(), NQ, MD, MD, NE);
    auto J = Reshape(j.Read(), NQ, 3, 3, NE);
    auto y = Reshape(op.Write(), NQ, 6, NE);
    MFEM_FORALL(e, NE,
@@ -133,7 +174,7 @@ static void PADiffusionSetup3D(const int Q1D,
          const double detJ = J11 * (J22 * J33 - J32 * J23) -
          /* */               J21 * (J12 * J33 - J32 * J13) +
          /* */               J31 * (J12 * J23 - J22 * J13);
-         const double c_detJ = W[q] * COEFF / detJ;
+         const double w_detJ = W[q] / detJ;
          // adj(J)
          const double A11 = (J22 * J33) - (J23 * J32);
          const double A12 = (J32 * J13) - (J12 * J33);
@@ -144,13 +185,41 @@ static void PADiffusionSetup3D(const int Q1D,
          const double A31 = (J21 * J32) - (J31 * J22);
          const double A32 = (J31 * J12) - (J11 * J32);
          const double A33 = (J11 * J22) - (J12 * J21);
-         // detJ J^{-1} J^{-T} = (1/detJ) adj(J) adj(J)^T
-         y(q,0,e) = c_detJ * (A11*A11 + A12*A12 + A13*A13); // 1,1
-         y(q,1,e) = c_detJ * (A11*A21 + A12*A22 + A13*A23); // 2,1
-         y(q,2,e) = c_detJ * (A11*A31 + A12*A32 + A13*A33); // 3,1
-         y(q,3,e) = c_detJ * (A21*A21 + A22*A22 + A23*A23); // 2,2
-         y(q,4,e) = c_detJ * (A21*A31 + A22*A32 + A23*A33); // 3,2
-         y(q,5,e) = c_detJ * (A31*A31 + A32*A32 + A33*A33); // 3,3
+         if (matrix_c)
+         {
+            // w/detJ adj(J) M adj(J)^T
+            const double A[3][3] = {{A11, A12, A13},
+               {A21, A22, A23},
+               {A31, A32, A33}
+            };
+            double AM[3][3];
+            for (int i = 0; i < 3; i++)
+            {
+               for (int l = 0; l < 3; l++)
+               {
+                  AM[i][l] = A[i][0]*C(q,0,l,e) + A[i][1]*C(q,1,l,e) +
+                             A[i][2]*C(q,2,l,e);
+               }
+            }
+            const int sym[6][2] = {{0,0}, {1,0}, {2,0}, {1,1}, {2,1}, {2,2}};
+            for (int s = 0; s < 6; s++)
+            {
+               const int i = sym[s][0], k = sym[s][1];
+               y(q,s,e) = w_detJ * (AM[i][0]*A[k][0] + AM[i][1]*A[k][1] +
+                                    AM[i][2]*A[k][2]);
+            }
+         }
+         else
+         {
+            const double c_detJ = w_detJ * (const_c ? C(0,0,0,0) : C(q,0,0,e));
+            // detJ J^{-1} J^{-T} = (1/detJ) adj(J) adj(J)^T
+            y(q,0,e) = c_detJ * (A11*A11 + A12*A12 + A13*A13); // 1,1
+            y(q,1,e) = c_detJ * (A11*A21 + A12*A22 + A13*A23); // 2,1
+            y(q,2,e) = c_detJ * (A11*A31 + A12*A32 + A13*A33); // 3,1
+            y(q,3,e) = c_detJ * (A21*A21 + A22*A22 + A23*A23); // 2,2
+            y(q,4,e) = c_detJ * (A21*A31 + A22*A32 + A23*A33); // 3,2
+            y(q,5,e) = c_detJ * (A31*A31 + A32*A32 + A33*A33); // 3,3
+         }
       }
    });
 }
@@ -161,31 +230,32 @@ static void PADiffusionSetup(const int dim,
                              const int NE,
                              const Array<double> &W,
                              const Vector &J,
-                             const double COEFF,
+                             const Vector &C,
+                             const PADiffusionCoeffLayout layout,
                              Vector &op)
 {
    if (dim == 1) { MFEM_ABORT("dim==1 not supported in PADiffusionSetup"); }
    if (dim == 2)
    {
 #ifdef MFEM_USE_OCCA
-      if (DeviceCanUseOcca())
+      if (DeviceCanUseOcca() && layout == PA_DIFFUSION_CONST_COEFF)
       {
-         OccaPADiffusionSetup2D(D1D, Q1D, NE, W, J, COEFF, op);
+         OccaPADiffusionSetup2D(D1D, Q1D, NE, W, J, C.HostRead()[0], op);
          return;
       }
 #endif // MFEM_USE_OCCA
-      PADiffusionSetup2D(Q1D, NE, W, J, COEFF, op);
+      PADiffusionSetup2D(Q1D, NE, W, J, C, layout, op);
    }
    if (dim == 3)
    {
 #ifdef MFEM_USE_OCCA
-      if (DeviceCanUseOcca())
+      if (DeviceCanUseOcca() && layout == PA_DIFFUSION_CONST_COEFF)
       {
-         OccaPADiffusionSetup3D(D1D, Q1D, NE, W, J, COEFF, op);
+         OccaPADiffusionSetup3D(D1D, Q1D, NE, W, J, C.HostRead()[0], op);
          return;
       }
 #endif // MFEM_USE_OCCA
-      PADiffusionSetup3D(Q1D, NE, W, J, COEFF, op);
+      PADiffusionSetup3D(Q1D, NE, W, J, C, layout, op);
    }
 }
 
@@ -205,11 +275,42 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
    dofs1D = maps->ndof;
    quad1D = maps->nqpt;
    pa_data.SetSize(symmDims * nq * ne, Device::GetMemoryType());
-   ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
-   MFEM_VERIFY(cQ != NULL, "only ConstantCoefficient is supported!");
-   const double coeff = cQ->constant;
+   Vector coeff;
+   PADiffusionCoeffLayout layout;
+   if (MQ)
+   {
+      MFEM_VERIFY(MQ->GetHeight() == dim && MQ->GetWidth() == dim,
+                  "invalid MatrixCoefficient size");
+      EvalCoefficientQVector(*MQ, *mesh, *ir, coeff);
+      // The PA data stores only the symmetric part of the operator
+      auto C = Reshape(coeff.HostRead(), nq, dim, dim, ne);
+      for (int e = 0; e < ne; e++)
+      {
+         for (int q = 0; q < nq; q++)
+         {
+            for (int i = 0; i < dim; i++)
+            {
+               for (int j = 0; j < i; j++)
+               {
+                  const double c_ij = C(q,i,j,e), c_ji = C(q,j,i,e);
+                  MFEM_VERIFY(std::abs(c_ij - c_ji) <=
+                              1e-12*(std::abs(c_ij) + std::abs(c_ji)),
+                              "partial assembly requires a symmetric "
+                              "MatrixCoefficient");
+               }
+            }
+         }
+      }
+      layout = PA_DIFFUSION_MATRIX_COEFF;
+   }
+   else
+   {
+      EvalCoefficientQVector(Q, *mesh, *ir, coeff);
+      layout = (coeff.Size() == 1) ? PA_DIFFUSION_CONST_COEFF :
+               PA_DIFFUSION_SCALAR_COEFF;
+   }
    PADiffusionSetup(dim, dofs1D, quad1D, ne, ir->GetWeights(), geom->J,
-                    coeff, pa_data);
+                    coeff, layout, pa_data);
 }
 
 #ifdef MFEM_USE_OCCA
@@ -315,6 +416,7 @@ static void OccaPADiffusionApply3D(const int D1D,
 // PA Diffusion Apply 2D kernel
 template<int T_D1D = 0, int T_Q1D = 0> static
 void PADiffusionApply2D(const int NE,
+                        const Array<int> *E,
                         const Array<double> &b,
                         const Array<double> &g,
                         const Array<double> &bt,
@@ -336,8 +438,11 @@ void PADiffusionApply2D(const int NE,
    auto op = Reshape(_op.Read(), Q1D*Q1D, 3, NE);
    auto x = Reshape(_x.Read(), D1D, D1D, NE);
    auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
-   MFEM_FORALL(e, NE,
+   const int NS = E ? E->Size() : NE;
+   const int *ids = E ? E->Read() : NULL;
+   MFEM_FORALL(i, NS,
    {
+      const int e = ids ? ids[i] : i;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       // the following variables are evaluated at compile time
@@ -437,6 +542,7 @@ template<const int T_D1D = 0,
          const int T_Q1D = 0,
          const int T_NBZ = 0>
 static void SmemPADiffusionApply2D(const int NE,
+                                   const Array<int> *E,
                                    const Array<double> &_b,
                                    const Array<double> &_g,
                                    const Array<double> &_bt,
@@ -459,8 +565,11 @@ static void SmemPADiffusionApply2D(const int NE,
    auto op = Reshape(_op.Read(), Q1D*Q1D, 3, NE);
    auto x = Reshape(_x.Read(), D1D, D1D, NE);
    auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
-   MFEM_FORALL_2D(e, NE, Q1D, Q1D, NBZ,
+   const int NS = E ? E->Size() : NE;
+   const int *ids = E ? E->Read() : NULL;
+   MFEM_FORALL_2D(i, NS, Q1D, Q1D, NBZ,
    {
+      const int e = ids ? ids[i] : i;
       const int tidz = MFEM_THREAD_ID(z);
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -597,6 +706,7 @@ static void SmemPADiffusionApply2D(const int NE,
 template<const int T_D1D = 0,
          const int T_Q1D = 0> static
 void PADiffusionApply3D(const int NE,
+                        const Array<int> *E,
                         const Array<double> &b,
                         const Array<double> &g,
                         const Array<double> &bt,
@@ -617,8 +727,11 @@ void PADiffusionApply3D(const int NE,
    auto op = Reshape(_op.Read(), Q1D*Q1D*Q1D, 6, NE);
    auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
    auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
-   MFEM_FORALL(e, NE,
+   const int NS = E ? E->Size() : NE;
+   const int *ids = E ? E->Read() : NULL;
+   MFEM_FORALL(i, NS,
    {
+      const int e = ids ? ids[i] : i;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
@@ -787,6 +900,7 @@ void PADiffusionApply3D(const int NE,
 template<const int T_D1D = 0,
          const int T_Q1D = 0>
 static void SmemPADiffusionApply3D(const int NE,
+                                   const Array<int> *E,
                                    const Array<double> &_b,
                                    const Array<double> &_g,
                                    const Array<double> &_bt,
@@ -808,8 +922,11 @@ static void SmemPADiffusionApply3D(const int NE,
    auto op = Reshape(_op.Read(), Q1D*Q1D*Q1D, 6, NE);
    auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
    auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
-   MFEM_FORALL_3D(e, NE, Q1D, Q1D, Q1D,
+   const int NS = E ? E->Size() : NE;
+   const int *ids = E ? E->Read() : NULL;
+   MFEM_FORALL_3D(i, NS, Q1D, Q1D, Q1D,
    {
+      const int e = ids ? ids[i] : i;
       const int tidz = MFEM_THREAD_ID(z);
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -1029,6 +1146,7 @@ static void PADiffusionApply(const int dim,
                              const int D1D,
                              const int Q1D,
                              const int NE,
+                             const Array<int> *E,
                              const Array<double> &B,
                              const Array<double> &G,
                              const Array<double> &Bt,
@@ -1038,7 +1156,8 @@ static void PADiffusionApply(const int dim,
                              Vector &y)
 {
 #ifdef MFEM_USE_OCCA
-   if (DeviceCanUseOcca())
+   // The OCCA kernels do not support subsets of the elements
+   if (DeviceCanUseOcca() && !E)
    {
       if (dim == 2)
       {
@@ -1060,29 +1179,29 @@ static void PADiffusionApply(const int dim,
       {
          switch ((D1D << 4 ) | Q1D)
          {
-            case 0x22: return PADiffusionApply2D<2,2>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x33: return PADiffusionApply2D<3,3>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x44: return PADiffusionApply2D<4,4>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x55: return PADiffusionApply2D<5,5>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x66: return PADiffusionApply2D<6,6>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x77: return PADiffusionApply2D<7,7>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x88: return PADiffusionApply2D<8,8>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x99: return PADiffusionApply2D<9,9>(NE,B,G,Bt,Gt,op,x,y);
-            default:   return PADiffusionApply2D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D);
+            case 0x22: return PADiffusionApply2D<2,2>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x33: return PADiffusionApply2D<3,3>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x44: return PADiffusionApply2D<4,4>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x55: return PADiffusionApply2D<5,5>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x66: return PADiffusionApply2D<6,6>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x77: return PADiffusionApply2D<7,7>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x88: return PADiffusionApply2D<8,8>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x99: return PADiffusionApply2D<9,9>(NE,E,B,G,Bt,Gt,op,x,y);
+            default:   return PADiffusionApply2D(NE,E,B,G,Bt,Gt,op,x,y,D1D,Q1D);
          }
       }
       if (dim == 3)
       {
          switch ((D1D << 4 ) | Q1D)
          {
-            case 0x23: return PADiffusionApply3D<2,3>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x34: return PADiffusionApply3D<3,4>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x45: return PADiffusionApply3D<4,5>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x56: return PADiffusionApply3D<5,6>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x67: return PADiffusionApply3D<6,7>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x78: return PADiffusionApply3D<7,8>(NE,B,G,Bt,Gt,op,x,y);
-            case 0x89: return PADiffusionApply3D<8,9>(NE,B,G,Bt,Gt,op,x,y);
-            default:   return PADiffusionApply3D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D);
+            case 0x23: return PADiffusionApply3D<2,3>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x34: return PADiffusionApply3D<3,4>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x45: return PADiffusionApply3D<4,5>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x56: return PADiffusionApply3D<5,6>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x67: return PADiffusionApply3D<6,7>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x78: return PADiffusionApply3D<7,8>(NE,E,B,G,Bt,Gt,op,x,y);
+            case 0x89: return PADiffusionApply3D<8,9>(NE,E,B,G,Bt,Gt,op,x,y);
+            default:   return PADiffusionApply3D(NE,E,B,G,Bt,Gt,op,x,y,D1D,Q1D);
          }
       }
    }
@@ -1090,29 +1209,29 @@ static void PADiffusionApply(const int dim,
    {
       switch ((D1D << 4 ) | Q1D)
       {
-         case 0x22: return SmemPADiffusionApply2D<2,2,16>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x33: return SmemPADiffusionApply2D<3,3,16>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x44: return SmemPADiffusionApply2D<4,4,8>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x55: return SmemPADiffusionApply2D<5,5,8>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x66: return SmemPADiffusionApply2D<6,6,4>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x77: return SmemPADiffusionApply2D<7,7,4>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x88: return SmemPADiffusionApply2D<8,8,2>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x99: return SmemPADiffusionApply2D<9,9,2>(NE,B,G,Bt,Gt,op,x,y);
-         default:   return PADiffusionApply2D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D);
+         case 0x22: return SmemPADiffusionApply2D<2,2,16>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x33: return SmemPADiffusionApply2D<3,3,16>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x44: return SmemPADiffusionApply2D<4,4,8>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x55: return SmemPADiffusionApply2D<5,5,8>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x66: return SmemPADiffusionApply2D<6,6,4>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x77: return SmemPADiffusionApply2D<7,7,4>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x88: return SmemPADiffusionApply2D<8,8,2>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x99: return SmemPADiffusionApply2D<9,9,2>(NE,E,B,G,Bt,Gt,op,x,y);
+         default:   return PADiffusionApply2D(NE,E,B,G,Bt,Gt,op,x,y,D1D,Q1D);
       }
    }
    else if (dim == 3)
    {
       switch ((D1D << 4 ) | Q1D)
       {
-         case 0x23: return SmemPADiffusionApply3D<2,3>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x34: return SmemPADiffusionApply3D<3,4>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x45: return SmemPADiffusionApply3D<4,5>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x56: return SmemPADiffusionApply3D<5,6>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x67: return SmemPADiffusionApply3D<6,7>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x78: return SmemPADiffusionApply3D<7,8>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x89: return SmemPADiffusionApply3D<8,9>(NE,B,G,Bt,Gt,op,x,y);
-         default:   return PADiffusionApply3D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D);
+         case 0x23: return SmemPADiffusionApply3D<2,3>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x34: return SmemPADiffusionApply3D<3,4>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x45: return SmemPADiffusionApply3D<4,5>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x56: return SmemPADiffusionApply3D<5,6>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x67: return SmemPADiffusionApply3D<6,7>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x78: return SmemPADiffusionApply3D<7,8>(NE,E,B,G,Bt,Gt,op,x,y);
+         case 0x89: return SmemPADiffusionApply3D<8,9>(NE,E,B,G,Bt,Gt,op,x,y);
+         default:   return PADiffusionApply3D(NE,E,B,G,Bt,Gt,op,x,y,D1D,Q1D);
       }
    }
    MFEM_ABORT("Unknown kernel.");
@@ -1121,9 +1240,1024 @@ static void PADiffusionApply(const int dim,
 // PA Diffusion Apply kernel
 void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
 {
-   PADiffusionApply(dim, dofs1D, quad1D, ne,
+   PADiffusionApply(dim, dofs1D, quad1D, ne, NULL,
+                    maps->B, maps->G, maps->Bt, maps->Gt,
+                    pa_data, x, y);
+}
+
+void DiffusionIntegrator::AddMultPAElements(const Vector &x, Vector &y,
+                                            const Array<int> &elems) const
+{
+   PADiffusionApply(dim, dofs1D, quad1D, ne, &elems,
                     maps->B, maps->G, maps->Bt, maps->Gt,
                     pa_data, x, y);
 }
 
+// PA Diffusion Diagonal 2D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void PADiffusionAssembleDiagonal2D(const int NE,
+                                          const Array<double> &b,
+                                          const Array<double> &g,
+                                          const Vector &_op,
+                                          Vector &_diag,
+                                          const int d1d = 0,
+                                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 3, NE);
+   auto Y = Reshape(_diag.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // contract the y quadrature points with the three (symmetric)
+      // components of the quadrature point matrices
+      double QD0[max_Q1D][max_D1D];
+      double QD1[max_Q1D][max_D1D];
+      double QD2[max_Q1D][max_D1D];
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            QD0[qx][dy] = 0.0;
+            QD1[qx][dy] = 0.0;
+            QD2[qx][dy] = 0.0;
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double By = B(qy,dy), Gy = G(qy,dy);
+               QD0[qx][dy] += By * By * op(qx,qy,0,e);
+               QD1[qx][dy] += By * Gy * op(qx,qy,1,e);
+               QD2[qx][dy] += Gy * Gy * op(qx,qy,2,e);
+            }
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            double val = 0.0;
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double Bx = B(qx,dx), Gx = G(qx,dx);
+               val += Gx * Gx * QD0[qx][dy];
+               val += 2.0 * Gx * Bx * QD1[qx][dy];
+               val += Bx * Bx * QD2[qx][dy];
+            }
+            Y(dx,dy,e) += val;
+         }
+      }
+   });
+}
+
+// PA Diffusion Diagonal 3D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void PADiffusionAssembleDiagonal3D(const int NE,
+                                          const Array<double> &b,
+                                          const Array<double> &g,
+                                          const Vector &_op,
+                                          Vector &_diag,
+                                          const int d1d = 0,
+                                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto Y = Reshape(_diag.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // symmetric storage of the 3x3 quadrature point matrices
+      const int sym[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+      double QQD[max_Q1D][max_Q1D][max_D1D];
+      double QDD[max_Q1D][max_D1D][max_D1D];
+      // (a,c): directions of the test and trial derivatives; the terms with
+      // a != c appear twice in the sum
+      for (int a = 0; a < 3; ++a)
+      {
+         for (int c = a; c < 3; ++c)
+         {
+            const double mult = (a == c) ? 1.0 : 2.0;
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int dz = 0; dz < D1D; ++dz)
+                  {
+                     double u = 0.0;
+                     for (int qz = 0; qz < Q1D; ++qz)
+                     {
+                        const double Bz = B(qz,dz), Gz = G(qz,dz);
+                        const double wz = ((a == 2) ? Gz : Bz) *
+                                          ((c == 2) ? Gz : Bz);
+                        u += wz * op(qx,qy,qz,sym[a][c],e);
+                     }
+                     QQD[qx][qy][dz] = u;
+                  }
+               }
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int dz = 0; dz < D1D; ++dz)
+               {
+                  for (int dy = 0; dy < D1D; ++dy)
+                  {
+                     double u = 0.0;
+                     for (int qy = 0; qy < Q1D; ++qy)
+                     {
+                        const double By = B(qy,dy), Gy = G(qy,dy);
+                        const double wy = ((a == 1) ? Gy : By) *
+                                          ((c == 1) ? Gy : By);
+                        u += wy * QQD[qx][qy][dz];
+                     }
+                     QDD[qx][dy][dz] = u;
+                  }
+               }
+            }
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     double val = 0.0;
+                     for (int qx = 0; qx < Q1D; ++qx)
+                     {
+                        const double Bx = B(qx,dx), Gx = G(qx,dx);
+                        const double wx = ((a == 0) ? Gx : Bx) *
+                                          ((c == 0) ? Gx : Bx);
+                        val += wx * QDD[qx][dy][dz];
+                     }
+                     Y(dx,dy,dz,e) += mult * val;
+                  }
+               }
+            }
+         }
+      }
+   });
+}
+
+static void PADiffusionAssembleDiagonal(const int dim,
+                                        const int D1D,
+                                        const int Q1D,
+                                        const int NE,
+                                        const Array<double> &B,
+                                        const Array<double> &G,
+                                        const Vector &op,
+                                        Vector &y)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22: return PADiffusionAssembleDiagonal2D<2,2>(NE,B,G,op,y);
+         case 0x33: return PADiffusionAssembleDiagonal2D<3,3>(NE,B,G,op,y);
+         case 0x44: return PADiffusionAssembleDiagonal2D<4,4>(NE,B,G,op,y);
+         case 0x55: return PADiffusionAssembleDiagonal2D<5,5>(NE,B,G,op,y);
+         case 0x66: return PADiffusionAssembleDiagonal2D<6,6>(NE,B,G,op,y);
+         default:
+            return PADiffusionAssembleDiagonal2D(NE,B,G,op,y,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23: return PADiffusionAssembleDiagonal3D<2,3>(NE,B,G,op,y);
+         case 0x34: return PADiffusionAssembleDiagonal3D<3,4>(NE,B,G,op,y);
+         case 0x45: return PADiffusionAssembleDiagonal3D<4,5>(NE,B,G,op,y);
+         case 0x56: return PADiffusionAssembleDiagonal3D<5,6>(NE,B,G,op,y);
+         default:
+            return PADiffusionAssembleDiagonal3D(NE,B,G,op,y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void DiffusionIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   PADiffusionAssembleDiagonal(dim, dofs1D, quad1D, ne, maps->B, maps->G,
+                               pa_data, diag);
+}
+
+// MF Diffusion Assemble: only the mesh nodes are stored, in an E-vector
+void DiffusionIntegrator::AssembleMF(const FiniteElementSpace &fes)
+{
+   // Assumes tensor-product elements
+   Mesh *mesh = fes.GetMesh();
+   ne = fes.GetNE();
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el);
+   dim = mesh->Dimension();
+   MFEM_VERIFY(dim == 2 || dim == 3, "dim = " << dim << " is not supported");
+   MFEM_VERIFY(mesh->SpaceDimension() == dim,
+               "surface meshes are not supported");
+   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   MFEM_VERIFY(MQ == NULL, "MatrixCoefficient is not supported!");
+   mf_coeff = 1.0;
+   if (Q)
+   {
+      ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
+      MFEM_VERIFY(cQ != NULL, "only ConstantCoefficient is supported!");
+      mf_coeff = cQ->constant;
+   }
+   mesh->EnsureNodes();
+   const GridFunction *nodes = mesh->GetNodes();
+   const FiniteElementSpace *nfes = nodes->FESpace();
+   const Operator *restr =
+      nfes->GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC);
+   MFEM_VERIFY(restr, "discontinuous mesh nodes are not supported");
+   mf_node_maps = &nfes->GetFE(0)->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   mf_nodes.SetSize(restr->Height(), Device::GetMemoryType());
+   restr->Mult(*nodes, mf_nodes);
+}
+
+// MF Diffusion Apply 2D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void MFDiffusionApply2D(const int NE,
+                               const Array<double> &b,
+                               const Array<double> &g,
+                               const Array<double> &bt,
+                               const Array<double> &gt,
+                               const Array<double> &nb,
+                               const Array<double> &ng,
+                               const Array<double> &w,
+                               const Vector &_X,
+                               const double COEFF,
+                               const Vector &_x,
+                               Vector &_y,
+                               const int nd1d,
+                               const int d1d = 0,
+                               const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int ND1D = nd1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(ND1D <= MAX_D1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt.Read(), D1D, Q1D);
+   auto NB = Reshape(nb.Read(), Q1D, ND1D);
+   auto NG = Reshape(ng.Read(), Q1D, ND1D);
+   auto W = Reshape(w.Read(), Q1D, Q1D);
+   auto X = Reshape(_X.Read(), ND1D, ND1D, 2, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // Jacobian of the element transformation at the quadrature points
+      double Jq[max_Q1D][max_Q1D][2][2];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            Jq[qy][qx][0][0] = Jq[qy][qx][0][1] = 0.0;
+            Jq[qy][qx][1][0] = Jq[qy][qx][1][1] = 0.0;
+         }
+      }
+      for (int c = 0; c < 2; ++c)
+      {
+         for (int ny = 0; ny < ND1D; ++ny)
+         {
+            double gradX[max_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] = 0.0;
+               gradX[qx][1] = 0.0;
+            }
+            for (int nx = 0; nx < ND1D; ++nx)
+            {
+               const double s = X(nx,ny,c,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] += s * NB(qx,nx);
+                  gradX[qx][1] += s * NG(qx,nx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = NB(qy,ny);
+               const double wDy = NG(qy,ny);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  Jq[qy][qx][c][0] += gradX[qx][1] * wy;
+                  Jq[qy][qx][c][1] += gradX[qx][0] * wDy;
+               }
+            }
+         }
+      }
+      double grad[max_Q1D][max_Q1D][2];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            grad[qy][qx][0] = 0.0;
+            grad[qy][qx][1] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double gradX[max_Q1D][2];
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            gradX[qx][0] = 0.0;
+            gradX[qx][1] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const double s = x(dx,dy,e);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] += s * B(qx,dx);
+               gradX[qx][1] += s * G(qx,dx);
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double wy  = B(qy,dy);
+            const double wDy = G(qy,dy);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qy][qx][0] += gradX[qx][1] * wy;
+               grad[qy][qx][1] += gradX[qx][0] * wDy;
+            }
+         }
+      }
+      // Compute the PA data of the quadrature point on the fly and apply it
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double J11 = Jq[qy][qx][0][0];
+            const double J21 = Jq[qy][qx][1][0];
+            const double J12 = Jq[qy][qx][0][1];
+            const double J22 = Jq[qy][qx][1][1];
+            const double c_detJ = W(qx,qy) * COEFF / ((J11*J22)-(J21*J12));
+            const double O11 =  c_detJ * (J12*J12 + J22*J22);
+            const double O12 = -c_detJ * (J12*J11 + J22*J21);
+            const double O22 =  c_detJ * (J11*J11 + J21*J21);
+
+            const double gradX = grad[qy][qx][0];
+            const double gradY = grad[qy][qx][1];
+
+            grad[qy][qx][0] = (O11 * gradX) + (O12 * gradY);
+            grad[qy][qx][1] = (O12 * gradX) + (O22 * gradY);
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double gradX[max_D1D][2];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            gradX[dx][0] = 0;
+            gradX[dx][1] = 0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double gX = grad[qy][qx][0];
+            const double gY = grad[qy][qx][1];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double wx  = Bt(dx,qx);
+               const double wDx = Gt(dx,qx);
+               gradX[dx][0] += gX * wDx;
+               gradX[dx][1] += gY * wx;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double wy  = Bt(dy,qy);
+            const double wDy = Gt(dy,qy);
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               y(dx,dy,e) += ((gradX[dx][0] * wy) + (gradX[dx][1] * wDy));
+            }
+         }
+      }
+   });
+}
+
+// MF Diffusion Apply 3D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void MFDiffusionApply3D(const int NE,
+                               const Array<double> &b,
+                               const Array<double> &g,
+                               const Array<double> &bt,
+                               const Array<double> &gt,
+                               const Array<double> &nb,
+                               const Array<double> &ng,
+                               const Array<double> &w,
+                               const Vector &_X,
+                               const double COEFF,
+                               const Vector &_x,
+                               Vector &_y,
+                               const int nd1d,
+                               const int d1d = 0,
+                               const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int ND1D = nd1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(ND1D <= MAX_D1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt.Read(), D1D, Q1D);
+   auto NB = Reshape(nb.Read(), Q1D, ND1D);
+   auto NG = Reshape(ng.Read(), Q1D, ND1D);
+   auto W = Reshape(w.Read(), Q1D, Q1D, Q1D);
+   auto X = Reshape(_X.Read(), ND1D, ND1D, ND1D, 3, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // Jacobian of the element transformation at the quadrature points
+      double Jq[max_Q1D][max_Q1D][max_Q1D][3][3];
+      for (int c = 0; c < 3; ++c)
+      {
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  Jq[qz][qy][qx][c][0] = 0.0;
+                  Jq[qz][qy][qx][c][1] = 0.0;
+                  Jq[qz][qy][qx][c][2] = 0.0;
+               }
+            }
+         }
+         for (int nz = 0; nz < ND1D; ++nz)
+         {
+            double gradXY[max_Q1D][max_Q1D][3];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradXY[qy][qx][0] = 0.0;
+                  gradXY[qy][qx][1] = 0.0;
+                  gradXY[qy][qx][2] = 0.0;
+               }
+            }
+            for (int ny = 0; ny < ND1D; ++ny)
+            {
+               double gradX[max_Q1D][2];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] = 0.0;
+                  gradX[qx][1] = 0.0;
+               }
+               for (int nx = 0; nx < ND1D; ++nx)
+               {
+                  const double s = X(nx,ny,nz,c,e);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     gradX[qx][0] += s * NB(qx,nx);
+                     gradX[qx][1] += s * NG(qx,nx);
+                  }
+               }
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy  = NB(qy,ny);
+                  const double wDy = NG(qy,ny);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     gradXY[qy][qx][0] += gradX[qx][1] * wy;
+                     gradXY[qy][qx][1] += gradX[qx][0] * wDy;
+                     gradXY[qy][qx][2] += gradX[qx][0] * wy;
+                  }
+               }
+            }
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               const double wz  = NB(qz,nz);
+               const double wDz = NG(qz,nz);
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     Jq[qz][qy][qx][c][0] += gradXY[qy][qx][0] * wz;
+                     Jq[qz][qy][qx][c][1] += gradXY[qy][qx][1] * wz;
+                     Jq[qz][qy][qx][c][2] += gradXY[qy][qx][2] * wDz;
+                  }
+               }
+            }
+         }
+      }
+      double grad[max_Q1D][max_Q1D][max_Q1D][3];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qz][qy][qx][0] = 0.0;
+               grad[qz][qy][qx][1] = 0.0;
+               grad[qz][qy][qx][2] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double gradXY[max_Q1D][max_Q1D][3];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradXY[qy][qx][0] = 0.0;
+               gradXY[qy][qx][1] = 0.0;
+               gradXY[qy][qx][2] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double gradX[max_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] = 0.0;
+               gradX[qx][1] = 0.0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double s = x(dx,dy,dz,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] += s * B(qx,dx);
+                  gradX[qx][1] += s * G(qx,dx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = B(qy,dy);
+               const double wDy = G(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const double wx  = gradX[qx][0];
+                  const double wDx = gradX[qx][1];
+                  gradXY[qy][qx][0] += wDx * wy;
+                  gradXY[qy][qx][1] += wx  * wDy;
+                  gradXY[qy][qx][2] += wx  * wy;
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz  = B(qz,dz);
+            const double wDz = G(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  grad[qz][qy][qx][0] += gradXY[qy][qx][0] * wz;
+                  grad[qz][qy][qx][1] += gradXY[qy][qx][1] * wz;
+                  grad[qz][qy][qx][2] += gradXY[qy][qx][2] * wDz;
+               }
+            }
+         }
+      }
+      // Compute the PA data of the quadrature point on the fly and apply it
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double (&J)[3][3] = Jq[qz][qy][qx];
+               const double J11 = J[0][0], J12 = J[0][1], J13 = J[0][2];
+               const double J21 = J[1][0], J22 = J[1][1], J23 = J[1][2];
+               const double J31 = J[2][0], J32 = J[2][1], J33 = J[2][2];
+               const double detJ = J11 * (J22 * J33 - J32 * J23) -
+               /* */               J21 * (J12 * J33 - J32 * J13) +
+               /* */               J31 * (J12 * J23 - J22 * J13);
+               const double c_detJ = W(qx,qy,qz) * COEFF / detJ;
+               // adj(J)
+               const double A11 = (J22 * J33) - (J23 * J32);
+               const double A12 = (J32 * J13) - (J12 * J33);
+               const double A13 = (J12 * J23) - (J22 * J13);
+               const double A21 = (J31 * J23) - (J21 * J33);
+               const double A22 = (J11 * J33) - (J13 * J31);
+               const double A23 = (J21 * J13) - (J11 * J23);
+               const double A31 = (J21 * J32) - (J31 * J22);
+               const double A32 = (J31 * J12) - (J11 * J32);
+               const double A33 = (J11 * J22) - (J12 * J21);
+               // detJ J^{-1} J^{-T} = (1/detJ) adj(J) adj(J)^T
+               const double O11 = c_detJ * (A11*A11 + A12*A12 + A13*A13);
+               const double O12 = c_detJ * (A11*A21 + A12*A22 + A13*A23);
+               const double O13 = c_detJ * (A11*A31 + A12*A32 + A13*A33);
+               const double O22 = c_detJ * (A21*A21 + A22*A22 + A23*A23);
+               const double O23 = c_detJ * (A21*A31 + A22*A32 + A23*A33);
+               const double O33 = c_detJ * (A31*A31 + A32*A32 + A33*A33);
+               const double gradX = grad[qz][qy][qx][0];
+               const double gradY = grad[qz][qy][qx][1];
+               const double gradZ = grad[qz][qy][qx][2];
+               grad[qz][qy][qx][0] = (O11*gradX)+(O12*gradY)+(O13*gradZ);
+               grad[qz][qy][qx][1] = (O12*gradX)+(O22*gradY)+(O23*gradZ);
+               grad[qz][qy][qx][2] = (O13*gradX)+(O23*gradY)+(O33*gradZ);
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double gradXY[max_D1D][max_D1D][3];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradXY[dy][dx][0] = 0;
+               gradXY[dy][dx][1] = 0;
+               gradXY[dy][dx][2] = 0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double gradX[max_D1D][3];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradX[dx][0] = 0;
+               gradX[dx][1] = 0;
+               gradX[dx][2] = 0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double gX = grad[qz][qy][qx][0];
+               const double gY = grad[qz][qy][qx][1];
+               const double gZ = grad[qz][qy][qx][2];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  const double wx  = Bt(dx,qx);
+                  const double wDx = Gt(dx,qx);
+                  gradX[dx][0] += gX * wDx;
+                  gradX[dx][1] += gY * wx;
+                  gradX[dx][2] += gZ * wx;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy  = Bt(dy,qy);
+               const double wDy = Gt(dy,qy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradXY[dy][dx][0] += gradX[dx][0] * wy;
+                  gradXY[dy][dx][1] += gradX[dx][1] * wDy;
+                  gradXY[dy][dx][2] += gradX[dx][2] * wy;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz  = Bt(dz,qz);
+            const double wDz = Gt(dz,qz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  y(dx,dy,dz,e) +=
+                     ((gradXY[dy][dx][0] * wz) +
+                      (gradXY[dy][dx][1] * wz) +
+                      (gradXY[dy][dx][2] * wDz));
+               }
+            }
+         }
+      }
+   });
+}
+
+static void MFDiffusionApply(const int dim,
+                             const int D1D,
+                             const int Q1D,
+                             const int ND1D,
+                             const int NE,
+                             const DofToQuad &maps,
+                             const DofToQuad &node_maps,
+                             const Vector &X,
+                             const double c,
+                             const Vector &x,
+                             Vector &y)
+{
+   const Array<double> &B = maps.B, &G = maps.G;
+   const Array<double> &Bt = maps.Bt, &Gt = maps.Gt;
+   const Array<double> &NB = node_maps.B, &NG = node_maps.G;
+   const Array<double> &W = maps.IntRule->GetWeights();
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22:
+            return MFDiffusionApply2D<2,2>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         case 0x33:
+            return MFDiffusionApply2D<3,3>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         case 0x44:
+            return MFDiffusionApply2D<4,4>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         case 0x55:
+            return MFDiffusionApply2D<5,5>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         default:
+            return MFDiffusionApply2D(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D,
+                                      D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23:
+            return MFDiffusionApply3D<2,3>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         case 0x34:
+            return MFDiffusionApply3D<3,4>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         case 0x45:
+            return MFDiffusionApply3D<4,5>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         case 0x56:
+            return MFDiffusionApply3D<5,6>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         case 0x67:
+            return MFDiffusionApply3D<6,7>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         case 0x78:
+            return MFDiffusionApply3D<7,8>(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D);
+         default:
+            return MFDiffusionApply3D(NE,B,G,Bt,Gt,NB,NG,W,X,c,x,y,ND1D,
+                                      D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// MF Diffusion Apply kernel
+void DiffusionIntegrator::AddMultMF(const Vector &x, Vector &y) const
+{
+   if (ne == 0) { return; }
+   MFDiffusionApply(dim, dofs1D, quad1D, mf_node_maps->ndof, ne,
+                    *maps, *mf_node_maps, mf_nodes, mf_coeff, x, y);
+}
+
+// EA Diffusion Assemble 2D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void EADiffusionAssemble2D(const int NE,
+                                  const Array<double> &b,
+                                  const Array<double> &g,
+                                  const Vector &_op,
+                                  Vector &_A,
+                                  const bool add,
+                                  const int d1d = 0,
+                                  const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 3, NE);
+   auto A = Reshape(add ? _A.ReadWrite() : _A.Write(),
+                    D1D, D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // symmetric storage of the 2x2 quadrature point matrices
+      const int sym[2][2] = {{0, 1}, {1, 2}};
+      double op_x[2][2][max_Q1D];
+      for (int i1 = 0; i1 < D1D; ++i1)
+      {
+         for (int j1 = 0; j1 < D1D; ++j1)
+         {
+            // (a,b): directions of the test and trial derivatives
+            for (int a = 0; a < 2; ++a)
+            {
+               for (int c = 0; c < 2; ++c)
+               {
+                  for (int k2 = 0; k2 < Q1D; ++k2)
+                  {
+                     double u = 0.0;
+                     for (int k1 = 0; k1 < Q1D; ++k1)
+                     {
+                        const double wi = (a == 0) ? G(k1,i1) : B(k1,i1);
+                        const double wj = (c == 0) ? G(k1,j1) : B(k1,j1);
+                        u += wi * wj * op(k1,k2,sym[a][c],e);
+                     }
+                     op_x[a][c][k2] = u;
+                  }
+               }
+            }
+            for (int i2 = 0; i2 < D1D; ++i2)
+            {
+               for (int j2 = 0; j2 < D1D; ++j2)
+               {
+                  double val = 0.0;
+                  for (int a = 0; a < 2; ++a)
+                  {
+                     for (int c = 0; c < 2; ++c)
+                     {
+                        for (int k2 = 0; k2 < Q1D; ++k2)
+                        {
+                           const double wi = (a == 1) ? G(k2,i2) : B(k2,i2);
+                           const double wj = (c == 1) ? G(k2,j2) : B(k2,j2);
+                           val += wi * wj * op_x[a][c][k2];
+                        }
+                     }
+                  }
+                  if (add) { A(i1,i2,j1,j2,e) += val; }
+                  else { A(i1,i2,j1,j2,e) = val; }
+               }
+            }
+         }
+      }
+   });
+}
+
+// EA Diffusion Assemble 3D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void EADiffusionAssemble3D(const int NE,
+                                  const Array<double> &b,
+                                  const Array<double> &g,
+                                  const Vector &_op,
+                                  Vector &_A,
+                                  const bool add,
+                                  const int d1d = 0,
+                                  const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto A = Reshape(add ? _A.ReadWrite() : _A.Write(),
+                    D1D, D1D, D1D, D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // symmetric storage of the 3x3 quadrature point matrices
+      const int sym[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+      double op_x[3][3][max_Q1D][max_Q1D];
+      double op_xy[3][3][max_Q1D];
+      for (int i1 = 0; i1 < D1D; ++i1)
+      {
+         for (int j1 = 0; j1 < D1D; ++j1)
+         {
+            // (a,b): directions of the test and trial derivatives
+            for (int a = 0; a < 3; ++a)
+            {
+               for (int c = 0; c < 3; ++c)
+               {
+                  for (int k3 = 0; k3 < Q1D; ++k3)
+                  {
+                     for (int k2 = 0; k2 < Q1D; ++k2)
+                     {
+                        double u = 0.0;
+                        for (int k1 = 0; k1 < Q1D; ++k1)
+                        {
+                           const double wi = (a == 0) ? G(k1,i1) : B(k1,i1);
+                           const double wj = (c == 0) ? G(k1,j1) : B(k1,j1);
+                           u += wi * wj * op(k1,k2,k3,sym[a][c],e);
+                        }
+                        op_x[a][c][k3][k2] = u;
+                     }
+                  }
+               }
+            }
+            for (int i2 = 0; i2 < D1D; ++i2)
+            {
+               for (int j2 = 0; j2 < D1D; ++j2)
+               {
+                  for (int a = 0; a < 3; ++a)
+                  {
+                     for (int c = 0; c < 3; ++c)
+                     {
+                        for (int k3 = 0; k3 < Q1D; ++k3)
+                        {
+                           double u = 0.0;
+                           for (int k2 = 0; k2 < Q1D; ++k2)
+                           {
+                              const double wi = (a == 1) ? G(k2,i2) : B(k2,i2);
+                              const double wj = (c == 1) ? G(k2,j2) : B(k2,j2);
+                              u += wi * wj * op_x[a][c][k3][k2];
+                           }
+                           op_xy[a][c][k3] = u;
+                        }
+                     }
+                  }
+                  for (int i3 = 0; i3 < D1D; ++i3)
+                  {
+                     for (int j3 = 0; j3 < D1D; ++j3)
+                     {
+                        double val = 0.0;
+                        for (int a = 0; a < 3; ++a)
+                        {
+                           for (int c = 0; c < 3; ++c)
+                           {
+                              for (int k3 = 0; k3 < Q1D; ++k3)
+                              {
+                                 const double wi =
+                                    (a == 2) ? G(k3,i3) : B(k3,i3);
+                                 const double wj =
+                                    (c == 2) ? G(k3,j3) : B(k3,j3);
+                                 val += wi * wj * op_xy[a][c][k3];
+                              }
+                           }
+                        }
+                        if (add) { A(i1,i2,i3,j1,j2,j3,e) += val; }
+                        else { A(i1,i2,i3,j1,j2,j3,e) = val; }
+                     }
+                  }
+               }
+            }
+         }
+      }
+   });
+}
+
+static void EADiffusionAssemble(const int dim,
+                                const int D1D,
+                                const int Q1D,
+                                const int NE,
+                                const Array<double> &B,
+                                const Array<double> &G,
+                                const Vector &op,
+                                Vector &A,
+                                const bool add)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22: return EADiffusionAssemble2D<2,2>(NE,B,G,op,A,add);
+         case 0x33: return EADiffusionAssemble2D<3,3>(NE,B,G,op,A,add);
+         case 0x44: return EADiffusionAssemble2D<4,4>(NE,B,G,op,A,add);
+         case 0x55: return EADiffusionAssemble2D<5,5>(NE,B,G,op,A,add);
+         case 0x66: return EADiffusionAssemble2D<6,6>(NE,B,G,op,A,add);
+         default:   return EADiffusionAssemble2D(NE,B,G,op,A,add,D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23: return EADiffusionAssemble3D<2,3>(NE,B,G,op,A,add);
+         case 0x34: return EADiffusionAssemble3D<3,4>(NE,B,G,op,A,add);
+         case 0x45: return EADiffusionAssemble3D<4,5>(NE,B,G,op,A,add);
+         case 0x56: return EADiffusionAssemble3D<5,6>(NE,B,G,op,A,add);
+         default:   return EADiffusionAssemble3D(NE,B,G,op,A,add,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void DiffusionIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                     Vector &emat, const bool add)
+{
+   // The batched kernels reuse the partial assembly data and therefore have
+   // the same restrictions as AssemblePA().
+   const int ne = fes.GetNE();
+   if (ne == 0) { return; }
+   const int el_dim = fes.GetFE(0)->GetDim();
+   const bool tensor =
+      dynamic_cast<const TensorBasisElement*>(fes.GetFE(0)) != NULL;
+   if (!tensor || fes.GetVDim() != 1 || (el_dim != 2 && el_dim != 3))
+   {
+      BilinearFormIntegrator::AssembleEA(fes, emat, add);
+      return;
+   }
+   AssemblePA(fes);
+   EADiffusionAssemble(dim, dofs1D, quad1D, ne, maps->B, maps->G, pa_data,
+                       emat, add);
+}
+
 } // namespace mfem
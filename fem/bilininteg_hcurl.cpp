@@ -0,0 +1,572 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../general/forall.hpp"
+#include "bilininteg.hpp"
+#include "bilininteg_vectorfe.hpp"
+#include "gridfunc.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA H(curl) Integrators
+
+using internal::TensorEval2D;
+using internal::TensorEvalT2D;
+using internal::TensorEval3D;
+using internal::TensorEvalT3D;
+
+// PA H(curl) Mass Assemble 2D kernel
+static void PAHcurlMassSetup2D(const int NQ,
+                               const int NE,
+                               const Array<double> &w,
+                               const Vector &j,
+                               const Vector &coeff,
+                               Vector &op)
+{
+   const bool const_c = coeff.Size() == 1;
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, 2, 2, NE);
+   auto C = const_c ? Reshape(coeff.Read(), 1, 1) :
+            Reshape(coeff.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, 3, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double J11 = J(q,0,0,e);
+         const double J21 = J(q,1,0,e);
+         const double J12 = J(q,0,1,e);
+         const double J22 = J(q,1,1,e);
+         const double c = const_c ? C(0,0) : C(q,e);
+         const double c_detJ = W[q] * c / ((J11*J22)-(J21*J12));
+         // (c/detJ) adj(J) adj(J)^T
+         y(q,0,e) =  c_detJ * (J12*J12 + J22*J22); // 1,1
+         y(q,1,e) = -c_detJ * (J12*J11 + J22*J21); // 1,2
+         y(q,2,e) =  c_detJ * (J11*J11 + J21*J21); // 2,2
+      }
+   });
+}
+
+// PA H(curl) Mass Assemble 3D kernel
+static void PAHcurlMassSetup3D(const int NQ,
+                               const int NE,
+                               const Array<double> &w,
+                               const Vector &j,
+                               const Vector &coeff,
+                               Vector &op)
+{
+   const bool const_c = coeff.Size() == 1;
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, 3, 3, NE);
+   auto C = const_c ? Reshape(coeff.Read(), 1, 1) :
+            Reshape(coeff.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, 6, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double J11 = J(q,0,0,e), J12 = J(q,0,1,e), J13 = J(q,0,2,e);
+         const double J21 = J(q,1,0,e), J22 = J(q,1,1,e), J23 = J(q,1,2,e);
+         const double J31 = J(q,2,0,e), J32 = J(q,2,1,e), J33 = J(q,2,2,e);
+         // adj(J)
+         const double A11 = (J22 * J33) - (J23 * J32);
+         const double A12 = (J13 * J32) - (J12 * J33);
+         const double A13 = (J12 * J23) - (J13 * J22);
+         const double A21 = (J23 * J31) - (J21 * J33);
+         const double A22 = (J11 * J33) - (J13 * J31);
+         const double A23 = (J13 * J21) - (J11 * J23);
+         const double A31 = (J21 * J32) - (J22 * J31);
+         const double A32 = (J12 * J31) - (J11 * J32);
+         const double A33 = (J11 * J22) - (J12 * J21);
+         const double detJ = J11 * A11 + J12 * A21 + J13 * A31;
+         const double c = const_c ? C(0,0) : C(q,e);
+         const double c_detJ = W[q] * c / detJ;
+         // (c/detJ) adj(J) adj(J)^T
+         y(q,0,e) = c_detJ * (A11*A11 + A12*A12 + A13*A13); // 1,1
+         y(q,1,e) = c_detJ * (A11*A21 + A12*A22 + A13*A23); // 1,2
+         y(q,2,e) = c_detJ * (A11*A31 + A12*A32 + A13*A33); // 1,3
+         y(q,3,e) = c_detJ * (A21*A21 + A22*A22 + A23*A23); // 2,2
+         y(q,4,e) = c_detJ * (A21*A31 + A22*A32 + A23*A33); // 2,3
+         y(q,5,e) = c_detJ * (A31*A31 + A32*A32 + A33*A33); // 3,3
+      }
+   });
+}
+
+// The mass kernels below are shared by the Nedelec and Raviart-Thomas
+// elements: component c uses the 1D matrix BA, with DA dofs, in direction c
+// and the 1D matrix BN, with DN dofs, in the other directions. For Nedelec
+// elements BA is the open basis and BN the closed one; for Raviart-Thomas
+// elements it is the opposite, see internal::TensorEval2D().
+
+// PA H(curl) and H(div) Mass Apply 2D kernel
+static void PAVectorFEMassApply2D(const int DA,
+                                  const int DN,
+                                  const int Q1D,
+                                  const int NE,
+                                  const Array<double> &ba,
+                                  const Array<double> &bn,
+                                  const Vector &op,
+                                  const Vector &x,
+                                  Vector &y)
+{
+   MFEM_VERIFY(DA <= MAX_D1D && DN <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int NC = DA*DN; // number of dofs of each component
+   auto Ba = ba.Read();
+   auto Bn = bn.Read();
+   auto op_ = Reshape(op.Read(), Q1D*Q1D, 3, NE);
+   auto X = Reshape(x.Read(), 2*NC, NE);
+   auto Y = Reshape(y.ReadWrite(), 2*NC, NE);
+   MFEM_FORALL(e, NE,
+   {
+      double mass[MAX_Q1D*MAX_Q1D*2];
+      for (int i = 0; i < 2*Q1D*Q1D; ++i) { mass[i] = 0.0; }
+      const double *Xe = &X(0,e);
+      TensorEval2D(DA, DN, Q1D, Ba, Bn, Xe, 2, 0, 1.0, mass);
+      TensorEval2D(DN, DA, Q1D, Bn, Ba, Xe + NC, 2, 1, 1.0, mass);
+      for (int q = 0; q < Q1D*Q1D; ++q)
+      {
+         const double m0 = mass[2*q], m1 = mass[2*q+1];
+         mass[2*q]   = op_(q,0,e) * m0 + op_(q,1,e) * m1;
+         mass[2*q+1] = op_(q,1,e) * m0 + op_(q,2,e) * m1;
+      }
+      double *Ye = &Y(0,e);
+      TensorEvalT2D(DA, DN, Q1D, Ba, Bn, mass, 2, 0, 1.0, Ye);
+      TensorEvalT2D(DN, DA, Q1D, Bn, Ba, mass, 2, 1, 1.0, Ye + NC);
+   });
+}
+
+// PA H(curl) and H(div) Mass Apply 3D kernel
+static void PAVectorFEMassApply3D(const int DA,
+                                  const int DN,
+                                  const int Q1D,
+                                  const int NE,
+                                  const Array<double> &ba,
+                                  const Array<double> &bn,
+                                  const Vector &op,
+                                  const Vector &x,
+                                  Vector &y)
+{
+   MFEM_VERIFY(DA <= MAX_D1D && DN <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int NC = DA*DN*DN; // number of dofs of each component
+   auto Ba = ba.Read();
+   auto Bn = bn.Read();
+   auto op_ = Reshape(op.Read(), Q1D*Q1D*Q1D, 6, NE);
+   auto X = Reshape(x.Read(), 3*NC, NE);
+   auto Y = Reshape(y.ReadWrite(), 3*NC, NE);
+   MFEM_FORALL(e, NE,
+   {
+      double mass[MAX_Q1D*MAX_Q1D*MAX_Q1D*3];
+      for (int i = 0; i < 3*Q1D*Q1D*Q1D; ++i) { mass[i] = 0.0; }
+      const double *Xe = &X(0,e);
+      TensorEval3D(DA, DN, DN, Q1D, Ba, Bn, Bn, Xe, 3, 0, 1.0, mass);
+      TensorEval3D(DN, DA, DN, Q1D, Bn, Ba, Bn, Xe + NC, 3, 1, 1.0, mass);
+      TensorEval3D(DN, DN, DA, Q1D, Bn, Bn, Ba, Xe + 2*NC, 3, 2, 1.0, mass);
+      for (int q = 0; q < Q1D*Q1D*Q1D; ++q)
+      {
+         const double m0 = mass[3*q], m1 = mass[3*q+1], m2 = mass[3*q+2];
+         const double O11 = op_(q,0,e), O12 = op_(q,1,e), O13 = op_(q,2,e);
+         const double O22 = op_(q,3,e), O23 = op_(q,4,e), O33 = op_(q,5,e);
+         mass[3*q]   = O11 * m0 + O12 * m1 + O13 * m2;
+         mass[3*q+1] = O12 * m0 + O22 * m1 + O23 * m2;
+         mass[3*q+2] = O13 * m0 + O23 * m1 + O33 * m2;
+      }
+      double *Ye = &Y(0,e);
+      TensorEvalT3D(DA, DN, DN, Q1D, Ba, Bn, Bn, mass, 3, 0, 1.0, Ye);
+      TensorEvalT3D(DN, DA, DN, Q1D, Bn, Ba, Bn, mass, 3, 1, 1.0, Ye + NC);
+      TensorEvalT3D(DN, DN, DA, Q1D, Bn, Bn, Ba, mass, 3, 2, 1.0,
+                    Ye + 2*NC);
+   });
+}
+
+// PA H(curl) and H(div) Mass Diagonal 2D kernel. Each dof belongs to a single
+// component, so its diagonal entry involves only the diagonal entry of the
+// quadrature data of that component; BA and BN hold the squared 1D bases.
+static void PAVectorFEMassDiagonal2D(const int DA,
+                                     const int DN,
+                                     const int Q1D,
+                                     const int NE,
+                                     const Array<double> &ba2,
+                                     const Array<double> &bn2,
+                                     const Vector &op,
+                                     Vector &diag)
+{
+   MFEM_VERIFY(DA <= MAX_D1D && DN <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int NC = DA*DN; // number of dofs of each component
+   auto Ba2 = ba2.Read();
+   auto Bn2 = bn2.Read();
+   auto op_ = Reshape(op.Read(), Q1D*Q1D, 3, NE);
+   auto D = Reshape(diag.ReadWrite(), 2*NC, NE);
+   MFEM_FORALL(e, NE,
+   {
+      double *De = &D(0,e);
+      TensorEvalT2D(DA, DN, Q1D, Ba2, Bn2, &op_(0,0,e), 1, 0, 1.0, De);
+      TensorEvalT2D(DN, DA, Q1D, Bn2, Ba2, &op_(0,2,e), 1, 0, 1.0, De + NC);
+   });
+}
+
+// PA H(curl) and H(div) Mass Diagonal 3D kernel
+static void PAVectorFEMassDiagonal3D(const int DA,
+                                     const int DN,
+                                     const int Q1D,
+                                     const int NE,
+                                     const Array<double> &ba2,
+                                     const Array<double> &bn2,
+                                     const Vector &op,
+                                     Vector &diag)
+{
+   MFEM_VERIFY(DA <= MAX_D1D && DN <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int NC = DA*DN*DN; // number of dofs of each component
+   auto Ba2 = ba2.Read();
+   auto Bn2 = bn2.Read();
+   auto op_ = Reshape(op.Read(), Q1D*Q1D*Q1D, 6, NE);
+   auto D = Reshape(diag.ReadWrite(), 3*NC, NE);
+   MFEM_FORALL(e, NE,
+   {
+      double *De = &D(0,e);
+      TensorEvalT3D(DA, DN, DN, Q1D, Ba2, Bn2, Bn2, &op_(0,0,e), 1, 0, 1.0,
+                    De);
+      TensorEvalT3D(DN, DA, DN, Q1D, Bn2, Ba2, Bn2, &op_(0,3,e), 1, 0, 1.0,
+                    De + NC);
+      TensorEvalT3D(DN, DN, DA, Q1D, Bn2, Bn2, Ba2, &op_(0,5,e), 1, 0, 1.0,
+                    De + 2*NC);
+   });
+}
+
+// Set B2 to the entrywise square of the 1D matrix B.
+static void SquareBasis(const Array<double> &B, Array<double> &B2)
+{
+   B2.SetSize(B.Size());
+   const double *h_B = B.HostRead();
+   for (int i = 0; i < B.Size(); i++) { B2[i] = h_B[i] * h_B[i]; }
+}
+
+void VectorFEMassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   // Assuming the same element type
+   Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNE() == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const VectorTensorFiniteElement *el_tp =
+      dynamic_cast<const VectorTensorFiniteElement*>(&el);
+   MFEM_VERIFY(el_tp && (el.GetMapType() == FiniteElement::H_CURL ||
+                         el.GetMapType() == FiniteElement::H_DIV),
+               "only Nedelec and Raviart-Thomas elements on quads and hexes "
+               "are supported");
+   MFEM_VERIFY(VQ == NULL && MQ == NULL,
+               "only scalar coefficients are supported");
+   ElementTransformation &T = *mesh->GetElementTransformation(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      const int order = T.OrderW() + 2*el.GetOrder();
+      ir = &IntRules.Get(el.GetGeomType(), order);
+   }
+   dim = mesh->Dimension();
+   MFEM_VERIFY(mesh->SpaceDimension() == dim, "surface meshes are not "
+               "supported");
+   hdiv = (el.GetMapType() == FiniteElement::H_DIV);
+   ne = fes.GetNE();
+   nq = ir->GetNPoints();
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+   mapsC = &el_tp->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   mapsO = &el_tp->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+   dofs1D = mapsC->ndof;
+   quad1D = mapsC->nqpt;
+   const int symmDims = (dim * (dim + 1)) / 2; // 1x1: 1, 2x2: 3, 3x3: 6
+   pa_data.SetSize(symmDims*nq*ne, Device::GetMemoryType());
+   Vector coeff;
+   EvalCoefficientQVector(Q, *mesh, *ir, coeff);
+   if (hdiv)
+   {
+      internal::PAHdivMassSetup(dim, nq, ne, ir->GetWeights(), geom->J,
+                                coeff, pa_data);
+   }
+   else if (dim == 2)
+   {
+      PAHcurlMassSetup2D(nq, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+   }
+   else if (dim == 3)
+   {
+      PAHcurlMassSetup3D(nq, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+   }
+   else
+   {
+      MFEM_ABORT("Unknown kernel.");
+   }
+}
+
+void VectorFEMassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   // The component c is closed in direction c for H(div), open for H(curl)
+   const int DA = hdiv ? dofs1D : dofs1D - 1;
+   const int DN = hdiv ? dofs1D - 1 : dofs1D;
+   const Array<double> &BA = hdiv ? mapsC->B : mapsO->B;
+   const Array<double> &BN = hdiv ? mapsO->B : mapsC->B;
+   if (dim == 2)
+   {
+      PAVectorFEMassApply2D(DA, DN, quad1D, ne, BA, BN, pa_data, x, y);
+   }
+   else if (dim == 3)
+   {
+      PAVectorFEMassApply3D(DA, DN, quad1D, ne, BA, BN, pa_data, x, y);
+   }
+   else
+   {
+      MFEM_ABORT("Unknown kernel.");
+   }
+}
+
+void VectorFEMassIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   const int DA = hdiv ? dofs1D : dofs1D - 1;
+   const int DN = hdiv ? dofs1D - 1 : dofs1D;
+   Array<double> BA2, BN2;
+   SquareBasis(hdiv ? mapsC->B : mapsO->B, BA2);
+   SquareBasis(hdiv ? mapsO->B : mapsC->B, BN2);
+   if (dim == 2)
+   {
+      PAVectorFEMassDiagonal2D(DA, DN, quad1D, ne, BA2, BN2, pa_data, diag);
+   }
+   else if (dim == 3)
+   {
+      PAVectorFEMassDiagonal3D(DA, DN, quad1D, ne, BA2, BN2, pa_data, diag);
+   }
+   else
+   {
+      MFEM_ABORT("Unknown kernel.");
+   }
+}
+
+// PA H(curl) curl-curl Assemble 2D kernel
+static void PACurlCurlSetup2D(const int NQ,
+                              const int NE,
+                              const Array<double> &w,
+                              const Vector &j,
+                              const Vector &coeff,
+                              Vector &op)
+{
+   const bool const_c = coeff.Size() == 1;
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, 2, 2, NE);
+   auto C = const_c ? Reshape(coeff.Read(), 1, 1) :
+            Reshape(coeff.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double J11 = J(q,0,0,e);
+         const double J21 = J(q,1,0,e);
+         const double J12 = J(q,0,1,e);
+         const double J22 = J(q,1,1,e);
+         const double c = const_c ? C(0,0) : C(q,e);
+         y(q,e) = W[q] * c / ((J11*J22)-(J21*J12));
+      }
+   });
+}
+
+// PA H(curl) curl-curl Assemble 3D kernel
+static void PACurlCurlSetup3D(const int NQ,
+                              const int NE,
+                              const Array<double> &w,
+                              const Vector &j,
+                              const Vector &coeff,
+                              Vector &op)
+{
+   const bool const_c = coeff.Size() == 1;
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, 3, 3, NE);
+   auto C = const_c ? Reshape(coeff.Read(), 1, 1) :
+            Reshape(coeff.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, 6, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double J11 = J(q,0,0,e), J12 = J(q,0,1,e), J13 = J(q,0,2,e);
+         const double J21 = J(q,1,0,e), J22 = J(q,1,1,e), J23 = J(q,1,2,e);
+         const double J31 = J(q,2,0,e), J32 = J(q,2,1,e), J33 = J(q,2,2,e);
+         const double detJ = J11 * (J22 * J33 - J32 * J23) -
+                             J21 * (J12 * J33 - J32 * J13) +
+                             J31 * (J12 * J23 - J22 * J13);
+         const double c = const_c ? C(0,0) : C(q,e);
+         const double c_detJ = W[q] * c / detJ;
+         // (c/detJ) J^T J
+         y(q,0,e) = c_detJ * (J11*J11 + J21*J21 + J31*J31); // 1,1
+         y(q,1,e) = c_detJ * (J11*J12 + J21*J22 + J31*J32); // 1,2
+         y(q,2,e) = c_detJ * (J11*J13 + J21*J23 + J31*J33); // 1,3
+         y(q,3,e) = c_detJ * (J12*J12 + J22*J22 + J32*J32); // 2,2
+         y(q,4,e) = c_detJ * (J12*J13 + J22*J23 + J32*J33); // 2,3
+         y(q,5,e) = c_detJ * (J13*J13 + J23*J23 + J33*J33); // 3,3
+      }
+   });
+}
+
+// PA H(curl) curl-curl Apply 2D kernel
+static void PACurlCurlApply2D(const int D1D,
+                              const int Q1D,
+                              const int NE,
+                              const Array<double> &bo,
+                              const Array<double> &gc,
+                              const Vector &op,
+                              const Vector &x,
+                              Vector &y)
+{
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int ND = 2*D1D*(D1D-1);
+   auto Bo = bo.Read();
+   auto Gc = gc.Read();
+   auto op_ = Reshape(op.Read(), Q1D*Q1D, NE);
+   auto X = Reshape(x.Read(), ND, NE);
+   auto Y = Reshape(y.ReadWrite(), ND, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1 = D1D - 1;
+      // The reference curl is d(u_y)/dx - d(u_x)/dy
+      double curl[MAX_Q1D*MAX_Q1D];
+      for (int q = 0; q < Q1D*Q1D; ++q) { curl[q] = 0.0; }
+      const double *Xe = &X(0,e);
+      TensorEval2D(D1, D1D, Q1D, Bo, Gc, Xe, 1, 0, -1.0, curl);
+      TensorEval2D(D1D, D1, Q1D, Gc, Bo, Xe + D1*D1D, 1, 0, 1.0, curl);
+      for (int q = 0; q < Q1D*Q1D; ++q) { curl[q] *= op_(q,e); }
+      double *Ye = &Y(0,e);
+      TensorEvalT2D(D1, D1D, Q1D, Bo, Gc, curl, 1, 0, -1.0, Ye);
+      TensorEvalT2D(D1D, D1, Q1D, Gc, Bo, curl, 1, 0, 1.0, Ye + D1*D1D);
+   });
+}
+
+// PA H(curl) curl-curl Apply 3D kernel
+static void PACurlCurlApply3D(const int D1D,
+                              const int Q1D,
+                              const int NE,
+                              const Array<double> &bo,
+                              const Array<double> &bc,
+                              const Array<double> &gc,
+                              const Vector &op,
+                              const Vector &x,
+                              Vector &y)
+{
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int ND = 3*D1D*D1D*(D1D-1);
+   auto Bo = bo.Read();
+   auto Bc = bc.Read();
+   auto Gc = gc.Read();
+   auto op_ = Reshape(op.Read(), Q1D*Q1D*Q1D, 6, NE);
+   auto X = Reshape(x.Read(), ND, NE);
+   auto Y = Reshape(y.ReadWrite(), ND, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1 = D1D - 1;
+      const int NC = D1*D1D*D1D; // number of dofs of each component
+      // The reference curl of the x-component is (0, du_x/dz, -du_x/dy), of
+      // the y-component (-du_y/dz, 0, du_y/dx) and of the z-component
+      // (du_z/dy, -du_z/dx, 0).
+      double curl[MAX_Q1D*MAX_Q1D*MAX_Q1D*3];
+      for (int i = 0; i < 3*Q1D*Q1D*Q1D; ++i) { curl[i] = 0.0; }
+      const double *Xx = &X(0,e), *Xy = Xx + NC, *Xz = Xx + 2*NC;
+      TensorEval3D(D1, D1D, D1D, Q1D, Bo, Bc, Gc, Xx, 3, 1, 1.0, curl);
+      TensorEval3D(D1, D1D, D1D, Q1D, Bo, Gc, Bc, Xx, 3, 2, -1.0, curl);
+      TensorEval3D(D1D, D1, D1D, Q1D, Bc, Bo, Gc, Xy, 3, 0, -1.0, curl);
+      TensorEval3D(D1D, D1, D1D, Q1D, Gc, Bo, Bc, Xy, 3, 2, 1.0, curl);
+      TensorEval3D(D1D, D1D, D1, Q1D, Bc, Gc, Bo, Xz, 3, 0, 1.0, curl);
+      TensorEval3D(D1D, D1D, D1, Q1D, Gc, Bc, Bo, Xz, 3, 1, -1.0, curl);
+      for (int q = 0; q < Q1D*Q1D*Q1D; ++q)
+      {
+         const double c0 = curl[3*q], c1 = curl[3*q+1], c2 = curl[3*q+2];
+         const double O11 = op_(q,0,e), O12 = op_(q,1,e), O13 = op_(q,2,e);
+         const double O22 = op_(q,3,e), O23 = op_(q,4,e), O33 = op_(q,5,e);
+         curl[3*q]   = O11 * c0 + O12 * c1 + O13 * c2;
+         curl[3*q+1] = O12 * c0 + O22 * c1 + O23 * c2;
+         curl[3*q+2] = O13 * c0 + O23 * c1 + O33 * c2;
+      }
+      double *Yx = &Y(0,e), *Yy = Yx + NC, *Yz = Yx + 2*NC;
+      TensorEvalT3D(D1, D1D, D1D, Q1D, Bo, Bc, Gc, curl, 3, 1, 1.0, Yx);
+      TensorEvalT3D(D1, D1D, D1D, Q1D, Bo, Gc, Bc, curl, 3, 2, -1.0, Yx);
+      TensorEvalT3D(D1D, D1, D1D, Q1D, Bc, Bo, Gc, curl, 3, 0, -1.0, Yy);
+      TensorEvalT3D(D1D, D1, D1D, Q1D, Gc, Bo, Bc, curl, 3, 2, 1.0, Yy);
+      TensorEvalT3D(D1D, D1D, D1, Q1D, Bc, Gc, Bo, curl, 3, 0, 1.0, Yz);
+      TensorEvalT3D(D1D, D1D, D1, Q1D, Gc, Bc, Bo, curl, 3, 1, -1.0, Yz);
+   });
+}
+
+void CurlCurlIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   // Assuming the same element type
+   Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNE() == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const VectorTensorFiniteElement *el_tp =
+      dynamic_cast<const VectorTensorFiniteElement*>(&el);
+   MFEM_VERIFY(el_tp && el.GetMapType() == FiniteElement::H_CURL,
+               "only Nedelec elements on quads and hexes are supported");
+   MFEM_VERIFY(MQ == NULL, "only scalar coefficients are supported");
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      // Same rule as in AssembleElementMatrix() for tensor-product elements
+      ir = &IntRules.Get(el.GetGeomType(), 2*el.GetOrder());
+   }
+   dim = mesh->Dimension();
+   MFEM_VERIFY(mesh->SpaceDimension() == dim, "surface meshes are not "
+               "supported");
+   ne = fes.GetNE();
+   nq = ir->GetNPoints();
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+   mapsC = &el_tp->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   mapsO = &el_tp->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+   dofs1D = mapsC->ndof;
+   quad1D = mapsC->nqpt;
+   const int curlDims = (dim == 2) ? 1 : 6; // symmetric 1x1 or 3x3
+   pa_data.SetSize(curlDims*nq*ne, Device::GetMemoryType());
+   Vector coeff;
+   EvalCoefficientQVector(Q, *mesh, *ir, coeff);
+   if (dim == 2)
+   {
+      PACurlCurlSetup2D(nq, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+   }
+   else if (dim == 3)
+   {
+      PACurlCurlSetup3D(nq, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+   }
+   else
+   {
+      MFEM_ABORT("Unknown kernel.");
+   }
+}
+
+void CurlCurlIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (dim == 2)
+   {
+      PACurlCurlApply2D(dofs1D, quad1D, ne, mapsO->B, mapsC->G, pa_data,
+                        x, y);
+   }
+   else if (dim == 3)
+   {
+      PACurlCurlApply3D(dofs1D, quad1D, ne, mapsO->B, mapsC->B, mapsC->G,
+                        pa_data, x, y);
+   }
+   else
+   {
+      MFEM_ABORT("Unknown kernel.");
+   }
+}
+
+} // namespace mfem
@@ -0,0 +1,451 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../general/forall.hpp"
+#include "bilininteg.hpp"
+#include "bilininteg_vectorfe.hpp"
+#include "gridfunc.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA H(div) Integrators
+
+using internal::TensorEval2D;
+using internal::TensorEvalT2D;
+using internal::TensorEval3D;
+using internal::TensorEvalT3D;
+
+// In the kernels below, D1D is the size of the closed 1D basis of the
+// Raviart-Thomas element and D1 = D1D - 1 the size of the open one. Component
+// c of the element is closed in direction c and open in the other directions.
+
+// PA H(div) Mass Assemble kernel, used by VectorFEMassIntegrator
+void internal::PAHdivMassSetup(const int dim,
+                               const int NQ,
+                               const int NE,
+                               const Array<double> &w,
+                               const Vector &j,
+                               const Vector &coeff,
+                               Vector &op)
+{
+   const bool const_c = coeff.Size() == 1;
+   auto W = w.Read();
+   auto C = const_c ? Reshape(coeff.Read(), 1, 1) :
+            Reshape(coeff.Read(), NQ, NE);
+   if (dim == 2)
+   {
+      auto J = Reshape(j.Read(), NQ, 2, 2, NE);
+      auto y = Reshape(op.Write(), NQ, 3, NE);
+      MFEM_FORALL(e, NE,
+      {
+         for (int q = 0; q < NQ; ++q)
+         {
+            const double J11 = J(q,0,0,e);
+            const double J21 = J(q,1,0,e);
+            const double J12 = J(q,0,1,e);
+            const double J22 = J(q,1,1,e);
+            const double c = const_c ? C(0,0) : C(q,e);
+            const double c_detJ = W[q] * c / ((J11*J22)-(J21*J12));
+            // (c/detJ) J^T J
+            y(q,0,e) = c_detJ * (J11*J11 + J21*J21); // 1,1
+            y(q,1,e) = c_detJ * (J11*J12 + J21*J22); // 1,2
+            y(q,2,e) = c_detJ * (J12*J12 + J22*J22); // 2,2
+         }
+      });
+   }
+   else if (dim == 3)
+   {
+      auto J = Reshape(j.Read(), NQ, 3, 3, NE);
+      auto y = Reshape(op.Write(), NQ, 6, NE);
+      MFEM_FORALL(e, NE,
+      {
+         for (int q = 0; q < NQ; ++q)
+         {
+            const double J11 = J(q,0,0,e), J12 = J(q,0,1,e), J13 = J(q,0,2,e);
+            const double J21 = J(q,1,0,e), J22 = J(q,1,1,e), J23 = J(q,1,2,e);
+            const double J31 = J(q,2,0,e), J32 = J(q,2,1,e), J33 = J(q,2,2,e);
+            const double detJ = J11 * (J22 * J33 - J32 * J23) -
+                                J21 * (J12 * J33 - J32 * J13) +
+                                J31 * (J12 * J23 - J22 * J13);
+            const double c = const_c ? C(0,0) : C(q,e);
+            const double c_detJ = W[q] * c / detJ;
+            // (c/detJ) J^T J
+            y(q,0,e) = c_detJ * (J11*J11 + J21*J21 + J31*J31); // 1,1
+            y(q,1,e) = c_detJ * (J11*J12 + J21*J22 + J31*J32); // 1,2
+            y(q,2,e) = c_detJ * (J11*J13 + J21*J23 + J31*J33); // 1,3
+            y(q,3,e) = c_detJ * (J12*J12 + J22*J22 + J32*J32); // 2,2
+            y(q,4,e) = c_detJ * (J12*J13 + J22*J23 + J32*J33); // 2,3
+            y(q,5,e) = c_detJ * (J13*J13 + J23*J23 + J33*J33); // 3,3
+         }
+      });
+   }
+   else
+   {
+      MFEM_ABORT("Unknown kernel.");
+   }
+}
+
+// PA H(div) div-div Assemble kernel
+static void PADivDivSetup(const int dim,
+                          const int NQ,
+                          const int NE,
+                          const Array<double> &w,
+                          const Vector &j,
+                          const Vector &coeff,
+                          Vector &op)
+{
+   const bool const_c = coeff.Size() == 1;
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, dim, dim, NE);
+   auto C = const_c ? Reshape(coeff.Read(), 1, 1) :
+            Reshape(coeff.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         double detJ;
+         if (dim == 2)
+         {
+            detJ = J(q,0,0,e)*J(q,1,1,e) - J(q,1,0,e)*J(q,0,1,e);
+         }
+         else
+         {
+            detJ = J(q,0,0,e)*(J(q,1,1,e)*J(q,2,2,e)-J(q,2,1,e)*J(q,1,2,e)) -
+                   J(q,1,0,e)*(J(q,0,1,e)*J(q,2,2,e)-J(q,2,1,e)*J(q,0,2,e)) +
+                   J(q,2,0,e)*(J(q,0,1,e)*J(q,1,2,e)-J(q,1,1,e)*J(q,0,2,e));
+         }
+         const double c = const_c ? C(0,0) : C(q,e);
+         y(q,e) = W[q] * c / detJ;
+      }
+   });
+}
+
+// Evaluate the reference divergence of the Raviart-Thomas E-vector of one
+// element, Xe, at the quadrature points: div += s*div(Xe).
+MFEM_HOST_DEVICE static inline
+void HdivDiv2D(const int D1D, const int Q1D, const double *Bo,
+               const double *Gc, const double *Xe, const double s,
+               double *div)
+{
+   const int D1 = D1D - 1;
+   TensorEval2D(D1D, D1, Q1D, Gc, Bo, Xe, 1, 0, s, div);
+   TensorEval2D(D1, D1D, Q1D, Bo, Gc, Xe + D1D*D1, 1, 0, s, div);
+}
+
+// Transpose of HdivDiv2D: Ye += s*div^T(div).
+MFEM_HOST_DEVICE static inline
+void HdivDivT2D(const int D1D, const int Q1D, const double *Bo,
+                const double *Gc, const double *div, const double s,
+                double *Ye)
+{
+   const int D1 = D1D - 1;
+   TensorEvalT2D(D1D, D1, Q1D, Gc, Bo, div, 1, 0, s, Ye);
+   TensorEvalT2D(D1, D1D, Q1D, Bo, Gc, div, 1, 0, s, Ye + D1D*D1);
+}
+
+// Evaluate the reference divergence in 3D, see HdivDiv2D.
+MFEM_HOST_DEVICE static inline
+void HdivDiv3D(const int D1D, const int Q1D, const double *Bo,
+               const double *Gc, const double *Xe, const double s,
+               double *div)
+{
+   const int D1 = D1D - 1;
+   const int NC = D1D*D1*D1; // number of dofs of each component
+   TensorEval3D(D1D, D1, D1, Q1D, Gc, Bo, Bo, Xe, 1, 0, s, div);
+   TensorEval3D(D1, D1D, D1, Q1D, Bo, Gc, Bo, Xe + NC, 1, 0, s, div);
+   TensorEval3D(D1, D1, D1D, Q1D, Bo, Bo, Gc, Xe + 2*NC, 1, 0, s, div);
+}
+
+// Transpose of HdivDiv3D: Ye += s*div^T(div).
+MFEM_HOST_DEVICE static inline
+void HdivDivT3D(const int D1D, const int Q1D, const double *Bo,
+                const double *Gc, const double *div, const double s,
+                double *Ye)
+{
+   const int D1 = D1D - 1;
+   const int NC = D1D*D1*D1; // number of dofs of each component
+   TensorEvalT3D(D1D, D1, D1, Q1D, Gc, Bo, Bo, div, 1, 0, s, Ye);
+   TensorEvalT3D(D1, D1D, D1, Q1D, Bo, Gc, Bo, div, 1, 0, s, Ye + NC);
+   TensorEvalT3D(D1, D1, D1D, Q1D, Bo, Bo, Gc, div, 1, 0, s, Ye + 2*NC);
+}
+
+// PA H(div) div-div Apply kernel
+static void PADivDivApply(const int dim,
+                          const int D1D,
+                          const int Q1D,
+                          const int NE,
+                          const Array<double> &bo,
+                          const Array<double> &gc,
+                          const Vector &op,
+                          const Vector &x,
+                          Vector &y)
+{
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int ND = (dim == 2) ? 2*D1D*(D1D-1) : 3*D1D*(D1D-1)*(D1D-1);
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   auto Bo = bo.Read();
+   auto Gc = gc.Read();
+   auto op_ = Reshape(op.Read(), NQ, NE);
+   auto X = Reshape(x.Read(), ND, NE);
+   auto Y = Reshape(y.ReadWrite(), ND, NE);
+   MFEM_FORALL(e, NE,
+   {
+      double div[MAX_Q1D*MAX_Q1D*MAX_Q1D];
+      for (int q = 0; q < NQ; ++q) { div[q] = 0.0; }
+      if (dim == 2) { HdivDiv2D(D1D, Q1D, Bo, Gc, &X(0,e), 1.0, div); }
+      else { HdivDiv3D(D1D, Q1D, Bo, Gc, &X(0,e), 1.0, div); }
+      for (int q = 0; q < NQ; ++q) { div[q] *= op_(q,e); }
+      if (dim == 2) { HdivDivT2D(D1D, Q1D, Bo, Gc, div, 1.0, &Y(0,e)); }
+      else { HdivDivT3D(D1D, Q1D, Bo, Gc, div, 1.0, &Y(0,e)); }
+   });
+}
+
+void DivDivIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   // Assuming the same element type
+   Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNE() == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const VectorTensorFiniteElement *el_tp =
+      dynamic_cast<const VectorTensorFiniteElement*>(&el);
+   MFEM_VERIFY(el_tp && el.GetMapType() == FiniteElement::H_DIV,
+               "only Raviart-Thomas elements on quads and hexes are "
+               "supported");
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      // Same rule as in AssembleElementMatrix()
+      ir = &IntRules.Get(el.GetGeomType(), 2*el.GetOrder() - 2);
+   }
+   dim = mesh->Dimension();
+   MFEM_VERIFY(dim == 2 || dim == 3, "Unknown kernel.");
+   MFEM_VERIFY(mesh->SpaceDimension() == dim, "surface meshes are not "
+               "supported");
+   ne = fes.GetNE();
+   nq = ir->GetNPoints();
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+   mapsC = &el_tp->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   mapsO = &el_tp->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+   dofs1D = mapsC->ndof;
+   quad1D = mapsC->nqpt;
+   pa_data.SetSize(nq*ne, Device::GetMemoryType());
+   Vector coeff;
+   EvalCoefficientQVector(Q, *mesh, *ir, coeff);
+   PADivDivSetup(dim, nq, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+}
+
+void DivDivIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   PADivDivApply(dim, dofs1D, quad1D, ne, mapsO->B, mapsC->G, pa_data, x, y);
+}
+
+// PA H(div)-L2 (div u, p) Assemble kernel: the Piola transformation of the
+// divergence and the change of variables cancel, so only W*c is stored.
+static void PAHdivL2Setup(const int NQ,
+                          const int NE,
+                          const Array<double> &w,
+                          const Vector &coeff,
+                          Vector &op)
+{
+   const bool const_c = coeff.Size() == 1;
+   auto W = w.Read();
+   auto C = const_c ? Reshape(coeff.Read(), 1, 1) :
+            Reshape(coeff.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         y(q,e) = W[q] * (const_c ? C(0,0) : C(q,e));
+      }
+   });
+}
+
+// PA H(div)-L2 (div u, p) Apply kernel, and its transpose. L1D is the size of
+// the 1D basis of the scalar (test) space, whose E-vector is lexicographic.
+static void PAHdivL2Apply(const int dim,
+                          const int D1D,
+                          const int L1D,
+                          const int Q1D,
+                          const int NE,
+                          const Array<double> &bo,
+                          const Array<double> &gc,
+                          const Array<double> &bt,
+                          const Vector &op,
+                          const Vector &x,
+                          Vector &y,
+                          const bool transpose)
+{
+   MFEM_VERIFY(D1D <= MAX_D1D && L1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int ND = (dim == 2) ? 2*D1D*(D1D-1) : 3*D1D*(D1D-1)*(D1D-1);
+   const int NL = (dim == 2) ? L1D*L1D : L1D*L1D*L1D;
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   auto Bo = bo.Read();
+   auto Gc = gc.Read();
+   auto Bt = bt.Read();
+   auto op_ = Reshape(op.Read(), NQ, NE);
+   auto X = Reshape(x.Read(), transpose ? NL : ND, NE);
+   auto Y = Reshape(y.ReadWrite(), transpose ? ND : NL, NE);
+   MFEM_FORALL(e, NE,
+   {
+      double val[MAX_Q1D*MAX_Q1D*MAX_Q1D];
+      for (int q = 0; q < NQ; ++q) { val[q] = 0.0; }
+      if (!transpose)
+      {
+         if (dim == 2) { HdivDiv2D(D1D, Q1D, Bo, Gc, &X(0,e), 1.0, val); }
+         else { HdivDiv3D(D1D, Q1D, Bo, Gc, &X(0,e), 1.0, val); }
+      }
+      else if (dim == 2)
+      {
+         TensorEval2D(L1D, L1D, Q1D, Bt, Bt, &X(0,e), 1, 0, 1.0, val);
+      }
+      else
+      {
+         TensorEval3D(L1D, L1D, L1D, Q1D, Bt, Bt, Bt, &X(0,e), 1, 0, 1.0,
+                      val);
+      }
+      for (int q = 0; q < NQ; ++q) { val[q] *= op_(q,e); }
+      if (transpose)
+      {
+         if (dim == 2) { HdivDivT2D(D1D, Q1D, Bo, Gc, val, 1.0, &Y(0,e)); }
+         else { HdivDivT3D(D1D, Q1D, Bo, Gc, val, 1.0, &Y(0,e)); }
+      }
+      else if (dim == 2)
+      {
+         TensorEvalT2D(L1D, L1D, Q1D, Bt, Bt, val, 1, 0, 1.0, &Y(0,e));
+      }
+      else
+      {
+         TensorEvalT3D(L1D, L1D, L1D, Q1D, Bt, Bt, Bt, val, 1, 0, 1.0,
+                       &Y(0,e));
+      }
+   });
+}
+
+// Diagonal of B_e diag(D) B_e^T for the H(div)-L2 element matrices B_e: the
+// row of B_e of each test dof is computed by applying the transpose of the
+// divergence to the test basis function times the quadrature data.
+static void PAHdivL2DiagonalADAt(const int dim,
+                                 const int D1D,
+                                 const int L1D,
+                                 const int Q1D,
+                                 const int NE,
+                                 const Array<double> &bo,
+                                 const Array<double> &gc,
+                                 const Array<double> &bt,
+                                 const Vector &op,
+                                 const Vector &d,
+                                 Vector &diag)
+{
+   MFEM_VERIFY(D1D <= MAX_D1D && L1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const int ND = (dim == 2) ? 2*D1D*(D1D-1) : 3*D1D*(D1D-1)*(D1D-1);
+   const int NL = (dim == 2) ? L1D*L1D : L1D*L1D*L1D;
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   auto Bo = bo.Read();
+   auto Gc = gc.Read();
+   auto Bt = Reshape(bt.Read(), Q1D, L1D);
+   auto op_ = Reshape(op.Read(), NQ, NE);
+   auto D = Reshape(d.Read(), ND, NE);
+   auto Y = Reshape(diag.ReadWrite(), NL, NE);
+   MFEM_FORALL(e, NE,
+   {
+      double val[MAX_Q1D*MAX_Q1D*MAX_Q1D];
+      double row[3*MAX_D1D*MAX_D1D*MAX_D1D];
+      for (int i = 0; i < NL; ++i)
+      {
+         const int ix = i % L1D, iy = (i / L1D) % L1D, iz = i / (L1D*L1D);
+         for (int q = 0; q < NQ; ++q)
+         {
+            const int qx = q % Q1D, qy = (q / Q1D) % Q1D, qz = q / (Q1D*Q1D);
+            const double bz = (dim == 2) ? 1.0 : Bt(qz,iz);
+            val[q] = Bt(qx,ix) * Bt(qy,iy) * bz * op_(q,e);
+         }
+         for (int j = 0; j < ND; ++j) { row[j] = 0.0; }
+         if (dim == 2) { HdivDivT2D(D1D, Q1D, Bo, Gc, val, 1.0, row); }
+         else { HdivDivT3D(D1D, Q1D, Bo, Gc, val, 1.0, row); }
+         double s = 0.0;
+         for (int j = 0; j < ND; ++j) { s += row[j] * row[j] * D(j,e); }
+         Y(i,e) += s;
+      }
+   });
+}
+
+void VectorFEDivergenceIntegrator::AssemblePA(
+   const FiniteElementSpace &trial_fes, const FiniteElementSpace &test_fes)
+{
+   // Assuming the same element type
+   Mesh *mesh = trial_fes.GetMesh();
+   if (mesh->GetNE() == 0) { return; }
+   const FiniteElement &trial_fe = *trial_fes.GetFE(0);
+   const FiniteElement &test_fe = *test_fes.GetFE(0);
+   const VectorTensorFiniteElement *trial_el =
+      dynamic_cast<const VectorTensorFiniteElement*>(&trial_fe);
+   const NodalTensorFiniteElement *test_el =
+      dynamic_cast<const NodalTensorFiniteElement*>(&test_fe);
+   MFEM_VERIFY(trial_el && trial_fe.GetMapType() == FiniteElement::H_DIV,
+               "the trial space must use Raviart-Thomas elements on quads "
+               "and hexes");
+   MFEM_VERIFY(test_el && test_fe.GetMapType() == FiniteElement::VALUE,
+               "the test space must use nodal tensor-product elements with "
+               "FiniteElement::VALUE map type");
+   MFEM_VERIFY(test_fes.GetVDim() == 1, "vector test spaces are not "
+               "supported");
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      // Same rule as in AssembleElementMatrix2()
+      const int order = trial_fe.GetOrder() + test_fe.GetOrder() - 1;
+      ir = &IntRules.Get(trial_fe.GetGeomType(), order);
+   }
+   dim = mesh->Dimension();
+   MFEM_VERIFY(dim == 2 || dim == 3, "Unknown kernel.");
+   ne = trial_fes.GetNE();
+   nq = ir->GetNPoints();
+   mapsC = &trial_el->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   mapsO = &trial_el->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+   L2mapsO = &test_el->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   dofs1D = mapsC->ndof;
+   quad1D = mapsC->nqpt;
+   testdofs1D = L2mapsO->ndof;
+   pa_data.SetSize(nq*ne, Device::GetMemoryType());
+   Vector coeff;
+   EvalCoefficientQVector(Q, *mesh, *ir, coeff);
+   PAHdivL2Setup(nq, ne, ir->GetWeights(), coeff, pa_data);
+}
+
+void VectorFEDivergenceIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   PAHdivL2Apply(dim, dofs1D, testdofs1D, quad1D, ne, mapsO->B, mapsC->G,
+                 L2mapsO->B, pa_data, x, y, false);
+}
+
+void VectorFEDivergenceIntegrator::AddMultTransposePA(const Vector &x,
+                                                      Vector &y) const
+{
+   PAHdivL2Apply(dim, dofs1D, testdofs1D, quad1D, ne, mapsO->B, mapsC->G,
+                 L2mapsO->B, pa_data, x, y, true);
+}
+
+void VectorFEDivergenceIntegrator::AssembleDiagonalPA_ADAt(const Vector &D,
+                                                           Vector &diag) const
+{
+   PAHdivL2DiagonalADAt(dim, dofs1D, testdofs1D, quad1D, ne, mapsO->B,
+                        mapsC->G, L2mapsO->B, pa_data, D, diag);
+}
+
+} // namespace mfem
@@ -38,22 +38,16 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
    dofs1D = maps->ndof;
    quad1D = maps->nqpt;
    pa_data.SetSize(ne*nq, Device::GetMemoryType());
-   ConstantCoefficient *const_coeff = dynamic_cast<ConstantCoefficient*>(Q);
-   // TODO: other types of coefficients ...
+   Vector coeff;
+   EvalCoefficientQVector(Q, *mesh, *ir, coeff);
    if (dim==1) { MFEM_ABORT("Not supported yet... stay tuned!"); }
    if (dim==2)
    {
-      double constant = 0.0;
-      if (const_coeff)
-      {
-         constant = const_coeff->constant;
-      }
-      else
-      {
-         MFEM_ABORT("Coefficient type not supported");
-      }
       const int NE = ne;
       const int NQ = nq;
+      const bool const_c = coeff.Size() == 1;
+      auto C = const_c ? Reshape(coeff.Read(), 1, 1) :
+               Reshape(coeff.Read(), NQ, NE);
       auto w = ir->GetWeights().Read();
       auto J = Reshape(geom->J.Read(), NQ,2,2,NE);
       auto v = Reshape(pa_data.Write(), NQ, NE);
@@ -66,23 +60,18 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
             const double J21 = J(q,0,1,e);
             const double J22 = J(q,1,1,e);
             const double detJ = (J11*J22)-(J21*J12);
-            v(q,e) =  w[q] * constant * detJ;
+            const double c = const_c ? C(0,0) : C(q,e);
+            v(q,e) =  w[q] * c * detJ;
          }
       });
    }
    if (dim==3)
    {
-      double constant = 0.0;
-      if (const_coeff)
-      {
-         constant = const_coeff->constant;
-      }
-      else
-      {
-         MFEM_ABORT("Coefficient type not supported");
-      }
       const int NE = ne;
       const int NQ = nq;
+      const bool const_c = coeff.Size() == 1;
+      auto C = const_c ? Reshape(coeff.Read(), 1, 1) :
+               Reshape(coeff.Read(), NQ, NE);
       auto W = ir->GetWeights().Read();
       auto J = Reshape(geom->J.Read(), NQ,3,3,NE);
       auto v = Reshape(pa_data.Write(), NQ,NE);
@@ -96,7 +85,8 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
             const double detJ = J11 * (J22 * J33 - J32 * J23) -
             /* */               J21 * (J12 * J33 - J32 * J13) +
             /* */               J31 * (J12 * J23 - J22 * J13);
-            v(q,e) = W[q] * constant * detJ;
+            const double c = const_c ? C(0,0) : C(q,e);
+            v(q,e) = W[q] * c * detJ;
          }
       });
    }
@@ -197,6 +187,7 @@ static void OccaPAMassApply3D(const int D1D,
 template<const int T_D1D = 0,
          const int T_Q1D = 0>
 static void PAMassApply2D(const int NE,
+                          const Array<int> *E,
                           const Array<double> &_B,
                           const Array<double> &_Bt,
                           const Vector &_op,
@@ -214,8 +205,11 @@ static void PAMassApply2D(const int NE,
    auto op = Reshape(_op.Read(), Q1D, Q1D, NE);
    auto x = Reshape(_x.Read(), D1D, D1D, NE);
    auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
-   MFEM_FORALL(e, NE,
+   const int NS = E ? E->Size() : NE;
+   const int *ids = E ? E->Read() : NULL;
+   MFEM_FORALL(i, NS,
    {
+      const int e = ids ? ids[i] : i;
       const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       // the following variables are evaluated at compile time
@@ -291,6 +285,7 @@ template<const int T_D1D = 0,
          const int T_Q1D = 0,
          const int T_NBZ = 0>
 static void SmemPAMassApply2D(const int NE,
+                              const Array<int> *E,
                               const Array<double> &_b,
                               const Array<double> &_bt,
                               const Vector &_op,
@@ -310,8 +305,11 @@ static void SmemPAMassApply2D(const int NE,
    auto op = Reshape(_op.Read(), Q1D, Q1D, NE);
    auto x = Reshape(_x.Read(), D1D, D1D, NE);
    auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
-   MFEM_FORALL_2D(e, NE, Q1D, Q1D, NBZ,
+   const int NS = E ? E->Size() : NE;
+   const int *ids = E ? E->Read() : NULL;
+   MFEM_FORALL_2D(i, NS, Q1D, Q1D, NBZ,
    {
+      const int e = ids ? ids[i] : i;
       const int tidz = MFEM_THREAD_ID(z);
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -414,6 +412,7 @@ static void SmemPAMassApply2D(const int NE,
 template<const int T_D1D = 0,
          const int T_Q1D = 0>
 static void PAMassApply3D(const int NE,
+                          const Array<int> *E,
                           const Array<double> &_B,
                           const Array<double> &_Bt,
                           const Vector &_op,
@@ -431,8 +430,11 @@ static void PAMassApply3D(const int NE,
    auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, NE);
    auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
    auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
-   MFEM_FORALL(e, NE,
+   const int NS = E ? E->Size() : NE;
+   const int *ids = E ? E->Read() : NULL;
+   MFEM_FORALL(i, NS,
    {
+      const int e = ids ? ids[i] : i;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
@@ -556,6 +558,7 @@ static void PAMassApply3D(const int NE,
 template<const int T_D1D = 0,
          const int T_Q1D = 0>
 static void SmemPAMassApply3D(const int NE,
+                              const Array<int> *E,
                               const Array<double> &_b,
                               const Array<double> &_bt,
                               const Vector &_op,
@@ -574,8 +577,11 @@ static void SmemPAMassApply3D(const int NE,
    auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, NE);
    auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
    auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
-   MFEM_FORALL_3D(e, NE, Q1D, Q1D, Q1D,
+   const int NS = E ? E->Size() : NE;
+   const int *ids = E ? E->Read() : NULL;
+   MFEM_FORALL_3D(i, NS, Q1D, Q1D, Q1D,
    {
+      const int e = ids ? ids[i] : i;
       const int tidz = MFEM_THREAD_ID(z);
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -727,6 +733,7 @@ static void PAMassApply(const int dim,
                         const int D1D,
                         const int Q1D,
                         const int NE,
+                        const Array<int> *E,
                         const Array<double> &B,
                         const Array<double> &Bt,
                         const Vector &op,
@@ -734,7 +741,8 @@ static void PAMassApply(const int dim,
                         Vector &y)
 {
 #ifdef MFEM_USE_OCCA
-   if (DeviceCanUseOcca())
+   // The OCCA kernels do not support subsets of the elements
+   if (DeviceCanUseOcca() && !E)
    {
       if (dim == 2)
       {
@@ -756,29 +764,29 @@ static void PAMassApply(const int dim,
       {
          switch ((D1D << 4 ) | Q1D)
          {
-            case 0x22: return PAMassApply2D<2,2>(NE, B, Bt, op, x, y);
-            case 0x33: return PAMassApply2D<3,3>(NE, B, Bt, op, x, y);
-            case 0x44: return PAMassApply2D<4,4>(NE, B, Bt, op, x, y);
-            case 0x55: return PAMassApply2D<5,5>(NE, B, Bt, op, x, y);
-            case 0x66: return PAMassApply2D<6,6>(NE, B, Bt, op, x, y);
-            case 0x77: return PAMassApply2D<7,7>(NE, B, Bt, op, x, y);
-            case 0x88: return PAMassApply2D<8,8>(NE, B, Bt, op, x, y);
-            case 0x99: return PAMassApply2D<9,9>(NE, B, Bt, op, x, y);
-            default:   return PAMassApply2D(NE, B, Bt, op, x, y, D1D, Q1D);
+            case 0x22: return PAMassApply2D<2,2>(NE, E, B, Bt, op, x, y);
+            case 0x33: return PAMassApply2D<3,3>(NE, E, B, Bt, op, x, y);
+            case 0x44: return PAMassApply2D<4,4>(NE, E, B, Bt, op, x, y);
+            case 0x55: return PAMassApply2D<5,5>(NE, E, B, Bt, op, x, y);
+            case 0x66: return PAMassApply2D<6,6>(NE, E, B, Bt, op, x, y);
+            case 0x77: return PAMassApply2D<7,7>(NE, E, B, Bt, op, x, y);
+            case 0x88: return PAMassApply2D<8,8>(NE, E, B, Bt, op, x, y);
+            case 0x99: return PAMassApply2D<9,9>(NE, E, B, Bt, op, x, y);
+            default:   return PAMassApply2D(NE, E, B, Bt, op, x, y, D1D, Q1D);
          }
       }
       if (dim == 3)
       {
          switch ((D1D << 4 ) | Q1D)
          {
-            case 0x23: return PAMassApply3D<2,3>(NE, B, Bt, op, x, y);
-            case 0x34: return PAMassApply3D<3,4>(NE, B, Bt, op, x, y);
-            case 0x45: return PAMassApply3D<4,5>(NE, B, Bt, op, x, y);
-            case 0x56: return PAMassApply3D<5,6>(NE, B, Bt, op, x, y);
-            case 0x67: return PAMassApply3D<6,7>(NE, B, Bt, op, x, y);
-            case 0x78: return PAMassApply3D<7,8>(NE, B, Bt, op, x, y);
-            case 0x89: return PAMassApply3D<8,9>(NE, B, Bt, op, x, y);
-            default:   return PAMassApply3D(NE, B, Bt, op, x, y, D1D, Q1D);
+            case 0x23: return PAMassApply3D<2,3>(NE, E, B, Bt, op, x, y);
+            case 0x34: return PAMassApply3D<3,4>(NE, E, B, Bt, op, x, y);
+            case 0x45: return PAMassApply3D<4,5>(NE, E, B, Bt, op, x, y);
+            case 0x56: return PAMassApply3D<5,6>(NE, E, B, Bt, op, x, y);
+            case 0x67: return PAMassApply3D<6,7>(NE, E, B, Bt, op, x, y);
+            case 0x78: return PAMassApply3D<7,8>(NE, E, B, Bt, op, x, y);
+            case 0x89: return PAMassApply3D<8,9>(NE, E, B, Bt, op, x, y);
+            default:   return PAMassApply3D(NE, E, B, Bt, op, x, y, D1D, Q1D);
          }
       }
    }
@@ -786,29 +794,29 @@ static void PAMassApply(const int dim,
    {
       switch ((D1D << 4 ) | Q1D)
       {
-         case 0x22: return SmemPAMassApply2D<2,2,16>(NE, B, Bt, op, x, y);
-         case 0x33: return SmemPAMassApply2D<3,3,16>(NE, B, Bt, op, x, y);
-         case 0x44: return SmemPAMassApply2D<4,4,8>(NE, B, Bt, op, x, y);
-         case 0x55: return SmemPAMassApply2D<5,5,8>(NE, B, Bt, op, x, y);
-         case 0x66: return SmemPAMassApply2D<6,6,4>(NE, B, Bt, op, x, y);
-         case 0x77: return SmemPAMassApply2D<7,7,4>(NE, B, Bt, op, x, y);
-         case 0x88: return SmemPAMassApply2D<8,8,2>(NE, B, Bt, op, x, y);
-         case 0x99: return SmemPAMassApply2D<9,9,2>(NE, B, Bt, op, x, y);
-         default:   return PAMassApply2D(NE, B, Bt, op, x, y, D1D, Q1D);
+         case 0x22: return SmemPAMassApply2D<2,2,16>(NE, E, B, Bt, op, x, y);
+         case 0x33: return SmemPAMassApply2D<3,3,16>(NE, E, B, Bt, op, x, y);
+         case 0x44: return SmemPAMassApply2D<4,4,8>(NE, E, B, Bt, op, x, y);
+         case 0x55: return SmemPAMassApply2D<5,5,8>(NE, E, B, Bt, op, x, y);
+         case 0x66: return SmemPAMassApply2D<6,6,4>(NE, E, B, Bt, op, x, y);
+         case 0x77: return SmemPAMassApply2D<7,7,4>(NE, E, B, Bt, op, x, y);
+         case 0x88: return SmemPAMassApply2D<8,8,2>(NE, E, B, Bt, op, x, y);
+         case 0x99: return SmemPAMassApply2D<9,9,2>(NE, E, B, Bt, op, x, y);
+         default:   return PAMassApply2D(NE, E, B, Bt, op, x, y, D1D, Q1D);
       }
    }
    else if (dim == 3)
    {
       switch ((D1D << 4 ) | Q1D)
       {
-         case 0x23: return SmemPAMassApply3D<2,3>(NE, B, Bt, op, x, y);
-         case 0x34: return SmemPAMassApply3D<3,4>(NE, B, Bt, op, x, y);
-         case 0x45: return SmemPAMassApply3D<4,5>(NE, B, Bt, op, x, y);
-         case 0x56: return SmemPAMassApply3D<5,6>(NE, B, Bt, op, x, y);
-         case 0x67: return SmemPAMassApply3D<6,7>(NE, B, Bt, op, x, y);
-         case 0x78: return SmemPAMassApply3D<7,8>(NE, B, Bt, op, x, y);
-         case 0x89: return SmemPAMassApply3D<8,9>(NE, B, Bt, op, x, y);
-         default:   return PAMassApply3D(NE, B, Bt, op, x, y, D1D, Q1D);
+         case 0x23: return SmemPAMassApply3D<2,3>(NE, E, B, Bt, op, x, y);
+         case 0x34: return SmemPAMassApply3D<3,4>(NE, E, B, Bt, op, x, y);
+         case 0x45: return SmemPAMassApply3D<4,5>(NE, E, B, Bt, op, x, y);
+         case 0x56: return SmemPAMassApply3D<5,6>(NE, E, B, Bt, op, x, y);
+         case 0x67: return SmemPAMassApply3D<6,7>(NE, E, B, Bt, op, x, y);
+         case 0x78: return SmemPAMassApply3D<7,8>(NE, E, B, Bt, op, x, y);
+         case 0x89: return SmemPAMassApply3D<8,9>(NE, E, B, Bt, op, x, y);
+         default:   return PAMassApply3D(NE, E, B, Bt, op, x, y, D1D, Q1D);
       }
    }
    MFEM_ABORT("Unknown kernel.");
@@ -816,7 +824,833 @@ static void PAMassApply(const int dim,
 
 void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
 {
-   PAMassApply(dim, dofs1D, quad1D, ne, maps->B, maps->Bt, pa_data, x, y);
+   PAMassApply(dim, dofs1D, quad1D, ne, NULL, maps->B, maps->Bt, pa_data, x, y);
+}
+
+void MassIntegrator::AddMultPAElements(const Vector &x, Vector &y,
+                                       const Array<int> &elems) const
+{
+   PAMassApply(dim, dofs1D, quad1D, ne, &elems, maps->B, maps->Bt, pa_data,
+               x, y);
+}
+
+// PA Mass Diagonal 2D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void PAMassAssembleDiagonal2D(const int NE,
+                                     const Array<double> &b,
+                                     const Vector &_op,
+                                     Vector &_diag,
+                                     const int d1d = 0,
+                                     const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, NE);
+   auto Y = Reshape(_diag.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double QD[max_Q1D][max_D1D];
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            QD[qx][dy] = 0.0;
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               QD[qx][dy] += B(qy,dy) * B(qy,dy) * op(qx,qy,e);
+            }
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            double val = 0.0;
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               val += B(qx,dx) * B(qx,dx) * QD[qx][dy];
+            }
+            Y(dx,dy,e) += val;
+         }
+      }
+   });
+}
+
+// PA Mass Diagonal 3D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void PAMassAssembleDiagonal3D(const int NE,
+                                     const Array<double> &b,
+                                     const Vector &_op,
+                                     Vector &_diag,
+                                     const int d1d = 0,
+                                     const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, NE);
+   auto Y = Reshape(_diag.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double QQD[max_Q1D][max_Q1D][max_D1D];
+      double QDD[max_Q1D][max_D1D][max_D1D];
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               QQD[qx][qy][dz] = 0.0;
+               for (int qz = 0; qz < Q1D; ++qz)
+               {
+                  QQD[qx][qy][dz] += B(qz,dz) * B(qz,dz) * op(qx,qy,qz,e);
+               }
+            }
+         }
+      }
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               QDD[qx][dy][dz] = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  QDD[qx][dy][dz] += B(qy,dy) * B(qy,dy) * QQD[qx][qy][dz];
+               }
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double val = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  val += B(qx,dx) * B(qx,dx) * QDD[qx][dy][dz];
+               }
+               Y(dx,dy,dz,e) += val;
+            }
+         }
+      }
+   });
+}
+
+static void PAMassAssembleDiagonal(const int dim,
+                                   const int D1D,
+                                   const int Q1D,
+                                   const int NE,
+                                   const Array<double> &B,
+                                   const Vector &op,
+                                   Vector &diag)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22: return PAMassAssembleDiagonal2D<2,2>(NE, B, op, diag);
+         case 0x33: return PAMassAssembleDiagonal2D<3,3>(NE, B, op, diag);
+         case 0x44: return PAMassAssembleDiagonal2D<4,4>(NE, B, op, diag);
+         case 0x55: return PAMassAssembleDiagonal2D<5,5>(NE, B, op, diag);
+         case 0x66: return PAMassAssembleDiagonal2D<6,6>(NE, B, op, diag);
+         default:
+            return PAMassAssembleDiagonal2D(NE, B, op, diag, D1D, Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23: return PAMassAssembleDiagonal3D<2,3>(NE, B, op, diag);
+         case 0x34: return PAMassAssembleDiagonal3D<3,4>(NE, B, op, diag);
+         case 0x45: return PAMassAssembleDiagonal3D<4,5>(NE, B, op, diag);
+         case 0x56: return PAMassAssembleDiagonal3D<5,6>(NE, B, op, diag);
+         default:
+            return PAMassAssembleDiagonal3D(NE, B, op, diag, D1D, Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void MassIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   PAMassAssembleDiagonal(dim, dofs1D, quad1D, ne, maps->B, pa_data, diag);
+}
+
+// MF Mass Integrator
+
+// MF Mass Assemble: only the mesh nodes are stored, in an E-vector
+void MassIntegrator::AssembleMF(const FiniteElementSpace &fes)
+{
+   // Assuming the same element type
+   Mesh *mesh = fes.GetMesh();
+   ne = fes.GetNE();
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   ElementTransformation *T = mesh->GetElementTransformation(0);
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el, *T);
+   dim = mesh->Dimension();
+   MFEM_VERIFY(dim == 2 || dim == 3, "dim = " << dim << " is not supported");
+   MFEM_VERIFY(mesh->SpaceDimension() == dim,
+               "surface meshes are not supported");
+   nq = ir->GetNPoints();
+   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   mf_coeff = 1.0;
+   if (Q)
+   {
+      ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q);
+      MFEM_VERIFY(cQ != NULL, "only ConstantCoefficient is supported!");
+      mf_coeff = cQ->constant;
+   }
+   mesh->EnsureNodes();
+   const GridFunction *nodes = mesh->GetNodes();
+   const FiniteElementSpace *nfes = nodes->FESpace();
+   const Operator *restr =
+      nfes->GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC);
+   MFEM_VERIFY(restr, "discontinuous mesh nodes are not supported");
+   mf_node_maps = &nfes->GetFE(0)->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   mf_nodes.SetSize(restr->Height(), Device::GetMemoryType());
+   restr->Mult(*nodes, mf_nodes);
+}
+
+// MF Mass Apply 2D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void MFMassApply2D(const int NE,
+                          const Array<double> &_B,
+                          const Array<double> &_Bt,
+                          const Array<double> &_NB,
+                          const Array<double> &_NG,
+                          const Array<double> &_W,
+                          const Vector &_X,
+                          const double COEFF,
+                          const Vector &_x,
+                          Vector &_y,
+                          const int nd1d,
+                          const int d1d = 0,
+                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int ND1D = nd1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(ND1D <= MAX_D1D, "");
+   auto B = Reshape(_B.Read(), Q1D, D1D);
+   auto Bt = Reshape(_Bt.Read(), D1D, Q1D);
+   auto NB = Reshape(_NB.Read(), Q1D, ND1D);
+   auto NG = Reshape(_NG.Read(), Q1D, ND1D);
+   auto W = Reshape(_W.Read(), Q1D, Q1D);
+   auto X = Reshape(_X.Read(), ND1D, ND1D, 2, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // Jacobian of the element transformation at the quadrature points
+      double Jq[max_Q1D][max_Q1D][2][2];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            Jq[qy][qx][0][0] = Jq[qy][qx][0][1] = 0.0;
+            Jq[qy][qx][1][0] = Jq[qy][qx][1][1] = 0.0;
+         }
+      }
+      for (int c = 0; c < 2; ++c)
+      {
+         for (int ny = 0; ny < ND1D; ++ny)
+         {
+            double gradX[max_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] = 0.0;
+               gradX[qx][1] = 0.0;
+            }
+            for (int nx = 0; nx < ND1D; ++nx)
+            {
+               const double s = X(nx,ny,c,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] += s * NB(qx,nx);
+                  gradX[qx][1] += s * NG(qx,nx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = NB(qy,ny);
+               const double wDy = NG(qy,ny);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  Jq[qy][qx][c][0] += gradX[qx][1] * wy;
+                  Jq[qy][qx][c][1] += gradX[qx][0] * wDy;
+               }
+            }
+         }
+      }
+      double sol_xy[max_Q1D][max_Q1D];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            sol_xy[qy][qx] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double sol_x[max_Q1D];
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            sol_x[qx] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const double s = x(dx,dy,e);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_x[qx] += B(qx,dx) * s;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double d2q = B(qy,dy);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xy[qy][qx] += d2q * sol_x[qx];
+            }
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double J11 = Jq[qy][qx][0][0], J12 = Jq[qy][qx][0][1];
+            const double J21 = Jq[qy][qx][1][0], J22 = Jq[qy][qx][1][1];
+            const double detJ = (J11*J22)-(J21*J12);
+            sol_xy[qy][qx] *= W(qx,qy) * COEFF * detJ;
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double sol_x[max_D1D];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            sol_x[dx] = 0.0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double s = sol_xy[qy][qx];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_x[dx] += Bt(dx,qx) * s;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double q2d = Bt(dy,qy);
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               y(dx,dy,e) += q2d * sol_x[dx];
+            }
+         }
+      }
+   });
+}
+
+// MF Mass Apply 3D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void MFMassApply3D(const int NE,
+                          const Array<double> &_B,
+                          const Array<double> &_Bt,
+                          const Array<double> &_NB,
+                          const Array<double> &_NG,
+                          const Array<double> &_W,
+                          const Vector &_X,
+                          const double COEFF,
+                          const Vector &_x,
+                          Vector &_y,
+                          const int nd1d,
+                          const int d1d = 0,
+                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int ND1D = nd1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(ND1D <= MAX_D1D, "");
+   auto B = Reshape(_B.Read(), Q1D, D1D);
+   auto Bt = Reshape(_Bt.Read(), D1D, Q1D);
+   auto NB = Reshape(_NB.Read(), Q1D, ND1D);
+   auto NG = Reshape(_NG.Read(), Q1D, ND1D);
+   auto W = Reshape(_W.Read(), Q1D, Q1D, Q1D);
+   auto X = Reshape(_X.Read(), ND1D, ND1D, ND1D, 3, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // Jacobian of the element transformation at the quadrature points
+      double Jq[max_Q1D][max_Q1D][max_Q1D][3][3];
+      for (int c = 0; c < 3; ++c)
+      {
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  Jq[qz][qy][qx][c][0] = 0.0;
+                  Jq[qz][qy][qx][c][1] = 0.0;
+                  Jq[qz][qy][qx][c][2] = 0.0;
+               }
+            }
+         }
+         for (int nz = 0; nz < ND1D; ++nz)
+         {
+            double gradXY[max_Q1D][max_Q1D][3];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradXY[qy][qx][0] = 0.0;
+                  gradXY[qy][qx][1] = 0.0;
+                  gradXY[qy][qx][2] = 0.0;
+               }
+            }
+            for (int ny = 0; ny < ND1D; ++ny)
+            {
+               double gradX[max_Q1D][2];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] = 0.0;
+                  gradX[qx][1] = 0.0;
+               }
+               for (int nx = 0; nx < ND1D; ++nx)
+               {
+                  const double s = X(nx,ny,nz,c,e);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     gradX[qx][0] += s * NB(qx,nx);
+                     gradX[qx][1] += s * NG(qx,nx);
+                  }
+               }
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy  = NB(qy,ny);
+                  const double wDy = NG(qy,ny);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     gradXY[qy][qx][0] += gradX[qx][1] * wy;
+                     gradXY[qy][qx][1] += gradX[qx][0] * wDy;
+                     gradXY[qy][qx][2] += gradX[qx][0] * wy;
+                  }
+               }
+            }
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               const double wz  = NB(qz,nz);
+               const double wDz = NG(qz,nz);
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     Jq[qz][qy][qx][c][0] += gradXY[qy][qx][0] * wz;
+                     Jq[qz][qy][qx][c][1] += gradXY[qy][qx][1] * wz;
+                     Jq[qz][qy][qx][c][2] += gradXY[qy][qx][2] * wDz;
+                  }
+               }
+            }
+         }
+      }
+      double sol_xyz[max_Q1D][max_Q1D][max_Q1D];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xyz[qz][qy][qx] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double sol_xy[max_Q1D][max_Q1D];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xy[qy][qx] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double sol_x[max_Q1D];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_x[qx] = 0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double s = x(dx,dy,dz,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_x[qx] += B(qx,dx) * s;
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = B(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xy[qy][qx] += wy * sol_x[qx];
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz = B(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xyz[qz][qy][qx] += wz * sol_xy[qy][qx];
+               }
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double (&J)[3][3] = Jq[qz][qy][qx];
+               const double J11 = J[0][0], J12 = J[0][1], J13 = J[0][2];
+               const double J21 = J[1][0], J22 = J[1][1], J23 = J[1][2];
+               const double J31 = J[2][0], J32 = J[2][1], J33 = J[2][2];
+               const double detJ = J11 * (J22 * J33 - J32 * J23) -
+               /* */               J21 * (J12 * J33 - J32 * J13) +
+               /* */               J31 * (J12 * J23 - J22 * J13);
+               sol_xyz[qz][qy][qx] *= W(qx,qy,qz) * COEFF * detJ;
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double sol_xy[max_D1D][max_D1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_xy[dy][dx] = 0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double sol_x[max_D1D];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_x[dx] = 0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double s = sol_xyz[qz][qy][qx];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_x[dx] += Bt(dx,qx) * s;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy = Bt(dy,qy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_xy[dy][dx] += wy * sol_x[dx];
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz = Bt(dz,qz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  y(dx,dy,dz,e) += wz * sol_xy[dy][dx];
+               }
+            }
+         }
+      }
+   });
+}
+
+static void MFMassApply(const int dim,
+                        const int D1D,
+                        const int Q1D,
+                        const int ND1D,
+                        const int NE,
+                        const Array<double> &B,
+                        const Array<double> &Bt,
+                        const Array<double> &NB,
+                        const Array<double> &NG,
+                        const Array<double> &W,
+                        const Vector &X,
+                        const double COEFF,
+                        const Vector &x,
+                        Vector &y)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22: return MFMassApply2D<2,2>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         case 0x33: return MFMassApply2D<3,3>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         case 0x44: return MFMassApply2D<4,4>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         case 0x55: return MFMassApply2D<5,5>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         default:   return MFMassApply2D(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D,
+                                            D1D,Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23: return MFMassApply3D<2,3>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         case 0x34: return MFMassApply3D<3,4>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         case 0x45: return MFMassApply3D<4,5>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         case 0x56: return MFMassApply3D<5,6>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         case 0x67: return MFMassApply3D<6,7>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         case 0x78: return MFMassApply3D<7,8>(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D);
+         default:   return MFMassApply3D(NE,B,Bt,NB,NG,W,X,COEFF,x,y,ND1D,
+                                            D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void MassIntegrator::AddMultMF(const Vector &x, Vector &y) const
+{
+   if (ne == 0) { return; }
+   MFMassApply(dim, dofs1D, quad1D, mf_node_maps->ndof, ne,
+               maps->B, maps->Bt, mf_node_maps->B, mf_node_maps->G,
+               maps->IntRule->GetWeights(), mf_nodes, mf_coeff, x, y);
+}
+
+// EA Mass Assemble 2D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void EAMassAssemble2D(const int NE,
+                             const Array<double> &_B,
+                             const Vector &_op,
+                             Vector &_A,
+                             const bool add,
+                             const int d1d = 0,
+                             const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(_B.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, NE);
+   auto A = Reshape(add ? _A.ReadWrite() : _A.Write(),
+                    D1D, D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double op_x[max_Q1D];
+      for (int i1 = 0; i1 < D1D; ++i1)
+      {
+         for (int j1 = 0; j1 < D1D; ++j1)
+         {
+            // contract the x quadrature points first
+            for (int k2 = 0; k2 < Q1D; ++k2)
+            {
+               double u = 0.0;
+               for (int k1 = 0; k1 < Q1D; ++k1)
+               {
+                  u += B(k1,i1) * B(k1,j1) * op(k1,k2,e);
+               }
+               op_x[k2] = u;
+            }
+            for (int i2 = 0; i2 < D1D; ++i2)
+            {
+               for (int j2 = 0; j2 < D1D; ++j2)
+               {
+                  double val = 0.0;
+                  for (int k2 = 0; k2 < Q1D; ++k2)
+                  {
+                     val += B(k2,i2) * B(k2,j2) * op_x[k2];
+                  }
+                  if (add) { A(i1,i2,j1,j2,e) += val; }
+                  else { A(i1,i2,j1,j2,e) = val; }
+               }
+            }
+         }
+      }
+   });
+}
+
+// EA Mass Assemble 3D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void EAMassAssemble3D(const int NE,
+                             const Array<double> &_B,
+                             const Vector &_op,
+                             Vector &_A,
+                             const bool add,
+                             const int d1d = 0,
+                             const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(_B.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, NE);
+   auto A = Reshape(add ? _A.ReadWrite() : _A.Write(),
+                    D1D, D1D, D1D, D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double op_x[max_Q1D][max_Q1D];
+      double op_xy[max_Q1D];
+      for (int i1 = 0; i1 < D1D; ++i1)
+      {
+         for (int j1 = 0; j1 < D1D; ++j1)
+         {
+            for (int k3 = 0; k3 < Q1D; ++k3)
+            {
+               for (int k2 = 0; k2 < Q1D; ++k2)
+               {
+                  double u = 0.0;
+                  for (int k1 = 0; k1 < Q1D; ++k1)
+                  {
+                     u += B(k1,i1) * B(k1,j1) * op(k1,k2,k3,e);
+                  }
+                  op_x[k3][k2] = u;
+               }
+            }
+            for (int i2 = 0; i2 < D1D; ++i2)
+            {
+               for (int j2 = 0; j2 < D1D; ++j2)
+               {
+                  for (int k3 = 0; k3 < Q1D; ++k3)
+                  {
+                     double u = 0.0;
+                     for (int k2 = 0; k2 < Q1D; ++k2)
+                     {
+                        u += B(k2,i2) * B(k2,j2) * op_x[k3][k2];
+                     }
+                     op_xy[k3] = u;
+                  }
+                  for (int i3 = 0; i3 < D1D; ++i3)
+                  {
+                     for (int j3 = 0; j3 < D1D; ++j3)
+                     {
+                        double val = 0.0;
+                        for (int k3 = 0; k3 < Q1D; ++k3)
+                        {
+                           val += B(k3,i3) * B(k3,j3) * op_xy[k3];
+                        }
+                        if (add) { A(i1,i2,i3,j1,j2,j3,e) += val; }
+                        else { A(i1,i2,i3,j1,j2,j3,e) = val; }
+                     }
+                  }
+               }
+            }
+         }
+      }
+   });
+}
+
+static void EAMassAssemble(const int dim,
+                           const int D1D,
+                           const int Q1D,
+                           const int NE,
+                           const Array<double> &B,
+                           const Vector &op,
+                           Vector &A,
+                           const bool add)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22: return EAMassAssemble2D<2,2>(NE, B, op, A, add);
+         case 0x33: return EAMassAssemble2D<3,3>(NE, B, op, A, add);
+         case 0x44: return EAMassAssemble2D<4,4>(NE, B, op, A, add);
+         case 0x55: return EAMassAssemble2D<5,5>(NE, B, op, A, add);
+         case 0x66: return EAMassAssemble2D<6,6>(NE, B, op, A, add);
+         default:   return EAMassAssemble2D(NE, B, op, A, add, D1D, Q1D);
+      }
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23: return EAMassAssemble3D<2,3>(NE, B, op, A, add);
+         case 0x34: return EAMassAssemble3D<3,4>(NE, B, op, A, add);
+         case 0x45: return EAMassAssemble3D<4,5>(NE, B, op, A, add);
+         case 0x56: return EAMassAssemble3D<5,6>(NE, B, op, A, add);
+         default:   return EAMassAssemble3D(NE, B, op, A, add, D1D, Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void MassIntegrator::AssembleEA(const FiniteElementSpace &fes, Vector &emat,
+                                const bool add)
+{
+   // The batched kernels reuse the partial assembly data and therefore have
+   // the same restrictions as AssemblePA().
+   const int ne = fes.GetNE();
+   if (ne == 0) { return; }
+   const int el_dim = fes.GetFE(0)->GetDim();
+   const bool tensor =
+      dynamic_cast<const TensorBasisElement*>(fes.GetFE(0)) != NULL;
+   if (!tensor || fes.GetVDim() != 1 || (el_dim != 2 && el_dim != 3))
+   {
+      BilinearFormIntegrator::AssembleEA(fes, emat, add);
+      return;
+   }
+   AssemblePA(fes);
+   EAMassAssemble(dim, dofs1D, quad1D, ne, maps->B, pa_data, emat, add);
 }
 
 } // namespace mfem
@@ -0,0 +1,179 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BILININTEG_VECTORFE
+#define MFEM_BILININTEG_VECTORFE
+
+#include "../config/config.hpp"
+#include "../general/forall.hpp"
+#include "../linalg/vector.hpp"
+
+namespace mfem
+{
+
+// Internal helpers shared by the partial assembly kernels of the integrators
+// on the H(curl) and H(div) tensor-product elements, see
+// VectorTensorFiniteElement. The E-vectors of these elements store the
+// components one after the other, each in lexicographic order. Component c of
+// a Nedelec element is the tensor product of the open 1D basis in direction c
+// and of the closed 1D basis in the other directions; for a Raviart-Thomas
+// element the roles of the two bases are swapped.
+namespace internal
+{
+
+// Sum-factorized interpolation of one component, X, with the 1D matrices Ax
+// and Ay of sizes Q1D x DX and Q1D x DY: Y(comp,qx,qy) += s*(Ax x Ay) X.
+MFEM_HOST_DEVICE inline
+void TensorEval2D(const int DX, const int DY, const int Q1D,
+                  const double *Ax, const double *Ay, const double *X,
+                  const int ncomp, const int comp, const double s, double *Y)
+{
+   for (int dy = 0; dy < DY; ++dy)
+   {
+      double aX[MAX_Q1D];
+      for (int qx = 0; qx < Q1D; ++qx) { aX[qx] = 0.0; }
+      for (int dx = 0; dx < DX; ++dx)
+      {
+         const double t = X[dx + DX*dy];
+         for (int qx = 0; qx < Q1D; ++qx) { aX[qx] += t * Ax[qx + Q1D*dx]; }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         const double wy = s * Ay[qy + Q1D*dy];
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            Y[comp + ncomp*(qx + Q1D*qy)] += aX[qx] * wy;
+         }
+      }
+   }
+}
+
+// Transpose of TensorEval2D: Y += s*(Ax x Ay)^T X(comp,:,:).
+MFEM_HOST_DEVICE inline
+void TensorEvalT2D(const int DX, const int DY, const int Q1D,
+                   const double *Ax, const double *Ay, const double *X,
+                   const int ncomp, const int comp, const double s, double *Y)
+{
+   for (int qy = 0; qy < Q1D; ++qy)
+   {
+      double aX[MAX_D1D];
+      for (int dx = 0; dx < DX; ++dx) { aX[dx] = 0.0; }
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         const double t = X[comp + ncomp*(qx + Q1D*qy)];
+         for (int dx = 0; dx < DX; ++dx) { aX[dx] += t * Ax[qx + Q1D*dx]; }
+      }
+      for (int dy = 0; dy < DY; ++dy)
+      {
+         const double wy = s * Ay[qy + Q1D*dy];
+         for (int dx = 0; dx < DX; ++dx) { Y[dx + DX*dy] += aX[dx] * wy; }
+      }
+   }
+}
+
+// Sum-factorized interpolation of one component in 3D:
+// Y(comp,qx,qy,qz) += s*(Ax x Ay x Az) X.
+MFEM_HOST_DEVICE inline
+void TensorEval3D(const int DX, const int DY, const int DZ, const int Q1D,
+                  const double *Ax, const double *Ay, const double *Az,
+                  const double *X, const int ncomp, const int comp,
+                  const double s, double *Y)
+{
+   for (int dz = 0; dz < DZ; ++dz)
+   {
+      double aXY[MAX_Q1D][MAX_Q1D];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx) { aXY[qy][qx] = 0.0; }
+      }
+      for (int dy = 0; dy < DY; ++dy)
+      {
+         double aX[MAX_Q1D];
+         for (int qx = 0; qx < Q1D; ++qx) { aX[qx] = 0.0; }
+         for (int dx = 0; dx < DX; ++dx)
+         {
+            const double t = X[dx + DX*(dy + DY*dz)];
+            for (int qx = 0; qx < Q1D; ++qx) { aX[qx] += t * Ax[qx + Q1D*dx]; }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double wy = Ay[qy + Q1D*dy];
+            for (int qx = 0; qx < Q1D; ++qx) { aXY[qy][qx] += aX[qx] * wy; }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         const double wz = s * Az[qz + Q1D*dz];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               Y[comp + ncomp*(qx + Q1D*(qy + Q1D*qz))] += aXY[qy][qx] * wz;
+            }
+         }
+      }
+   }
+}
+
+// Transpose of TensorEval3D: Y += s*(Ax x Ay x Az)^T X(comp,:,:,:).
+MFEM_HOST_DEVICE inline
+void TensorEvalT3D(const int DX, const int DY, const int DZ, const int Q1D,
+                   const double *Ax, const double *Ay, const double *Az,
+                   const double *X, const int ncomp, const int comp,
+                   const double s, double *Y)
+{
+   for (int qz = 0; qz < Q1D; ++qz)
+   {
+      double aXY[MAX_D1D][MAX_D1D];
+      for (int dy = 0; dy < DY; ++dy)
+      {
+         for (int dx = 0; dx < DX; ++dx) { aXY[dy][dx] = 0.0; }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double aX[MAX_D1D];
+         for (int dx = 0; dx < DX; ++dx) { aX[dx] = 0.0; }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double t = X[comp + ncomp*(qx + Q1D*(qy + Q1D*qz))];
+            for (int dx = 0; dx < DX; ++dx) { aX[dx] += t * Ax[qx + Q1D*dx]; }
+         }
+         for (int dy = 0; dy < DY; ++dy)
+         {
+            const double wy = Ay[qy + Q1D*dy];
+            for (int dx = 0; dx < DX; ++dx) { aXY[dy][dx] += aX[dx] * wy; }
+         }
+      }
+      for (int dz = 0; dz < DZ; ++dz)
+      {
+         const double wz = s * Az[qz + Q1D*dz];
+         for (int dy = 0; dy < DY; ++dy)
+         {
+            for (int dx = 0; dx < DX; ++dx)
+            {
+               Y[dx + DX*(dy + DY*dz)] += aXY[dy][dx] * wz;
+            }
+         }
+      }
+   }
+}
+
+/// Setup of the H(div) mass quadrature data, W*c/detJ J^T J, see
+/// VectorFEMassIntegrator::AssemblePA(). Defined in bilininteg_hdiv.cpp.
+void PAHdivMassSetup(const int dim, const int NQ, const int NE,
+                     const Array<double> &w, const Vector &j,
+                     const Vector &coeff, Vector &op);
+
+} // namespace internal
+
+} // namespace mfem
+
+#endif
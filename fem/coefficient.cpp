@@ -12,6 +12,7 @@
 // Implementation of Coefficient class
 
 #include "fem.hpp"
+#include "../general/forall.hpp"
 
 #include <cmath>
 #include <limits>
@@ -696,6 +697,129 @@ double ComputeLpNorm(double p, VectorCoefficient &coeff, Mesh &mesh,
    return norm;
 }
 
+void EvalCoefficientQVector(Coefficient *coeff, Mesh &mesh,
+                            const IntegrationRule &ir, Vector &qvec)
+{
+   const int ne = mesh.GetNE();
+   const int nq = ir.GetNPoints();
+
+   if (coeff == NULL)
+   {
+      qvec.SetSize(1);
+      qvec(0) = 1.0;
+      return;
+   }
+   if (ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(coeff))
+   {
+      qvec.SetSize(1);
+      qvec(0) = cQ->constant;
+      return;
+   }
+
+   qvec.SetSize(nq*ne, Device::GetMemoryType());
+   if (ne == 0) { return; }
+
+   // Scalar grid functions are interpolated in bulk, from their E-vector
+   GridFunctionCoefficient *gfQ = dynamic_cast<GridFunctionCoefficient*>(coeff);
+   const GridFunction *gf = gfQ ? gfQ->GetGridFunction() : NULL;
+   if (gf && gf->FESpace()->GetMesh() == &mesh &&
+       gf->FESpace()->GetVDim() == 1 && !gf->FESpace()->GetNURBSext() &&
+       (mesh.Dimension() == 2 || mesh.Dimension() == 3))
+   {
+      const FiniteElementSpace &gf_fes = *gf->FESpace();
+      const Operator *restr =
+         gf_fes.GetElementRestriction(ElementDofOrdering::NATIVE);
+      const QuadratureInterpolator *qi = gf_fes.GetQuadratureInterpolator(ir);
+      Vector q_der, q_det;
+      if (restr)
+      {
+         Vector e_vec(restr->Height(), Device::GetMemoryType());
+         restr->Mult(*gf, e_vec);
+         qi->Mult(e_vec, QuadratureInterpolator::VALUES, qvec, q_der, q_det);
+      }
+      else
+      {
+         qi->Mult(*gf, QuadratureInterpolator::VALUES, qvec, q_der, q_det);
+      }
+      return;
+   }
+
+   auto C = Reshape(qvec.HostWrite(), nq, ne);
+   PWConstCoefficient *pwQ = dynamic_cast<PWConstCoefficient*>(coeff);
+   for (int e = 0; e < ne; e++)
+   {
+      if (pwQ)
+      {
+         const double c = (*pwQ)(mesh.GetAttribute(e));
+         for (int q = 0; q < nq; q++) { C(q,e) = c; }
+         continue;
+      }
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         C(q,e) = coeff->Eval(T, ip);
+      }
+   }
+}
+
+void EvalCoefficientQVector(MatrixCoefficient &coeff, Mesh &mesh,
+                            const IntegrationRule &ir, Vector &qvec)
+{
+   const int ne = mesh.GetNE();
+   const int nq = ir.GetNPoints();
+   const int h = coeff.GetHeight();
+   const int w = coeff.GetWidth();
+
+   qvec.SetSize(nq*h*w*ne, Device::GetMemoryType());
+   auto C = Reshape(qvec.HostWrite(), nq, h, w, ne);
+   DenseMatrix M(h, w);
+   for (int e = 0; e < ne; e++)
+   {
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         coeff.Eval(M, T, ip);
+         for (int j = 0; j < w; j++)
+         {
+            for (int i = 0; i < h; i++)
+            {
+               C(q,i,j,e) = M(i,j);
+            }
+         }
+      }
+   }
+}
+
+void EvalCoefficientQVector(VectorCoefficient &coeff, Mesh &mesh,
+                            const IntegrationRule &ir, Vector &qvec)
+{
+   const int ne = mesh.GetNE();
+   const int nq = ir.GetNPoints();
+   const int vdim = coeff.GetVDim();
+
+   qvec.SetSize(nq*vdim*ne, Device::GetMemoryType());
+   auto C = Reshape(qvec.HostWrite(), nq, vdim, ne);
+   Vector V(vdim);
+   for (int e = 0; e < ne; e++)
+   {
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T.SetIntPoint(&ip);
+         coeff.Eval(V, T, ip);
+         for (int i = 0; i < vdim; i++)
+         {
+            C(q,i,e) = V(i);
+         }
+      }
+   }
+}
+
 #ifdef MFEM_USE_MPI
 double ComputeGlobalLpNorm(double p, Coefficient &coeff, ParMesh &pmesh,
                            const IntegrationRule *irs[])
@@ -955,6 +955,36 @@ double ComputeLpNorm(double p, Coefficient &coeff, Mesh &mesh,
 double ComputeLpNorm(double p, VectorCoefficient &coeff, Mesh &mesh,
                      const IntegrationRule *irs[]);
 
+/** @brief Evaluate the coefficient @a coeff at the points of the integration
+    rule @a ir in all elements of @a mesh, i.e. compute its Q-vector.
+
+    The result is stored in @a qvec with a column-major layout with dimensions
+    (NQ x NE), where NQ is the number of points in @a ir and NE is the number
+    of elements in @a mesh. As a special case, when @a coeff is NULL or a
+    ConstantCoefficient, @a qvec has size 1 and stores the constant (which is 1
+    when @a coeff is NULL). A GridFunctionCoefficient with a scalar GridFunction
+    is interpolated in bulk with a QuadratureInterpolator, any other
+    coefficient is evaluated point by point on the host. All elements are
+    assumed to have the same geometry. */
+void EvalCoefficientQVector(Coefficient *coeff, Mesh &mesh,
+                            const IntegrationRule &ir, Vector &qvec);
+
+/** @brief Evaluate the matrix coefficient @a coeff at the points of the
+    integration rule @a ir in all elements of @a mesh.
+
+    The result is stored in @a qvec with a column-major layout with dimensions
+    (NQ x H x W x NE), where H and W are the height and width of @a coeff. */
+void EvalCoefficientQVector(MatrixCoefficient &coeff, Mesh &mesh,
+                            const IntegrationRule &ir, Vector &qvec);
+
+/** @brief Evaluate the vector coefficient @a coeff at the points of the
+    integration rule @a ir in all elements of @a mesh.
+
+    The result is stored in @a qvec with a column-major layout with dimensions
+    (NQ x VDIM x NE), where VDIM is the vector dimension of @a coeff. */
+void EvalCoefficientQVector(VectorCoefficient &coeff, Mesh &mesh,
+                            const IntegrationRule &ir, Vector &qvec);
+
 #ifdef MFEM_USE_MPI
 /** Compute the global Lp norm of a function f.
     \f$ \| f \|_{Lp} = ( \int_\Omega | f |^p d\Omega)^{1/p} \f$ */
@@ -108,6 +108,9 @@ protected:
    // holds currently active conduit relay i/o protocol
    std::string relay_protocol;
 
+   /// SaveAsync() is not supported
+   virtual DataCollection *NewSnapshot() const { return NULL; }
+
 public:
    /// Constructor. The collection name is used when saving the data.
    /** If @a mesh is NULL, then the mesh can be set later by calling either
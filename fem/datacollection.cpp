@@ -17,6 +17,9 @@
 #include <fstream>
 #include <cerrno>      // errno
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #ifndef _WIN32
 #include <sys/stat.h>  // mkdir
@@ -110,10 +113,13 @@ DataCollection::DataCollection(const std::string& collection_name, Mesh *mesh_)
    format = SERIAL_FORMAT; // use serial mesh format
    compression = false;
    error = NO_ERROR;
+   async_save = NULL;
+   is_snapshot = false;
 }
 
 void DataCollection::SetMesh(Mesh *new_mesh)
 {
+   Wait();
    if (own_data && new_mesh != mesh) { delete mesh; }
    mesh = new_mesh;
    myid = 0;
@@ -156,6 +162,7 @@ void DataCollection::SetFormat(int fmt)
       case SERIAL_FORMAT: break;
 #ifdef MFEM_USE_MPI
       case PARALLEL_FORMAT: break;
+      case SHARED_FORMAT: break;
 #endif
       default: MFEM_ABORT("unknown format: " << fmt);
    }
@@ -193,6 +200,7 @@ void DataCollection::Load(int cycle)
 
 void DataCollection::Save()
 {
+   Wait();
    SaveMesh();
 
    if (error) { return; }
@@ -219,7 +227,8 @@ void DataCollection::SaveMesh()
    {
       dir_name += "_" + to_padded_string(cycle, pad_digits_cycle);
    }
-   err = create_directory(dir_name, mesh, myid);
+   // The directory of an asynchronous save is created by SaveAsync()
+   err = is_snapshot ? 0 : create_directory(dir_name, mesh, myid);
    if (err)
    {
       error = WRITE_ERROR;
@@ -228,11 +237,26 @@ void DataCollection::SaveMesh()
    }
 
    std::string mesh_name = GetMeshFileName();
+#ifdef MFEM_USE_MPI
+   const ParMesh *pmesh = dynamic_cast<const ParMesh*>(mesh);
+   if (UseSharedFiles())
+   {
+      std::ostringstream mesh_out;
+      mesh_out.precision(precision);
+      if (pmesh) { pmesh->ParPrint(mesh_out); }
+      else { mesh->Print(mesh_out); }
+      if (!WriteSharedFile(m_comm, mesh_name, mesh_out.str()))
+      {
+         error = WRITE_ERROR;
+         MFEM_WARNING("Error writing mesh to file: " << mesh_name);
+      }
+      return;
+   }
+#endif
    const char *mode = (compression) ? "zwb6" : "w";
    ofgzstream mesh_file(mesh_name.c_str(), mode);
    mesh_file.precision(precision);
 #ifdef MFEM_USE_MPI
-   const ParMesh *pmesh = dynamic_cast<const ParMesh*>(mesh);
    if (pmesh && format == PARALLEL_FORMAT)
    {
       pmesh->ParPrint(mesh_file);
@@ -249,6 +273,15 @@ void DataCollection::SaveMesh()
    }
 }
 
+bool DataCollection::UseSharedFiles() const
+{
+#ifdef MFEM_USE_MPI
+   return (format == SHARED_FORMAT && m_comm != MPI_COMM_NULL);
+#else
+   return false;
+#endif
+}
+
 std::string DataCollection::GetMeshShortFileName() const
 {
    return (serial || format == SERIAL_FORMAT) ? "mesh" : "pmesh";
@@ -268,7 +301,7 @@ const
       dir_name += "_" + to_padded_string(cycle, pad_digits_cycle);
    }
    std::string file_name = dir_name + "/" + field_name;
-   if (appendRankToFileName)
+   if (appendRankToFileName && !UseSharedFiles())
    {
       file_name += "." + to_padded_string(myid, pad_digits_rank);
    }
@@ -277,6 +310,21 @@ const
 
 void DataCollection::SaveOneField(const FieldMapIterator &it)
 {
+#ifdef MFEM_USE_MPI
+   if (UseSharedFiles())
+   {
+      std::ostringstream field_out;
+      field_out.precision(precision);
+      (it->second)->Save(field_out);
+      if (!WriteSharedFile(m_comm, GetFieldFileName(it->first),
+                           field_out.str()))
+      {
+         error = WRITE_ERROR;
+         MFEM_WARNING("Error writing field to file: " << it->first);
+      }
+      return;
+   }
+#endif
    const char *mode = (compression) ? "zwb6" : "w";
    ofgzstream field_file(GetFieldFileName(it->first).c_str(), mode);
 
@@ -291,6 +339,21 @@ void DataCollection::SaveOneField(const FieldMapIterator &it)
 
 void DataCollection::SaveOneQField(const QFieldMapIterator &it)
 {
+#ifdef MFEM_USE_MPI
+   if (UseSharedFiles())
+   {
+      std::ostringstream q_field_out;
+      q_field_out.precision(precision);
+      (it->second)->Save(q_field_out);
+      if (!WriteSharedFile(m_comm, GetFieldFileName(it->first),
+                           q_field_out.str()))
+      {
+         error = WRITE_ERROR;
+         MFEM_WARNING("Error writing q-field to file: " << it->first);
+      }
+      return;
+   }
+#endif
    const char *mode = (compression) ? "zwb6" : "w";
    ofgzstream q_field_file(GetFieldFileName(it->first).c_str(), mode);
    q_field_file.precision(precision);
@@ -320,8 +383,105 @@ void DataCollection::SaveQField(const std::string &q_field_name)
    }
 }
 
+struct DataCollection::AsyncSave
+{
+   DataCollection *snapshot;
+   std::thread thread;
+   std::atomic<bool> done;
+};
+
+// Copy the data of a field into a new field on the same space
+static GridFunction *CopyField(GridFunction *gf)
+{
+   GridFunction *copy;
+#ifdef MFEM_USE_MPI
+   ParGridFunction *pgf = dynamic_cast<ParGridFunction*>(gf);
+   if (pgf) { copy = new ParGridFunction(pgf->ParFESpace()); }
+   else
+#endif
+   {
+      copy = new GridFunction(gf->FESpace());
+   }
+   const double *data = gf->HostRead();
+   std::copy(data, data + gf->Size(), copy->HostWrite());
+   return copy;
+}
+
+static QuadratureFunction *CopyQField(QuadratureFunction *qf)
+{
+   QuadratureFunction *copy =
+      new QuadratureFunction(qf->GetSpace(), qf->GetVDim());
+   const double *data = qf->HostRead();
+   std::copy(data, data + qf->Size(), copy->HostWrite());
+   return copy;
+}
+
+void DataCollection::SaveAsync()
+{
+   Wait();
+   MFEM_VERIFY(!UseSharedFiles(), "SaveAsync() does not support the "
+               "SHARED_FORMAT");
+   DataCollection *snapshot = NewSnapshot();
+   MFEM_VERIFY(snapshot, "SaveAsync() is not supported by this collection");
+
+   // Directory creation is collective in parallel, so it is done here
+   std::string dir_name = prefix_path + name;
+   if (cycle != -1)
+   {
+      dir_name += "_" + to_padded_string(cycle, pad_digits_cycle);
+   }
+   if (create_directory(dir_name, mesh, myid))
+   {
+      delete snapshot;
+      error = WRITE_ERROR;
+      MFEM_WARNING("Error creating directory: " << dir_name);
+      return;
+   }
+
+   // The snapshot owns copies of the fields but not the mesh, so the copies
+   // are deleted separately in Wait()
+   snapshot->own_data = false;
+   snapshot->is_snapshot = true;
+   snapshot->error = NO_ERROR;
+   for (FieldMapIterator it = snapshot->field_map.begin();
+        it != snapshot->field_map.end(); ++it)
+   {
+      it->second = CopyField(it->second);
+   }
+   for (QFieldMapIterator it = snapshot->q_field_map.begin();
+        it != snapshot->q_field_map.end(); ++it)
+   {
+      it->second = CopyQField(it->second);
+   }
+
+   AsyncSave *as = new AsyncSave;
+   as->snapshot = snapshot;
+   as->done = false;
+   as->thread = std::thread([as]() { as->snapshot->Save(); as->done = true; });
+   async_save = as;
+}
+
+void DataCollection::Wait()
+{
+   if (!async_save) { return; }
+   async_save->thread.join();
+   DataCollection *snapshot = async_save->snapshot;
+   if (snapshot->error) { error = snapshot->error; }
+   snapshot->field_map.DeleteData(true);
+   snapshot->q_field_map.DeleteData(true);
+   delete snapshot;
+   delete async_save;
+   async_save = NULL;
+}
+
+bool DataCollection::IsSaving() const
+{
+   return (async_save && !async_save->done);
+}
+
 void DataCollection::DeleteData()
 {
+   Wait();
    if (own_data) { delete mesh; }
    mesh = NULL;
 
@@ -547,31 +707,51 @@ void VisItDataCollection::LoadVisItRootFile(const std::string& root_name)
 
 void VisItDataCollection::LoadMesh()
 {
+   // GetMeshFileName() uses 'serial', so we need to set it in advance.
+   serial = (format == SERIAL_FORMAT);
    std::string mesh_fname = GetMeshFileName();
-   named_ifgzstream file(mesh_fname.c_str());
-   // TODO: in parallel, check for errors on all processors
-   if (!file)
-   {
-      error = READ_ERROR;
-      MFEM_WARNING("Unable to open mesh file: " << mesh_fname);
-      return;
-   }
-   // TODO: 1) load parallel mesh on one processor
-   if (format == SERIAL_FORMAT)
+#ifdef MFEM_USE_MPI
+   if (UseSharedFiles())
    {
-      mesh = new Mesh(file, 1, 0, false);
-      serial = true;
+      std::string buffer;
+      if (!ReadSharedFile(m_comm, mesh_fname, buffer))
+      {
+         error = READ_ERROR;
+         MFEM_WARNING("Unable to read mesh file: " << mesh_fname);
+         return;
+      }
+      std::istringstream file(buffer);
+      mesh = new ParMesh(m_comm, file);
+      serial = false;
    }
    else
+#endif
    {
+      named_ifgzstream file(mesh_fname.c_str());
+      // TODO: in parallel, check for errors on all processors
+      if (!file)
+      {
+         error = READ_ERROR;
+         MFEM_WARNING("Unable to open mesh file: " << mesh_fname);
+         return;
+      }
+      // TODO: 1) load parallel mesh on one processor
+      if (format == SERIAL_FORMAT)
+      {
+         mesh = new Mesh(file, 1, 0, false);
+         serial = true;
+      }
+      else
+      {
 #ifdef MFEM_USE_MPI
-      mesh = new ParMesh(m_comm, file);
-      serial = false;
+         mesh = new ParMesh(m_comm, file);
+         serial = false;
 #else
-      error = READ_ERROR;
-      MFEM_WARNING("Reading parallel format in serial is not supported");
-      return;
+         error = READ_ERROR;
+         MFEM_WARNING("Reading parallel format in serial is not supported");
+         return;
 #endif
+      }
    }
    spatial_dim = mesh->SpaceDimension();
    topo_dim = mesh->Dimension();
@@ -582,13 +762,31 @@ void VisItDataCollection::LoadFields()
 {
    std::string path_left = prefix_path + name + "_" +
                            to_padded_string(cycle, pad_digits_cycle) + "/";
-   std::string path_right = "." + to_padded_string(myid, pad_digits_rank);
+   std::string path_right = UseSharedFiles() ? "" :
+                            "." + to_padded_string(myid, pad_digits_rank);
 
    field_map.clear();
    for (FieldInfoMapIterator it = field_info_map.begin();
         it != field_info_map.end(); ++it)
    {
       std::string fname = path_left + it->first + path_right;
+#ifdef MFEM_USE_MPI
+      if (UseSharedFiles())
+      {
+         std::string buffer;
+         if (!ReadSharedFile(m_comm, fname, buffer))
+         {
+            error = READ_ERROR;
+            MFEM_WARNING("Unable to read field file: " << fname);
+            return;
+         }
+         std::istringstream file(buffer);
+         field_map.Register(
+            it->first,
+            new ParGridFunction(dynamic_cast<ParMesh*>(mesh), file), own_data);
+         continue;
+      }
+#endif
       ifgzstream file(fname.c_str());
       // TODO: in parallel, check for errors on all processors
       if (!file)
@@ -627,7 +825,8 @@ std::string VisItDataCollection::GetVisItRootString()
    picojson::object top, dsets, main, mesh, fields, field, mtags, ftags;
 
    // Build the mesh data
-   std::string file_ext_format = ".%0" + to_string(pad_digits_rank) + "d";
+   std::string file_ext_format = UseSharedFiles() ? "" :
+                                 ".%0" + to_string(pad_digits_rank) + "d";
    mtags["spatial_dim"] = picojson::value(to_string(spatial_dim));
    mtags["topo_dim"] = picojson::value(to_string(topo_dim));
    mtags["max_lods"] = picojson::value(to_string(visit_max_levels_of_detail));
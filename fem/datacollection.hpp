@@ -148,9 +148,14 @@ public:
       SERIAL_FORMAT = 0, /**<
          MFEM's serial ascii format, using the methods Mesh::Print() /
          ParMesh::Print(), and GridFunction::Save() / ParGridFunction::Save().*/
-      PARALLEL_FORMAT = 1  /**<
+      PARALLEL_FORMAT = 1, /**<
          MFEM's parallel ascii format, using the methods ParMesh::ParPrint() and
          GridFunction::Save() / ParGridFunction::Save(). */
+      SHARED_FORMAT = 2    /**<
+         The parallel ascii format of PARALLEL_FORMAT where the data of all MPI
+         ranks is written into a single file for the mesh and for each field
+         with collective MPI-IO, see WriteSharedFile(). Compression is not
+         supported with this format. */
    };
 
 protected:
@@ -213,11 +218,22 @@ protected:
    /// Error state
    int error;
 
+   /// State of the save started by SaveAsync(), defined in datacollection.cpp
+   struct AsyncSave;
+   /// The save in progress started by SaveAsync(), or NULL
+   AsyncSave *async_save;
+   /// True in the copy of the collection written by SaveAsync()
+   bool is_snapshot;
+
    /// Delete data owned by the DataCollection keeping field information
    void DeleteData();
    /// Delete data owned by the DataCollection including field information
    void DeleteAll();
 
+   /// Are the mesh and the fields written into shared files? See
+   /// #SHARED_FORMAT.
+   bool UseSharedFiles() const;
+
    std::string GetMeshShortFileName() const;
    std::string GetMeshFileName() const;
    std::string GetFieldFileName(const std::string &field_name) const;
@@ -228,6 +244,13 @@ protected:
    /// Save one q-field to disk, assuming the collection directory exists
    void SaveOneQField(const QFieldMapIterator &it);
 
+   /// Return a copy of the collection that SaveAsync() writes with Save().
+   /** The copy shares the mesh and the fields of the collection. Derived
+       classes that override Save() should override this method too; they
+       return NULL if SaveAsync() is not supported. */
+   virtual DataCollection *NewSnapshot() const
+   { return new DataCollection(*this); }
+
    // Helper method
    static int create_directory(const std::string &dir_name,
                                const Mesh *mesh, int myid);
@@ -368,6 +391,21 @@ public:
    /// Save one q-field, assuming the collection directory already exists.
    virtual void SaveQField(const std::string &q_field_name);
 
+   /// Save the collection to disk in a background thread.
+   /** The data of the registered fields and q-fields is copied, then the
+       method returns while the mesh and the field copies are written as in
+       Save(), including the optional compression. The collection parameters,
+       e.g. the cycle and the time, can be changed during the save. The mesh
+       and the finite element and quadrature spaces of the fields are not
+       copied: they must not be modified or deleted until the save completes,
+       see Wait(). Write errors are reported by Error() after Wait(). The
+       #SHARED_FORMAT is not supported. */
+   virtual void SaveAsync();
+   /// Wait for the completion of the save started by SaveAsync(), if any.
+   void Wait();
+   /// Is a save started by SaveAsync() still in progress?
+   bool IsSaving() const;
+
    /// Load the collection. Not implemented in the base class DataCollection.
    virtual void Load(int cycle_ = 0);
 
@@ -407,6 +445,9 @@ protected:
    std::map<std::string, VisItFieldInfo> field_info_map;
    typedef std::map<std::string, VisItFieldInfo>::iterator FieldInfoMapIterator;
 
+   virtual DataCollection *NewSnapshot() const
+   { return new VisItDataCollection(*this); }
+
    /// Prepare the VisIt root file in JSON format for the current collection
    std::string GetVisItRootString();
    /// Read in a VisIt root file in JSON format
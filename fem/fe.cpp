@@ -354,6 +354,9 @@ const DofToQuad &ScalarFiniteElement::GetTensorDofToQuad(
       if (d2q.IntRule == &ir && d2q.mode == mode) { return d2q; }
    }
 
+   MFEM_VERIFY(ir.IsTensorProduct(Dim),
+               "the integration rule is not a tensor product rule");
+
    DofToQuad *d2q = new DofToQuad;
    const Poly_1D::Basis &basis_1d = tb.GetBasis1D();
    const int ndof = Order + 1;
@@ -7176,6 +7179,75 @@ PositiveTensorFiniteElement::PositiveTensorFiniteElement(
                            dims > 1 ? FunctionSpace::Qk : FunctionSpace::Pk),
      TensorBasisElement(dims, p, BasisType::Positive, dmtype) { }
 
+VectorTensorFiniteElement::VectorTensorFiniteElement(
+   const int dims, const int d, const int p, const int cp, const int op,
+   const int cbtype, const int obtype, const int M)
+   : VectorFiniteElement(dims,
+                         TensorBasisElement::GetTensorProductGeometry(dims), d,
+                         p, M, FunctionSpace::Qk),
+     cbasis1d(poly1d.GetBasis(cp, VerifyClosed(cbtype))),
+     obasis1d(poly1d.GetBasis(op, VerifyOpen(obtype))),
+     cdofs1d(cp + 1), odofs1d(op + 1), dof_map(d) { }
+
+const DofToQuad &VectorTensorFiniteElement::GetDofToQuad(
+   const IntegrationRule &ir, DofToQuad::Mode mode) const
+{
+   return GetTensorDofToQuad(cbasis1d, cdofs1d, ir, mode);
+}
+
+const DofToQuad &VectorTensorFiniteElement::GetDofToQuadOpen(
+   const IntegrationRule &ir, DofToQuad::Mode mode) const
+{
+   return GetTensorDofToQuad(obasis1d, odofs1d, ir, mode);
+}
+
+// protected method
+const DofToQuad &VectorTensorFiniteElement::GetTensorDofToQuad(
+   const Poly_1D::Basis &basis1d, const int ndof, const IntegrationRule &ir,
+   DofToQuad::Mode mode) const
+{
+   MFEM_VERIFY(mode == DofToQuad::TENSOR, "invalid mode requested");
+
+   // The closed and open DofToQuad objects differ in their number of dofs
+   for (int i = 0; i < dof2quad_array.Size(); i++)
+   {
+      const DofToQuad &d2q = *dof2quad_array[i];
+      if (d2q.IntRule == &ir && d2q.mode == mode && d2q.ndof == ndof)
+      {
+         return d2q;
+      }
+   }
+
+   MFEM_VERIFY(ir.IsTensorProduct(Dim),
+               "the integration rule is not a tensor product rule");
+
+   DofToQuad *d2q = new DofToQuad;
+   const int nqpt = (int)floor(pow(ir.GetNPoints(), 1.0/Dim) + 0.5);
+   d2q->FE = this;
+   d2q->IntRule = &ir;
+   d2q->mode = mode;
+   d2q->ndof = ndof;
+   d2q->nqpt = nqpt;
+   d2q->B.SetSize(nqpt*ndof);
+   d2q->Bt.SetSize(ndof*nqpt);
+   d2q->G.SetSize(nqpt*ndof);
+   d2q->Gt.SetSize(ndof*nqpt);
+   Vector val(ndof), grad(ndof);
+   for (int i = 0; i < nqpt; i++)
+   {
+      // The first 'nqpt' points in 'ir' have the same x-coordinates as those
+      // of the 1D rule.
+      basis1d.Eval(ir.IntPoint(i).x, val, grad);
+      for (int j = 0; j < ndof; j++)
+      {
+         d2q->B[i+nqpt*j] = d2q->Bt[j+ndof*i] = val(j);
+         d2q->G[i+nqpt*j] = d2q->Gt[j+ndof*i] = grad(j);
+      }
+   }
+   dof2quad_array.Append(d2q);
+   return *d2q;
+}
+
 
 H1_SegmentElement::H1_SegmentElement(const int p, const int btype)
    : NodalTensorFiniteElement(1, p, VerifyClosed(btype), H1_DOF_MAP)
@@ -9882,11 +9954,9 @@ const double RT_QuadrilateralElement::nk[8] =
 RT_QuadrilateralElement::RT_QuadrilateralElement(const int p,
                                                  const int cb_type,
                                                  const int ob_type)
-   : VectorFiniteElement(2, Geometry::SQUARE, 2*(p + 1)*(p + 2), p + 1,
-                         H_DIV, FunctionSpace::Qk),
-     cbasis1d(poly1d.GetBasis(p + 1, VerifyClosed(cb_type))),
-     obasis1d(poly1d.GetBasis(p, VerifyOpen(ob_type))),
-     dof_map(Dof), dof2nk(Dof)
+   : VectorTensorFiniteElement(2, 2*(p + 1)*(p + 2), p + 1, p + 1, p, cb_type,
+                               ob_type, H_DIV),
+     dof2nk(Dof)
 {
    const double *cp = poly1d.ClosedPoints(p + 1, cb_type);
    const double *op = poly1d.OpenPoints(p, ob_type);
@@ -10093,11 +10163,9 @@ const double RT_HexahedronElement::nk[18] =
 RT_HexahedronElement::RT_HexahedronElement(const int p,
                                            const int cb_type,
                                            const int ob_type)
-   : VectorFiniteElement(3, Geometry::CUBE, 3*(p + 1)*(p + 1)*(p + 2), p + 1,
-                         H_DIV, FunctionSpace::Qk),
-     cbasis1d(poly1d.GetBasis(p + 1, VerifyClosed(cb_type))),
-     obasis1d(poly1d.GetBasis(p, VerifyOpen(ob_type))),
-     dof_map(Dof), dof2nk(Dof)
+   : VectorTensorFiniteElement(3, 3*(p + 1)*(p + 1)*(p + 2), p + 1, p + 1, p,
+                               cb_type, ob_type, H_DIV),
+     dof2nk(Dof)
 {
    const double *cp = poly1d.ClosedPoints(p + 1, cb_type);
    const double *op = poly1d.OpenPoints(p, ob_type);
@@ -10742,11 +10810,9 @@ const double ND_HexahedronElement::tk[18] =
 
 ND_HexahedronElement::ND_HexahedronElement(const int p,
                                            const int cb_type, const int ob_type)
-   : VectorFiniteElement(3, Geometry::CUBE, 3*p*(p + 1)*(p + 1), p,
-                         H_CURL, FunctionSpace::Qk),
-     cbasis1d(poly1d.GetBasis(p, VerifyClosed(cb_type))),
-     obasis1d(poly1d.GetBasis(p - 1, VerifyOpen(ob_type))),
-     dof_map(Dof), dof2tk(Dof)
+   : VectorTensorFiniteElement(3, 3*p*(p + 1)*(p + 1), p, p, p - 1, cb_type,
+                               ob_type, H_CURL),
+     dof2tk(Dof)
 {
    const double *cp = poly1d.ClosedPoints(p, cb_type);
    const double *op = poly1d.OpenPoints(p - 1, ob_type);
@@ -11114,11 +11180,9 @@ const double ND_QuadrilateralElement::tk[8] =
 ND_QuadrilateralElement::ND_QuadrilateralElement(const int p,
                                                  const int cb_type,
                                                  const int ob_type)
-   : VectorFiniteElement(2, Geometry::SQUARE, 2*p*(p + 1), p,
-                         H_CURL, FunctionSpace::Qk),
-     cbasis1d(poly1d.GetBasis(p, VerifyClosed(cb_type))),
-     obasis1d(poly1d.GetBasis(p - 1, VerifyOpen(ob_type))),
-     dof_map(Dof), dof2tk(Dof)
+   : VectorTensorFiniteElement(2, 2*p*(p + 1), p, p, p - 1, cb_type, ob_type,
+                               H_CURL),
+     dof2tk(Dof)
 {
    const double *cp = poly1d.ClosedPoints(p, cb_type);
    const double *op = poly1d.OpenPoints(p - 1, ob_type);
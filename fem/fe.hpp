@@ -146,8 +146,8 @@ public:
           dimensions using 1D number of quadrature points and degrees of
           freedom. */
       /** When representing a vector-valued FiniteElement, two DofToQuad objects
-          are used to describe the "closed" and "open" 1D basis functions
-          (TODO). */
+          are used to describe the "closed" and "open" 1D basis functions, see
+          VectorTensorFiniteElement. */
       TENSOR
    };
 
@@ -1882,6 +1882,48 @@ public:
    }
 };
 
+/** @brief Base class for the vector tensor-product elements on quadrilaterals
+    and hexahedra, whose components are products of "closed" and "open" 1D
+    bases. */
+class VectorTensorFiniteElement : public VectorFiniteElement
+{
+protected:
+   Poly_1D::Basis &cbasis1d, &obasis1d;
+   const int cdofs1d, odofs1d; ///< Sizes of the closed and open 1D bases
+   Array<int> dof_map;
+
+   const DofToQuad &GetTensorDofToQuad(const Poly_1D::Basis &basis1d,
+                                       const int ndof,
+                                       const IntegrationRule &ir,
+                                       DofToQuad::Mode mode) const;
+
+public:
+   /** @brief Construct an element of dimension @a dims with @a d dofs, order
+       @a p and map type @a M, using closed and open 1D bases of orders @a cp
+       and @a op with basis types @a cbtype and @a obtype, respectively. */
+   VectorTensorFiniteElement(const int dims, const int d, const int p,
+                             const int cp, const int op, const int cbtype,
+                             const int obtype, const int M);
+
+   const Poly_1D::Basis &GetClosedBasis1D() const { return cbasis1d; }
+   const Poly_1D::Basis &GetOpenBasis1D() const { return obasis1d; }
+
+   /** @brief Get an Array<int> that maps the lexicographically ordered dofs of
+       the components (first all x-components, then y and z) to the indices of
+       the respective basis functions. */
+   /** A negative entry, -1-i, means that the basis function i is the tensor
+       product basis function with the opposite sign. */
+   const Array<int> &GetDofMap() const { return dof_map; }
+
+   /// Return the DofToQuad of the closed 1D basis; only TENSOR mode is valid.
+   const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
+                                 DofToQuad::Mode mode) const;
+
+   /// Return the DofToQuad of the open 1D basis; only TENSOR mode is valid.
+   const DofToQuad &GetDofToQuadOpen(const IntegrationRule &ir,
+                                     DofToQuad::Mode mode) const;
+};
+
 class H1_SegmentElement : public NodalTensorFiniteElement
 {
 private:
@@ -2368,17 +2410,16 @@ public:
 };
 
 
-class RT_QuadrilateralElement : public VectorFiniteElement
+class RT_QuadrilateralElement : public VectorTensorFiniteElement
 {
 private:
    static const double nk[8];
 
-   Poly_1D::Basis &cbasis1d, &obasis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_cx, shape_ox, shape_cy, shape_oy;
    mutable Vector dshape_cx, dshape_cy;
 #endif
-   Array<int> dof_map, dof2nk;
+   Array<int> dof2nk;
 
 public:
    RT_QuadrilateralElement(const int p,
@@ -2424,16 +2465,15 @@ public:
 };
 
 
-class RT_HexahedronElement : public VectorFiniteElement
+class RT_HexahedronElement : public VectorTensorFiniteElement
 {
    static const double nk[18];
 
-   Poly_1D::Basis &cbasis1d, &obasis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_cx, shape_ox, shape_cy, shape_oy, shape_cz, shape_oz;
    mutable Vector dshape_cx, dshape_cy, dshape_cz;
 #endif
-   Array<int> dof_map, dof2nk;
+   Array<int> dof2nk;
 
 public:
    RT_HexahedronElement(const int p,
@@ -2578,16 +2618,15 @@ public:
 };
 
 
-class ND_HexahedronElement : public VectorFiniteElement
+class ND_HexahedronElement : public VectorTensorFiniteElement
 {
    static const double tk[18];
 
-   Poly_1D::Basis &cbasis1d, &obasis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_cx, shape_ox, shape_cy, shape_oy, shape_cz, shape_oz;
    mutable Vector dshape_cx, dshape_cy, dshape_cz;
 #endif
-   Array<int> dof_map, dof2tk;
+   Array<int> dof2tk;
 
 public:
    ND_HexahedronElement(const int p,
@@ -2644,16 +2683,15 @@ public:
 };
 
 
-class ND_QuadrilateralElement : public VectorFiniteElement
+class ND_QuadrilateralElement : public VectorTensorFiniteElement
 {
    static const double tk[8];
 
-   Poly_1D::Basis &cbasis1d, &obasis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_cx, shape_ox, shape_cy, shape_oy;
    mutable Vector dshape_cx, dshape_cy;
 #endif
-   Array<int> dof_map, dof2tk;
+   Array<int> dof2tk;
 
 public:
    ND_QuadrilateralElement(const int p,
@@ -19,6 +19,7 @@
 #include <cmath>
 #include <cstdarg>
 #include <limits>
+#include <algorithm>
 
 using namespace std;
 
@@ -260,6 +261,49 @@ void FiniteElementSpace::ReorderElementToDofTable()
    }
 }
 
+const Table &FiniteElementSpace::GetElementColoring() const
+{
+   const int NE = GetNE();
+   if (elem_colors.Size() > 0 || NE == 0) { return elem_colors; }
+
+   // The element-to-dof table without the signs of the dofs and its transpose.
+   Table el_dof(*elem_dof), dof_el;
+   int *J = el_dof.GetJ();
+   for (int k = 0; k < el_dof.Size_of_connections(); k++)
+   {
+      if (J[k] < 0) { J[k] = -1-J[k]; }
+   }
+   Transpose(el_dof, dof_el, ndofs);
+
+   // Assign to each element, in the order of the mesh, the smallest color not
+   // used by the previous elements sharing one of its dofs; used[c] == i when
+   // color c is taken by such an element.
+   Array<int> color(NE), used;
+   for (int i = 0; i < NE; i++)
+   {
+      const int *dofs = el_dof.GetRow(i);
+      for (int j = 0; j < el_dof.RowSize(i); j++)
+      {
+         const int *elems = dof_el.GetRow(dofs[j]);
+         for (int k = 0; k < dof_el.RowSize(dofs[j]); k++)
+         {
+            if (elems[k] < i) { used[color[elems[k]]] = i; }
+         }
+      }
+      int c = 0;
+      while (c < used.Size() && used[c] == i) { c++; }
+      if (c == used.Size()) { used.Append(-1); }
+      color[i] = c;
+   }
+
+   elem_colors.MakeI(used.Size());
+   for (int i = 0; i < NE; i++) { elem_colors.AddAColumnInRow(color[i]); }
+   elem_colors.MakeJ();
+   for (int i = 0; i < NE; i++) { elem_colors.AddConnection(color[i], i); }
+   elem_colors.ShiftUpI();
+   return elem_colors;
+}
+
 void FiniteElementSpace::BuildDofToArrays()
 {
    if (dof_elem_array.Size()) { return; }
@@ -809,6 +853,16 @@ const Operator *FiniteElementSpace::GetElementRestriction(
    return L2E_nat.Ptr();
 }
 
+const Operator *FiniteElementSpace::GetFaceRestriction(FaceType type) const
+{
+   OperatorHandle &L2F = (type == FaceType::Interior) ? L2F_int : L2F_bdr;
+   if (L2F.Ptr() == NULL)
+   {
+      L2F.Reset(new FaceRestriction(*this, type));
+   }
+   return L2F.Ptr();
+}
+
 const QuadratureInterpolator *FiniteElementSpace::GetQuadratureInterpolator(
    const IntegrationRule &ir) const
 {
@@ -1030,6 +1084,56 @@ void FiniteElementSpace::RefinementOperator
    }
 }
 
+void FiniteElementSpace::RefinementOperator
+::MultTranspose(const Vector &x, Vector &y) const
+{
+   Mesh* mesh = fespace->GetMesh();
+   const CoarseFineTransformations &rtrans = mesh->GetRefinementTransforms();
+
+   Array<int> dofs, old_dofs, old_vdofs;
+
+   Array<char> processed(fespace->GetVSize());
+   processed = 0;
+
+   int vdim = fespace->GetVDim();
+   int old_ndofs = width / vdim;
+
+   y = 0.0;
+   for (int k = 0; k < mesh->GetNE(); k++)
+   {
+      const Embedding &emb = rtrans.embeddings[k];
+      const Geometry::Type geom = mesh->GetElementBaseGeometry(k);
+      const DenseMatrix &lP = localP[geom](emb.matrix);
+
+      fespace->GetElementDofs(k, dofs);
+      old_elem_dof->GetRow(emb.parent, old_dofs);
+
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         old_dofs.Copy(old_vdofs);
+         fespace->DofsToVDofs(vd, old_vdofs, old_ndofs);
+
+         for (int i = 0; i < dofs.Size(); i++)
+         {
+            double rsign, osign;
+            int r = fespace->DofToVDof(dofs[i], vd);
+            r = DecodeDof(r, rsign);
+
+            if (!processed[r])
+            {
+               const double xr = x[r] * rsign;
+               for (int j = 0; j < old_vdofs.Size(); j++)
+               {
+                  int o = DecodeDof(old_vdofs[j], osign);
+                  y[o] += xr * lP(i, j) * osign;
+               }
+               processed[r] = 1;
+            }
+         }
+      }
+   }
+}
+
 FiniteElementSpace::DerefinementOperator::DerefinementOperator(
    const FiniteElementSpace *f_fes, const FiniteElementSpace *c_fes,
    BilinearFormIntegrator *mass_integ)
@@ -1850,6 +1954,9 @@ void FiniteElementSpace::Destroy()
    Th.Clear();
    L2E_nat.Clear();
    L2E_lex.Clear();
+   L2F_int.Clear();
+   L2F_bdr.Clear();
+   elem_colors.Clear();
    for (int i = 0; i < E2Q_array.Size(); i++)
    {
       delete E2Q_array[i];
@@ -2648,7 +2755,8 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
      dof(ne > 0 ? fes.GetFE(0)->GetDof() : 0),
      nedofs(ne*dof),
      offsets(ndofs+1),
-     indices(ne*dof)
+     indices(ne*dof),
+     gatherMap(ne*dof)
 {
    // Assuming all finite elements are the same.
    height = vdim*ne*dof;
@@ -2660,18 +2768,23 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
       for (int e = 0; e < ne; ++e)
       {
          const FiniteElement *fe = fes.GetFE(e);
-         const TensorBasisElement* el =
-            dynamic_cast<const TensorBasisElement*>(fe);
-         if (el) { continue; }
+         if (dynamic_cast<const TensorBasisElement*>(fe) ||
+             dynamic_cast<const VectorTensorFiniteElement*>(fe)) { continue; }
          mfem_error("Finite element not suitable for lexicographic ordering");
       }
       const FiniteElement *fe = fes.GetFE(0);
       const TensorBasisElement* el =
          dynamic_cast<const TensorBasisElement*>(fe);
-      const Array<int> &fe_dof_map = el->GetDofMap();
+      const VectorTensorFiniteElement* vel =
+         dynamic_cast<const VectorTensorFiniteElement*>(fe);
+      const Array<int> &fe_dof_map = el ? el->GetDofMap() : vel->GetDofMap();
       MFEM_VERIFY(fe_dof_map.Size() > 0, "invalid dof map");
       dof_map = fe_dof_map.GetData();
    }
+   // The DOFs of H(curl) and H(div) spaces, and the entries of the dof maps of
+   // their tensor-product elements, may be signed: -1-i denotes the DOF i with
+   // the opposite orientation. The signed local indices are stored in
+   // 'indices' and 'gatherMap' with the same convention.
    const Table& e2dTable = fes.GetElementToDofTable();
    const int* elementMap = e2dTable.GetJ();
    // We will be keeping a count of how many local nodes point to its global dof
@@ -2683,7 +2796,8 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
    {
       for (int d = 0; d < dof; ++d)
       {
-         const int gid = elementMap[dof*e + d];
+         const int sgid = elementMap[dof*e + d];
+         const int gid = (sgid >= 0) ? sgid : -1 - sgid;
          ++offsets[gid + 1];
       }
    }
@@ -2697,10 +2811,14 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
    {
       for (int d = 0; d < dof; ++d)
       {
-         const int did = (!dof_reorder)?d:dof_map[d];
-         const int gid = elementMap[dof*e + did];
+         const int sdid = (!dof_reorder)?d:dof_map[d];
+         const int did = (sdid >= 0) ? sdid : -1 - sdid;
+         const int sgid = elementMap[dof*e + did];
+         const int gid = (sgid >= 0) ? sgid : -1 - sgid;
          const int lid = dof*e + d;
-         indices[offsets[gid]++] = lid;
+         const bool plus = (sgid >= 0) == (sdid >= 0);
+         indices[offsets[gid]++] = plus ? lid : -1 - lid;
+         gatherMap[lid] = plus ? gid : -1 - gid;
       }
    }
    // We shifted the offsets vector by 1 by using it as a counter.
@@ -2731,8 +2849,40 @@ void ElementRestriction::Mult(const Vector& x, Vector& y) const
          const double dofValue = d_x(t?c:i,t?i:c);
          for (int j = offset; j < nextOffset; ++j)
          {
-            const int idx_j = d_indices[j];
-            d_y(idx_j % nd, c, idx_j / nd) = dofValue;
+            const int idx_j = (d_indices[j] >= 0) ? d_indices[j] :
+                              -1 - d_indices[j];
+            d_y(idx_j % nd, c, idx_j / nd) =
+               (d_indices[j] >= 0) ? dofValue : -dofValue;
+         }
+      }
+   });
+}
+
+void ElementRestriction::MultSubset(const Array<int> &dof_list,
+                                    const Vector& x, Vector& y) const
+{
+   const int nd = dof;
+   const int vd = vdim;
+   const bool t = byvdim;
+   auto d_offsets = offsets.Read();
+   auto d_indices = indices.Read();
+   auto d_list = dof_list.Read();
+   auto d_x = Reshape(x.Read(), t?vd:ndofs, t?ndofs:vd);
+   auto d_y = Reshape(y.ReadWrite(), nd, vd, ne);
+   MFEM_FORALL(k, dof_list.Size(),
+   {
+      const int i = d_list[k];
+      const int offset = d_offsets[i];
+      const int nextOffset = d_offsets[i+1];
+      for (int c = 0; c < vd; ++c)
+      {
+         const double dofValue = d_x(t?c:i,t?i:c);
+         for (int j = offset; j < nextOffset; ++j)
+         {
+            const int idx_j = (d_indices[j] >= 0) ? d_indices[j] :
+                              -1 - d_indices[j];
+            d_y(idx_j % nd, c, idx_j / nd) =
+               (d_indices[j] >= 0) ? dofValue : -dofValue;
          }
       }
    });
@@ -2757,189 +2907,1031 @@ void ElementRestriction::MultTranspose(const Vector& x, Vector& y) const
          double dofValue = 0;
          for (int j = offset; j < nextOffset; ++j)
          {
-            const int idx_j = d_indices[j];
-            dofValue +=  d_x(idx_j % nd, c, idx_j / nd);
+            const int idx_j = (d_indices[j] >= 0) ? d_indices[j] :
+                              -1 - d_indices[j];
+            dofValue += (d_indices[j] >= 0) ? d_x(idx_j % nd, c, idx_j / nd) :
+                        -d_x(idx_j % nd, c, idx_j / nd);
          }
          d_y(t?c:i,t?i:c) = dofValue;
       }
    });
 }
 
-
-QuadratureInterpolator::QuadratureInterpolator(const FiniteElementSpace &fes,
-                                               const IntegrationRule &ir)
+void ElementRestriction::MultUnsigned(const Vector& x, Vector& y) const
 {
-   fespace = &fes;
-   qspace = NULL;
-   IntRule = &ir;
-   use_tensor_products = true; // not implemented yet (not used)
-
-   if (fespace->GetNE() == 0) { return; }
-   const FiniteElement *fe = fespace->GetFE(0);
-   MFEM_VERIFY(dynamic_cast<const ScalarFiniteElement*>(fe) != NULL,
-               "Only scalar finite elements are supported");
+   // Assumes all elements have the same number of dofs
+   const int nd = dof;
+   const int vd = vdim;
+   const bool t = byvdim;
+   auto d_offsets = offsets.Read();
+   auto d_indices = indices.Read();
+   auto d_x = Reshape(x.Read(), t?vd:ndofs, t?ndofs:vd);
+   auto d_y = Reshape(y.Write(), nd, vd, ne);
+   MFEM_FORALL(i, ndofs,
+   {
+      const int offset = d_offsets[i];
+      const int nextOffset = d_offsets[i+1];
+      for (int c = 0; c < vd; ++c)
+      {
+         const double dofValue = d_x(t?c:i,t?i:c);
+         for (int j = offset; j < nextOffset; ++j)
+         {
+            const int idx_j = (d_indices[j] >= 0) ? d_indices[j] :
+                              -1 - d_indices[j];
+            d_y(idx_j % nd, c, idx_j / nd) = dofValue;
+         }
+      }
+   });
 }
 
-QuadratureInterpolator::QuadratureInterpolator(const FiniteElementSpace &fes,
-                                               const QuadratureSpace &qs)
+void ElementRestriction::MultTransposeUnsigned(const Vector& x,
+                                               Vector& y) const
 {
-   fespace = &fes;
-   qspace = &qs;
-   IntRule = NULL;
-   use_tensor_products = true; // not implemented yet (not used)
-
-   if (fespace->GetNE() == 0) { return; }
-   const FiniteElement *fe = fespace->GetFE(0);
-   MFEM_VERIFY(dynamic_cast<const ScalarFiniteElement*>(fe) != NULL,
-               "Only scalar finite elements are supported");
+   // Assumes all elements have the same number of dofs
+   const int nd = dof;
+   const int vd = vdim;
+   const bool t = byvdim;
+   auto d_offsets = offsets.Read();
+   auto d_indices = indices.Read();
+   auto d_x = Reshape(x.Read(), nd, vd, ne);
+   auto d_y = Reshape(y.Write(), t?vd:ndofs, t?ndofs:vd);
+   MFEM_FORALL(i, ndofs,
+   {
+      const int offset = d_offsets[i];
+      const int nextOffset = d_offsets[i + 1];
+      for (int c = 0; c < vd; ++c)
+      {
+         double dofValue = 0;
+         for (int j = offset; j < nextOffset; ++j)
+         {
+            const int idx_j = (d_indices[j] >= 0) ? d_indices[j] :
+                              -1 - d_indices[j];
+            dofValue += d_x(idx_j % nd, c, idx_j / nd);
+         }
+         d_y(t?c:i,t?i:c) = dofValue;
+      }
+   });
 }
 
-template<const int T_VDIM, const int T_ND, const int T_NQ>
-void QuadratureInterpolator::Eval2D(
-   const int NE,
-   const int vdim,
-   const DofToQuad &maps,
-   const Vector &e_vec,
-   Vector &q_val,
-   Vector &q_der,
-   Vector &q_det,
-   const int eval_flags)
+SparseMatrix *ElementRestriction::NewSparseMatrix() const
 {
-   const int nd = maps.ndof;
-   const int nq = maps.nqpt;
-   const int ND = T_ND ? T_ND : nd;
-   const int NQ = T_NQ ? T_NQ : nq;
-   const int VDIM = T_VDIM ? T_VDIM : vdim;
-   MFEM_VERIFY(ND <= MAX_ND2D, "");
-   MFEM_VERIFY(NQ <= MAX_NQ2D, "");
-   MFEM_VERIFY(VDIM == 2 || !(eval_flags & DETERMINANTS), "");
-   auto B = Reshape(maps.B.Read(), NQ, ND);
-   auto G = Reshape(maps.G.Read(), NQ, 2, ND);
-   auto E = Reshape(e_vec.Read(), ND, VDIM, NE);
-   auto val = Reshape(q_val.Write(), NQ, VDIM, NE);
-   auto der = Reshape(q_der.Write(), NQ, VDIM, 2, NE);
-   auto det = Reshape(q_det.Write(), NQ, NE);
-   MFEM_FORALL(e, NE,
+   const int nd = dof;
+   const int vd = vdim;
+   const bool t = byvdim;
+   const int *h_offsets = offsets.HostRead();
+   const int *h_indices = indices.HostRead();
+   const int *h_gather = gatherMap.HostRead();
+   // Scalar sparsity pattern: the columns of each row are the DOFs of all
+   // elements sharing the row DOF
+   Array<int> I_s(ndofs+1);
+   Array<int> marker(ndofs);
+   marker = -1;
+   I_s[0] = 0;
+   for (int i = 0; i < ndofs; i++)
    {
-      const int ND = T_ND ? T_ND : nd;
-      const int NQ = T_NQ ? T_NQ : nq;
-      const int VDIM = T_VDIM ? T_VDIM : vdim;
-      constexpr int max_ND = T_ND ? T_ND : MAX_ND2D;
-      constexpr int max_VDIM = T_VDIM ? T_VDIM : MAX_VDIM2D;
-      double s_E[max_VDIM*max_ND];
-      for (int d = 0; d < ND; d++)
+      int cnt = 0;
+      for (int k = h_offsets[i]; k < h_offsets[i+1]; k++)
       {
-         for (int c = 0; c < VDIM; c++)
+         const int lid = h_indices[k];
+         const int e = ((lid >= 0) ? lid : -1 - lid) / nd;
+         for (int j = 0; j < nd; j++)
          {
-            s_E[c+d*VDIM] = E(d,c,e);
+            const int sgid = h_gather[nd*e + j];
+            const int gid = (sgid >= 0) ? sgid : -1 - sgid;
+            if (marker[gid] != i) { marker[gid] = i; cnt++; }
          }
       }
-      for (int q = 0; q < NQ; ++q)
+      I_s[i+1] = I_s[i] + cnt;
+   }
+   Array<int> J_s(I_s[ndofs]);
+   marker = -1;
+   for (int i = 0; i < ndofs; i++)
+   {
+      int pos = I_s[i];
+      for (int k = h_offsets[i]; k < h_offsets[i+1]; k++)
       {
-         if (eval_flags & VALUES)
+         const int lid = h_indices[k];
+         const int e = ((lid >= 0) ? lid : -1 - lid) / nd;
+         for (int j = 0; j < nd; j++)
          {
-            double ed[max_VDIM];
-            for (int c = 0; c < VDIM; c++) { ed[c] = 0.0; }
-            for (int d = 0; d < ND; ++d)
-            {
-               const double b = B(q,d);
-               for (int c = 0; c < VDIM; c++) { ed[c] += b*s_E[c+d*VDIM]; }
-            }
-            for (int c = 0; c < VDIM; c++) { val(q,c,e) = ed[c]; }
+            const int sgid = h_gather[nd*e + j];
+            const int gid = (sgid >= 0) ? sgid : -1 - sgid;
+            if (marker[gid] != i) { marker[gid] = i; J_s[pos++] = gid; }
          }
-         if ((eval_flags & DERIVATIVES) || (eval_flags & DETERMINANTS))
+      }
+      std::sort(J_s.GetData() + I_s[i], J_s.GetData() + I_s[i+1]);
+   }
+   // Every vector component couples to all components of the same scalar
+   // columns; the loop order below keeps the columns sorted for both
+   // orderings.
+   const int size = vd*ndofs;
+   int *I = new int[size+1];
+   I[0] = 0;
+   for (int r = 0; r < size; r++)
+   {
+      const int i = t ? r / vd : r % ndofs;
+      I[r+1] = I[r] + vd*(I_s[i+1] - I_s[i]);
+   }
+   const int nnz = I[size];
+   int *J = new int[nnz];
+   for (int r = 0; r < size; r++)
+   {
+      const int i = t ? r / vd : r % ndofs;
+      int pos = I[r];
+      if (t)
+      {
+         for (int k = I_s[i]; k < I_s[i+1]; k++)
          {
-            // use MAX_VDIM2D to avoid "subscript out of range" warnings
-            double D[MAX_VDIM2D*2];
-            for (int i = 0; i < 2*VDIM; i++) { D[i] = 0.0; }
-            for (int d = 0; d < ND; ++d)
+            for (int c = 0; c < vd; c++) { J[pos++] = J_s[k]*vd + c; }
+         }
+      }
+      else
+      {
+         for (int c = 0; c < vd; c++)
+         {
+            for (int k = I_s[i]; k < I_s[i+1]; k++)
             {
-               const double wx = G(q,0,d);
-               const double wy = G(q,1,d);
-               for (int c = 0; c < VDIM; c++)
-               {
-                  double s_e = s_E[c+d*VDIM];
-                  D[c+VDIM*0] += s_e * wx;
-                  D[c+VDIM*1] += s_e * wy;
-               }
+               J[pos++] = J_s[k] + c*ndofs;
             }
-            if (eval_flags & DERIVATIVES)
+         }
+      }
+   }
+   double *data = new double[nnz];
+   SparseMatrix *mat = new SparseMatrix(I, J, data, size, size,
+                                        true, true, true);
+   *mat = 0.0;
+   return mat;
+}
+
+void ElementRestriction::FillSparseMatrix(const Vector &ea_data,
+                                          SparseMatrix &mat) const
+{
+   MFEM_VERIFY(mat.Finalized() && mat.Height() == vdim*ndofs,
+               "invalid SparseMatrix, see NewSparseMatrix()");
+   const int nd = dof;
+   const int vd = vdim;
+   const bool t = byvdim;
+   const int size = vd*ndofs;
+   const int nnz = mat.NumNonZeroElems();
+   auto d_offsets = offsets.Read();
+   auto d_indices = indices.Read();
+   auto d_gather = gatherMap.Read();
+   auto d_I = Read(mat.GetMemoryI(), size+1);
+   auto d_J = Read(mat.GetMemoryJ(), nnz);
+   auto d_A = Write(mat.GetMemoryData(), nnz);
+   auto A = Reshape(ea_data.Read(), nd, vd, nd, vd, ne);
+   MFEM_FORALL(i, ndofs,
+   {
+      for (int ci = 0; ci < vd; ci++)
+      {
+         const int row = t ? i*vd + ci : i + ci*ndofs;
+         const int row_begin = d_I[row];
+         const int row_end = d_I[row+1];
+         for (int k = row_begin; k < row_end; k++) { d_A[k] = 0.0; }
+         for (int k = d_offsets[i]; k < d_offsets[i+1]; k++)
+         {
+            const int slid = d_indices[k];
+            const int lid = (slid >= 0) ? slid : -1 - slid;
+            const int e = lid / nd;
+            const int i_loc = lid % nd;
+            for (int j_loc = 0; j_loc < nd; j_loc++)
             {
-               for (int c = 0; c < VDIM; c++)
+               const int sgid = d_gather[nd*e + j_loc];
+               const int gid = (sgid >= 0) ? sgid : -1 - sgid;
+               const bool plus = (slid >= 0) == (sgid >= 0);
+               for (int cj = 0; cj < vd; cj++)
                {
-                  der(q,c,0,e) = D[c+VDIM*0];
-                  der(q,c,1,e) = D[c+VDIM*1];
+                  // Binary search for the column in the sorted row
+                  const int col = t ? gid*vd + cj : gid + cj*ndofs;
+                  int lo = row_begin, hi = row_end - 1;
+                  while (lo < hi)
+                  {
+                     const int mid = (lo + hi) / 2;
+                     if (d_J[mid] < col) { lo = mid + 1; }
+                     else { hi = mid; }
+                  }
+                  const double a_ij = A(i_loc, ci, j_loc, cj, e);
+                  d_A[lo] += plus ? a_ij : -a_ij;
                }
             }
-            if (VDIM == 2 && (eval_flags & DETERMINANTS))
-            {
-               // The check (VDIM == 2) should eliminate this block when VDIM is
-               // known at compile time and (VDIM != 2).
-               det(q,e) = D[0]*D[3] - D[1]*D[2];
-            }
          }
       }
    });
 }
 
-template<const int T_VDIM, const int T_ND, const int T_NQ>
-void QuadratureInterpolator::Eval3D(
-   const int NE,
-   const int vdim,
-   const DofToQuad &maps,
-   const Vector &e_vec,
-   Vector &q_val,
-   Vector &q_der,
-   Vector &q_det,
-   const int eval_flags)
+static FaceElementTransformations *GetFaceTransformations(Mesh &mesh,
+                                                          FaceType type,
+                                                          int i)
 {
-   const int nd = maps.ndof;
-   const int nq = maps.nqpt;
-   const int ND = T_ND ? T_ND : nd;
+   return (type == FaceType::Interior) ?
+          mesh.GetInteriorFaceTransformations(i) :
+          mesh.GetBdrFaceTransformations(i);
+}
+
+FaceRestriction::FaceRestriction(const FiniteElementSpace &f, FaceType t)
+   : fes(f),
+     type(t),
+     nsides(t == FaceType::Interior ? 2 : 1),
+     ndofs(fes.GetNDofs()),
+     nf(0),
+     dof(0),
+     nw(1),
+     offsets(ndofs+1)
+{
+   Mesh &mesh = *fes.GetMesh();
+   const int dim = mesh.Dimension();
+   MFEM_VERIFY(fes.GetVDim() == 1, "vector spaces are not supported yet");
+   MFEM_VERIFY(dim == 2 || dim == 3, "only 2D and 3D meshes are supported");
+   MFEM_VERIFY(mesh.Conforming() && !fes.GetNURBSext(),
+               "nonconforming and NURBS spaces are not supported");
+#ifdef MFEM_USE_MPI
+   MFEM_VERIFY(dynamic_cast<const ParFiniteElementSpace*>(&fes) == NULL,
+               "parallel spaces are not supported yet");
+#endif
+   const int ncand = (type == FaceType::Interior) ?
+                     mesh.GetNumFaces() : mesh.GetNBE();
+   for (int i = 0; i < ncand; i++)
+   {
+      if (mfem::GetFaceTransformations(mesh, type, i)) { faces.Append(i); }
+   }
+   nf = faces.Size();
+   width = fes.GetVSize();
+   offsets = 0;
+   if (nf == 0) { return; }
+
+   // Assuming all finite elements are the same.
+   const FiniteElement &fe = *fes.GetFE(0);
+   const TensorBasisElement *el = dynamic_cast<const TensorBasisElement*>(&fe);
+   MFEM_VERIFY(el, "tensor-product elements are required");
+   const Poly_1D::Basis &basis1d = el->GetBasis1D();
+   const Array<int> &dof_map = el->GetDofMap();
+   const int d1d = fe.GetOrder() + 1;
+   // The 1D nodes are the first row of the lexicographic element nodes.
+   Vector nodes1d(d1d);
+   for (int i = 0; i < d1d; i++)
+   {
+      nodes1d(i) = fe.GetNodes().IntPoint(dof_map.Size() ? dof_map[i] : i).x;
+   }
+   dof = (dim == 2) ? d1d : d1d*d1d;
+   height = dof*nsides*nf;
+
+   // Interpolate the trace at every face node from the d1d element DOFs on
+   // the line through the node, normal to the face.
+   const double tol = 1e-10;
+   const int nent = d1d*height;
+   Array<int> all_indices(nent);
+   Vector all_weights(nent);
+   Array<int> edofs;
+   Vector wn(d1d);
+   IntegrationPoint fip, eip;
+   double fxyz[3] = { 0.5, 0.5, 0.0 }, exyz[3];
+   for (int f = 0; f < nf; f++)
+   {
+      FaceElementTransformations *tr =
+         mfem::GetFaceTransformations(mesh, type, faces[f]);
+      for (int s = 0; s < nsides; s++)
+      {
+         const int e = s ? tr->Elem2No : tr->Elem1No;
+         IntegrationPointTransformation &loc = s ? tr->Loc2 : tr->Loc1;
+         MFEM_VERIFY(fes.GetFE(e)->GetDof() == fe.GetDof(),
+                     "all elements must be of the same type");
+         fes.GetElementDofs(e, edofs);
+         // The normal direction is the one where the face center is on the
+         // boundary of the reference element.
+         fip.Set(fxyz, dim-1);
+         loc.Transform(fip, eip);
+         eip.Get(exyz, dim);
+         int dn = -1;
+         for (int d = 0; d < dim; d++)
+         {
+            if (std::min(std::abs(exyz[d]), std::abs(exyz[d]-1.0)) < tol)
+            {
+               dn = d;
+            }
+         }
+         MFEM_VERIFY(dn >= 0, "invalid face transformation");
+         for (int k = 0; k < dof; k++)
+         {
+            const double nxyz[2] = { nodes1d(k % d1d), nodes1d(k / d1d) };
+            fip.Set(nxyz, dim-1);
+            loc.Transform(fip, eip);
+            eip.Get(exyz, dim);
+            int idx[3] = { 0, 0, 0 };
+            for (int d = 0; d < dim; d++)
+            {
+               if (d == dn) { continue; }
+               idx[d] = -1;
+               for (int m = 0; m < d1d; m++)
+               {
+                  if (std::abs(nodes1d(m) - exyz[d]) < tol) { idx[d] = m; }
+               }
+               MFEM_VERIFY(idx[d] >= 0, "the face nodes do not match the "
+                           "element nodes");
+            }
+            basis1d.Eval(exyz[dn], wn);
+            for (int n = 0; n < d1d; n++)
+            {
+               idx[dn] = n;
+               const int lex = idx[0] + d1d*(idx[1] + d1d*idx[2]);
+               const int gid = edofs[dof_map.Size() ? dof_map[lex] : lex];
+               MFEM_VERIFY(gid >= 0, "signed DOFs are not supported");
+               const int j = n + d1d*(k + dof*(s + nsides*f));
+               all_indices[j] = gid;
+               all_weights(j) = wn(n);
+            }
+         }
+      }
+   }
+
+   // With closed 1D bases each face node is a single element DOF.
+   bool closed = true;
+   for (int i = 0; i < height && closed; i++)
+   {
+      int nunit = 0, nzero = 0;
+      for (int n = 0; n < d1d; n++)
+      {
+         const double w = all_weights(n + d1d*i);
+         if (std::abs(w - 1.0) < tol) { nunit++; }
+         else if (std::abs(w) < tol) { nzero++; }
+      }
+      closed = (nunit == 1 && nzero == d1d-1);
+   }
+   nw = closed ? 1 : d1d;
+   scatter_indices.SetSize(nw*height);
+   weights.SetSize(nw*height);
+   for (int i = 0; i < height; i++)
+   {
+      for (int n = 0, m = 0; n < d1d; n++)
+      {
+         const int j = n + d1d*i;
+         if (closed && std::abs(all_weights(j)) < tol) { continue; }
+         scatter_indices[m + nw*i] = all_indices[j];
+         weights(m + nw*i) = closed ? 1.0 : all_weights(j);
+         m++;
+      }
+   }
+
+   // Build the transpose, listing for each L-vector DOF its entries
+   for (int j = 0; j < nw*height; j++)
+   {
+      ++offsets[scatter_indices[j] + 1];
+   }
+   for (int i = 1; i <= ndofs; ++i)
+   {
+      offsets[i] += offsets[i - 1];
+   }
+   indices.SetSize(nw*height);
+   for (int j = 0; j < nw*height; j++)
+   {
+      indices[offsets[scatter_indices[j]]++] = j;
+   }
+   for (int i = ndofs; i > 0; --i)
+   {
+      offsets[i] = offsets[i - 1];
+   }
+   offsets[0] = 0;
+}
+
+FaceElementTransformations *FaceRestriction::GetFaceTransformations(
+   int f) const
+{
+   return mfem::GetFaceTransformations(*fes.GetMesh(), type, faces[f]);
+}
+
+void FaceRestriction::Mult(const Vector &x, Vector &y) const
+{
+   const int n = height;
+   const int w = nw;
+   auto d_indices = scatter_indices.Read();
+   auto d_weights = weights.Read();
+   auto d_x = x.Read();
+   auto d_y = y.Write();
+   MFEM_FORALL(i, n,
+   {
+      double value = 0.0;
+      for (int j = i*w; j < (i+1)*w; j++)
+      {
+         value += d_weights[j] * d_x[d_indices[j]];
+      }
+      d_y[i] = value;
+   });
+}
+
+void FaceRestriction::MultTranspose(const Vector &x, Vector &y,
+                                    const bool add) const
+{
+   const int w = nw;
+   auto d_offsets = offsets.Read();
+   auto d_indices = indices.Read();
+   auto d_weights = weights.Read();
+   auto d_x = x.Read();
+   auto d_y = add ? y.ReadWrite() : y.Write();
+   MFEM_FORALL(i, ndofs,
+   {
+      double value = add ? d_y[i] : 0.0;
+      for (int j = d_offsets[i]; j < d_offsets[i+1]; j++)
+      {
+         const int idx_j = d_indices[j];
+         value += d_weights[idx_j] * d_x[idx_j / w];
+      }
+      d_y[i] = value;
+   });
+}
+
+void FaceRestriction::MultTranspose(const Vector &x, Vector &y) const
+{
+   MultTranspose(x, y, false);
+}
+
+void FaceRestriction::AddMultTranspose(const Vector &x, Vector &y) const
+{
+   MultTranspose(x, y, true);
+}
+
+
+QuadratureInterpolator::QuadratureInterpolator(const FiniteElementSpace &fes,
+                                               const IntegrationRule &ir)
+{
+   fespace = &fes;
+   qspace = NULL;
+   IntRule = &ir;
+   use_tensor_products = true;
+
+   if (fespace->GetNE() == 0) { return; }
+   const FiniteElement *fe = fespace->GetFE(0);
+   MFEM_VERIFY(dynamic_cast<const ScalarFiniteElement*>(fe) != NULL,
+               "Only scalar finite elements are supported");
+}
+
+QuadratureInterpolator::QuadratureInterpolator(const FiniteElementSpace &fes,
+                                               const QuadratureSpace &qs)
+{
+   fespace = &fes;
+   qspace = &qs;
+   IntRule = NULL;
+   use_tensor_products = true;
+
+   if (fespace->GetNE() == 0) { return; }
+   const FiniteElement *fe = fespace->GetFE(0);
+   MFEM_VERIFY(dynamic_cast<const ScalarFiniteElement*>(fe) != NULL,
+               "Only scalar finite elements are supported");
+}
+
+template<const int T_VDIM, const int T_ND, const int T_NQ>
+void QuadratureInterpolator::Eval2D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &e_vec,
+   Vector &q_val,
+   Vector &q_der,
+   Vector &q_det,
+   const int eval_flags)
+{
+   const int nd = maps.ndof;
+   const int nq = maps.nqpt;
+   const int ND = T_ND ? T_ND : nd;
+   const int NQ = T_NQ ? T_NQ : nq;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(ND <= MAX_ND2D, "");
+   MFEM_VERIFY(NQ <= MAX_NQ2D, "");
+   MFEM_VERIFY(VDIM == 2 || !(eval_flags & DETERMINANTS), "");
+   auto B = Reshape(maps.B.Read(), NQ, ND);
+   auto G = Reshape(maps.G.Read(), NQ, 2, ND);
+   auto E = Reshape(e_vec.Read(), ND, VDIM, NE);
+   auto val = Reshape(q_val.Write(), NQ, VDIM, NE);
+   auto der = Reshape(q_der.Write(), NQ, VDIM, 2, NE);
+   auto det = Reshape(q_det.Write(), NQ, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int ND = T_ND ? T_ND : nd;
+      const int NQ = T_NQ ? T_NQ : nq;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_ND = T_ND ? T_ND : MAX_ND2D;
+      constexpr int max_VDIM = T_VDIM ? T_VDIM : MAX_VDIM2D;
+      double s_E[max_VDIM*max_ND];
+      for (int d = 0; d < ND; d++)
+      {
+         for (int c = 0; c < VDIM; c++)
+         {
+            s_E[c+d*VDIM] = E(d,c,e);
+         }
+      }
+      for (int q = 0; q < NQ; ++q)
+      {
+         if (eval_flags & VALUES)
+         {
+            double ed[max_VDIM];
+            for (int c = 0; c < VDIM; c++) { ed[c] = 0.0; }
+            for (int d = 0; d < ND; ++d)
+            {
+               const double b = B(q,d);
+               for (int c = 0; c < VDIM; c++) { ed[c] += b*s_E[c+d*VDIM]; }
+            }
+            for (int c = 0; c < VDIM; c++) { val(q,c,e) = ed[c]; }
+         }
+         if ((eval_flags & DERIVATIVES) || (eval_flags & DETERMINANTS))
+         {
+            // use MAX_VDIM2D to avoid "subscript out of range" warnings
+            double D[MAX_VDIM2D*2];
+            for (int i = 0; i < 2*VDIM; i++) { D[i] = 0.0; }
+            for (int d = 0; d < ND; ++d)
+            {
+               const double wx = G(q,0,d);
+               const double wy = G(q,1,d);
+               for (int c = 0; c < VDIM; c++)
+               {
+                  double s_e = s_E[c+d*VDIM];
+                  D[c+VDIM*0] += s_e * wx;
+                  D[c+VDIM*1] += s_e * wy;
+               }
+            }
+            if (eval_flags & DERIVATIVES)
+            {
+               for (int c = 0; c < VDIM; c++)
+               {
+                  der(q,c,0,e) = D[c+VDIM*0];
+                  der(q,c,1,e) = D[c+VDIM*1];
+               }
+            }
+            if (VDIM == 2 && (eval_flags & DETERMINANTS))
+            {
+               // The check (VDIM == 2) should eliminate this block when VDIM is
+               // known at compile time and (VDIM != 2).
+               det(q,e) = D[0]*D[3] - D[1]*D[2];
+            }
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_ND, const int T_NQ>
+void QuadratureInterpolator::Eval3D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &e_vec,
+   Vector &q_val,
+   Vector &q_der,
+   Vector &q_det,
+   const int eval_flags)
+{
+   const int nd = maps.ndof;
+   const int nq = maps.nqpt;
+   const int ND = T_ND ? T_ND : nd;
+   const int NQ = T_NQ ? T_NQ : nq;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(ND <= MAX_ND3D, "");
+   MFEM_VERIFY(NQ <= MAX_NQ3D, "");
+   MFEM_VERIFY(VDIM == 3 || !(eval_flags & DETERMINANTS), "");
+   auto B = Reshape(maps.B.Read(), NQ, ND);
+   auto G = Reshape(maps.G.Read(), NQ, 3, ND);
+   auto E = Reshape(e_vec.Read(), ND, VDIM, NE);
+   auto val = Reshape(q_val.Write(), NQ, VDIM, NE);
+   auto der = Reshape(q_der.Write(), NQ, VDIM, 3, NE);
+   auto det = Reshape(q_det.Write(), NQ, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int ND = T_ND ? T_ND : nd;
+      const int NQ = T_NQ ? T_NQ : nq;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_ND = T_ND ? T_ND : MAX_ND3D;
+      constexpr int max_VDIM = T_VDIM ? T_VDIM : MAX_VDIM3D;
+      double s_E[max_VDIM*max_ND];
+      for (int d = 0; d < ND; d++)
+      {
+         for (int c = 0; c < VDIM; c++)
+         {
+            s_E[c+d*VDIM] = E(d,c,e);
+         }
+      }
+      for (int q = 0; q < NQ; ++q)
+      {
+         if (eval_flags & VALUES)
+         {
+            double ed[max_VDIM];
+            for (int c = 0; c < VDIM; c++) { ed[c] = 0.0; }
+            for (int d = 0; d < ND; ++d)
+            {
+               const double b = B(q,d);
+               for (int c = 0; c < VDIM; c++) { ed[c] += b*s_E[c+d*VDIM]; }
+            }
+            for (int c = 0; c < VDIM; c++) { val(q,c,e) = ed[c]; }
+         }
+         if ((eval_flags & DERIVATIVES) || (eval_flags & DETERMINANTS))
+         {
+            // use MAX_VDIM3D to avoid "subscript out of range" warnings
+            double D[MAX_VDIM3D*3];
+            for (int i = 0; i < 3*VDIM; i++) { D[i] = 0.0; }
+            for (int d = 0; d < ND; ++d)
+            {
+               const double wx = G(q,0,d);
+               const double wy = G(q,1,d);
+               const double wz = G(q,2,d);
+               for (int c = 0; c < VDIM; c++)
+               {
+                  double s_e = s_E[c+d*VDIM];
+                  D[c+VDIM*0] += s_e * wx;
+                  D[c+VDIM*1] += s_e * wy;
+                  D[c+VDIM*2] += s_e * wz;
+               }
+            }
+            if (eval_flags & DERIVATIVES)
+            {
+               for (int c = 0; c < VDIM; c++)
+               {
+                  der(q,c,0,e) = D[c+VDIM*0];
+                  der(q,c,1,e) = D[c+VDIM*1];
+                  der(q,c,2,e) = D[c+VDIM*2];
+               }
+            }
+            if (VDIM == 3 && (eval_flags & DETERMINANTS))
+            {
+               // The check (VDIM == 3) should eliminate this block when VDIM is
+               // known at compile time and (VDIM != 3).
+               det(q,e) = D[0] * (D[4] * D[8] - D[5] * D[7]) +
+                          D[3] * (D[2] * D[7] - D[1] * D[8]) +
+                          D[6] * (D[1] * D[5] - D[2] * D[4]);
+            }
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_D1D, const int T_Q1D>
+void QuadratureInterpolator::TensorEval2D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Array<int> &dof_map,
+   const Vector &e_vec,
+   Vector &q_val,
+   Vector &q_der,
+   Vector &q_det,
+   const int eval_flags)
+{
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(VDIM == 2 || !(eval_flags & DETERMINANTS), "");
+   const bool reorder = (dof_map.Size() > 0);
+   auto B = Reshape(maps.B.Read(), Q1D, D1D);
+   auto G = Reshape(maps.G.Read(), Q1D, D1D);
+   auto map = dof_map.Read();
+   auto E = Reshape(e_vec.Read(), D1D*D1D, VDIM, NE);
+   auto val = Reshape(q_val.Write(), Q1D, Q1D, VDIM, NE);
+   auto der = Reshape(q_der.Write(), Q1D, Q1D, VDIM, 2, NE);
+   auto det = Reshape(q_det.Write(), Q1D, Q1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      const bool eval_der = (eval_flags & (DERIVATIVES | DETERMINANTS));
+      for (int c = 0; c < VDIM; c++)
+      {
+         double X[max_D1D][max_D1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const int d = dx + D1D*dy;
+               X[dy][dx] = E(reorder ? map[d] : d, c, e);
+            }
+         }
+         double BX[max_D1D][max_Q1D], GX[max_D1D][max_Q1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               double b = 0.0, g = 0.0;
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  b += B(qx,dx) * X[dy][dx];
+                  g += G(qx,dx) * X[dy][dx];
+               }
+               BX[dy][qx] = b;
+               GX[dy][qx] = g;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               double u = 0.0, du_dx = 0.0, du_dy = 0.0;
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  const double wy = B(qy,dy);
+                  const double wDy = G(qy,dy);
+                  u += wy * BX[dy][qx];
+                  du_dx += wy * GX[dy][qx];
+                  du_dy += wDy * BX[dy][qx];
+               }
+               if (eval_flags & VALUES) { val(qx,qy,c,e) = u; }
+               if (eval_der)
+               {
+                  der(qx,qy,c,0,e) = du_dx;
+                  der(qx,qy,c,1,e) = du_dy;
+               }
+            }
+         }
+      }
+      if (VDIM == 2 && (eval_flags & DETERMINANTS))
+      {
+         // The derivatives were computed above, for all components
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               det(qx,qy,e) = der(qx,qy,0,0,e)*der(qx,qy,1,1,e) -
+                              der(qx,qy,1,0,e)*der(qx,qy,0,1,e);
+            }
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_D1D, const int T_Q1D>
+void QuadratureInterpolator::TensorEval3D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Array<int> &dof_map,
+   const Vector &e_vec,
+   Vector &q_val,
+   Vector &q_der,
+   Vector &q_det,
+   const int eval_flags)
+{
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(VDIM == 3 || !(eval_flags & DETERMINANTS), "");
+   const bool reorder = (dof_map.Size() > 0);
+   auto B = Reshape(maps.B.Read(), Q1D, D1D);
+   auto G = Reshape(maps.G.Read(), Q1D, D1D);
+   auto map = dof_map.Read();
+   auto E = Reshape(e_vec.Read(), D1D*D1D*D1D, VDIM, NE);
+   auto val = Reshape(q_val.Write(), Q1D, Q1D, Q1D, VDIM, NE);
+   auto der = Reshape(q_der.Write(), Q1D, Q1D, Q1D, VDIM, 3, NE);
+   auto det = Reshape(q_det.Write(), Q1D, Q1D, Q1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      const bool eval_der = (eval_flags & (DERIVATIVES | DETERMINANTS));
+      for (int c = 0; c < VDIM; c++)
+      {
+         double X[max_D1D][max_D1D][max_D1D];
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  const int d = dx + D1D*(dy + D1D*dz);
+                  X[dz][dy][dx] = E(reorder ? map[d] : d, c, e);
+               }
+            }
+         }
+         double BX[max_D1D][max_D1D][max_Q1D];
+         double GX[max_D1D][max_D1D][max_Q1D];
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  double b = 0.0, g = 0.0;
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     b += B(qx,dx) * X[dz][dy][dx];
+                     g += G(qx,dx) * X[dz][dy][dx];
+                  }
+                  BX[dz][dy][qx] = b;
+                  GX[dz][dy][qx] = g;
+               }
+            }
+         }
+         double BBX[max_D1D][max_Q1D][max_Q1D];
+         double BGX[max_D1D][max_Q1D][max_Q1D];
+         double GBX[max_D1D][max_Q1D][max_Q1D];
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  double bb = 0.0, bg = 0.0, gb = 0.0;
+                  for (int dy = 0; dy < D1D; ++dy)
+                  {
+                     const double wy = B(qy,dy);
+                     const double wDy = G(qy,dy);
+                     bb += wy * BX[dz][dy][qx];
+                     bg += wy * GX[dz][dy][qx];
+                     gb += wDy * BX[dz][dy][qx];
+                  }
+                  BBX[dz][qy][qx] = bb;
+                  BGX[dz][qy][qx] = bg;
+                  GBX[dz][qy][qx] = gb;
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  double u = 0.0, du_dx = 0.0, du_dy = 0.0, du_dz = 0.0;
+                  for (int dz = 0; dz < D1D; ++dz)
+                  {
+                     const double wz = B(qz,dz);
+                     const double wDz = G(qz,dz);
+                     u += wz * BBX[dz][qy][qx];
+                     du_dx += wz * BGX[dz][qy][qx];
+                     du_dy += wz * GBX[dz][qy][qx];
+                     du_dz += wDz * BBX[dz][qy][qx];
+                  }
+                  if (eval_flags & VALUES) { val(qx,qy,qz,c,e) = u; }
+                  if (eval_der)
+                  {
+                     der(qx,qy,qz,c,0,e) = du_dx;
+                     der(qx,qy,qz,c,1,e) = du_dy;
+                     der(qx,qy,qz,c,2,e) = du_dz;
+                  }
+               }
+            }
+         }
+      }
+      if (VDIM == 3 && (eval_flags & DETERMINANTS))
+      {
+         // The derivatives were computed above, for all components
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  double D[9];
+                  for (int d = 0; d < 3; d++)
+                  {
+                     for (int c = 0; c < 3; c++)
+                     {
+                        D[c+3*d] = der(qx,qy,qz,c,d,e);
+                     }
+                  }
+                  det(qx,qy,qz,e) = D[0] * (D[4] * D[8] - D[5] * D[7]) +
+                                    D[3] * (D[2] * D[7] - D[1] * D[8]) +
+                                    D[6] * (D[1] * D[5] - D[2] * D[4]);
+               }
+            }
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_ND, const int T_NQ>
+void QuadratureInterpolator::EvalTranspose2D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &q_val,
+   const Vector &q_der,
+   Vector &e_vec,
+   const int eval_flags)
+{
+   const int nd = maps.ndof;
+   const int nq = maps.nqpt;
+   const int ND = T_ND ? T_ND : nd;
+   const int NQ = T_NQ ? T_NQ : nq;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(ND <= MAX_ND2D, "");
+   MFEM_VERIFY(NQ <= MAX_NQ2D, "");
+   MFEM_VERIFY(VDIM <= MAX_VDIM2D, "");
+   auto B = Reshape(maps.B.Read(), NQ, ND);
+   auto G = Reshape(maps.G.Read(), NQ, 2, ND);
+   auto val = Reshape(q_val.Read(), NQ, VDIM, NE);
+   auto der = Reshape(q_der.Read(), NQ, VDIM, 2, NE);
+   auto E = Reshape(e_vec.Write(), ND, VDIM, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int ND = T_ND ? T_ND : nd;
+      const int NQ = T_NQ ? T_NQ : nq;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_ND = T_ND ? T_ND : MAX_ND2D;
+      constexpr int max_VDIM = T_VDIM ? T_VDIM : MAX_VDIM2D;
+      double s_E[max_VDIM*max_ND];
+      for (int i = 0; i < VDIM*ND; i++) { s_E[i] = 0.0; }
+      for (int q = 0; q < NQ; ++q)
+      {
+         if (eval_flags & VALUES)
+         {
+            double s_val[max_VDIM];
+            for (int c = 0; c < VDIM; c++) { s_val[c] = val(q,c,e); }
+            for (int d = 0; d < ND; ++d)
+            {
+               const double b = B(q,d);
+               for (int c = 0; c < VDIM; c++) { s_E[c+d*VDIM] += b*s_val[c]; }
+            }
+         }
+         if (eval_flags & DERIVATIVES)
+         {
+            // use MAX_VDIM2D to avoid "subscript out of range" warnings
+            double D[MAX_VDIM2D*2];
+            for (int c = 0; c < VDIM; c++)
+            {
+               D[c+VDIM*0] = der(q,c,0,e);
+               D[c+VDIM*1] = der(q,c,1,e);
+            }
+            for (int d = 0; d < ND; ++d)
+            {
+               const double wx = G(q,0,d);
+               const double wy = G(q,1,d);
+               for (int c = 0; c < VDIM; c++)
+               {
+                  s_E[c+d*VDIM] += wx * D[c+VDIM*0] + wy * D[c+VDIM*1];
+               }
+            }
+         }
+      }
+      for (int d = 0; d < ND; d++)
+      {
+         for (int c = 0; c < VDIM; c++)
+         {
+            E(d,c,e) = s_E[c+d*VDIM];
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_ND, const int T_NQ>
+void QuadratureInterpolator::EvalTranspose3D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &q_val,
+   const Vector &q_der,
+   Vector &e_vec,
+   const int eval_flags)
+{
+   const int nd = maps.ndof;
+   const int nq = maps.nqpt;
+   const int ND = T_ND ? T_ND : nd;
    const int NQ = T_NQ ? T_NQ : nq;
    const int VDIM = T_VDIM ? T_VDIM : vdim;
    MFEM_VERIFY(ND <= MAX_ND3D, "");
    MFEM_VERIFY(NQ <= MAX_NQ3D, "");
-   MFEM_VERIFY(VDIM == 3 || !(eval_flags & DETERMINANTS), "");
+   MFEM_VERIFY(VDIM <= MAX_VDIM3D, "");
    auto B = Reshape(maps.B.Read(), NQ, ND);
    auto G = Reshape(maps.G.Read(), NQ, 3, ND);
-   auto E = Reshape(e_vec.Read(), ND, VDIM, NE);
-   auto val = Reshape(q_val.Write(), NQ, VDIM, NE);
-   auto der = Reshape(q_der.Write(), NQ, VDIM, 3, NE);
-   auto det = Reshape(q_det.Write(), NQ, NE);
+   auto val = Reshape(q_val.Read(), NQ, VDIM, NE);
+   auto der = Reshape(q_der.Read(), NQ, VDIM, 3, NE);
+   auto E = Reshape(e_vec.Write(), ND, VDIM, NE);
    MFEM_FORALL(e, NE,
    {
       const int ND = T_ND ? T_ND : nd;
       const int NQ = T_NQ ? T_NQ : nq;
       const int VDIM = T_VDIM ? T_VDIM : vdim;
-      constexpr int max_ND = T_ND ? T_ND : MAX_ND2D;
-      constexpr int max_VDIM = T_VDIM ? T_VDIM : MAX_VDIM2D;
+      constexpr int max_ND = T_ND ? T_ND : MAX_ND3D;
+      constexpr int max_VDIM = T_VDIM ? T_VDIM : MAX_VDIM3D;
       double s_E[max_VDIM*max_ND];
-      for (int d = 0; d < ND; d++)
-      {
-         for (int c = 0; c < VDIM; c++)
-         {
-            s_E[c+d*VDIM] = E(d,c,e);
-         }
-      }
+      for (int i = 0; i < VDIM*ND; i++) { s_E[i] = 0.0; }
       for (int q = 0; q < NQ; ++q)
       {
          if (eval_flags & VALUES)
          {
-            double ed[max_VDIM];
-            for (int c = 0; c < VDIM; c++) { ed[c] = 0.0; }
+            double s_val[max_VDIM];
+            for (int c = 0; c < VDIM; c++) { s_val[c] = val(q,c,e); }
             for (int d = 0; d < ND; ++d)
             {
                const double b = B(q,d);
-               for (int c = 0; c < VDIM; c++) { ed[c] += b*s_E[c+d*VDIM]; }
+               for (int c = 0; c < VDIM; c++) { s_E[c+d*VDIM] += b*s_val[c]; }
             }
-            for (int c = 0; c < VDIM; c++) { val(q,c,e) = ed[c]; }
          }
-         if ((eval_flags & DERIVATIVES) || (eval_flags & DETERMINANTS))
+         if (eval_flags & DERIVATIVES)
          {
             // use MAX_VDIM3D to avoid "subscript out of range" warnings
             double D[MAX_VDIM3D*3];
-            for (int i = 0; i < 3*VDIM; i++) { D[i] = 0.0; }
+            for (int c = 0; c < VDIM; c++)
+            {
+               D[c+VDIM*0] = der(q,c,0,e);
+               D[c+VDIM*1] = der(q,c,1,e);
+               D[c+VDIM*2] = der(q,c,2,e);
+            }
             for (int d = 0; d < ND; ++d)
             {
                const double wx = G(q,0,d);
@@ -2947,28 +3939,200 @@ void QuadratureInterpolator::Eval3D(
                const double wz = G(q,2,d);
                for (int c = 0; c < VDIM; c++)
                {
-                  double s_e = s_E[c+d*VDIM];
-                  D[c+VDIM*0] += s_e * wx;
-                  D[c+VDIM*1] += s_e * wy;
-                  D[c+VDIM*2] += s_e * wz;
+                  s_E[c+d*VDIM] += wx * D[c+VDIM*0] + wy * D[c+VDIM*1] +
+                                   wz * D[c+VDIM*2];
                }
             }
-            if (eval_flags & DERIVATIVES)
+         }
+      }
+      for (int d = 0; d < ND; d++)
+      {
+         for (int c = 0; c < VDIM; c++)
+         {
+            E(d,c,e) = s_E[c+d*VDIM];
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_D1D, const int T_Q1D>
+void QuadratureInterpolator::TensorEvalTranspose2D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Array<int> &dof_map,
+   const Vector &q_val,
+   const Vector &q_der,
+   Vector &e_vec,
+   const int eval_flags)
+{
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const bool reorder = (dof_map.Size() > 0);
+   auto B = Reshape(maps.B.Read(), Q1D, D1D);
+   auto G = Reshape(maps.G.Read(), Q1D, D1D);
+   auto map = dof_map.Read();
+   auto val = Reshape(q_val.Read(), Q1D, Q1D, VDIM, NE);
+   auto der = Reshape(q_der.Read(), Q1D, Q1D, VDIM, 2, NE);
+   auto E = Reshape(e_vec.Write(), D1D*D1D, VDIM, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      const bool use_val = (eval_flags & VALUES);
+      const bool use_der = (eval_flags & DERIVATIVES);
+      for (int c = 0; c < VDIM; c++)
+      {
+         // A collects the terms with B in x, C the terms with G in x
+         double A[max_D1D][max_Q1D], C[max_D1D][max_Q1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
             {
-               for (int c = 0; c < VDIM; c++)
+               double a = 0.0, g = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy)
                {
-                  der(q,c,0,e) = D[c+VDIM*0];
-                  der(q,c,1,e) = D[c+VDIM*1];
-                  der(q,c,2,e) = D[c+VDIM*2];
+                  const double wy = B(qy,dy);
+                  const double wDy = G(qy,dy);
+                  if (use_val) { a += wy * val(qx,qy,c,e); }
+                  if (use_der)
+                  {
+                     a += wDy * der(qx,qy,c,1,e);
+                     g += wy * der(qx,qy,c,0,e);
+                  }
                }
+               A[dy][qx] = a;
+               C[dy][qx] = g;
             }
-            if (VDIM == 3 && (eval_flags & DETERMINANTS))
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
             {
-               // The check (VDIM == 3) should eliminate this block when VDIM is
-               // known at compile time and (VDIM != 3).
-               det(q,e) = D[0] * (D[4] * D[8] - D[5] * D[7]) +
-                          D[3] * (D[2] * D[7] - D[1] * D[8]) +
-                          D[6] * (D[1] * D[5] - D[2] * D[4]);
+               double u = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  u += B(qx,dx) * A[dy][qx] + G(qx,dx) * C[dy][qx];
+               }
+               const int d = dx + D1D*dy;
+               E(reorder ? map[d] : d, c, e) = u;
+            }
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_D1D, const int T_Q1D>
+void QuadratureInterpolator::TensorEvalTranspose3D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Array<int> &dof_map,
+   const Vector &q_val,
+   const Vector &q_der,
+   Vector &e_vec,
+   const int eval_flags)
+{
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const bool reorder = (dof_map.Size() > 0);
+   auto B = Reshape(maps.B.Read(), Q1D, D1D);
+   auto G = Reshape(maps.G.Read(), Q1D, D1D);
+   auto map = dof_map.Read();
+   auto val = Reshape(q_val.Read(), Q1D, Q1D, Q1D, VDIM, NE);
+   auto der = Reshape(q_der.Read(), Q1D, Q1D, Q1D, VDIM, 3, NE);
+   auto E = Reshape(e_vec.Write(), D1D*D1D*D1D, VDIM, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      const bool use_val = (eval_flags & VALUES);
+      const bool use_der = (eval_flags & DERIVATIVES);
+      for (int c = 0; c < VDIM; c++)
+      {
+         // Contract in z: U collects the terms with B in x and y, D0 the terms
+         // with G in x, D1 the terms with G in y
+         double U[max_D1D][max_Q1D][max_Q1D];
+         double D0[max_D1D][max_Q1D][max_Q1D];
+         double D1[max_D1D][max_Q1D][max_Q1D];
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  double u = 0.0, d0 = 0.0, d1 = 0.0;
+                  for (int qz = 0; qz < Q1D; ++qz)
+                  {
+                     const double wz = B(qz,dz);
+                     const double wDz = G(qz,dz);
+                     if (use_val) { u += wz * val(qx,qy,qz,c,e); }
+                     if (use_der)
+                     {
+                        u += wDz * der(qx,qy,qz,c,2,e);
+                        d0 += wz * der(qx,qy,qz,c,0,e);
+                        d1 += wz * der(qx,qy,qz,c,1,e);
+                     }
+                  }
+                  U[dz][qy][qx] = u;
+                  D0[dz][qy][qx] = d0;
+                  D1[dz][qy][qx] = d1;
+               }
+            }
+         }
+         // Contract in y: A collects the terms with B in x, C the terms with G
+         // in x
+         double A[max_D1D][max_D1D][max_Q1D];
+         double C[max_D1D][max_D1D][max_Q1D];
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  double a = 0.0, g = 0.0;
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     const double wy = B(qy,dy);
+                     const double wDy = G(qy,dy);
+                     a += wy * U[dz][qy][qx] + wDy * D1[dz][qy][qx];
+                     g += wy * D0[dz][qy][qx];
+                  }
+                  A[dz][dy][qx] = a;
+                  C[dz][dy][qx] = g;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  double u = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     u += B(qx,dx) * A[dz][dy][qx] + G(qx,dx) * C[dz][dy][qx];
+                  }
+                  const int d = dx + D1D*(dy + D1D*dz);
+                  E(reorder ? map[d] : d, c, e) = u;
+               }
             }
          }
       }
@@ -2986,6 +4150,22 @@ void QuadratureInterpolator::Mult(
    const FiniteElement *fe = fespace->GetFE(0);
    const IntegrationRule *ir =
       IntRule ? IntRule : &qspace->GetElementIntRule(0);
+
+   const TensorBasisElement *tfe = dynamic_cast<const TensorBasisElement*>(fe);
+   if (use_tensor_products && tfe && (dim == 2 || dim == 3) &&
+       (vdim == 1 || vdim == dim) && ir->IsTensorProduct(dim))
+   {
+      const DofToQuad &tmaps = fe->GetDofToQuad(*ir, DofToQuad::TENSOR);
+      const int d1d = tmaps.ndof;
+      const int q1d = tmaps.nqpt;
+      if (d1d <= MAX_D1D && q1d <= MAX_Q1D)
+      {
+         TensorMult(dim, vdim, tmaps, tfe->GetDofMap(), e_vec, eval_flags,
+                    q_val, q_der, q_det);
+         return;
+      }
+   }
+
    const DofToQuad &maps = fe->GetDofToQuad(*ir, DofToQuad::FULL);
    const int nd = maps.ndof;
    const int nq = maps.nqpt;
@@ -3116,11 +4296,322 @@ void QuadratureInterpolator::Mult(
    }
 }
 
+void QuadratureInterpolator::TensorMult(
+   const int dim, const int vdim, const DofToQuad &maps,
+   const Array<int> &dof_map, const Vector &e_vec, unsigned eval_flags,
+   Vector &q_val, Vector &q_der, Vector &q_det) const
+{
+   const int ne = fespace->GetNE();
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   // The determinants are computed from the derivatives, so these need to be
+   // stored even when only the determinants are requested.
+   Vector tmp_der;
+   const bool need_tmp_der =
+      (eval_flags & DETERMINANTS) && !(eval_flags & DERIVATIVES);
+   if (need_tmp_der)
+   {
+      const int nq = (dim == 2) ? q1d*q1d : q1d*q1d*q1d;
+      tmp_der.SetSize(nq*vdim*dim*ne, Device::GetMemoryType());
+   }
+   Vector &der = need_tmp_der ? tmp_der : q_der;
+   void (*eval_func)(
+      const int NE,
+      const int vdim,
+      const DofToQuad &maps,
+      const Array<int> &dof_map,
+      const Vector &e_vec,
+      Vector &q_val,
+      Vector &q_der,
+      Vector &q_det,
+      const int eval_flags) = NULL;
+   if (dim == 2)
+   {
+      switch ((vdim << 8) | (d1d << 4) | q1d)
+      {
+         case 0x122: eval_func = &TensorEval2D<1,2,2>; break;
+         case 0x123: eval_func = &TensorEval2D<1,2,3>; break;
+         case 0x133: eval_func = &TensorEval2D<1,3,3>; break;
+         case 0x134: eval_func = &TensorEval2D<1,3,4>; break;
+         case 0x144: eval_func = &TensorEval2D<1,4,4>; break;
+         case 0x145: eval_func = &TensorEval2D<1,4,5>; break;
+         case 0x155: eval_func = &TensorEval2D<1,5,5>; break;
+         case 0x156: eval_func = &TensorEval2D<1,5,6>; break;
+         case 0x222: eval_func = &TensorEval2D<2,2,2>; break;
+         case 0x223: eval_func = &TensorEval2D<2,2,3>; break;
+         case 0x233: eval_func = &TensorEval2D<2,3,3>; break;
+         case 0x234: eval_func = &TensorEval2D<2,3,4>; break;
+         case 0x244: eval_func = &TensorEval2D<2,4,4>; break;
+         case 0x245: eval_func = &TensorEval2D<2,4,5>; break;
+         case 0x255: eval_func = &TensorEval2D<2,5,5>; break;
+         case 0x256: eval_func = &TensorEval2D<2,5,6>; break;
+      }
+      if (!eval_func)
+      {
+         eval_func = (vdim == 1) ? &TensorEval2D<1> : &TensorEval2D<2>;
+      }
+   }
+   else if (dim == 3)
+   {
+      switch ((vdim << 8) | (d1d << 4) | q1d)
+      {
+         case 0x122: eval_func = &TensorEval3D<1,2,2>; break;
+         case 0x123: eval_func = &TensorEval3D<1,2,3>; break;
+         case 0x133: eval_func = &TensorEval3D<1,3,3>; break;
+         case 0x134: eval_func = &TensorEval3D<1,3,4>; break;
+         case 0x144: eval_func = &TensorEval3D<1,4,4>; break;
+         case 0x145: eval_func = &TensorEval3D<1,4,5>; break;
+         case 0x155: eval_func = &TensorEval3D<1,5,5>; break;
+         case 0x156: eval_func = &TensorEval3D<1,5,6>; break;
+         case 0x322: eval_func = &TensorEval3D<3,2,2>; break;
+         case 0x323: eval_func = &TensorEval3D<3,2,3>; break;
+         case 0x333: eval_func = &TensorEval3D<3,3,3>; break;
+         case 0x334: eval_func = &TensorEval3D<3,3,4>; break;
+         case 0x344: eval_func = &TensorEval3D<3,4,4>; break;
+         case 0x345: eval_func = &TensorEval3D<3,4,5>; break;
+         case 0x355: eval_func = &TensorEval3D<3,5,5>; break;
+         case 0x356: eval_func = &TensorEval3D<3,5,6>; break;
+      }
+      if (!eval_func)
+      {
+         eval_func = (vdim == 1) ? &TensorEval3D<1> : &TensorEval3D<3>;
+      }
+   }
+   MFEM_VERIFY(eval_func, "case not supported yet");
+   eval_func(ne, vdim, maps, dof_map, e_vec, q_val, der, q_det, eval_flags);
+}
+
 void QuadratureInterpolator::MultTranspose(
    unsigned eval_flags, const Vector &q_val, const Vector &q_der,
    Vector &e_vec) const
 {
-   MFEM_ABORT("this method is not implemented yet");
+   MFEM_VERIFY(!(eval_flags & DETERMINANTS),
+               "the DETERMINANTS flag is not supported in MultTranspose()");
+   const int ne = fespace->GetNE();
+   if (ne == 0) { return; }
+   const int vdim = fespace->GetVDim();
+   const int dim = fespace->GetMesh()->Dimension();
+   const FiniteElement *fe = fespace->GetFE(0);
+   const IntegrationRule *ir =
+      IntRule ? IntRule : &qspace->GetElementIntRule(0);
+
+   const TensorBasisElement *tfe = dynamic_cast<const TensorBasisElement*>(fe);
+   if (use_tensor_products && tfe && (dim == 2 || dim == 3) &&
+       (vdim == 1 || vdim == dim) && ir->IsTensorProduct(dim))
+   {
+      const DofToQuad &tmaps = fe->GetDofToQuad(*ir, DofToQuad::TENSOR);
+      const int d1d = tmaps.ndof;
+      const int q1d = tmaps.nqpt;
+      if (d1d <= MAX_D1D && q1d <= MAX_Q1D)
+      {
+         TensorMultTranspose(dim, vdim, tmaps, tfe->GetDofMap(), eval_flags,
+                             q_val, q_der, e_vec);
+         return;
+      }
+   }
+
+   const DofToQuad &maps = fe->GetDofToQuad(*ir, DofToQuad::FULL);
+   const int nd = maps.ndof;
+   const int nq = maps.nqpt;
+   void (*eval_func)(
+      const int NE,
+      const int vdim,
+      const DofToQuad &maps,
+      const Vector &q_val,
+      const Vector &q_der,
+      Vector &e_vec,
+      const int eval_flags) = NULL;
+   if (vdim == 1)
+   {
+      if (dim == 2)
+      {
+         switch (100*nd + nq)
+         {
+            // Q0
+            case 101: eval_func = &EvalTranspose2D<1,1,1>; break;
+            case 104: eval_func = &EvalTranspose2D<1,1,4>; break;
+            // Q1
+            case 404: eval_func = &EvalTranspose2D<1,4,4>; break;
+            case 409: eval_func = &EvalTranspose2D<1,4,9>; break;
+            // Q2
+            case 909: eval_func = &EvalTranspose2D<1,9,9>; break;
+            case 916: eval_func = &EvalTranspose2D<1,9,16>; break;
+            // Q3
+            case 1616: eval_func = &EvalTranspose2D<1,16,16>; break;
+            case 1625: eval_func = &EvalTranspose2D<1,16,25>; break;
+            case 1636: eval_func = &EvalTranspose2D<1,16,36>; break;
+            // Q4
+            case 2525: eval_func = &EvalTranspose2D<1,25,25>; break;
+            case 2536: eval_func = &EvalTranspose2D<1,25,36>; break;
+            case 2549: eval_func = &EvalTranspose2D<1,25,49>; break;
+            case 2564: eval_func = &EvalTranspose2D<1,25,64>; break;
+         }
+         if (nq >= 100 || !eval_func)
+         {
+            eval_func = &EvalTranspose2D<1>;
+         }
+      }
+      else if (dim == 3)
+      {
+         switch (1000*nd + nq)
+         {
+            // Q0
+            case 1001: eval_func = &EvalTranspose3D<1,1,1>; break;
+            case 1008: eval_func = &EvalTranspose3D<1,1,8>; break;
+            // Q1
+            case 8008: eval_func = &EvalTranspose3D<1,8,8>; break;
+            case 8027: eval_func = &EvalTranspose3D<1,8,27>; break;
+            // Q2
+            case 27027: eval_func = &EvalTranspose3D<1,27,27>; break;
+            case 27064: eval_func = &EvalTranspose3D<1,27,64>; break;
+            // Q3
+            case 64064: eval_func = &EvalTranspose3D<1,64,64>; break;
+            case 64125: eval_func = &EvalTranspose3D<1,64,125>; break;
+            case 64216: eval_func = &EvalTranspose3D<1,64,216>; break;
+            // Q4
+            case 125125: eval_func = &EvalTranspose3D<1,125,125>; break;
+            case 125216: eval_func = &EvalTranspose3D<1,125,216>; break;
+         }
+         if (nq >= 1000 || !eval_func)
+         {
+            eval_func = &EvalTranspose3D<1>;
+         }
+      }
+   }
+   else if (vdim == dim)
+   {
+      if (dim == 2)
+      {
+         switch (100*nd + nq)
+         {
+            // Q1
+            case 404: eval_func = &EvalTranspose2D<2,4,4>; break;
+            case 409: eval_func = &EvalTranspose2D<2,4,9>; break;
+            // Q2
+            case 909: eval_func = &EvalTranspose2D<2,9,9>; break;
+            case 916: eval_func = &EvalTranspose2D<2,9,16>; break;
+            // Q3
+            case 1616: eval_func = &EvalTranspose2D<2,16,16>; break;
+            case 1625: eval_func = &EvalTranspose2D<2,16,25>; break;
+            case 1636: eval_func = &EvalTranspose2D<2,16,36>; break;
+            // Q4
+            case 2525: eval_func = &EvalTranspose2D<2,25,25>; break;
+            case 2536: eval_func = &EvalTranspose2D<2,25,36>; break;
+            case 2549: eval_func = &EvalTranspose2D<2,25,49>; break;
+            case 2564: eval_func = &EvalTranspose2D<2,25,64>; break;
+         }
+         if (nq >= 100 || !eval_func)
+         {
+            eval_func = &EvalTranspose2D<2>;
+         }
+      }
+      else if (dim == 3)
+      {
+         switch (1000*nd + nq)
+         {
+            // Q1
+            case 8008: eval_func = &EvalTranspose3D<3,8,8>; break;
+            case 8027: eval_func = &EvalTranspose3D<3,8,27>; break;
+            // Q2
+            case 27027: eval_func = &EvalTranspose3D<3,27,27>; break;
+            case 27064: eval_func = &EvalTranspose3D<3,27,64>; break;
+            // Q3
+            case 64064: eval_func = &EvalTranspose3D<3,64,64>; break;
+            case 64125: eval_func = &EvalTranspose3D<3,64,125>; break;
+            case 64216: eval_func = &EvalTranspose3D<3,64,216>; break;
+            // Q4
+            case 125125: eval_func = &EvalTranspose3D<3,125,125>; break;
+            case 125216: eval_func = &EvalTranspose3D<3,125,216>; break;
+         }
+         if (nq >= 1000 || !eval_func)
+         {
+            eval_func = &EvalTranspose3D<3>;
+         }
+      }
+   }
+   if (eval_func)
+   {
+      eval_func(ne, vdim, maps, q_val, q_der, e_vec, eval_flags);
+   }
+   else
+   {
+      MFEM_ABORT("case not supported yet");
+   }
+}
+
+void QuadratureInterpolator::TensorMultTranspose(
+   const int dim, const int vdim, const DofToQuad &maps,
+   const Array<int> &dof_map, unsigned eval_flags, const Vector &q_val,
+   const Vector &q_der, Vector &e_vec) const
+{
+   const int ne = fespace->GetNE();
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   void (*eval_func)(
+      const int NE,
+      const int vdim,
+      const DofToQuad &maps,
+      const Array<int> &dof_map,
+      const Vector &q_val,
+      const Vector &q_der,
+      Vector &e_vec,
+      const int eval_flags) = NULL;
+   if (dim == 2)
+   {
+      switch ((vdim << 8) | (d1d << 4) | q1d)
+      {
+         case 0x122: eval_func = &TensorEvalTranspose2D<1,2,2>; break;
+         case 0x123: eval_func = &TensorEvalTranspose2D<1,2,3>; break;
+         case 0x133: eval_func = &TensorEvalTranspose2D<1,3,3>; break;
+         case 0x134: eval_func = &TensorEvalTranspose2D<1,3,4>; break;
+         case 0x144: eval_func = &TensorEvalTranspose2D<1,4,4>; break;
+         case 0x145: eval_func = &TensorEvalTranspose2D<1,4,5>; break;
+         case 0x155: eval_func = &TensorEvalTranspose2D<1,5,5>; break;
+         case 0x156: eval_func = &TensorEvalTranspose2D<1,5,6>; break;
+         case 0x222: eval_func = &TensorEvalTranspose2D<2,2,2>; break;
+         case 0x223: eval_func = &TensorEvalTranspose2D<2,2,3>; break;
+         case 0x233: eval_func = &TensorEvalTranspose2D<2,3,3>; break;
+         case 0x234: eval_func = &TensorEvalTranspose2D<2,3,4>; break;
+         case 0x244: eval_func = &TensorEvalTranspose2D<2,4,4>; break;
+         case 0x245: eval_func = &TensorEvalTranspose2D<2,4,5>; break;
+         case 0x255: eval_func = &TensorEvalTranspose2D<2,5,5>; break;
+         case 0x256: eval_func = &TensorEvalTranspose2D<2,5,6>; break;
+      }
+      if (!eval_func)
+      {
+         eval_func = (vdim == 1) ? &TensorEvalTranspose2D<1> :
+                     &TensorEvalTranspose2D<2>;
+      }
+   }
+   else if (dim == 3)
+   {
+      switch ((vdim << 8) | (d1d << 4) | q1d)
+      {
+         case 0x122: eval_func = &TensorEvalTranspose3D<1,2,2>; break;
+         case 0x123: eval_func = &TensorEvalTranspose3D<1,2,3>; break;
+         case 0x133: eval_func = &TensorEvalTranspose3D<1,3,3>; break;
+         case 0x134: eval_func = &TensorEvalTranspose3D<1,3,4>; break;
+         case 0x144: eval_func = &TensorEvalTranspose3D<1,4,4>; break;
+         case 0x145: eval_func = &TensorEvalTranspose3D<1,4,5>; break;
+         case 0x155: eval_func = &TensorEvalTranspose3D<1,5,5>; break;
+         case 0x156: eval_func = &TensorEvalTranspose3D<1,5,6>; break;
+         case 0x322: eval_func = &TensorEvalTranspose3D<3,2,2>; break;
+         case 0x323: eval_func = &TensorEvalTranspose3D<3,2,3>; break;
+         case 0x333: eval_func = &TensorEvalTranspose3D<3,3,3>; break;
+         case 0x334: eval_func = &TensorEvalTranspose3D<3,3,4>; break;
+         case 0x344: eval_func = &TensorEvalTranspose3D<3,4,4>; break;
+         case 0x345: eval_func = &TensorEvalTranspose3D<3,4,5>; break;
+         case 0x355: eval_func = &TensorEvalTranspose3D<3,5,5>; break;
+         case 0x356: eval_func = &TensorEvalTranspose3D<3,5,6>; break;
+      }
+      if (!eval_func)
+      {
+         eval_func = (vdim == 1) ? &TensorEvalTranspose3D<1> :
+                     &TensorEvalTranspose3D<3>;
+      }
+   }
+   MFEM_VERIFY(eval_func, "case not supported yet");
+   eval_func(ne, vdim, maps, dof_map, q_val, q_der, e_vec, eval_flags);
 }
 
 } // namespace mfem
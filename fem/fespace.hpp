@@ -72,6 +72,15 @@ enum class ElementDofOrdering
    LEXICOGRAPHIC
 };
 
+/// Constants describing the types of mesh faces used by face restrictions.
+enum class FaceType : bool
+{
+   /// Faces shared by two elements of the mesh.
+   Interior,
+   /// Faces of the mesh boundary, see Mesh::GetBdrFaceTransformations().
+   Boundary
+};
+
 
 // Forward declarations
 class NURBSExtension;
@@ -128,9 +137,14 @@ protected:
 
    /// The element restriction operators, see GetElementRestriction().
    mutable OperatorHandle L2E_nat, L2E_lex;
+   /// The face restriction operators, see GetFaceRestriction().
+   mutable OperatorHandle L2F_int, L2F_bdr;
 
    mutable Array<QuadratureInterpolator*> E2Q_array;
 
+   /// The element coloring, see GetElementColoring().
+   mutable Table elem_colors;
+
    long sequence; // should match Mesh::GetSequence
 
    void UpdateNURBS();
@@ -173,6 +187,10 @@ protected:
       RefinementOperator(const FiniteElementSpace *fespace,
                          const FiniteElementSpace *coarse_fes);
       virtual void Mult(const Vector &x, Vector &y) const;
+      /** Apply the transpose of the interpolation, e.g. to restrict residuals
+          in multigrid. Every fine dof contributes only once, from the same
+          element that defines its value in Mult(). */
+      virtual void MultTranspose(const Vector &x, Vector &y) const;
       virtual ~RefinementOperator();
    };
 
@@ -310,6 +328,15 @@ public:
        The returned Operator is owned by the FiniteElementSpace. */
    const Operator *GetElementRestriction(ElementDofOrdering e_ordering) const;
 
+   /// Return an Operator that converts L-vectors to face E-vectors.
+   /** A face E-vector stores the traces of the FE functions on the faces of
+       the given @a type, see FaceRestriction for its layout. Currently, only
+       scalar spaces with tensor-product elements on conforming serial meshes
+       are supported.
+
+       The returned Operator is owned by the FiniteElementSpace. */
+   const Operator *GetFaceRestriction(FaceType type) const;
+
    /** @brief Return a QuadratureInterpolator that interpolates E-vectors to
        quadrature point values and/or derivatives (Q-vectors). */
    /** An E-vector represents the element-wise discontinuous version of the FE
@@ -481,6 +508,14 @@ public:
    const Table &GetElementToDofTable() const { return *elem_dof; }
    const Table &GetBdrElementToDofTable() const { return *bdrElem_dof; }
 
+   /** @brief Return a coloring of the elements such that two elements of the
+       same color do not share any degree of freedom. */
+   /** Row c of the returned Table lists the elements of color c. The coloring
+       is computed greedily on the first call and kept until the next Update().
+       It is used by the threaded assembly of BilinearForm and LinearForm, see
+       BilinearForm::UseThreadedAssembly(). */
+   const Table &GetElementColoring() const;
+
    int GetElementForDof(int i) const { return dof_elem_array[i]; }
    int GetLocalDofForDof(int i) const { return dof_ldof_array[i]; }
 
@@ -889,11 +924,114 @@ protected:
    const int nedofs;
    Array<int> offsets;
    Array<int> indices;
+   Array<int> gatherMap;
 
 public:
    ElementRestriction(const FiniteElementSpace&, ElementDofOrdering);
    void Mult(const Vector &x, Vector &y) const;
    void MultTranspose(const Vector &x, Vector &y) const;
+
+   /** @brief Same as Mult(), ignoring the signs of the DOFs, e.g. of the
+       H(curl) and H(div) spaces. */
+   /** Used to restrict vectors of nonnegative weights, e.g. diagonals. */
+   void MultUnsigned(const Vector &x, Vector &y) const;
+
+   /** @brief Same as MultTranspose(), ignoring the signs of the DOFs, e.g. of
+       the H(curl) and H(div) spaces. */
+   /** Used to sum element diagonals into the diagonal of the global
+       operator. */
+   void MultTransposeUnsigned(const Vector &x, Vector &y) const;
+
+   /** @brief Same as Mult(), restricted to the scalar DOFs listed in
+       @a dof_list. */
+   /** Only the entries of @a y associated with the listed DOFs (and all their
+       vector components) are overwritten; the other entries are preserved.
+       Used to update an E-vector after the values of a few DOFs of @a x have
+       changed, e.g. the DOFs received from the neighbor processors. */
+   void MultSubset(const Array<int> &dof_list, const Vector &x,
+                   Vector &y) const;
+
+   /** @brief Return a new finalized SparseMatrix with the sparsity pattern of
+       the fully assembled operator defined by dense element matrices. */
+   /** The column indices in each row are sorted and all entries are set to
+       zero. The sparsity is computed on the host; it can be reused by multiple
+       calls to FillSparseMatrix(). For vector spaces, each row couples to all
+       vector components of the neighboring DOFs. */
+   SparseMatrix *NewSparseMatrix() const;
+
+   /** @brief Sum the element matrices @a ea_data, stored in the layout
+       ND x VDIM x ND x VDIM x NE, into the SparseMatrix @a mat. */
+   /** The matrix @a mat must use the sparsity pattern returned by
+       NewSparseMatrix(); its previous entries are overwritten. The rows are
+       processed in parallel, each row gathering its contributions from the
+       elements sharing the row DOF, so no atomic operations are required. */
+   void FillSparseMatrix(const Vector &ea_data, SparseMatrix &mat) const;
+};
+
+
+/// Operator that converts FiniteElementSpace L-vectors to face E-vectors.
+/** A face E-vector stores the values of the traces of the FE functions at the
+    nodes of the faces of a given FaceType, in the layout FD x NS x NF, where
+    FD = D1D^(dim-1) is the number of face nodes, NS is the number of sides (2
+    for interior faces, 1 for boundary faces) and NF is the number of faces.
+    Side 0 is the element Elem1No of the face, whose outward normal is used by
+    the face integrators. The face nodes are ordered lexicographically in the
+    reference coordinates of the face, so both sides of an interior face
+    describe the same points.
+
+    The interior faces are ordered as the mesh faces and the boundary faces as
+    the boundary elements, skipping the faces for which
+    Mesh::GetInteriorFaceTransformations() and
+    Mesh::GetBdrFaceTransformations() return NULL, respectively.
+
+    The trace at a face node is interpolated in the direction normal to the
+    face from the element DOFs, so both open and closed 1D bases are
+    supported; for closed bases, e.g. BasisType::GaussLobatto, only the DOFs
+    on the face are used. Objects of this type are typically created and owned
+    by FiniteElementSpace objects, see FiniteElementSpace::GetFaceRestriction().
+*/
+class FaceRestriction : public Operator
+{
+protected:
+   const FiniteElementSpace &fes;
+   const FaceType type;
+   const int nsides;
+   const int ndofs;
+   /// Indices of the faces: mesh faces or boundary elements, see FaceType.
+   Array<int> faces;
+   int nf;
+   int dof;
+   /// Number of element DOFs contributing to each face node.
+   int nw;
+   /// Element DOFs (L-vector indices) and weights, layout nw x FD x NS x NF.
+   Array<int> scatter_indices;
+   Vector weights;
+   /// Transpose of @a scatter_indices in CSR format.
+   Array<int> offsets;
+   Array<int> indices;
+
+public:
+   FaceRestriction(const FiniteElementSpace&, FaceType);
+   void Mult(const Vector &x, Vector &y) const;
+   void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// Add the transpose action of the operator to @a y.
+   void AddMultTranspose(const Vector &x, Vector &y) const;
+
+   /// Return the number of faces, NF.
+   int GetNFaces() const { return nf; }
+
+   /// Return the number of nodes per face, FD.
+   int GetFaceDofs() const { return dof; }
+
+   /** @brief Return the FaceElementTransformations of the face @a f, in the
+       ordering of the face E-vectors. */
+   /** The returned object is owned by the Mesh and is overwritten by the next
+       call. */
+   FaceElementTransformations *GetFaceTransformations(int f) const;
+
+protected:
+   void MultTranspose(const Vector &x, Vector &y, const bool add) const;
 };
 
 
@@ -925,6 +1063,18 @@ protected:
    static const int MAX_ND3D = 1000;
    static const int MAX_VDIM3D = 3;
 
+   /// Tensor-product version of Mult(), using the 1D DofToQuad @a maps.
+   void TensorMult(const int dim, const int vdim, const DofToQuad &maps,
+                   const Array<int> &dof_map, const Vector &e_vec,
+                   unsigned eval_flags, Vector &q_val, Vector &q_der,
+                   Vector &q_det) const;
+
+   /// Tensor-product version of MultTranspose().
+   void TensorMultTranspose(const int dim, const int vdim,
+                            const DofToQuad &maps, const Array<int> &dof_map,
+                            unsigned eval_flags, const Vector &q_val,
+                            const Vector &q_der, Vector &e_vec) const;
+
 public:
    enum EvalFlags
    {
@@ -944,8 +1094,10 @@ public:
 
    /** @brief Disable the use of tensor product evaluations, for tensor-product
        elements, e.g. quads and hexes. */
-   /** Currently, tensor product evaluations are not implemented and this method
-       has no effect. */
+   /** By default, tensor-product elements are evaluated with sum-factorized
+       kernels, based on the 1D DofToQuad maps, when the integration rule is a
+       tensor-product rule and the 1D sizes are at most MAX_D1D and MAX_Q1D.
+       The input E-vector still uses the native ordering of the element dofs. */
    void DisableTensorProducts(bool disable = true) const
    { use_tensor_products = !disable; }
 
@@ -961,7 +1113,11 @@ public:
    void Mult(const Vector &e_vec, unsigned eval_flags,
              Vector &q_val, Vector &q_der, Vector &q_det) const;
 
-   /// Perform the transpose operation of Mult(). (TODO)
+   /// Perform the transpose operation of Mult().
+   /** The E-vector @a e_vec is overwritten with the sum of the transposed
+       value interpolation applied to @a q_val, when the VALUES flag is set, and
+       the transposed derivative interpolation applied to @a q_der, when the
+       DERIVATIVES flag is set. The DETERMINANTS flag is not supported. */
    void MultTranspose(unsigned eval_flags, const Vector &q_val,
                       const Vector &q_der, Vector &e_vec) const;
 
@@ -988,6 +1144,74 @@ public:
                       Vector &q_der,
                       Vector &q_det,
                       const int eval_flags);
+
+   /// Template sum-factorized compute kernel for 2D tensor-product elements.
+   /** The @a dof_map gives the native index of each lexicographic dof, see
+       TensorBasisElement::GetDofMap(); an empty @a dof_map means identity. */
+   template<const int T_VDIM = 0, const int T_D1D = 0, const int T_Q1D = 0>
+   static void TensorEval2D(const int NE,
+                            const int vdim,
+                            const DofToQuad &maps,
+                            const Array<int> &dof_map,
+                            const Vector &e_vec,
+                            Vector &q_val,
+                            Vector &q_der,
+                            Vector &q_det,
+                            const int eval_flags);
+
+   /// Template sum-factorized compute kernel for 3D tensor-product elements.
+   template<const int T_VDIM = 0, const int T_D1D = 0, const int T_Q1D = 0>
+   static void TensorEval3D(const int NE,
+                            const int vdim,
+                            const DofToQuad &maps,
+                            const Array<int> &dof_map,
+                            const Vector &e_vec,
+                            Vector &q_val,
+                            Vector &q_der,
+                            Vector &q_det,
+                            const int eval_flags);
+
+   /// Template compute kernel for the transpose of Eval2D().
+   template<const int T_VDIM = 0, const int T_ND = 0, const int T_NQ = 0>
+   static void EvalTranspose2D(const int NE,
+                               const int vdim,
+                               const DofToQuad &maps,
+                               const Vector &q_val,
+                               const Vector &q_der,
+                               Vector &e_vec,
+                               const int eval_flags);
+
+   /// Template compute kernel for the transpose of Eval3D().
+   template<const int T_VDIM = 0, const int T_ND = 0, const int T_NQ = 0>
+   static void EvalTranspose3D(const int NE,
+                               const int vdim,
+                               const DofToQuad &maps,
+                               const Vector &q_val,
+                               const Vector &q_der,
+                               Vector &e_vec,
+                               const int eval_flags);
+
+   /// Template compute kernel for the transpose of TensorEval2D().
+   template<const int T_VDIM = 0, const int T_D1D = 0, const int T_Q1D = 0>
+   static void TensorEvalTranspose2D(const int NE,
+                                     const int vdim,
+                                     const DofToQuad &maps,
+                                     const Array<int> &dof_map,
+                                     const Vector &q_val,
+                                     const Vector &q_der,
+                                     Vector &e_vec,
+                                     const int eval_flags);
+
+   /// Template compute kernel for the transpose of TensorEval3D().
+   template<const int T_VDIM = 0, const int T_D1D = 0, const int T_Q1D = 0>
+   static void TensorEvalTranspose3D(const int NE,
+                                     const int vdim,
+                                     const DofToQuad &maps,
+                                     const Array<int> &dof_map,
+                                     const Vector &q_val,
+                                     const Vector &q_der,
+                                     Vector &e_vec,
+                                     const int eval_flags);
 };
 
 }
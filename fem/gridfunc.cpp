@@ -20,6 +20,7 @@
 #include <string>
 #include <cmath>
 #include <iostream>
+#include <sstream>
 #include <algorithm>
 
 namespace mfem
@@ -61,6 +62,26 @@ GridFunction::GridFunction(Mesh *m, std::istream &input)
    sequence = fes->GetSequence();
 }
 
+GridFunction::GridFunction(Mesh *m, const BinaryReader &input)
+   : Vector()
+{
+   MFEM_VERIFY(input.GetType() == "MFEM binary grid function v1.0",
+               "invalid binary file type: " << input.GetType());
+
+   // Grid functions are stored on the device
+   UseDevice(true);
+
+   istringstream fes_header(input.GetString("fespace"));
+   fes = new FiniteElementSpace;
+   fec = fes->Load(m, fes_header);
+
+   int size;
+   double *gf_data = input.GetData<double>("data", size);
+   MFEM_VERIFY(size == fes->GetVSize(), "invalid binary grid function");
+   NewDataAndSize(gf_data, size);
+   sequence = fes->GetSequence();
+}
+
 GridFunction::GridFunction(Mesh *m, GridFunction *gf_array[], int num_pieces)
 {
    UseDevice(true);
@@ -2649,6 +2670,17 @@ void GridFunction::Save(std::ostream &out) const
    out.flush();
 }
 
+void GridFunction::SaveBinary(std::ostream &out) const
+{
+   BinaryWriter bin_out(out, "MFEM binary grid function v1.0");
+   std::ostringstream fes_header;
+   fes->Save(fes_header);
+   bin_out.Write("fespace", fes_header.str());
+   bin_out.Write("data", HostRead(), Size());
+   bin_out.Finish();
+   out.flush();
+}
+
 void GridFunction::SaveVTK(std::ostream &out, const std::string &field_name,
                            int ref)
 {
@@ -2861,6 +2893,26 @@ QuadratureFunction::QuadratureFunction(Mesh *mesh, std::istream &in)
    Load(in, vdim*qspace->GetSize());
 }
 
+QuadratureFunction::QuadratureFunction(Mesh *mesh, const BinaryReader &in)
+{
+   MFEM_VERIFY(in.GetType() == "MFEM binary quadrature function v1.0",
+               "invalid binary file type: " << in.GetType());
+
+   istringstream qspace_header(in.GetString("qspace"));
+   qspace = new QuadratureSpace(mesh, qspace_header);
+   own_qspace = true;
+
+   int size;
+   const int *vdim_data = in.GetData<int>("vdim", size);
+   MFEM_VERIFY(size == 1, "invalid binary quadrature function");
+   vdim = vdim_data[0];
+
+   double *qf_data = in.GetData<double>("data", size);
+   MFEM_VERIFY(size == vdim*qspace->GetSize(),
+               "invalid binary quadrature function");
+   NewDataAndSize(qf_data, size);
+}
+
 QuadratureFunction & QuadratureFunction::operator=(double value)
 {
    Vector::operator=(value);
@@ -2888,6 +2940,18 @@ void QuadratureFunction::Save(std::ostream &out) const
    out.flush();
 }
 
+void QuadratureFunction::SaveBinary(std::ostream &out) const
+{
+   BinaryWriter bin_out(out, "MFEM binary quadrature function v1.0");
+   std::ostringstream qspace_header;
+   qspace->Save(qspace_header);
+   bin_out.Write("qspace", qspace_header.str());
+   bin_out.Write("vdim", &vdim, 1);
+   bin_out.Write("data", HostRead(), Size());
+   bin_out.Finish();
+   out.flush();
+}
+
 std::ostream &operator<<(std::ostream &out, const QuadratureFunction &qf)
 {
    qf.Save(out);
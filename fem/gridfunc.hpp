@@ -95,6 +95,15 @@ public:
        are owned by the GridFunction. */
    GridFunction(Mesh *m, std::istream &input);
 
+   /** @brief Construct a GridFunction on the given Mesh, using the data from
+       the binary file read by @a input. */
+   /** The content of @a input should be in the format created by the method
+       SaveBinary(). The data is not copied: the GridFunction references the
+       memory of @a input, e.g. of the memory-mapped file, so @a input must
+       outlive the GridFunction. The reconstructed FiniteElementSpace and
+       FiniteElementCollection are owned by the GridFunction. */
+   GridFunction(Mesh *m, const BinaryReader &input);
+
    GridFunction(Mesh *m, GridFunction *gf_array[], int num_pieces);
 
    /// Copy assignment. Only the data of the base class Vector is copied.
@@ -472,6 +481,12 @@ public:
    /// Save the GridFunction to an output stream.
    virtual void Save(std::ostream &out) const;
 
+   /// Save the GridFunction to an output stream in binary format.
+   /** The FE space header is the same as in Save() and the data is written
+       without conversion, see BinaryWriter. The result can be read with the
+       constructor GridFunction(Mesh *, const BinaryReader &). */
+   virtual void SaveBinary(std::ostream &out) const;
+
    /** Write the GridFunction in VTK format. Note that Mesh::PrintVTK must be
        called first. The parameter ref > 0 must match the one used in
        Mesh::PrintVTK. */
@@ -529,6 +544,12 @@ public:
    /** The QuadratureFunction assumes ownership of the read QuadratureSpace. */
    QuadratureFunction(Mesh *mesh, std::istream &in);
 
+   /// Read a QuadratureFunction from the binary file read by @a in.
+   /** The QuadratureFunction assumes ownership of the read QuadratureSpace.
+       The data is not copied, so @a in must outlive the QuadratureFunction,
+       see SaveBinary(). */
+   QuadratureFunction(Mesh *mesh, const BinaryReader &in);
+
    virtual ~QuadratureFunction() { if (own_qspace) { delete qspace; } }
 
    /// Get the associated QuadratureSpace.
@@ -629,6 +650,9 @@ public:
 
    /// Write the QuadratureFunction to the stream @a out.
    void Save(std::ostream &out) const;
+
+   /// Write the QuadratureFunction to the stream @a out in binary format.
+   void SaveBinary(std::ostream &out) const;
 };
 
 /// Overload operator<< for std::ostream and QuadratureFunction.
@@ -91,6 +91,22 @@ const Array<double> &IntegrationRule::GetWeights() const
    return weights;
 }
 
+bool IntegrationRule::IsTensorProduct(int dim) const
+{
+   const int np = GetNPoints();
+   const int n1d = (int)floor(pow(np, 1.0/dim) + 0.5);
+   const int nt = (dim == 1) ? n1d : (dim == 2) ? n1d*n1d : n1d*n1d*n1d;
+   if (np == 0 || nt != np) { return false; }
+   for (int p = 0; p < np; p++)
+   {
+      const IntegrationPoint &ip = IntPoint(p);
+      if (ip.x != IntPoint(p % n1d).x) { return false; }
+      if (dim > 1 && ip.y != IntPoint((p / n1d) % n1d).x) { return false; }
+      if (dim > 2 && ip.z != IntPoint(p / (n1d*n1d)).x) { return false; }
+   }
+   return true;
+}
+
 void IntegrationRule::GrundmannMollerSimplexRule(int s, int n)
 {
    // for pow on older compilers
@@ -899,7 +915,8 @@ const IntegrationRule &IntegrationRules::Get(int GeomType, int Order)
 
    if (!HaveIntRule(*ir_array, Order))
    {
-#ifdef MFEM_USE_LEGACY_OPENMP
+#if defined(MFEM_USE_LEGACY_OPENMP) || \
+    (defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE))
       #pragma omp critical
 #endif
       {
@@ -247,6 +247,13 @@ public:
        a call like this: `IntPoint(i).weight`. */
    const Array<double> &GetWeights() const;
 
+   /** @brief Return true if the points are the lexicographic tensor product
+       (x fastest) of a 1D rule in @a dim dimensions, as built by the tensor
+       product constructors. */
+   /** The 1D points are the x-coordinates of the first points of the rule.
+       This is the structure assumed by the DofToQuad::TENSOR maps. */
+   bool IsTensorProduct(int dim) const;
+
    /// Destroys an IntegrationRule object
    ~IntegrationRule() { }
 };
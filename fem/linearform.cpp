@@ -24,6 +24,7 @@ LinearForm::LinearForm(FiniteElementSpace *f, LinearForm *lf)
 
    fes = f;
    extern_lfs = 1;
+   threaded_assembly = lf->threaded_assembly;
 
    // Copy the pointers to the integrators
    dlfi = lf->dlfi;
@@ -90,7 +91,16 @@ void LinearForm::Assemble()
    // The first use of AddElementVector() below will move it back to host
    // because both 'vdofs' and 'elemvect' are on host.
 
-   if (dlfi.Size())
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+   const bool use_threads = threaded_assembly && !fes->GetNURBSext();
+#else
+   const bool use_threads = false;
+#endif
+   if (dlfi.Size() && use_threads)
+   {
+      AssembleDomainThreaded();
+   }
+   else if (dlfi.Size())
    {
       for (i = 0; i < fes -> GetNE(); i++)
       {
@@ -199,6 +209,49 @@ void LinearForm::Update(FiniteElementSpace *f, Vector &v, int v_offset)
    ResetDeltaLocations();
 }
 
+void LinearForm::AssembleDomainThreaded()
+{
+   const Table &colors = fes->GetElementColoring();
+   double *b = HostReadWrite();
+   Mesh *mesh = fes->GetMesh();
+   if (mesh->GetNodes()) { mesh->GetNodes()->HostRead(); }
+
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+   #pragma omp parallel
+#endif
+   {
+      IsoparametricTransformation eltrans;
+      Vector elemvect;
+      Array<int> vdofs;
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *elems = colors.GetRow(c);
+         // The elements of one color do not share vdofs; the implicit barrier
+         // at the end of the loop separates the colors.
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+         #pragma omp for schedule(dynamic, 16)
+#endif
+         for (int j = 0; j < colors.RowSize(c); j++)
+         {
+            const int i = elems[j];
+            const FiniteElement &fe = *fes->GetFE(i);
+            fes->GetElementVDofs(i, vdofs);
+            fes->GetElementTransformation(i, &eltrans);
+            for (int k = 0; k < dlfi.Size(); k++)
+            {
+               dlfi[k]->AssembleRHSElementVect(fe, eltrans, elemvect);
+               for (int l = 0; l < vdofs.Size(); l++)
+               {
+                  const int vdof = vdofs[l];
+                  if (vdof >= 0) { b[vdof] += elemvect(l); }
+                  else { b[-1-vdof] -= elemvect(l); }
+               }
+            }
+         }
+      }
+   }
+}
+
 void LinearForm::AssembleDelta()
 {
    if (dlfi_delta.Size() == 0) { return; }
@@ -56,6 +56,12 @@ protected:
    /// Force (re)computation of delta locations.
    void ResetDeltaLocations() { dlfi_delta_elem_id.SetSize(0); }
 
+   /// Assemble the domain integrators with threads, see UseThreadedAssembly().
+   bool threaded_assembly;
+
+   /// Threaded version of the domain integrator loop in Assemble().
+   void AssembleDomainThreaded();
+
 private:
    /// Copy construction is not supported; body is undefined.
    LinearForm(const LinearForm &);
@@ -64,7 +70,7 @@ public:
    /// Creates linear form associated with FE space @a *f.
    /** The pointer @a f is not owned by the newly constructed object. */
    LinearForm(FiniteElementSpace *f) : Vector(f->GetVSize())
-   { fes = f; extern_lfs = 0; UseDevice(true); }
+   { fes = f; extern_lfs = 0; threaded_assembly = false; UseDevice(true); }
 
    /** @brief Create a LinearForm on the FiniteElementSpace @a f, using the
        same integrators as the LinearForm @a lf.
@@ -79,7 +85,8 @@ public:
    /** The associated FiniteElementSpace can be set later using one of the
        methods: Update(FiniteElementSpace *) or
        Update(FiniteElementSpace *, Vector &, int). */
-   LinearForm() { fes = NULL; extern_lfs = 0; UseDevice(true); }
+   LinearForm()
+   { fes = NULL; extern_lfs = 0; threaded_assembly = false; UseDevice(true); }
 
    /// Copy assignment. Only the data of the base class Vector is copied.
    /** It is assumed that this object and @a rhs use FiniteElementSpace%s that
@@ -144,6 +151,14 @@ public:
        corresponding pointer (to Array<int>) will be NULL. */
    Array<Array<int>*> *GetFLFI_Marker() { return &flfi_marker; }
 
+   /** @brief Assemble the domain integrators with OpenMP threads, see
+       BilinearForm::UseThreadedAssembly(). */
+   /** This option has an effect only when MFEM is built with MFEM_USE_OPENMP
+       and MFEM_THREAD_SAFE. The element vectors of one color, see
+       FiniteElementSpace::GetElementColoring(), are added concurrently. The
+       domain integrators and their coefficients must be thread-safe. */
+   void UseThreadedAssembly(bool use = true) { threaded_assembly = use; }
+
    /// Assembles the linear form i.e. sums over all domain/bdr integrators.
    void Assemble();
 
@@ -28,6 +28,9 @@ void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
                                                 Vector &elvect)
 {
    int dof = el.GetDof();
+#ifdef MFEM_THREAD_SAFE
+   Vector shape;
+#endif
 
    shape.SetSize(dof);       // vector of size dof
    elvect.SetSize(dof);
@@ -170,6 +173,9 @@ void VectorDomainLFIntegrator::AssembleRHSElementVect(
 {
    int vdim = Q.GetVDim();
    int dof  = el.GetDof();
+#ifdef MFEM_THREAD_SAFE
+   Vector shape, Qvec;
+#endif
 
    double val,cf;
 
@@ -213,6 +219,9 @@ void VectorDomainLFIntegrator::AssembleDeltaElementVect(
    MFEM_ASSERT(vec_delta != NULL, "coefficient must be VectorDeltaCoefficient");
    int vdim = Q.GetVDim();
    int dof  = fe.GetDof();
+#ifdef MFEM_THREAD_SAFE
+   Vector shape, Qvec;
+#endif
 
    shape.SetSize(dof);
    fe.CalcPhysShape(Trans, shape);
@@ -305,6 +314,10 @@ void VectorFEDomainLFIntegrator::AssembleRHSElementVect(
 {
    int dof = el.GetDof();
    int spaceDim = Tr.GetSpaceDim();
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix vshape;
+   Vector vec;
+#endif
 
    vshape.SetSize(dof,spaceDim);
    vec.SetSize(spaceDim);
@@ -340,6 +353,10 @@ void VectorFEDomainLFIntegrator::AssembleDeltaElementVect(
    MFEM_ASSERT(vec_delta != NULL, "coefficient must be VectorDeltaCoefficient");
    int dof = fe.GetDof();
    int spaceDim = Trans.GetSpaceDim();
+#ifdef MFEM_THREAD_SAFE
+   DenseMatrix vshape;
+   Vector vec;
+#endif
 
    vshape.SetSize(dof, spaceDim);
    fe.CalcPhysVShape(Trans, vshape);
@@ -92,7 +92,9 @@ public:
 /// Class for domain integration L(v) := (f, v)
 class DomainLFIntegrator : public DeltaLFIntegrator
 {
+#ifndef MFEM_THREAD_SAFE
    Vector shape;
+#endif
    Coefficient &Q;
    int oa, ob;
 public:
@@ -180,7 +182,9 @@ public:
 class VectorDomainLFIntegrator : public DeltaLFIntegrator
 {
 private:
+#ifndef MFEM_THREAD_SAFE
    Vector shape, Qvec;
+#endif
    VectorCoefficient &Q;
 
 public:
@@ -232,8 +236,10 @@ class VectorFEDomainLFIntegrator : public DeltaLFIntegrator
 {
 private:
    VectorCoefficient &QF;
+#ifndef MFEM_THREAD_SAFE
    DenseMatrix vshape;
    Vector vec;
+#endif
 
 public:
    VectorFEDomainLFIntegrator(VectorCoefficient &F)
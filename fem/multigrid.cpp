@@ -0,0 +1,277 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../general/forall.hpp"
+#include "fem.hpp"
+#include "multigrid.hpp"
+
+namespace mfem
+{
+
+static inline int DecodeSignedDof(int dof, double &sign)
+{
+   return (dof >= 0) ? (sign = 1.0, dof) : (sign = -1.0, -1 - dof);
+}
+
+PRefinementTransferOperator::PRefinementTransferOperator(
+   const FiniteElementSpace &coarse_fes_, const FiniteElementSpace &fine_fes_)
+   : Operator(fine_fes_.GetVSize(), coarse_fes_.GetVSize()),
+     coarse_fes(coarse_fes_), fine_fes(fine_fes_)
+{
+   MFEM_VERIFY(coarse_fes.GetMesh() == fine_fes.GetMesh(),
+               "the FE spaces must be defined on the same mesh");
+   MFEM_VERIFY(coarse_fes.GetVDim() == fine_fes.GetVDim() &&
+               coarse_fes.GetOrdering() == fine_fes.GetOrdering(),
+               "the FE spaces must have the same vdim and ordering");
+
+   Mesh *mesh = fine_fes.GetMesh();
+   Mesh::GeometryList elem_geoms(*mesh);
+   IsoparametricTransformation isotr;
+   for (int i = 0; i < elem_geoms.Size(); i++)
+   {
+      const Geometry::Type geom = elem_geoms[i];
+      const FiniteElement *coarse_fe =
+         coarse_fes.FEColl()->FiniteElementForGeometry(geom);
+      const FiniteElement *fine_fe =
+         fine_fes.FEColl()->FiniteElementForGeometry(geom);
+      isotr.SetIdentityTransformation(geom);
+      fine_fe->GetTransferMatrix(*coarse_fe, isotr, localP[geom]);
+   }
+}
+
+void PRefinementTransferOperator::Mult(const Vector &x, Vector &y) const
+{
+   Mesh *mesh = fine_fes.GetMesh();
+   const int vdim = fine_fes.GetVDim();
+   Array<int> c_dofs, f_dofs;
+   Array<char> processed(fine_fes.GetNDofs());
+   processed = 0;
+
+   for (int e = 0; e < mesh->GetNE(); e++)
+   {
+      const DenseMatrix &lP = localP[mesh->GetElementBaseGeometry(e)];
+      coarse_fes.GetElementDofs(e, c_dofs);
+      fine_fes.GetElementDofs(e, f_dofs);
+      for (int i = 0; i < f_dofs.Size(); i++)
+      {
+         double fsign, csign;
+         const int f = DecodeSignedDof(f_dofs[i], fsign);
+         if (processed[f]) { continue; }
+         processed[f] = 1;
+         for (int vd = 0; vd < vdim; vd++)
+         {
+            double value = 0.0;
+            for (int j = 0; j < c_dofs.Size(); j++)
+            {
+               const int c = DecodeSignedDof(c_dofs[j], csign);
+               value += lP(i, j) * csign * x[coarse_fes.DofToVDof(c, vd)];
+            }
+            y[fine_fes.DofToVDof(f, vd)] = fsign * value;
+         }
+      }
+   }
+}
+
+void PRefinementTransferOperator::MultTranspose(const Vector &x,
+                                                Vector &y) const
+{
+   Mesh *mesh = fine_fes.GetMesh();
+   const int vdim = fine_fes.GetVDim();
+   Array<int> c_dofs, f_dofs;
+   Array<char> processed(fine_fes.GetNDofs());
+   processed = 0;
+
+   y = 0.0;
+   for (int e = 0; e < mesh->GetNE(); e++)
+   {
+      const DenseMatrix &lP = localP[mesh->GetElementBaseGeometry(e)];
+      coarse_fes.GetElementDofs(e, c_dofs);
+      fine_fes.GetElementDofs(e, f_dofs);
+      for (int i = 0; i < f_dofs.Size(); i++)
+      {
+         double fsign, csign;
+         const int f = DecodeSignedDof(f_dofs[i], fsign);
+         if (processed[f]) { continue; }
+         processed[f] = 1;
+         for (int vd = 0; vd < vdim; vd++)
+         {
+            const double xf = fsign * x[fine_fes.DofToVDof(f, vd)];
+            for (int j = 0; j < c_dofs.Size(); j++)
+            {
+               const int c = DecodeSignedDof(c_dofs[j], csign);
+               y[coarse_fes.DofToVDof(c, vd)] += lP(i, j) * csign * xf;
+            }
+         }
+      }
+   }
+}
+
+
+FiniteElementSpaceHierarchy::FiniteElementSpaceHierarchy(
+   Mesh *mesh, FiniteElementSpace *fespace, bool own_mesh, bool own_fespace)
+{
+   meshes.Append(mesh);
+   fespaces.Append(fespace);
+   prolongations.Append(NULL);
+   own_meshes.Append(own_mesh);
+   own_fespaces.Append(own_fespace);
+}
+
+FiniteElementSpaceHierarchy::~FiniteElementSpaceHierarchy()
+{
+   for (int i = 0; i < owned_operators.Size(); i++)
+   {
+      delete owned_operators[i];
+   }
+   for (int i = 0; i < transfers.Size(); i++)
+   {
+      delete transfers[i];
+   }
+   for (int l = GetFinestLevelIndex(); l >= 0; l--)
+   {
+      if (own_fespaces[l]) { delete fespaces[l]; }
+      if (own_meshes[l]) { delete meshes[l]; }
+   }
+}
+
+void FiniteElementSpaceHierarchy::AddLevel(
+   Mesh *mesh, FiniteElementSpace *fespace, Operator *prolongation,
+   bool own_mesh, bool own_fespace, bool own_prolongation)
+{
+   MFEM_VERIFY(prolongation &&
+               prolongation->Height() == fespace->GetTrueVSize() &&
+               prolongation->Width() == GetFinestFESpace().GetTrueVSize(),
+               "invalid prolongation");
+   meshes.Append(mesh);
+   fespaces.Append(fespace);
+   prolongations.Append(prolongation);
+   own_meshes.Append(own_mesh);
+   own_fespaces.Append(own_fespace);
+   if (own_prolongation) { owned_operators.Append(prolongation); }
+}
+
+void FiniteElementSpaceHierarchy::AddUniformlyRefinedLevel()
+{
+   FiniteElementSpace &coarse_fes = GetFinestFESpace();
+#ifdef MFEM_USE_MPI
+   MFEM_VERIFY(!dynamic_cast<ParFiniteElementSpace*>(&coarse_fes),
+               "parallel FE spaces are not supported, use AddLevel()");
+#endif
+   Mesh *mesh = new Mesh(*coarse_fes.GetMesh());
+   mesh->UniformRefinement();
+   FiniteElementSpace *fespace =
+      new FiniteElementSpace(mesh, coarse_fes.FEColl(), coarse_fes.GetVDim(),
+                             coarse_fes.GetOrdering());
+   InterpolationGridTransfer *transfer =
+      new InterpolationGridTransfer(coarse_fes, *fespace);
+   transfers.Append(transfer);
+   AddLevel(mesh, fespace,
+            const_cast<Operator*>(&transfer->TrueForwardOperator()),
+            true, true, false);
+}
+
+void FiniteElementSpaceHierarchy::AddOrderRefinedLevel(
+   const FiniteElementCollection *fec)
+{
+   FiniteElementSpace &coarse_fes = GetFinestFESpace();
+   Mesh *mesh = coarse_fes.GetMesh();
+   FiniteElementSpace *fespace =
+      new FiniteElementSpace(mesh, fec, coarse_fes.GetVDim(),
+                             coarse_fes.GetOrdering());
+
+   // True-dof prolongation: R_fine P P_coarse
+   Operator *P = new PRefinementTransferOperator(coarse_fes, *fespace);
+   const Operator *coarse_P = coarse_fes.GetProlongationMatrix();
+   const Operator *fine_R = fespace->GetRestrictionMatrix();
+   if (coarse_P) { P = new ProductOperator(P, coarse_P, true, false); }
+   if (fine_R) { P = new ProductOperator(fine_R, P, false, true); }
+   AddLevel(mesh, fespace, P, false, true, true);
+}
+
+
+static void ZeroEntries(const Array<int> &list, Vector &v)
+{
+   const int n = list.Size();
+   auto d_list = list.Read();
+   auto d_v = v.ReadWrite();
+   MFEM_FORALL(i, n, d_v[d_list[i]] = 0.0;);
+}
+
+void GeometricMultigrid::ConstrainedProlongation::Mult(const Vector &x,
+                                                       Vector &y) const
+{
+   z = x;
+   ZeroEntries(coarse_ess, z);
+   P.Mult(z, y);
+   ZeroEntries(fine_ess, y);
+}
+
+void GeometricMultigrid::ConstrainedProlongation::MultTranspose(
+   const Vector &x, Vector &y) const
+{
+   z = x;
+   ZeroEntries(fine_ess, z);
+   P.MultTranspose(z, y);
+   ZeroEntries(coarse_ess, y);
+}
+
+GeometricMultigrid::GeometricMultigrid(
+   const FiniteElementSpaceHierarchy &fespaces_)
+   : fespaces(fespaces_)
+{
+   for (int l = 0; l < fespaces.GetNumLevels(); l++)
+   {
+      ess_tdofs.Append(new Array<int>);
+   }
+}
+
+GeometricMultigrid::GeometricMultigrid(
+   const FiniteElementSpaceHierarchy &fespaces_, const Array<int> &ess_bdr)
+   : fespaces(fespaces_)
+{
+   for (int l = 0; l < fespaces.GetNumLevels(); l++)
+   {
+      ess_tdofs.Append(new Array<int>);
+      fespaces.GetFESpaceAtLevel(l).GetEssentialTrueDofs(ess_bdr,
+                                                         *ess_tdofs[l]);
+   }
+}
+
+GeometricMultigrid::~GeometricMultigrid()
+{
+   for (int l = 0; l < ess_tdofs.Size(); l++)
+   {
+      delete ess_tdofs[l];
+   }
+}
+
+void GeometricMultigrid::AddLevel(Operator *op, Solver *smoother,
+                                  bool own_op, bool own_smoother)
+{
+   const int level = NumLevels();
+   MFEM_VERIFY(level < ess_tdofs.Size(), "all levels of the hierarchy were "
+               "already added");
+   Operator *P = NULL;
+   bool own_P = false;
+   if (level > 0)
+   {
+      P = fespaces.GetProlongationAtLevel(level);
+      if (ess_tdofs[level-1]->Size() || ess_tdofs[level]->Size())
+      {
+         P = new ConstrainedProlongation(*P, *ess_tdofs[level-1],
+                                         *ess_tdofs[level]);
+         own_P = true;
+      }
+   }
+   Multigrid::AddLevel(op, smoother, P, own_op, own_smoother, own_P);
+}
+
+}
@@ -0,0 +1,168 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_FEM_MULTIGRID
+#define MFEM_FEM_MULTIGRID
+
+#include "../config/config.hpp"
+#include "../linalg/multigrid.hpp"
+#include "fespace.hpp"
+
+namespace mfem
+{
+
+/** @brief Interpolation between two FiniteElementSpace%s on the same mesh with
+    different orders, e.g. for p-multigrid. */
+/** The operator maps L-vectors of the lower order space @a coarse_fes to
+    L-vectors of the higher order space @a fine_fes by evaluating the coarse
+    basis functions at the nodes of the fine elements, see
+    FiniteElement::GetTransferMatrix(). Both spaces must use the same map type,
+    vector dimension and ordering. MultTranspose() is the exact transpose of
+    Mult(): every fine dof contributes only once, from the first element that
+    contains it. */
+class PRefinementTransferOperator : public Operator
+{
+protected:
+   const FiniteElementSpace &coarse_fes;
+   const FiniteElementSpace &fine_fes;
+
+   /// Reference-space interpolation matrices for each element geometry.
+   DenseMatrix localP[Geometry::NumGeom];
+
+public:
+   PRefinementTransferOperator(const FiniteElementSpace &coarse_fes_,
+                               const FiniteElementSpace &fine_fes_);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+};
+
+
+/// A hierarchy of FiniteElementSpace%s with the prolongations between them
+/** The levels are numbered from 0 (coarsest) to GetFinestLevelIndex(). New
+    levels are obtained from the current finest level by uniform refinement of
+    a copy of its mesh or by increasing the order on the same mesh. The
+    prolongations act on true-dof vectors. */
+class FiniteElementSpaceHierarchy
+{
+protected:
+   Array<Mesh*> meshes;
+   Array<FiniteElementSpace*> fespaces;
+   /// True-dof prolongations from level l-1 to l; NULL for level 0.
+   Array<Operator*> prolongations;
+   /// Objects owning the prolongations created by the hierarchy.
+   Array<GridTransfer*> transfers;
+   Array<Operator*> owned_operators;
+   Array<bool> own_meshes, own_fespaces;
+
+public:
+   /// Create a hierarchy with the single (coarse) level @a fespace on @a mesh.
+   FiniteElementSpaceHierarchy(Mesh *mesh, FiniteElementSpace *fespace,
+                               bool own_mesh, bool own_fespace);
+
+   virtual ~FiniteElementSpaceHierarchy();
+
+   /** @brief Add the finest level @a fespace, on @a mesh, with the true-dof
+       prolongation @a prolongation from the previous finest level. */
+   void AddLevel(Mesh *mesh, FiniteElementSpace *fespace,
+                 Operator *prolongation, bool own_mesh, bool own_fespace,
+                 bool own_prolongation);
+
+   /** @brief Add a level by uniform refinement of a copy of the finest mesh,
+       with the same FiniteElementCollection, vector dimension and ordering. */
+   /** The prolongation is the nodal interpolation of InterpolationGridTransfer.
+       The mesh of the current finest level must not be modified afterwards. */
+   void AddUniformlyRefinedLevel();
+
+   /** @brief Add a level on the finest mesh with the (typically higher order)
+       collection @a fec, which is not owned by the hierarchy. */
+   /** The prolongation is a PRefinementTransferOperator. */
+   void AddOrderRefinedLevel(const FiniteElementCollection *fec);
+
+   /// Return the number of levels.
+   int GetNumLevels() const { return fespaces.Size(); }
+
+   /// Return the index of the finest level.
+   int GetFinestLevelIndex() const { return GetNumLevels() - 1; }
+
+   Mesh &GetMeshAtLevel(int level) const { return *meshes[level]; }
+
+   FiniteElementSpace &GetFESpaceAtLevel(int level) const
+   { return *fespaces[level]; }
+
+   FiniteElementSpace &GetFinestFESpace() const
+   { return *fespaces[GetFinestLevelIndex()]; }
+
+   /// Return the true-dof prolongation from level @a level-1 to @a level.
+   Operator *GetProlongationAtLevel(int level) const
+   { return prolongations[level]; }
+};
+
+
+/// Multigrid for the levels of a FiniteElementSpaceHierarchy
+/** The prolongations are taken from the hierarchy. If essential boundary
+    attributes are given, the corrections are zeroed at the essential true dofs
+    of each level, which makes the method consistent with level operators
+    formed with BilinearForm::FormSystemMatrix() using the lists returned by
+    GetEssentialTrueDofs(). Typically, the finer levels use partial assembly
+    with a diagonal-based smoother and the coarsest level is assembled and
+    solved with a sparse solver. */
+class GeometricMultigrid : public Multigrid
+{
+protected:
+   /// Prolongation that ignores and zeroes the essential true dofs.
+   class ConstrainedProlongation : public Operator
+   {
+   protected:
+      const Operator &P;
+      const Array<int> &coarse_ess, &fine_ess;
+      mutable Vector z;
+
+   public:
+      ConstrainedProlongation(const Operator &P_,
+                              const Array<int> &coarse_ess_,
+                              const Array<int> &fine_ess_)
+         : Operator(P_.Height(), P_.Width()), P(P_),
+           coarse_ess(coarse_ess_), fine_ess(fine_ess_) { }
+
+      virtual void Mult(const Vector &x, Vector &y) const;
+      virtual void MultTranspose(const Vector &x, Vector &y) const;
+   };
+
+   const FiniteElementSpaceHierarchy &fespaces;
+   Array<Array<int>*> ess_tdofs;
+
+public:
+   /** Create a multigrid solver for the levels of @a fespaces_; the levels are
+       added with AddLevel(), starting from the coarsest. */
+   GeometricMultigrid(const FiniteElementSpaceHierarchy &fespaces_);
+
+   /** Same as above, with essential boundary conditions on the boundary
+       attributes marked in @a ess_bdr. */
+   GeometricMultigrid(const FiniteElementSpaceHierarchy &fespaces_,
+                      const Array<int> &ess_bdr);
+
+   virtual ~GeometricMultigrid();
+
+   /// Return the essential true dofs of the given @a level.
+   const Array<int> &GetEssentialTrueDofs(int level) const
+   { return *ess_tdofs[level]; }
+
+   /** @brief Add the next level, with Operator @a op and smoother @a smoother,
+       using the prolongation of the hierarchy. */
+   void AddLevel(Operator *op, Solver *smoother, bool own_op,
+                 bool own_smoother);
+};
+
+}
+
+#endif
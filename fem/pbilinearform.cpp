@@ -291,7 +291,23 @@ void ParBilinearForm::FormLinearSystem(
    const Array<int> &ess_tdof_list, Vector &x, Vector &b,
    OperatorHandle &A, Vector &X, Vector &B, int copy_interior)
 {
-   if (ext)
+   if (overlap_comm && assembly == AssemblyLevel::PARTIAL)
+   {
+      FormSystemMatrix(ess_tdof_list, A);
+
+      // Variational restriction with P
+      const Operator &P = *pfes->GetProlongationMatrix();
+      const SparseMatrix &R = *pfes->GetRestrictionMatrix();
+      X.SetSize(pfes->TrueVSize());
+      B.SetSize(X.Size());
+      P.MultTranspose(b, B);
+      R.Mult(x, X);
+      if (!copy_interior) { X.SetSubVectorComplement(ess_tdof_list, 0.0); }
+      A.As<ConstrainedOperator>()->EliminateRHS(X, B);
+      return;
+   }
+
+   if (ext && !ext->AssemblesSparseMatrix())
    {
       ext->FormLinearSystem(ess_tdof_list, x, b, A, X, B, copy_interior);
       return;
@@ -340,7 +356,14 @@ void ParBilinearForm::FormLinearSystem(
 void ParBilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
                                        OperatorHandle &A)
 {
-   if (ext)
+   if (overlap_comm && assembly == AssemblyLevel::PARTIAL)
+   {
+      A.Reset(new ConstrainedOperator(new ParPAOverlapOperator(*this),
+                                      ess_tdof_list, true));
+      return;
+   }
+
+   if (ext && !ext->AssemblesSparseMatrix())
    {
       ext->FormSystemMatrix(ess_tdof_list, A);
       return;
@@ -388,7 +411,7 @@ void ParBilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
 void ParBilinearForm::RecoverFEMSolution(
    const Vector &X, const Vector &b, Vector &x)
 {
-   if (ext)
+   if (ext && !ext->AssemblesSparseMatrix())
    {
       ext->RecoverFEMSolution(X, b, x);
       return;
@@ -435,6 +458,79 @@ void ParBilinearForm::Update(FiniteElementSpace *nfes)
 }
 
 
+ParPAOverlapOperator::ParPAOverlapOperator(ParBilinearForm &pa)
+   : Operator(pa.ParFESpace()->GetTrueVSize()), a(pa)
+{
+   ParFiniteElementSpace &pfes = *a.ParFESpace();
+   P = dynamic_cast<const ConformingProlongationOperator*>(
+          pfes.GetProlongationMatrix());
+   MFEM_VERIFY(P != NULL, "a conforming ParFiniteElementSpace is required");
+   R = dynamic_cast<const ElementRestriction*>(
+          pfes.GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC));
+   MFEM_VERIFY(R != NULL, "the space has no ElementRestriction");
+   MFEM_VERIFY(a.GetFBFI()->Size() == 0 && a.GetBFBFI()->Size() == 0 &&
+               a.GetBBFI()->Size() == 0,
+               "only domain integrators are supported");
+
+   // Elements with at least one dof that is not a local true dof need the
+   // values received from the neighbors.
+   Array<bool> is_ext_dof(pfes.GetNDofs());
+   is_ext_dof = false;
+   Array<int> vdofs;
+   for (int e = 0; e < pfes.GetNE(); e++)
+   {
+      bool shared = false;
+      pfes.GetElementVDofs(e, vdofs);
+      for (int j = 0; j < vdofs.Size(); j++)
+      {
+         const int ldof = (vdofs[j] >= 0) ? vdofs[j] : -1-vdofs[j];
+         if (pfes.GetLocalTDofNumber(ldof) < 0)
+         {
+            shared = true;
+            is_ext_dof[pfes.VDofToDof(ldof)] = true;
+         }
+      }
+      if (shared) { bdr_elems.Append(e); }
+      else { int_elems.Append(e); }
+   }
+   for (int i = 0; i < is_ext_dof.Size(); i++)
+   {
+      if (is_ext_dof[i]) { ext_dofs.Append(i); }
+   }
+
+   xL.SetSize(pfes.GetVSize());
+   yL.SetSize(pfes.GetVSize());
+   xE.SetSize(R->Height());
+   yE.SetSize(R->Height());
+}
+
+void ParPAOverlapOperator::Mult(const Vector &x, Vector &y) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a.GetDBFI();
+
+   // Start the exchange of the shared dofs; the restriction to the interior
+   // elements only needs the owned dofs of xL.
+   P->MultBegin(x, xL);
+   R->Mult(xL, xE);
+   yE = 0.0;
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      integrators[i]->AddMultPAElements(xE, yE, int_elems);
+   }
+
+   // Complete the exchange and update the entries of the received dofs.
+   P->MultEnd(xL);
+   R->MultSubset(ext_dofs, xL, xE);
+   for (int i = 0; i < integrators.Size(); i++)
+   {
+      integrators[i]->AddMultPAElements(xE, yE, bdr_elems);
+   }
+
+   R->MultTranspose(yE, yL);
+   P->MultTranspose(yL, y);
+}
+
+
 HypreParMatrix *ParMixedBilinearForm::ParallelAssemble()
 {
    // construct the block-diagonal matrix A
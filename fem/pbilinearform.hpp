@@ -37,6 +37,10 @@ protected:
 
    bool keep_nbr_block;
 
+   /// Use ParPAOverlapOperator for the system operator, see
+   /// OverlapCommunication().
+   bool overlap_comm;
+
    // Allocate mat - called when (mat == NULL && fbfi.Size() > 0)
    void pAllocMat();
 
@@ -55,7 +59,7 @@ public:
    ParBilinearForm(ParFiniteElementSpace *pf)
       : BilinearForm(pf), pfes(pf),
         p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR)
-   { keep_nbr_block = false; }
+   { keep_nbr_block = false; overlap_comm = false; }
 
    /** @brief Create a ParBilinearForm on the ParFiniteElementSpace @a *pf,
        using the same integrators as the ParBilinearForm @a *bf.
@@ -67,7 +71,7 @@ public:
    ParBilinearForm(ParFiniteElementSpace *pf, ParBilinearForm *bf)
       : BilinearForm(pf, bf), pfes(pf),
         p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR)
-   { keep_nbr_block = false; }
+   { keep_nbr_block = false; overlap_comm = false; }
 
    /** When set to true and the ParBilinearForm has interior face integrators,
        the local SparseMatrix will include the rows (in addition to the columns)
@@ -75,8 +79,15 @@ public:
        those rows. Must be called before the first Assemble call. */
    void KeepNbrBlock(bool knb = true) { keep_nbr_block = knb; }
 
+   /** When set to true and the ParBilinearForm uses AssemblyLevel::PARTIAL,
+       the operator returned by FormSystemMatrix() and FormLinearSystem()
+       overlaps the exchange of the shared dofs with the action on the
+       elements that do not need them, see ParPAOverlapOperator. The default
+       behavior is to complete the exchange before the element work. */
+   void OverlapCommunication(bool ovlp = true) { overlap_comm = ovlp; }
+
    /** @brief Set the operator type id for the parallel matrix/operator when
-       using AssemblyLevel::FULL. */
+       using AssemblyLevel::FULL or AssemblyLevel::DEVICEFULL. */
    /** If using static condensation or hybridization, call this method *after*
        enabling it. */
    void SetOperatorType(Operator::Type tid)
@@ -184,6 +195,49 @@ public:
    virtual ~ParBilinearForm() { }
 };
 
+/** @brief Action of a partially assembled ParBilinearForm on the true dofs,
+    P^t A P, overlapping the exchange of the shared dofs with the local work.
+
+    The local elements are split into interior elements, whose dofs are all
+    owned by this processor, and boundary elements, that have at least one dof
+    owned by a neighbor processor. The action starts the exchange of the shared
+    dofs with ConformingProlongationOperator::MultBegin(), applies the domain
+    integrators on the interior elements, completes the exchange and finally
+    applies the integrators on the boundary elements. Only this exchange is
+    overlapped: the final reduction with P^t starts after all the local
+    element work is done.
+
+    Only conforming spaces with an ElementRestriction (e.g. H1 spaces) and
+    domain integrators implementing
+    BilinearFormIntegrator::AddMultPAElements() are supported. The
+    ParBilinearForm must be assembled before the operator is applied. */
+class ParPAOverlapOperator : public Operator
+{
+protected:
+   ParBilinearForm &a;
+   const ConformingProlongationOperator *P;
+   const ElementRestriction *R;
+
+   /// Elements without and with dofs owned by the neighbor processors.
+   Array<int> int_elems, bdr_elems;
+   /// The (scalar) dofs owned by the neighbor processors.
+   Array<int> ext_dofs;
+
+   /// L-vectors and E-vectors used in Mult().
+   mutable Vector xL, yL, xE, yE;
+
+public:
+   ParPAOverlapOperator(ParBilinearForm &pa);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Return the elements whose dofs are all owned by this processor.
+   const Array<int> &GetInteriorElements() const { return int_elems; }
+
+   /// Return the elements with dofs owned by the neighbor processors.
+   const Array<int> &GetBoundaryElements() const { return bdr_elems; }
+};
+
 /// Class for parallel bilinear form using different test and trial FE spaces.
 class ParMixedBilinearForm : public MixedBilinearForm
 {
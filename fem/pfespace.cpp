@@ -2883,6 +2883,13 @@ ConformingProlongationOperator::ConformingProlongationOperator(
 }
 
 void ConformingProlongationOperator::Mult(const Vector &x, Vector &y) const
+{
+   MultBegin(x, y);
+   MultEnd(y);
+}
+
+void ConformingProlongationOperator::MultBegin(const Vector &x,
+                                               Vector &y) const
 {
    MFEM_ASSERT(x.Size() == Width(), "");
    MFEM_ASSERT(y.Size() == Height(), "");
@@ -2902,9 +2909,14 @@ void ConformingProlongationOperator::Mult(const Vector &x, Vector &y) const
       j = end+1;
    }
    std::copy(xdata+j-m, xdata+Width(), ydata+j);
+}
+
+void ConformingProlongationOperator::MultEnd(Vector &y) const
+{
+   MFEM_ASSERT(y.Size() == Height(), "");
 
    const int out_layout = 0; // 0 - output is ldofs array
-   gc.BcastEnd(ydata, out_layout);
+   gc.BcastEnd(y.HostReadWrite(), out_layout);
 }
 
 void ConformingProlongationOperator::MultTranspose(
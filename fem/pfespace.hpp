@@ -384,6 +384,16 @@ public:
 
    virtual void Mult(const Vector &x, Vector &y) const;
 
+   /** @brief Start the action of the operator: the owned entries of @a y are
+       set from @a x and the exchange of the shared entries is started. */
+   /** The local work that does not depend on the shared entries of @a y can
+       be performed before calling MultEnd(), which completes the action. The
+       vector @a y must not be modified in between. */
+   void MultBegin(const Vector &x, Vector &y) const;
+
+   /// Finish the action started with MultBegin().
+   void MultEnd(Vector &y) const;
+
    virtual void MultTranspose(const Vector &x, Vector &y) const;
 };
 
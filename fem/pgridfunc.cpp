@@ -15,6 +15,7 @@
 
 #include "fem.hpp"
 #include <iostream>
+#include <sstream>
 #include <limits>
 using namespace std;
 
@@ -77,6 +78,36 @@ ParGridFunction::ParGridFunction(ParMesh *pmesh, std::istream &input)
    fes = pfes;
 }
 
+ParGridFunction::ParGridFunction(ParMesh *pmesh, const BinaryReader &input)
+   : GridFunction(pmesh, input)
+{
+   // Convert the FiniteElementSpace, fes, to a ParFiniteElementSpace:
+   pfes = new ParFiniteElementSpace(pmesh, fec, fes->GetVDim(),
+                                    fes->GetOrdering());
+   delete fes;
+   fes = pfes;
+
+   // Undo the sign changes of SaveBinary(). The data of the reader is left
+   // unchanged, so the ParGridFunction gets its own copy in this case.
+   bool flip = false;
+   for (int i = 0; i < size && !flip; i++)
+   {
+      flip = (pfes->GetDofSign(i) < 0);
+   }
+   if (flip)
+   {
+      const int in_size = size;
+      const double *in_data = HostRead();
+      Vector::Destroy();
+      SetSize(in_size);
+      double *data_ = HostWrite();
+      for (int i = 0; i < size; i++)
+      {
+         data_[i] = (pfes->GetDofSign(i) < 0) ? -in_data[i] : in_data[i];
+      }
+   }
+}
+
 void ParGridFunction::Update()
 {
    face_nbr_data.Destroy();
@@ -251,6 +282,16 @@ void ParGridFunction::ExchangeFaceNbrData()
    delete [] requests;
 }
 
+int ParGridFunction::GetValuesAtPoints(const DenseMatrix &point_mat,
+                                       DenseMatrix &values, Array<int> &ranks,
+                                       bool warn) const
+{
+   Array<int> elem_ids;
+   Array<IntegrationPoint> ips;
+   return pfes->GetParMesh()->LocatePoints(point_mat, this, ranks, elem_ids,
+                                           ips, values, warn);
+}
+
 double ParGridFunction::GetValue(int i, const IntegrationPoint &ip, int vdim)
 const
 {
@@ -501,6 +542,58 @@ void ParGridFunction::Save(std::ostream &out) const
    }
 }
 
+void ParGridFunction::SaveBinary(std::ostream &out) const
+{
+   double *data_  = const_cast<double*>(HostRead());
+   for (int i = 0; i < size; i++)
+   {
+      if (pfes->GetDofSign(i) < 0) { data_[i] = -data_[i]; }
+   }
+
+   GridFunction::SaveBinary(out);
+
+   for (int i = 0; i < size; i++)
+   {
+      if (pfes->GetDofSign(i) < 0) { data_[i] = -data_[i]; }
+   }
+}
+
+void ParGridFunction::SaveShared(const std::string &filename) const
+{
+   std::ostringstream out;
+   SaveBinary(out);
+   const bool ok = WriteSharedFile(pfes->GetComm(), filename, out.str());
+   MFEM_VERIFY(ok, "error writing shared grid function file " << filename);
+}
+
+void ParGridFunction::LoadShared(const std::string &filename)
+{
+   std::string buffer;
+   const bool ok = ReadSharedFile(pfes->GetComm(), filename, buffer);
+   MFEM_VERIFY(ok, "error reading shared grid function file " << filename);
+
+   std::istringstream in(buffer);
+   BinaryReader bin_in(in);
+   MFEM_VERIFY(bin_in.GetType() == "MFEM binary grid function v1.0",
+               "invalid grid function in shared file " << filename);
+   std::ostringstream fes_header;
+   pfes->Save(fes_header);
+   MFEM_VERIFY(bin_in.GetString("fespace") == fes_header.str(),
+               "the grid function in " << filename << " uses a different "
+               "finite element space");
+   int in_size;
+   const double *in_data = bin_in.GetData<double>("data", in_size);
+   MFEM_VERIFY(in_size == size, "the grid function in " << filename
+               << " has size " << in_size << ", expected " << size);
+
+   // Undo the sign changes of SaveBinary()
+   double *data_ = HostWrite();
+   for (int i = 0; i < size; i++)
+   {
+      data_[i] = (pfes->GetDofSign(i) < 0) ? -in_data[i] : in_data[i];
+   }
+}
+
 void ParGridFunction::SaveAsOne(std::ostream &out)
 {
    int i, p;
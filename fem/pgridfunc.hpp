@@ -83,6 +83,14 @@ public:
        constructed. The new ParGridFunction assumes ownership of both. */
    ParGridFunction(ParMesh *pmesh, std::istream &input);
 
+   /** @brief Construct a ParGridFunction on a given ParMesh, @a pmesh, from
+       the binary file read by @a input, see SaveBinary().
+
+       The data references the memory of @a input, which must outlive the
+       ParGridFunction, see GridFunction(Mesh *, const BinaryReader &). If
+       some local dofs have negative signs, the data is copied instead. */
+   ParGridFunction(ParMesh *pmesh, const BinaryReader &input);
+
    /// Copy assignment. Only the data of the base class Vector is copied.
    /** It is assumed that this object and @a rhs use ParFiniteElementSpace%s
        that have the same size.
@@ -202,6 +210,23 @@ public:
    double GetValue(ElementTransformation &T)
    { return GetValue(T.ElementNo, T.GetIntPoint()); }
 
+   /** @brief Evaluate the ParGridFunction at the given physical points, which
+       may be different on each rank and may lie in elements owned by other
+       ranks. */
+   /** The points, given as the columns of @a point_mat, are located as in
+       ParMesh::FindPointsGlobal() and the ranks owning the elements that
+       contain them compute and return the values in the same round of
+       communication. On return, the i-th column of @a values, of height
+       VectorDim(), is the value at the i-th point and @a ranks[i] is the rank
+       where the point was found; if the point is not found, @a ranks[i] is -1
+       and the column is set to zero.
+
+       This method must be called by all ranks of the mesh communicator.
+
+       @returns The number of local points that were found. */
+   int GetValuesAtPoints(const DenseMatrix &point_mat, DenseMatrix &values,
+                         Array<int> &ranks, bool warn = true) const;
+
    using GridFunction::ProjectCoefficient;
    virtual void ProjectCoefficient(Coefficient &coeff);
 
@@ -313,6 +338,22 @@ public:
        the local dofs. */
    virtual void Save(std::ostream &out) const;
 
+   /** Save the local portion of the ParGridFunction in binary format, taking
+       into account the signs of the local dofs as in Save(). */
+   virtual void SaveBinary(std::ostream &out) const;
+
+   /** @brief Collectively save the local portions of the ParGridFunction in
+       the binary format of SaveBinary() into the single file @a filename, see
+       WriteSharedFile(). */
+   void SaveShared(const std::string &filename) const;
+
+   /** @brief Collectively read the local portion of the ParGridFunction from
+       the shared file @a filename written by SaveShared(). */
+   /** The file must have been written on the same number of ranks with the
+       same mesh partitioning and finite element space; the data is read
+       directly into the current ParGridFunction. */
+   void LoadShared(const std::string &filename);
+
    /// Merge the local grid functions
    void SaveAsOne(std::ostream &out = mfem::out);
 
@@ -435,6 +435,9 @@ protected:
    // return the filename based on prefix_path, collection name and cycle.
    std::string get_file_path(const std::string &filename) const;
 
+   // SaveAsync() is not supported.
+   virtual DataCollection *NewSnapshot() const { return NULL; }
+
 private:
    // If the data collection does not own the datastore, it will need pointers
    // to the blueprint and blueprint index group to use.
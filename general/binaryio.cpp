@@ -0,0 +1,271 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "binaryio.hpp"
+#include "error.hpp"
+#include <cstring>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace mfem
+{
+
+// Version of the container format written by BinaryWriter
+static const std::uint32_t binary_version = 1;
+static const std::uint32_t endian_tag = 0x01020304u;
+static const std::uint32_t swapped_endian_tag = 0x04030201u;
+
+static const int header_size = 64, type_size = 48;
+static const int record_header_size = 48, name_size = 32;
+
+static int EntrySize(int type)
+{
+   switch (type)
+   {
+      case BinaryReader::INT32: return 4;
+      case BinaryReader::FLOAT64: return 8;
+      case BinaryReader::CHAR: return 1;
+   }
+   return 0;
+}
+
+// Reverse the byte order of the 'count' entries of size 'entry_size'
+static void SwapBytes(char *data, int entry_size, std::size_t count)
+{
+   for (std::size_t i = 0; i < count; i++)
+   {
+      std::reverse(data + i*entry_size, data + (i+1)*entry_size);
+   }
+}
+
+
+BinaryWriter::BinaryWriter(std::ostream &out_, const std::string &type)
+   : out(out_), finished(false)
+{
+   MFEM_VERIFY(type.size() < type_size && type.find('\n') == std::string::npos,
+               "invalid binary file type: " << type);
+   char header[header_size] = { 0 };
+   std::memcpy(header, type.data(), type.size());
+   header[type.size()] = '\n';
+   std::memcpy(header + type_size, &endian_tag, 4);
+   std::memcpy(header + type_size + 4, &binary_version, 4);
+   out.write(header, header_size);
+}
+
+void BinaryWriter::WriteRecord(const std::string &name, int type,
+                               const void *data, int count, int entry_size)
+{
+   MFEM_VERIFY(!finished, "the binary file is already finished");
+   MFEM_VERIFY(!name.empty() && name.size() < name_size,
+               "invalid record name: " << name);
+   char header[record_header_size] = { 0 };
+   const std::int32_t rtype = type;
+   const std::int64_t rcount = count;
+   std::memcpy(header, name.data(), name.size());
+   std::memcpy(header + name_size, &rtype, 4);
+   std::memcpy(header + name_size + 8, &rcount, 8);
+   out.write(header, record_header_size);
+
+   const std::size_t nbytes = std::size_t(count)*entry_size;
+   const char zeros[8] = { 0 };
+   out.write(static_cast<const char*>(data), nbytes);
+   out.write(zeros, (8 - nbytes % 8) % 8);
+}
+
+void BinaryWriter::Write(const std::string &name, const int *data, int size)
+{
+   static_assert(sizeof(int) == 4, "int must have 32 bits");
+   WriteRecord(name, BinaryReader::INT32, data, size, 4);
+}
+
+void BinaryWriter::Write(const std::string &name, const double *data,
+                         int size)
+{
+   WriteRecord(name, BinaryReader::FLOAT64, data, size, 8);
+}
+
+void BinaryWriter::Write(const std::string &name, const std::string &str)
+{
+   MFEM_VERIFY(str.size() <= INT_MAX, "string is too long");
+   WriteRecord(name, BinaryReader::CHAR, str.data(), int(str.size()), 1);
+}
+
+void BinaryWriter::Finish()
+{
+   MFEM_VERIFY(!finished, "the binary file is already finished");
+   const char header[record_header_size] = { 0 };
+   out.write(header, record_header_size);
+   finished = true;
+}
+
+
+BinaryReader::BinaryReader(const char *filename)
+   : in(NULL), map_data(NULL), map_size(0), map_pos(0), mapped(false)
+{
+#ifndef _WIN32
+   const int fd = open(filename, O_RDONLY);
+   MFEM_VERIFY(fd >= 0, "unable to open file " << filename);
+   struct stat st;
+   if (fstat(fd, &st) != 0)
+   {
+      close(fd);
+      MFEM_ABORT("unable to stat file " << filename);
+   }
+   map_size = st.st_size;
+   if (map_size > 0)
+   {
+      // A private writable mapping: the pages are shared with the page cache
+      // until they are modified by the user or by the byte order conversion.
+      void *p = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                     fd, 0);
+      close(fd);
+      MFEM_VERIFY(p != MAP_FAILED, "unable to map file " << filename);
+      map_data = static_cast<char*>(p);
+      mapped = true;
+   }
+   else
+   {
+      close(fd);
+   }
+#else
+   std::ifstream file(filename, std::ios::binary | std::ios::ate);
+   MFEM_VERIFY(file.good(), "unable to open file " << filename);
+   map_size = file.tellg();
+   file.seekg(0);
+   double *buffer = new double[(map_size + 7)/8];
+   file.read((char*) buffer, map_size);
+   blocks.Append(buffer);
+   map_data = (char*) buffer;
+#endif
+   Parse(false);
+}
+
+BinaryReader::BinaryReader(std::istream &input, const std::string &type_line)
+   : type(type_line), in(&input), map_data(NULL), map_size(0), map_pos(0),
+     mapped(false)
+{
+   Parse(!type_line.empty());
+   in = NULL;
+}
+
+BinaryReader::~BinaryReader()
+{
+#ifndef _WIN32
+   if (mapped) { munmap(map_data, map_size); }
+#endif
+   for (int i = 0; i < blocks.Size(); i++)
+   {
+      delete [] blocks[i];
+   }
+}
+
+char *BinaryReader::Next(std::size_t nbytes)
+{
+   if (in)
+   {
+      double *block = new double[(nbytes + 7)/8];
+      in->read((char*) block, nbytes);
+      if (!in->good())
+      {
+         delete [] block;
+         MFEM_ABORT("error reading binary file from stream");
+      }
+      blocks.Append(block);
+      return (char*) block;
+   }
+   MFEM_VERIFY(map_pos + nbytes <= map_size, "truncated binary file");
+   char *data = map_data + map_pos;
+   map_pos += nbytes;
+   return data;
+}
+
+void BinaryReader::Parse(bool type_read)
+{
+   // Number of header bytes already extracted from the stream
+   const std::size_t skip = type_read ? type.size() + 1 : 0;
+   MFEM_VERIFY(skip <= type_size, "invalid binary file header");
+   const char *header = Next(header_size - skip);
+   if (!type_read)
+   {
+      const char *end =
+         static_cast<const char*>(std::memchr(header, '\n', type_size));
+      MFEM_VERIFY(end != NULL, "invalid binary file header");
+      type.assign(header, end - header);
+   }
+
+   std::uint32_t tag, version;
+   std::memcpy(&tag, header + type_size - skip, 4);
+   std::memcpy(&version, header + type_size + 4 - skip, 4);
+   const bool swap = (tag == swapped_endian_tag);
+   MFEM_VERIFY(swap || tag == endian_tag,
+               "invalid endianness tag in binary file of type " << type);
+   if (swap) { SwapBytes((char*) &version, 4, 1); }
+   MFEM_VERIFY(version <= binary_version,
+               "unsupported binary file version " << version);
+
+   while (true)
+   {
+      const char *rheader = Next(record_header_size);
+      const char *name_end =
+         static_cast<const char*>(std::memchr(rheader, '\0', name_size));
+      MFEM_VERIFY(name_end != NULL, "invalid record in binary file");
+      if (name_end == rheader) { break; }
+
+      std::int32_t rtype;
+      std::int64_t rcount;
+      std::memcpy(&rtype, rheader + name_size, 4);
+      std::memcpy(&rcount, rheader + name_size + 8, 8);
+      if (swap)
+      {
+         SwapBytes((char*) &rtype, 4, 1);
+         SwapBytes((char*) &rcount, 8, 1);
+      }
+      const int entry_size = EntrySize(rtype);
+      MFEM_VERIFY(entry_size > 0, "unknown record type " << rtype);
+      MFEM_VERIFY(rcount >= 0 && rcount <= INT_MAX,
+                  "invalid record size " << rcount);
+
+      const std::size_t nbytes = std::size_t(rcount)*entry_size;
+      Record &rec = records[std::string(rheader, name_end)];
+      rec.type = rtype;
+      rec.size = int(rcount);
+      rec.data = Next(nbytes + (8 - nbytes % 8) % 8);
+      rec.swap = swap && entry_size > 1;
+   }
+}
+
+void *BinaryReader::Find(const std::string &name, int rtype, int &size) const
+{
+   std::map<std::string, Record>::const_iterator it = records.find(name);
+   MFEM_VERIFY(it != records.end(), "record '" << name << "' not found in "
+               "binary file of type " << type);
+   const Record &rec = it->second;
+   MFEM_VERIFY(rec.type == rtype, "record '" << name << "' has type "
+               << rec.type << ", expected " << rtype);
+   if (rec.swap)
+   {
+      SwapBytes(rec.data, EntrySize(rec.type), rec.size);
+      rec.swap = false;
+   }
+   size = rec.size;
+   return rec.data;
+}
+
+} // namespace mfem
@@ -13,8 +13,12 @@
 #define MFEM_BINARYIO
 
 #include "../config/config.hpp"
+#include "array.hpp"
 
+#include <cstddef>
 #include <iostream>
+#include <string>
+#include <map>
 
 namespace mfem
 {
@@ -40,6 +44,148 @@ inline T read(std::istream& is)
 
 } // namespace mfem::bin_io
 
+
+/** @brief Writer of MFEM's binary file format, a sequence of named arrays that
+    can be read in place from a memory-mapped file, see BinaryReader. */
+/** A binary file starts with a header of 64 bytes: a text line identifying the
+    contents, e.g. "MFEM binary mesh v1.0", zero-padded to 48 bytes, followed
+    by the 32-bit endianness tag 0x01020304 and the version of the container
+    format, both in the byte order of the writer, and 8 zero bytes.
+
+    The header is followed by the records. Each record has a header of 48
+    bytes, consisting of its zero-padded name (at most 31 characters), its data
+    type (32-bit), 4 zero bytes and its number of entries (64-bit), followed by
+    its data, zero-padded to a multiple of 8 bytes. The records are terminated
+    by a record header with an empty name. All data offsets are multiples of 8
+    bytes from the beginning of the file. */
+class BinaryWriter
+{
+protected:
+   std::ostream &out;
+   bool finished;
+
+   void WriteRecord(const std::string &name, int type, const void *data,
+                    int count, int entry_size);
+
+public:
+   /// Write the header of a binary file with the given @a type to @a out.
+   BinaryWriter(std::ostream &out, const std::string &type);
+
+   /// Write the integer array @a data of size @a size as record @a name.
+   void Write(const std::string &name, const int *data, int size);
+
+   /// Write the double array @a data of size @a size as record @a name.
+   void Write(const std::string &name, const double *data, int size);
+
+   /// Write the string @a str as record @a name.
+   void Write(const std::string &name, const std::string &str);
+
+   /// Write the integer array @a a as record @a name.
+   void Write(const std::string &name, const Array<int> &a)
+   { Write(name, a.GetData(), a.Size()); }
+
+   /// Terminate the list of records; no more records can be written.
+   void Finish();
+
+   /// Calls Finish(), if it was not called already.
+   ~BinaryWriter() { if (!finished) { Finish(); } }
+};
+
+
+/// Reader of the binary file format written by BinaryWriter.
+/** When constructed from a file name, the file is mapped in memory (with
+    copy-on-write semantics, where supported) and the arrays returned by
+    GetData() point directly to the mapped file, so large arrays, e.g. the
+    data of a GridFunction, are never copied. When constructed from a stream,
+    the records are read into memory owned by the reader.
+
+    Files written on a machine with a different byte order are detected from
+    the endianness tag and their data is converted in place on the first
+    access, which for mapped files copies the affected pages.
+
+    The data returned by the reader is valid only during the lifetime of the
+    reader. */
+class BinaryReader
+{
+public:
+   /// Data types of the records.
+   enum DataType { INT32 = 1, FLOAT64 = 2, CHAR = 3 };
+
+protected:
+   struct Record
+   {
+      int type, size;
+      char *data;
+      mutable bool swap; ///< The data has to be converted to this byte order
+   };
+
+   std::string type;
+   std::map<std::string, Record> records;
+
+   std::istream *in;  ///< Not NULL while parsing a stream
+   char *map_data;    ///< The mapped (or read) file, or NULL
+   std::size_t map_size, map_pos;
+   bool mapped;       ///< Whether map_data was mapped with mmap()
+   Array<double*> blocks; ///< Memory allocated by the reader
+
+   char *Next(std::size_t nbytes);
+   void Parse(bool type_read);
+   void *Find(const std::string &name, int rtype, int &size) const;
+
+   static int TypeOf(const int *) { return INT32; }
+   static int TypeOf(const double *) { return FLOAT64; }
+   static int TypeOf(const char *) { return CHAR; }
+
+private:
+   /// Copy construction is not supported; body is undefined.
+   BinaryReader(const BinaryReader &);
+
+   /// Copy assignment is not supported; body is undefined.
+   BinaryReader &operator=(const BinaryReader &);
+
+public:
+   /// Map the binary file @a filename in memory and read its list of records.
+   explicit BinaryReader(const char *filename);
+
+   /// Read a binary file from the stream @a input.
+   /** If @a type_line is not empty, it is the first line of the header, which
+       has already been extracted from the stream, e.g. by Mesh::Load(). */
+   BinaryReader(std::istream &input, const std::string &type_line = "");
+
+   ~BinaryReader();
+
+   /// Return the type of the file, i.e. the first line of its header.
+   const std::string &GetType() const { return type; }
+
+   /// Return true if the file contains a record with the given @a name.
+   bool Has(const std::string &name) const
+   { return records.find(name) != records.end(); }
+
+   /** @brief Return a pointer to the data of the record @a name and set
+       @a size to its number of entries. The type T must be int, double or
+       char and match the type of the record. */
+   template <typename T>
+   T *GetData(const std::string &name, int &size) const
+   { return static_cast<T*>(Find(name, TypeOf((T*)NULL), size)); }
+
+   /// Make @a a a reference to the data of the record @a name.
+   template <typename T>
+   void Get(const std::string &name, Array<T> &a) const
+   {
+      int size;
+      T *data = GetData<T>(name, size);
+      a.MakeRef(data, size);
+   }
+
+   /// Return the string stored in the record @a name.
+   std::string GetString(const std::string &name) const
+   {
+      int size;
+      const char *str = GetData<char>(name, size);
+      return std::string(str, size);
+   }
+};
+
 } // namespace mfem
 
 #endif
@@ -28,6 +28,10 @@
 
 #include <iostream>
 #include <map>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
 
 using namespace std;
 
@@ -1349,6 +1353,200 @@ MPI_Comm ReorderRanksZCurve(MPI_Comm comm)
 }
 #endif // __bgq__
 
+
+// Layout of the files written by WriteSharedFile(): a header of size
+// shared_header_size with the type line, the endianness tag, the format version
+// and the number of ranks, followed by the index of nranks+1 int64 file offsets
+// of the rank buffers, followed by the buffers.
+static const char shared_file_type[] = "MFEM shared file v1.0\n";
+static const int shared_header_size = 64;
+static const std::uint32_t shared_endian_tag = 0x01020304u;
+static const std::uint32_t shared_swapped_endian_tag = 0x04030201u;
+static const std::uint32_t shared_version = 1;
+
+// Maximum number of bytes transferred by one MPI-IO call
+static const int shared_max_chunk = 1 << 30;
+
+static void SwapInt64(std::int64_t &v)
+{
+   char *bytes = reinterpret_cast<char*>(&v);
+   std::reverse(bytes, bytes + 8);
+}
+
+// Collective open; returns true if the file was opened on all ranks. The
+// ranks agree on the result before returning, so that they all either go on
+// with the collective I/O calls or return.
+static bool OpenSharedFile(MPI_Comm comm, const std::string &filename,
+                           int amode, MPI_File &fh)
+{
+   int failed = (MPI_File_open(comm, const_cast<char*>(filename.c_str()),
+                               amode, MPI_INFO_NULL, &fh) != MPI_SUCCESS);
+   int any_failed;
+   MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, comm);
+   if (any_failed && !failed) { MPI_File_close(&fh); }
+   return !any_failed;
+}
+
+bool WriteSharedFile(MPI_Comm comm, const std::string &filename,
+                     const std::string &data)
+{
+   int myid, nranks;
+   MPI_Comm_rank(comm, &myid);
+   MPI_Comm_size(comm, &nranks);
+
+   // Offset of the local buffer relative to the start of the data section
+   const std::int64_t size = data.size();
+   std::int64_t my_start = 0;
+   MPI_Exscan(&size, &my_start, 1, MPI_INT64_T, MPI_SUM, comm);
+   if (myid == 0) { my_start = 0; }
+   std::vector<std::int64_t> sizes(myid == 0 ? nranks : 0);
+   MPI_Gather(&size, 1, MPI_INT64_T, sizes.data(), 1, MPI_INT64_T, 0, comm);
+
+   MPI_File fh;
+   if (!OpenSharedFile(comm, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY, fh))
+   {
+      return false;
+   }
+   // Discard the contents of an existing file
+   int failed = (MPI_File_set_size(fh, 0) != MPI_SUCCESS);
+
+   MPI_Status status;
+   const MPI_Offset data_start = shared_header_size + 8*(nranks + 1);
+   if (myid == 0)
+   {
+      std::vector<char> header(data_start, '\0');
+      const std::int64_t nranks64 = nranks;
+      std::memcpy(&header[0], shared_file_type, sizeof(shared_file_type) - 1);
+      std::memcpy(&header[48], &shared_endian_tag, 4);
+      std::memcpy(&header[52], &shared_version, 4);
+      std::memcpy(&header[56], &nranks64, 8);
+      std::int64_t offset = data_start;
+      for (int i = 0; i <= nranks; i++)
+      {
+         std::memcpy(&header[shared_header_size + 8*i], &offset, 8);
+         if (i < nranks) { offset += sizes[i]; }
+      }
+      failed |= (MPI_File_write_at(fh, 0, &header[0], int(header.size()),
+                                   MPI_BYTE, &status) != MPI_SUCCESS);
+   }
+
+   // All ranks take part in the same number of collective calls
+   int nchunks = int((size + shared_max_chunk - 1)/shared_max_chunk);
+   int max_nchunks;
+   MPI_Allreduce(&nchunks, &max_nchunks, 1, MPI_INT, MPI_MAX, comm);
+   for (int i = 0; i < max_nchunks; i++)
+   {
+      const std::int64_t pos =
+         std::min(std::int64_t(i)*shared_max_chunk, size);
+      const int count =
+         int(std::min(size - pos, std::int64_t(shared_max_chunk)));
+      failed |= (MPI_File_write_at_all(
+                    fh, data_start + my_start + pos,
+                    const_cast<char*>(data.data()) + pos, count, MPI_BYTE,
+                    &status) != MPI_SUCCESS);
+   }
+   failed |= (MPI_File_close(&fh) != MPI_SUCCESS);
+
+   int any_failed;
+   MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, comm);
+   return !any_failed;
+}
+
+// Collective read of 'count' bytes at 'offset'; returns true on success
+static bool ReadAtAll(MPI_File fh, MPI_Offset offset, char *buf, int count)
+{
+   MPI_Status status;
+   int nread;
+   if (MPI_File_read_at_all(fh, offset, buf, count, MPI_BYTE, &status)
+       != MPI_SUCCESS) { return false; }
+   MPI_Get_count(&status, MPI_BYTE, &nread);
+   return (nread == count);
+}
+
+bool ReadSharedFile(MPI_Comm comm, const std::string &filename,
+                    std::string &data)
+{
+   int myid, nranks;
+   MPI_Comm_rank(comm, &myid);
+   MPI_Comm_size(comm, &nranks);
+   data.clear();
+
+   MPI_File fh;
+   if (!OpenSharedFile(comm, filename, MPI_MODE_RDONLY, fh)) { return false; }
+
+   // All ranks read and check the (small) header
+   char header[shared_header_size];
+   int failed = !ReadAtAll(fh, 0, header, shared_header_size);
+   bool swap = false;
+   if (!failed)
+   {
+      std::uint32_t tag, version;
+      std::int64_t file_nranks;
+      std::memcpy(&tag, header + 48, 4);
+      std::memcpy(&version, header + 52, 4);
+      std::memcpy(&file_nranks, header + 56, 8);
+      swap = (tag == shared_swapped_endian_tag);
+      if (swap)
+      {
+         std::reverse((char*) &version, (char*) &version + 4);
+         SwapInt64(file_nranks);
+      }
+      if (std::memcmp(header, shared_file_type,
+                      sizeof(shared_file_type) - 1) != 0 ||
+          (!swap && tag != shared_endian_tag) || version > shared_version)
+      {
+         failed = 1;
+         if (myid == 0)
+         {
+            MFEM_WARNING("invalid shared file: " << filename);
+         }
+      }
+      else if (file_nranks != nranks)
+      {
+         failed = 1;
+         if (myid == 0)
+         {
+            MFEM_WARNING("the shared file " << filename << " was written by "
+                         << file_nranks << " ranks, expected " << nranks);
+         }
+      }
+   }
+   int any_failed;
+   MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, comm);
+   if (any_failed)
+   {
+      MPI_File_close(&fh);
+      return false;
+   }
+
+   // Each rank reads its two entries of the index, then its buffer
+   std::int64_t range[2] = { 0, 0 };
+   failed = !ReadAtAll(fh, shared_header_size + 8*myid, (char*) range, 16);
+   if (swap) { SwapInt64(range[0]); SwapInt64(range[1]); }
+   const std::int64_t size = failed ? 0 : range[1] - range[0];
+   if (size < 0) { failed = 1; }
+   else { data.resize(size); }
+   // The characters of a non-empty string are contiguous and writable
+   char *buf = data.empty() ? NULL : &data[0];
+
+   int nchunks = int((data.size() + shared_max_chunk - 1)/shared_max_chunk);
+   int max_nchunks;
+   MPI_Allreduce(&nchunks, &max_nchunks, 1, MPI_INT, MPI_MAX, comm);
+   for (int i = 0; i < max_nchunks; i++)
+   {
+      const std::int64_t pos =
+         std::min(std::int64_t(i)*shared_max_chunk, std::int64_t(data.size()));
+      const int count = int(std::min(std::int64_t(data.size()) - pos,
+                                     std::int64_t(shared_max_chunk)));
+      failed |= !ReadAtAll(fh, range[0] + pos, buf + pos, count);
+   }
+   MPI_File_close(&fh);
+
+   MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_MAX, comm);
+   if (any_failed) { data.clear(); }
+   return !any_failed;
+}
+
 } // namespace mfem
 
 #endif
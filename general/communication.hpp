@@ -21,6 +21,7 @@
 #include "sets.hpp"
 #include "globals.hpp"
 #include <mpi.h>
+#include <string>
 
 
 namespace mfem
@@ -449,6 +450,31 @@ template<> struct MPITypeMap<double> { static const MPI_Datatype mpi_type; };
 MPI_Comm ReorderRanksZCurve(MPI_Comm comm);
 
 
+/** @brief Write the buffer @a data of every rank of @a comm into the single
+    shared file @a filename using collective MPI-IO.
+
+    The file starts with a header holding the number of ranks, followed by an
+    index with the offsets of the rank buffers, followed by the buffers in rank
+    order. This avoids creating one file per rank (as in ParMesh::ParPrint()
+    with one stream per rank) and funneling all data through rank 0 (as in
+    ParMesh::PrintAsOne()). The function is collective and returns the same
+    value on all ranks: true on success, false if the file could not be
+    written. */
+bool WriteSharedFile(MPI_Comm comm, const std::string &filename,
+                     const std::string &data);
+
+/** @brief Read the buffer of the calling rank from the shared file
+    @a filename written by WriteSharedFile() using collective MPI-IO.
+
+    The number of ranks in @a comm must be the same as when the file was
+    written: the rank with index i gets the buffer written by rank i. The
+    function is collective and returns the same value on all ranks: true on
+    success, false if the file could not be read or if the number of ranks does
+    not match. */
+bool ReadSharedFile(MPI_Comm comm, const std::string &filename,
+                    std::string &data);
+
+
 } // namespace mfem
 
 #endif
@@ -0,0 +1,231 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "bcsrmat.hpp"
+#include "../general/forall.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+BCSRMatrix::BCSRMatrix(const SparseMatrix &mat, int block_size)
+   : Operator(mat.Height(), mat.Width()), bs(block_size)
+{
+   MFEM_VERIFY(mat.Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(bs > 0 && height % bs == 0 && width % bs == 0,
+               "the matrix size " << height << " x " << width
+               << " is not a multiple of the block size " << bs);
+
+   nbrows = height / bs;
+   nbcols = width / bs;
+   const int *mI = mfem::Read(mat.GetMemoryI(), height+1, false);
+   const int nnz = mI[height];
+   const int *mJ = mfem::Read(mat.GetMemoryJ(), nnz, false);
+   const double *mA = mfem::Read(mat.GetMemoryData(), nnz, false);
+
+   // Count the distinct block columns in every block row.
+   Array<int> marker(nbcols), pos(nbcols);
+   marker = -1;
+   I.SetSize(nbrows+1);
+   I[0] = 0;
+   for (int ib = 0; ib < nbrows; ib++)
+   {
+      int cnt = 0;
+      for (int i = ib*bs; i < (ib+1)*bs; i++)
+      {
+         for (int j = mI[i]; j < mI[i+1]; j++)
+         {
+            const int jb = mJ[j] / bs;
+            if (marker[jb] != ib) { marker[jb] = ib; cnt++; }
+         }
+      }
+      I[ib+1] = I[ib] + cnt;
+   }
+
+   // Fill the block column indices and the blocks.
+   const int nnzb = I[nbrows];
+   J.SetSize(nnzb);
+   A.SetSize(bs*bs*nnzb);
+   double *hA = A.HostWrite();
+   std::fill(hA, hA + A.Size(), 0.0);
+   marker = -1;
+   for (int ib = 0; ib < nbrows; ib++)
+   {
+      int k = I[ib];
+      for (int r = 0; r < bs; r++)
+      {
+         const int i = ib*bs + r;
+         for (int j = mI[i]; j < mI[i+1]; j++)
+         {
+            const int jb = mJ[j] / bs;
+            if (marker[jb] != ib)
+            {
+               marker[jb] = ib;
+               pos[jb] = k;
+               J[k++] = jb;
+            }
+            hA[(pos[jb]*bs + r)*bs + mJ[j] % bs] += mA[j];
+         }
+      }
+   }
+}
+
+// y += a * A * x, with the block size known at compile time.
+template <int T_BS>
+static void BCSRAddMult(const int nbrows, const Array<int> &I,
+                        const Array<int> &J, const Vector &A,
+                        const Vector &x, Vector &y, const double a)
+{
+   constexpr int BS = T_BS;
+   auto d_I = I.Read();
+   auto d_J = J.Read();
+   auto d_A = A.Read();
+   auto d_x = x.Read();
+   auto d_y = y.ReadWrite();
+   MFEM_FORALL(i, nbrows,
+   {
+      double s[BS];
+      for (int r = 0; r < BS; r++) { s[r] = 0.0; }
+      const int end = d_I[i+1];
+      for (int k = d_I[i]; k < end; k++)
+      {
+         const double *Ak = d_A + k*BS*BS;
+         const double *xk = d_x + d_J[k]*BS;
+         for (int r = 0; r < BS; r++)
+         {
+            for (int c = 0; c < BS; c++)
+            {
+               s[r] += Ak[r*BS + c] * xk[c];
+            }
+         }
+      }
+      for (int r = 0; r < BS; r++) { d_y[i*BS + r] += a * s[r]; }
+   });
+}
+
+// Generic version of BCSRAddMult, for any block size.
+static void BCSRAddMult(const int nbrows, const int bs, const Array<int> &I,
+                        const Array<int> &J, const Vector &A,
+                        const Vector &x, Vector &y, const double a)
+{
+   auto d_I = I.Read();
+   auto d_J = J.Read();
+   auto d_A = A.Read();
+   auto d_x = x.Read();
+   auto d_y = y.ReadWrite();
+   MFEM_FORALL(i, nbrows,
+   {
+      const int end = d_I[i+1];
+      for (int r = 0; r < bs; r++)
+      {
+         double s = 0.0;
+         for (int k = d_I[i]; k < end; k++)
+         {
+            const double *Akr = d_A + (k*bs + r)*bs;
+            const double *xk = d_x + d_J[k]*bs;
+            for (int c = 0; c < bs; c++) { s += Akr[c] * xk[c]; }
+         }
+         d_y[i*bs + r] += a * s;
+      }
+   });
+}
+
+void BCSRMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y.UseDevice(true);
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void BCSRMatrix::AddMult(const Vector &x, Vector &y, const double a) const
+{
+   MFEM_ASSERT(width == x.Size(), "Input vector size (" << x.Size()
+               << ") must match matrix width (" << width << ")");
+   MFEM_ASSERT(height == y.Size(), "Output vector size (" << y.Size()
+               << ") must match matrix height (" << height << ")");
+
+   switch (bs)
+   {
+      case 1: return BCSRAddMult<1>(nbrows, I, J, A, x, y, a);
+      case 2: return BCSRAddMult<2>(nbrows, I, J, A, x, y, a);
+      case 3: return BCSRAddMult<3>(nbrows, I, J, A, x, y, a);
+      case 4: return BCSRAddMult<4>(nbrows, I, J, A, x, y, a);
+      default: return BCSRAddMult(nbrows, bs, I, J, A, x, y, a);
+   }
+}
+
+void BCSRMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMultTranspose(x, y);
+}
+
+void BCSRMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                  const double a) const
+{
+   MFEM_ASSERT(height == x.Size(), "Input vector size (" << x.Size()
+               << ") must match matrix height (" << height << ")");
+   MFEM_ASSERT(width == y.Size(), "Output vector size (" << y.Size()
+               << ") must match matrix width (" << width << ")");
+
+   // The scatter to the block columns is done on the host.
+   const int *h_I = I.HostRead();
+   const int *h_J = J.HostRead();
+   const double *h_A = A.HostRead();
+   const double *h_x = x.HostRead();
+   double *h_y = y.HostReadWrite();
+   for (int i = 0; i < nbrows; i++)
+   {
+      const double *xi = h_x + i*bs;
+      for (int k = h_I[i]; k < h_I[i+1]; k++)
+      {
+         const double *Ak = h_A + k*bs*bs;
+         double *yk = h_y + h_J[k]*bs;
+         for (int r = 0; r < bs; r++)
+         {
+            const double axr = a * xi[r];
+            for (int c = 0; c < bs; c++) { yk[c] += Ak[r*bs + c] * axr; }
+         }
+      }
+   }
+}
+
+SparseMatrix *BCSRMatrix::ToSparseMatrix() const
+{
+   const int *h_I = I.HostRead();
+   const int *h_J = J.HostRead();
+   const double *h_A = A.HostRead();
+   int *mI = new int[height+1];
+   int *mJ = new int[A.Size()];
+   double *mA = new double[A.Size()];
+   mI[0] = 0;
+   int j = 0;
+   for (int ib = 0; ib < nbrows; ib++)
+   {
+      for (int r = 0; r < bs; r++)
+      {
+         for (int k = h_I[ib]; k < h_I[ib+1]; k++)
+         {
+            for (int c = 0; c < bs; c++)
+            {
+               mJ[j] = h_J[k]*bs + c;
+               mA[j] = h_A[(k*bs + r)*bs + c];
+               j++;
+            }
+         }
+         mI[ib*bs + r + 1] = j;
+      }
+   }
+   return new SparseMatrix(mI, mJ, mA, height, width);
+}
+
+}
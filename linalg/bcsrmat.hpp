@@ -0,0 +1,91 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BCSRMAT
+#define MFEM_BCSRMAT
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix in block compressed sparse row (BCSR) format, with
+    dense square blocks of a fixed size.
+
+    The matrix is a copy of a finalized SparseMatrix whose rows and columns are
+    grouped in consecutive blocks of size #bs. Every block that contains at
+    least one stored entry of the SparseMatrix is stored as a dense bs x bs
+    block, so only one column index is read per block. For vector finite
+    element spaces with Ordering::byVDIM and bs = vdim, the blocks are the
+    natural vdim x vdim couplings between two nodes and no zeros are added. */
+class BCSRMatrix : public Operator
+{
+protected:
+   /// Size of the square blocks.
+   int bs;
+   /// Number of block rows and block columns.
+   int nbrows, nbcols;
+   /// Block row offsets, size #nbrows+1.
+   Array<int> I;
+   /// Block column indices, size I[#nbrows].
+   Array<int> J;
+   /** @brief Block entries, size bs*bs*I[#nbrows]. Every block is stored in
+       row-major order. */
+   Vector A;
+
+public:
+   /** @brief Create the BCSR copy of the finalized SparseMatrix @a mat with
+       blocks of size @a block_size. The height and width of @a mat must be
+       multiples of @a block_size. */
+   BCSRMatrix(const SparseMatrix &mat, int block_size);
+
+   /// Return the size of the square blocks.
+   int GetBlockSize() const { return bs; }
+
+   /// Return the number of stored blocks.
+   int NumBlocks() const { return J.Size(); }
+
+   /// Return the number of stored entries, including the zeros in the blocks.
+   int NumStoredEntries() const { return A.Size(); }
+
+   /// Block row offsets.
+   const Array<int> &GetBlockI() const { return I; }
+   /// Block column indices.
+   const Array<int> &GetBlockJ() const { return J; }
+   /// Block entries, see #A.
+   const Vector &GetBlockData() const { return A; }
+
+   virtual MemoryClass GetMemoryClass() const
+   { return Device::GetMemoryClass(); }
+
+   /// y = A * x
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a * A * x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// y = A^t * x
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a * A^t * x
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double a = 1.0) const;
+
+   /// Convert back to a (finalized) SparseMatrix, keeping the block zeros.
+   SparseMatrix *ToSparseMatrix() const;
+};
+
+}
+
+#endif
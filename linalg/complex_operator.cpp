@@ -79,6 +79,54 @@ void ComplexOperator::Mult(const Vector &x_r, const Vector &x_i,
    }
 }
 
+void ComplexOperator::ArrayMult(const Array<const Vector *> &X,
+                                Array<Vector *> &Y) const
+{
+   const int nv = X.Size();
+   const int w = Op_Real_->Width(), h = Op_Real_->Height();
+   // Views of the real (even entries) and imaginary (odd entries) parts
+   Array<const Vector *> xc(2*nv);
+   Array<Vector *> yc(2*nv), tc(2*nv);
+   for (int v = 0; v < nv; v++)
+   {
+      double *x_data = X[v]->GetData();
+      double *y_data = Y[v]->GetData();
+      xc[2*v] = new Vector(x_data, w);
+      xc[2*v+1] = new Vector(&x_data[w], w);
+      yc[2*v] = new Vector(y_data, h);
+      yc[2*v+1] = new Vector(&y_data[h], h);
+   }
+
+   if (Op_Real_)
+   {
+      Op_Real_->ArrayMult(xc, yc);
+   }
+   else
+   {
+      for (int v = 0; v < nv; v++) { *Y[v] = 0.0; }
+   }
+   if (Op_Imag_)
+   {
+      for (int i = 0; i < 2*nv; i++) { tc[i] = new Vector(h); }
+      Op_Imag_->ArrayMult(xc, tc);
+      for (int v = 0; v < nv; v++)
+      {
+         *yc[2*v] -= *tc[2*v+1];
+         *yc[2*v+1] += *tc[2*v];
+      }
+      for (int i = 0; i < 2*nv; i++) { delete tc[i]; }
+   }
+
+   for (int v = 0; v < nv; v++)
+   {
+      if (convention_ == BLOCK_SYMMETRIC) { *yc[2*v+1] *= -1.0; }
+      delete xc[2*v];
+      delete xc[2*v+1];
+      delete yc[2*v];
+      delete yc[2*v+1];
+   }
+}
+
 void ComplexOperator::MultTranspose(const Vector &x, Vector &y) const
 {
    double * x_data = x.GetData();
@@ -85,6 +85,12 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
    virtual void MultTranspose(const Vector &x, Vector &y) const;
 
+   /** @brief Operator application on a batch of vectors. The real and
+       imaginary parts of all vectors are passed as one batch to ArrayMult() of
+       the real and imaginary operators. */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
 protected:
    // Let this be hidden from the public interface since the implementation
    // depends on internal members
@@ -18,6 +18,8 @@
 #include "operator.hpp"
 #include "matrix.hpp"
 #include "sparsemat.hpp"
+#include "bcsrmat.hpp"
+#include "sellmat.hpp"
 #include "complex_operator.hpp"
 #include "blockvector.hpp"
 #include "blockmatrix.hpp"
@@ -26,6 +28,7 @@
 #include "densemat.hpp"
 #include "ode.hpp"
 #include "solvers.hpp"
+#include "multigrid.hpp"
 #include "handle.hpp"
 #include "invariants.hpp"
 
@@ -0,0 +1,148 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "multigrid.hpp"
+
+namespace mfem
+{
+
+Multigrid::Multigrid()
+   : Solver(0, false), cycle_type(VCYCLE),
+     pre_smoothing_steps(1), post_smoothing_steps(1)
+{ }
+
+Multigrid::~Multigrid()
+{
+   for (int l = 0; l < NumLevels(); l++)
+   {
+      if (own_operators[l]) { delete operators[l]; }
+      if (own_smoothers[l]) { delete smoothers[l]; }
+      if (own_prolongations[l]) { delete prolongations[l]; }
+      delete R[l];
+      delete Z[l];
+   }
+   for (int l = 0; l < B.Size(); l++)
+   {
+      delete B[l];
+      delete U[l];
+   }
+}
+
+void Multigrid::AddLevel(Operator *op, Solver *smoother,
+                         Operator *prolongation, bool own_op,
+                         bool own_smoother, bool own_prolongation)
+{
+   MFEM_VERIFY(op && smoother, "invalid operator or smoother");
+   MFEM_VERIFY(op->Height() == op->Width(), "the operator must be square");
+   if (NumLevels() > 0)
+   {
+      const int coarse_size = operators.Last()->Height();
+      MFEM_VERIFY(prolongation != NULL, "the prolongation is missing");
+      MFEM_VERIFY(prolongation->Height() == op->Height() &&
+                  prolongation->Width() == coarse_size,
+                  "the prolongation size " << prolongation->Height() << " x "
+                  << prolongation->Width() << " does not match the levels, "
+                  << op->Height() << " x " << coarse_size);
+      // The previous finest level becomes a coarse level.
+      B.Append(new Vector(coarse_size));
+      U.Append(new Vector(coarse_size));
+   }
+   else
+   {
+      MFEM_VERIFY(prolongation == NULL || !own_prolongation,
+                  "the coarsest level has no prolongation");
+      prolongation = NULL;
+   }
+   // The smoothers are applied to residuals, starting from zero
+   smoother->iterative_mode = false;
+   operators.Append(op);
+   smoothers.Append(smoother);
+   prolongations.Append(prolongation);
+   own_operators.Append(own_op);
+   own_smoothers.Append(own_smoother);
+   own_prolongations.Append(own_prolongation && prolongation);
+   R.Append(new Vector(op->Height()));
+   Z.Append(new Vector(op->Height()));
+   height = width = op->Height();
+}
+
+void Multigrid::SmoothingStep(int level, const Vector &b, Vector &u,
+                              bool zero) const
+{
+   if (zero)
+   {
+      smoothers[level]->Mult(b, u);
+      return;
+   }
+   Vector &r = *R[level], &z = *Z[level];
+   operators[level]->Mult(u, r);
+   subtract(b, r, r);
+   smoothers[level]->Mult(r, z);
+   u += z;
+}
+
+void Multigrid::Cycle(int level, const Vector &b, Vector &u, bool zero) const
+{
+   if (level == 0)
+   {
+      SmoothingStep(0, b, u, zero);
+      return;
+   }
+
+   for (int s = 0; s < pre_smoothing_steps; s++)
+   {
+      SmoothingStep(level, b, u, zero);
+      zero = false;
+   }
+
+   // Coarse grid correction
+   Vector &r = *R[level], &z = *Z[level];
+   Vector &bc = *B[level-1], &uc = *U[level-1];
+   if (zero)
+   {
+      prolongations[level]->MultTranspose(b, bc);
+   }
+   else
+   {
+      operators[level]->Mult(u, r);
+      subtract(b, r, r);
+      prolongations[level]->MultTranspose(r, bc);
+   }
+   const int num_coarse_cycles = (cycle_type == WCYCLE) ? 2 : 1;
+   for (int c = 0; c < num_coarse_cycles; c++)
+   {
+      Cycle(level-1, bc, uc, c == 0);
+   }
+   if (zero)
+   {
+      prolongations[level]->Mult(uc, u);
+   }
+   else
+   {
+      prolongations[level]->Mult(uc, z);
+      u += z;
+   }
+
+   for (int s = 0; s < post_smoothing_steps; s++)
+   {
+      SmoothingStep(level, b, u, false);
+   }
+}
+
+void Multigrid::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(NumLevels() > 0, "no levels were added");
+   MFEM_ASSERT(x.Size() == height && y.Size() == height,
+               "invalid vector sizes");
+   Cycle(GetFinestLevelIndex(), x, y, !iterative_mode);
+}
+
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MULTIGRID
+#define MFEM_MULTIGRID
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "vector.hpp"
+
+namespace mfem
+{
+
+/// Multigrid solver/preconditioner for a hierarchy of Operator%s
+/** The levels are numbered from 0 (coarsest) to NumLevels()-1 (finest) and are
+    added in that order with AddLevel(). Each level consists of an Operator A_l,
+    a smoother S_l, which is a Solver approximating the inverse of A_l, and, for
+    l > 0, a prolongation P_l from level l-1 to level l. The restriction is the
+    transpose of the prolongation and the smoother of level 0 is used as the
+    coarse solver.
+
+    The smoothers are applied in correction form, u <- u + S_l (b - A_l u), so
+    they only need to implement Mult() with iterative_mode = false; in
+    particular, operator-only (e.g. partially assembled) levels can be combined
+    with smoothers that use any approximation of A_l. With symmetric smoothers,
+    the same number of pre- and post-smoothing steps and a V- or W-cycle, the
+    resulting preconditioner is symmetric and can be used with CG.
+
+    One cycle is performed for every call to Mult(), starting from zero unless
+    iterative_mode is set. */
+class Multigrid : public Solver
+{
+public:
+   enum CycleType { VCYCLE, WCYCLE };
+
+protected:
+   Array<Operator*> operators;
+   Array<Solver*> smoothers;
+   /// Prolongations from level l-1 to level l; the entry for level 0 is NULL.
+   Array<Operator*> prolongations;
+   Array<bool> own_operators, own_smoothers, own_prolongations;
+
+   CycleType cycle_type;
+   int pre_smoothing_steps, post_smoothing_steps;
+
+   /// Right-hand side and solution work vectors for the coarse levels.
+   mutable Array<Vector*> B, U;
+   /// Residual and correction work vectors for all levels.
+   mutable Array<Vector*> R, Z;
+
+   /** Apply one smoothing step at @a level. If @a zero is true, @a u is assumed
+       to be zero on entry and the residual is not computed. */
+   void SmoothingStep(int level, const Vector &b, Vector &u, bool zero) const;
+
+   /// Recursive multigrid cycle at @a level; see SmoothingStep() for @a zero.
+   void Cycle(int level, const Vector &b, Vector &u, bool zero) const;
+
+public:
+   /// Create an empty multigrid solver; add the levels with AddLevel().
+   Multigrid();
+
+   virtual ~Multigrid();
+
+   /** @brief Add a new finest level with the Operator @a op, smoother
+       @a smoother and prolongation @a prolongation from the previous finest
+       level (ignored for the first level, which can pass NULL). */
+   /** The ownership flags specify whether the objects are destroyed together
+       with the Multigrid. */
+   void AddLevel(Operator *op, Solver *smoother, Operator *prolongation,
+                 bool own_op, bool own_smoother, bool own_prolongation);
+
+   /// Return the number of levels.
+   int NumLevels() const { return operators.Size(); }
+
+   /// Return the index of the finest level.
+   int GetFinestLevelIndex() const { return NumLevels() - 1; }
+
+   /// Return the Operator at the given @a level.
+   Operator *GetOperatorAtLevel(int level) const { return operators[level]; }
+
+   /// Return the smoother (the coarse solver for level 0) at @a level.
+   Solver *GetSmootherAtLevel(int level) const { return smoothers[level]; }
+
+   /// Return the prolongation from level @a level-1 to level @a level.
+   Operator *GetProlongationAtLevel(int level) const
+   { return prolongations[level]; }
+
+   /// Set the cycle type and the number of pre- and post-smoothing steps.
+   void SetCycle(CycleType type, int pre_steps, int post_steps)
+   {
+      cycle_type = type;
+      pre_smoothing_steps = pre_steps;
+      post_smoothing_steps = post_steps;
+   }
+
+   /// Apply one multigrid cycle on the finest level.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// The levels must be set with AddLevel(); not supported.
+   virtual void SetOperator(const Operator &)
+   { MFEM_ABORT("use AddLevel() to define the multigrid levels"); }
+};
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 
 #include "operator.hpp"
 #include "ode.hpp"
+#include "../general/forall.hpp"
 
 namespace mfem
 {
@@ -344,6 +345,192 @@ const double RK8Solver::c[] =
 };
 
 
+EmbeddedRKSolver::EmbeddedRKSolver(int _s, const double *_a,
+                                   const double *_b, const double *_bh,
+                                   const double *_c, int _q)
+   : ExplicitRKSolver(_s, _a, _b, _c), bh(_bh), q(_q)
+{
+   // FSAL: the last row of the tableau is b[] and the last stage is at t+dt
+   fsal = (c[s-2] == 1.0 && b[s-1] == 0.0);
+   for (int i = 0, l = (s-1)*(s-2)/2; fsal && i < s-1; i++)
+   {
+      fsal = (a[l+i] == b[i]);
+   }
+   first_valid = last_valid = repeat = false;
+}
+
+void EmbeddedRKSolver::Init(TimeDependentOperator &_f)
+{
+   ExplicitRKSolver::Init(_f);
+   err.SetSize(f->Width(), mem_type);
+   first_valid = last_valid = repeat = false;
+}
+
+void EmbeddedRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   if (!(repeat && first_valid && t == t_first))
+   {
+      if (fsal && last_valid && t == t_last)
+      {
+         k[0].Swap(k[s-1]);
+      }
+      else
+      {
+         f->SetTime(t);
+         f->Mult(x, k[0]);
+      }
+   }
+   first_valid = true;
+   repeat = false;
+   t_first = t;
+
+   for (int l = 0, i = 1; i < s; i++)
+   {
+      add(x, a[l++]*dt, k[0], y);
+      for (int j = 1; j < i; j++)
+      {
+         y.Add(a[l++]*dt, k[j]);
+      }
+
+      f->SetTime(t + c[i-1]*dt);
+      f->Mult(y, k[i]);
+   }
+   last_valid = fsal;
+   t_last = t + dt;
+
+   // err = dt sum (b[i] - bh[i]) k[i], the difference of the two solutions
+   err.Set((b[0] - bh[0])*dt, k[0]);
+   for (int i = 1; i < s; i++)
+   {
+      err.Add((b[i] - bh[i])*dt, k[i]);
+   }
+   for (int i = 0; i < s; i++)
+   {
+      if (b[i] != 0.0) { x.Add(b[i]*dt, k[i]); }
+   }
+   t += dt;
+}
+
+const double BogackiShampineSolver::a[] =
+{
+   1./2.,
+   0., 3./4.,
+   2./9., 1./3., 4./9.
+};
+const double BogackiShampineSolver::b[] =
+{
+   2./9., 1./3., 4./9., 0.
+};
+const double BogackiShampineSolver::bh[] =
+{
+   7./24., 1./4., 1./3., 1./8.
+};
+const double BogackiShampineSolver::c[] =
+{
+   1./2., 3./4., 1.
+};
+
+const double DormandPrinceSolver::a[] =
+{
+   1./5.,
+   3./40., 9./40.,
+   44./45., -56./15., 32./9.,
+   19372./6561., -25360./2187., 64448./6561., -212./729.,
+   9017./3168., -355./33., 46732./5247., 49./176., -5103./18656.,
+   35./384., 0., 500./1113., 125./192., -2187./6784., 11./84.
+};
+const double DormandPrinceSolver::b[] =
+{
+   35./384., 0., 500./1113., 125./192., -2187./6784., 11./84., 0.
+};
+const double DormandPrinceSolver::bh[] =
+{
+   5179./57600., 0., 7571./16695., 393./640., -92097./339200., 187./2100.,
+   1./40.
+};
+const double DormandPrinceSolver::c[] =
+{
+   1./5., 3./10., 4./5., 8./9., 1., 1.
+};
+
+
+LowStorageRKSolver::LowStorageRKSolver(int _s, const double *_A,
+                                       const double *_B, const double *_c)
+   : s(_s), A(_A), B(_B), c(_c)
+{
+   MFEM_ASSERT(A[0] == 0.0, "invalid low-storage RK coefficients");
+}
+
+void LowStorageRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   dx.SetSize(f->Width(), mem_type);
+   k.SetSize(f->Width(), mem_type);
+}
+
+void LowStorageRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   const int n = x.Size();
+   for (int i = 0; i < s; i++)
+   {
+      f->SetTime(t + c[i]*dt);
+      f->Mult(x, k);
+
+      // Fused update: dx = A[i] dx + dt k, x = x + B[i] dx
+      const double a = A[i], b = B[i], h = dt;
+      const bool first = (i == 0);
+      auto d_k = k.Read();
+      auto d_dx = first ? dx.Write() : dx.ReadWrite();
+      auto d_x = x.ReadWrite();
+      MFEM_FORALL(j, n,
+      {
+         const double dxj = first ? h*d_k[j] : a*d_dx[j] + h*d_k[j];
+         d_dx[j] = dxj;
+         d_x[j] += b*dxj;
+      });
+   }
+   t += dt;
+}
+
+const double WilliamsonRK3Solver::A[] =
+{
+   0., -5./9., -153./128.
+};
+const double WilliamsonRK3Solver::B[] =
+{
+   1./3., 15./16., 8./15.
+};
+const double WilliamsonRK3Solver::c[] =
+{
+   0., 1./3., 3./4.
+};
+
+const double CarpenterKennedyRK4Solver::A[] =
+{
+   0.,
+   -567301805773./1357537059087.,
+   -2404267990393./2016746695238.,
+   -3550918686646./2091501179385.,
+   -1275806237668./842570457699.
+};
+const double CarpenterKennedyRK4Solver::B[] =
+{
+   1432997174477./9575080441755.,
+   5161836677717./13612068292357.,
+   1720146321549./2090206949498.,
+   3134564353537./4481467310338.,
+   2277821191437./14882151754819.
+};
+const double CarpenterKennedyRK4Solver::c[] =
+{
+   0.,
+   1432997174477./9575080441755.,
+   2526269341429./6820363266100.,
+   2006345519317./3224310063776.,
+   2802321613138./2924317926251.
+};
+
+
 void BackwardEulerSolver::Init(TimeDependentOperator &_f)
 {
    ODESolver::Init(_f);
@@ -399,6 +586,7 @@ void SDIRK23Solver::Init(TimeDependentOperator &_f)
    ODESolver::Init(_f);
    k.SetSize(f->Width(), mem_type);
    y.SetSize(f->Width(), mem_type);
+   err.SetSize(f->Width(), mem_type);
 }
 
 void SDIRK23Solver::Step(Vector &x, double &t, double &dt)
@@ -408,15 +596,18 @@ void SDIRK23Solver::Step(Vector &x, double &t, double &dt)
    //  1-a  |  1-2a  a
    // ------+-----------
    //       |  1/2  1/2
+   //       |   1    0    (embedded, order 1)
    // note: with gamma_opt=3, both solve are outside [t,t+dt] since a>1
    f->SetTime(t + gamma*dt);
    f->ImplicitSolve(gamma*dt, x, k);
    add(x, (1.-2.*gamma)*dt, k, y); // y = x + (1-2*gamma)*dt*k
    x.Add(dt/2, k);
+   err.Set(-dt/2, k);
 
    f->SetTime(t + (1.-gamma)*dt);
    f->ImplicitSolve(gamma*dt, y, k);
    x.Add(dt/2, k);
+   err.Add(dt/2, k);
    t += dt;
 }
 
@@ -427,6 +618,7 @@ void SDIRK34Solver::Init(TimeDependentOperator &_f)
    k.SetSize(f->Width(), mem_type);
    y.SetSize(f->Width(), mem_type);
    z.SetSize(f->Width(), mem_type);
+   err.SetSize(f->Width(), mem_type);
 }
 
 void SDIRK34Solver::Step(Vector &x, double &t, double &dt)
@@ -436,6 +628,7 @@ void SDIRK34Solver::Step(Vector &x, double &t, double &dt)
    //  1-a  |   2a    1-4a   a
    // ------+--------------------
    //       |    b    1-2b   b
+   //       |    0     1     0    (embedded, order 2)
    // note: two solves are outside [t,t+dt] since c1=a>1, c3=1-a<0
    const double a = 1./sqrt(3.)*cos(M_PI/18.) + 0.5;
    const double b = 1./(6.*(2.*a-1.)*(2.*a-1.));
@@ -445,15 +638,18 @@ void SDIRK34Solver::Step(Vector &x, double &t, double &dt)
    add(x, (0.5-a)*dt, k, y);
    add(x,  (2.*a)*dt, k, z);
    x.Add(b*dt, k);
+   err.Set(b*dt, k);
 
    f->SetTime(t + dt/2);
    f->ImplicitSolve(a*dt, y, k);
    z.Add((1.-4.*a)*dt, k);
    x.Add((1.-2.*b)*dt, k);
+   err.Add(-2.*b*dt, k);
 
    f->SetTime(t + (1.-a)*dt);
    f->ImplicitSolve(a*dt, z, k);
    x.Add(b*dt, k);
+   err.Add(b*dt, k);
    t += dt;
 }
 
@@ -463,6 +659,7 @@ void SDIRK33Solver::Init(TimeDependentOperator &_f)
    ODESolver::Init(_f);
    k.SetSize(f->Width(), mem_type);
    y.SetSize(f->Width(), mem_type);
+   err.SetSize(f->Width(), mem_type);
 }
 
 void SDIRK33Solver::Step(Vector &x, double &t, double &dt)
@@ -472,26 +669,140 @@ void SDIRK33Solver::Step(Vector &x, double &t, double &dt)
    //   1  |   b   1-a-b  a
    // -----+----------------
    //      |   b   1-a-b  a
+   //      |  1-d    d    0    (embedded, order 2, d = (1/2-a)/(c-a))
    const double a = 0.435866521508458999416019;
    const double b = 1.20849664917601007033648;
    const double c = 0.717933260754229499708010;
+   const double d = (0.5-a)/(c-a);
 
    f->SetTime(t + a*dt);
    f->ImplicitSolve(a*dt, x, k);
    add(x, (c-a)*dt, k, y);
    x.Add(b*dt, k);
+   err.Set((b-1.+d)*dt, k);
 
    f->SetTime(t + c*dt);
    f->ImplicitSolve(a*dt, y, k);
    x.Add((1.-a-b)*dt, k);
+   err.Add((1.-a-b-d)*dt, k);
 
    f->SetTime(t + dt);
    f->ImplicitSolve(a*dt, x, k);
    x.Add(a*dt, k);
+   err.Add(a*dt, k);
    t += dt;
 }
 
 
+AdaptiveODESolver::AdaptiveODESolver(ODESolver &_solver)
+   : solver(_solver), rel_tol(1e-4), abs_tol(1e-6), safety(0.9),
+     min_factor(0.2), max_factor(5.0), k_I(0.7), k_P(0.4)
+{
+   dt_last = 0.0;
+#ifdef MFEM_USE_MPI
+   comm = MPI_COMM_NULL;
+#endif
+}
+
+#ifdef MFEM_USE_MPI
+AdaptiveODESolver::AdaptiveODESolver(MPI_Comm _comm, ODESolver &_solver)
+   : AdaptiveODESolver(_solver)
+{
+   comm = _comm;
+}
+#endif
+
+void AdaptiveODESolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   solver.Init(_f);
+   MFEM_VERIFY(solver.GetErrorEstimateOrder() > 0,
+               "the ODE solver does not provide an error estimate");
+   x_old.SetSize(f->Width(), mem_type);
+   err_old = 1.0;
+   rejected = false;
+   num_steps = num_rejected = 0;
+}
+
+double AdaptiveODESolver::ErrorNorm(const Vector &err, const Vector &x0,
+                                    const Vector &x1) const
+{
+   const int n = err.Size();
+   const double *e = err.HostRead(), *y0 = x0.HostRead(), *y1 = x1.HostRead();
+   double sums[2] = { 0.0, double(n) };
+   for (int i = 0; i < n; i++)
+   {
+      const double w = abs_tol + rel_tol*std::max(fabs(y0[i]), fabs(y1[i]));
+      sums[0] += (e[i]/w)*(e[i]/w);
+   }
+#ifdef MFEM_USE_MPI
+   if (comm != MPI_COMM_NULL)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, sums, 2, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+   return (sums[1] > 0.0) ? sqrt(sums[0]/sums[1]) : 0.0;
+}
+
+void AdaptiveODESolver::Step(Vector &x, double &t, double &dt)
+{
+   const double p = solver.GetErrorEstimateOrder() + 1;
+   double h = dt;
+   x_old = x;
+   while (true)
+   {
+      double t1 = t, h1 = h;
+      solver.Step(x, t1, h1);
+      const double err = ErrorNorm(*solver.GetErrorEstimate(), x_old, x);
+      if (err <= 1.0)
+      {
+         double factor = safety*pow(std::max(err, 1e-10), -k_I/p)*
+                         pow(err_old, k_P/p);
+         factor = std::min(std::max(factor, min_factor),
+                           rejected ? 1.0 : max_factor);
+         err_old = std::max(err, 1e-4);
+         rejected = false;
+         num_steps++;
+         t = t1;
+         dt_last = h;
+         dt = h*factor;
+         return;
+      }
+
+      // Reject the step, also if the error is not finite
+      num_rejected++;
+      rejected = true;
+      x = x_old;
+      solver.RepeatStep();
+      h *= IsFinite(err) ? std::max(safety*pow(err, -1.0/p), min_factor) :
+           min_factor;
+      MFEM_VERIFY(t + h > t, "step size underflow at t = " << t);
+   }
+}
+
+void AdaptiveODESolver::Run(Vector &x, double &t, double &dt, double tf)
+{
+   while (t < tf)
+   {
+      const double h_try = std::min(dt, tf - t);
+      const bool last = (h_try == tf - t);
+      double h = h_try;
+      Step(x, t, h);
+      if (last && dt_last == h_try)
+      {
+         // Avoid a tiny extra step due to round-off; the proposed step size
+         // is not limited by the clipped last step.
+         t = tf;
+         dt = std::max(dt, h);
+      }
+      else
+      {
+         dt = h;
+      }
+   }
+}
+
+
 void GeneralizedAlphaSolver::Init(TimeDependentOperator &_f)
 {
    ODESolver::Init(_f);
@@ -15,6 +15,10 @@
 #include "../config/config.hpp"
 #include "operator.hpp"
 
+#ifdef MFEM_USE_MPI
+#include <mpi.h>
+#endif
+
 namespace mfem
 {
 
@@ -91,6 +95,25 @@ public:
       while (t < tf) { Step(x, t, dt); }
    }
 
+   /** @brief Return an estimate of the local error of the last Step(), or NULL
+       if the method does not provide one. */
+   /** The estimate is the difference between the new solution and the
+       solution of an embedded method of order GetErrorEstimateOrder(), see
+       AdaptiveODESolver. */
+   virtual const Vector *GetErrorEstimate() const { return NULL; }
+
+   /** @brief Return the order q of the embedded method used by
+       GetErrorEstimate(), whose estimate is O(dt^(q+1)), or 0 if there is no
+       error estimate. */
+   virtual int GetErrorEstimateOrder() const { return 0; }
+
+   /** @brief Announce that the next call to Step() repeats the last step from
+       the same input @a x and @a t, e.g. with a smaller step size after a
+       rejection by AdaptiveODESolver. */
+   /** Solvers may then reuse data computed at the start of the last step. The
+       default implementation does nothing. */
+   virtual void RepeatStep() { }
+
    virtual ~ODESolver() { }
 };
 
@@ -165,7 +188,7 @@ public:
     +--------+----------------------+ */
 class ExplicitRKSolver : public ODESolver
 {
-private:
+protected:
    int s;
    const double *a, *b, *c;
    Vector y, *k;
@@ -206,6 +229,119 @@ public:
 };
 
 
+/** An explicit Runge-Kutta method with an embedded method of lower order that
+    provides an estimate of the local error, for use with AdaptiveODESolver.
+    The tableau is that of ExplicitRKSolver with the additional weights bh[] of
+    the embedded method. If the last stage is evaluated at the new solution
+    (First Same As Last, FSAL), it is reused as the first stage of the next
+    step. This assumes that the next step starts from the unmodified output
+    of the last one, as required by ODESolver::Step(); call Init() before
+    continuing from a different solution. The first stage is also reused when
+    the last step is repeated after a call to RepeatStep(). */
+class EmbeddedRKSolver : public ExplicitRKSolver
+{
+protected:
+   const double *bh;
+   int q;
+   bool fsal;
+   Vector err;
+   /// Times of the function values stored in k[0] and k[s-1], if valid.
+   double t_first, t_last;
+   bool first_valid, last_valid;
+   /// Set by RepeatStep(): the next step may reuse the stored k[0].
+   bool repeat;
+
+public:
+   /** Create the pair with weights @a _b (higher order) and @a _bh (embedded
+       method of order @a _q). */
+   EmbeddedRKSolver(int _s, const double *_a, const double *_b,
+                    const double *_bh, const double *_c, int _q);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   virtual const Vector *GetErrorEstimate() const { return &err; }
+
+   virtual int GetErrorEstimateOrder() const { return q; }
+
+   virtual void RepeatStep() { repeat = true; }
+};
+
+
+/** The 4-stage, 3rd order Bogacki-Shampine method with an embedded 2nd order
+    error estimate, RK3(2). FSAL, so it uses 3 function evaluations per step. */
+class BogackiShampineSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[6], b[4], bh[4], c[3];
+
+public:
+   BogackiShampineSolver() : EmbeddedRKSolver(4, a, b, bh, c, 2) { }
+};
+
+
+/** The 7-stage, 5th order Dormand-Prince method with an embedded 4th order
+    error estimate, RK5(4). FSAL, so it uses 6 function evaluations per step. */
+class DormandPrinceSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[21], b[7], bh[7], c[6];
+
+public:
+   DormandPrinceSolver() : EmbeddedRKSolver(7, a, b, bh, c, 4) { }
+};
+
+
+/** An explicit low-storage Runge-Kutta method in the 2N form of Williamson:
+    for i = 0,...,s-1
+
+        dx = A[i] dx + dt f(t + c[i] dt, x),
+         x = x + B[i] dx,
+
+    with A[0] = 0. Independently of the number of stages, the method stores
+    only the increment dx and the function value besides the solution, which
+    makes high-order methods with many stages affordable for large systems. */
+class LowStorageRKSolver : public ODESolver
+{
+protected:
+   int s;
+   const double *A, *B, *c;
+   Vector dx, k;
+
+public:
+   LowStorageRKSolver(int _s, const double *_A, const double *_B,
+                      const double *_c);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+};
+
+
+/// The 3-stage, 3rd order low-storage method of Williamson.
+class WilliamsonRK3Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[3], B[3], c[3];
+
+public:
+   WilliamsonRK3Solver() : LowStorageRKSolver(3, A, B, c) { }
+};
+
+
+/** The 5-stage, 4th order low-storage method of Carpenter and Kennedy, with a
+    larger stability region than RK4 per function evaluation. */
+class CarpenterKennedyRK4Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[5], B[5], c[5];
+
+public:
+   CarpenterKennedyRK4Solver() : LowStorageRKSolver(5, A, B, c) { }
+};
+
+
 /// Backward Euler ODE solver. L-stable.
 class BackwardEulerSolver : public ODESolver
 {
@@ -242,7 +378,7 @@ class SDIRK23Solver : public ODESolver
 {
 protected:
    double gamma;
-   Vector k, y;
+   Vector k, y, err;
 
 public:
    SDIRK23Solver(int gamma_opt = 1);
@@ -250,6 +386,11 @@ public:
    virtual void Init(TimeDependentOperator &_f);
 
    virtual void Step(Vector &x, double &t, double &dt);
+
+   /// Error estimate from the embedded 1st order method.
+   virtual const Vector *GetErrorEstimate() const { return &err; }
+
+   virtual int GetErrorEstimateOrder() const { return 1; }
 };
 
 
@@ -258,12 +399,17 @@ public:
 class SDIRK34Solver : public ODESolver
 {
 protected:
-   Vector k, y, z;
+   Vector k, y, z, err;
 
 public:
    virtual void Init(TimeDependentOperator &_f);
 
    virtual void Step(Vector &x, double &t, double &dt);
+
+   /// Error estimate from the embedded 2nd order method.
+   virtual const Vector *GetErrorEstimate() const { return &err; }
+
+   virtual int GetErrorEstimateOrder() const { return 2; }
 };
 
 
@@ -272,12 +418,99 @@ public:
 class SDIRK33Solver : public ODESolver
 {
 protected:
-   Vector k, y;
+   Vector k, y, err;
+
+public:
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   /// Error estimate from the embedded 2nd order method.
+   virtual const Vector *GetErrorEstimate() const { return &err; }
+
+   virtual int GetErrorEstimateOrder() const { return 2; }
+};
+
+
+/** @brief Adaptive time stepping with any ODESolver that provides an estimate
+    of the local error, e.g. EmbeddedRKSolver or the SDIRK solvers. */
+/** A step is accepted if the weighted RMS norm of the error estimate,
+    ||e_i / (abs_tol + rel_tol max(|x_i|, |x_new_i|))||, is at most 1;
+    otherwise it is repeated with a smaller step size. The next step size is
+    given by the PI controller
+
+        dt_new = dt safety err^(-k_I/(q+1)) err_old^(k_P/(q+1)),
+
+    where q is the order of the error estimate and err_old is the error of the
+    previous accepted step, with the factor dt_new/dt limited to the given
+    bounds. With k_P = 0 this is the elementary controller.
+
+    Unlike the general rule of ODESolver::Step(), the output @a dt of Step() is
+    the step size proposed for the next step, so repeated calls to Step() with
+    the same @a dt variable follow the controller; the step actually taken is
+    returned by GetLastStepSize(). Run() clips the last step to end exactly at
+    the final time. */
+class AdaptiveODESolver : public ODESolver
+{
+protected:
+   ODESolver &solver;
+   double rel_tol, abs_tol;
+   double safety, min_factor, max_factor, k_I, k_P;
+   double err_old, dt_last;
+   bool rejected;
+   int num_steps, num_rejected;
+   Vector x_old;
+#ifdef MFEM_USE_MPI
+   MPI_Comm comm;
+#endif
+
+   /// Weighted RMS norm of the error estimate @a err.
+   double ErrorNorm(const Vector &err, const Vector &x0,
+                    const Vector &x1) const;
 
 public:
+   /// Use the (not owned) @a _solver with adaptive step size control.
+   AdaptiveODESolver(ODESolver &_solver);
+
+#ifdef MFEM_USE_MPI
+   /// Same as above, with the error norm reduced over @a _comm.
+   AdaptiveODESolver(MPI_Comm _comm, ODESolver &_solver);
+#endif
+
+   /// Set the relative and absolute tolerances (defaults: 1e-4 and 1e-6).
+   void SetTolerances(double rtol, double atol)
+   { rel_tol = rtol; abs_tol = atol; }
+
+   /// Set the safety factor of the controller (default: 0.9).
+   void SetSafetyFactor(double s) { safety = s; }
+
+   /** Set the bounds of the factor dt_new/dt (defaults: 0.2 and 5). After a
+       rejection the step size is not increased in the next step. */
+   void SetStepFactorBounds(double fmin, double fmax)
+   { min_factor = fmin; max_factor = fmax; }
+
+   /// Set the gains of the PI controller (defaults: 0.7 and 0.4).
+   void SetPIGains(double kI, double kP) { k_I = kI; k_P = kP; }
+
    virtual void Init(TimeDependentOperator &_f);
 
+   /** @brief Perform one accepted step, starting with the step size @a dt,
+       which on output is the step size proposed for the next step. */
    virtual void Step(Vector &x, double &t, double &dt);
+
+   /** @brief Integrate to the final time @a tf, taking the steps proposed by
+       the controller; on output @a dt is the step size proposed for a next
+       step. */
+   virtual void Run(Vector &x, double &t, double &dt, double tf);
+
+   /// Return the size of the last accepted step.
+   double GetLastStepSize() const { return dt_last; }
+
+   /// Return the number of accepted steps since Init().
+   int GetNumSteps() const { return num_steps; }
+
+   /// Return the number of rejected steps since Init().
+   int GetNumRejectedSteps() const { return num_rejected; }
 };
 
 
@@ -20,6 +20,16 @@
 namespace mfem
 {
 
+void Operator::ArrayMult(const Array<const Vector *> &X,
+                         Array<Vector *> &Y) const
+{
+   MFEM_ASSERT(X.Size() == Y.Size(), "incompatible batch sizes");
+   for (int i = 0; i < X.Size(); i++)
+   {
+      Mult(*X[i], *Y[i]);
+   }
+}
+
 void Operator::FormLinearSystem(const Array<int> &ess_tdof_list,
                                 Vector &x, Vector &b,
                                 Operator* &Aout, Vector &X, Vector &B,
@@ -266,4 +276,77 @@ void ConstrainedOperator::Mult(const Vector &x, Vector &y) const
    });
 }
 
+void ConstrainedOperator::MultTranspose(const Vector &x, Vector &y) const
+{
+   const int csz = constraint_list.Size();
+   if (csz == 0)
+   {
+      A->MultTranspose(x, y);
+      return;
+   }
+
+   z = x;
+
+   auto idx = constraint_list.Read();
+   auto d_z = z.ReadWrite();
+   MFEM_FORALL(i, csz, d_z[idx[i]] = 0.0;);
+
+   A->MultTranspose(z, y);
+
+   auto d_x = x.Read();
+   auto d_y = y.ReadWrite();
+   MFEM_FORALL(i, csz,
+   {
+      const int id = idx[i];
+      d_y[id] = d_x[id];
+   });
+}
+
+void ConstrainedOperator::ArrayMult(const Array<const Vector *> &X,
+                                    Array<Vector *> &Y) const
+{
+   const int csz = constraint_list.Size();
+   if (csz == 0)
+   {
+      A->ArrayMult(X, Y);
+      return;
+   }
+
+   // The work vectors are kept between calls and added as needed
+   const int nv = X.Size();
+   for (int v = zb.Size(); v < nv; v++)
+   {
+      zb.Append(new Vector(width, GetMemoryType(mem_class)));
+      zb[v]->UseDevice(true);
+   }
+   Array<const Vector *> cZ(nv);
+   auto idx = constraint_list.Read();
+   for (int v = 0; v < nv; v++)
+   {
+      *zb[v] = *X[v];
+      auto d_z = zb[v]->ReadWrite();
+      MFEM_FORALL(i, csz, d_z[idx[i]] = 0.0;);
+      cZ[v] = zb[v];
+   }
+
+   A->ArrayMult(cZ, Y);
+
+   for (int v = 0; v < nv; v++)
+   {
+      auto d_x = X[v]->Read();
+      auto d_y = Y[v]->ReadWrite();
+      MFEM_FORALL(i, csz,
+      {
+         const int id = idx[i];
+         d_y[id] = d_x[id];
+      });
+   }
+}
+
+ConstrainedOperator::~ConstrainedOperator()
+{
+   for (int v = 0; v < zb.Size(); v++) { delete zb[v]; }
+   if (own_A) { delete A; }
+}
+
 }
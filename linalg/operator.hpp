@@ -69,6 +69,14 @@ public:
    virtual void MultTranspose(const Vector &x, Vector &y) const
    { mfem_error("Operator::MultTranspose() is not overloaded!"); }
 
+   /// Operator application on a batch of vectors: `*Y[i]=A(*X[i])`.
+   /** Derived classes can override this method to apply the operator to all
+       vectors in a single pass over their data, e.g. the nonzeros of a matrix,
+       which reduces the memory traffic when solving with multiple right-hand
+       sides. The default implementation calls Mult() for each vector. */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
    /** @brief Evaluate the gradient operator at the point @a x. The default
        behavior in class Operator is to generate an error. */
    virtual Operator &GetGradient(const Vector &x) const
@@ -455,6 +463,7 @@ protected:
    Operator *A;                 ///< The unconstrained Operator.
    bool own_A;                  ///< Ownership flag for A.
    mutable Vector z, w;         ///< Auxiliary vectors.
+   mutable Array<Vector *> zb;  ///< Auxiliary vectors of ArrayMult().
    MemoryClass mem_class;
 
 public:
@@ -490,8 +499,17 @@ public:
        the vectors, and "_i" -- the rest of the entries. */
    virtual void Mult(const Vector &x, Vector &y) const;
 
+   /** @brief Transpose of the constrained operator action, using
+       MultTranspose() of the unconstrained Operator. */
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /** @brief Constrained operator action on a batch of vectors, using
+       ArrayMult() of the unconstrained Operator. */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
    /// Destructor: destroys the unconstrained Operator, if owned.
-   virtual ~ConstrainedOperator() { if (own_A) { delete A; } }
+   virtual ~ConstrainedOperator();
 };
 
 }
@@ -0,0 +1,228 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "sellmat.hpp"
+#include "../general/forall.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+SellCSigmaMatrix::SellCSigmaMatrix(const SparseMatrix &mat, int chunk_size,
+                                   int window)
+   : Operator(mat.Height(), mat.Width()), C(chunk_size), sigma(window)
+{
+   MFEM_VERIFY(mat.Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(C > 0 && sigma > 0, "invalid chunk size " << C
+               << " or sorting window " << sigma);
+
+   const int *mI = mfem::Read(mat.GetMemoryI(), height+1, false);
+   nnz = mI[height];
+   const int *mJ = mfem::Read(mat.GetMemoryJ(), nnz, false);
+   const double *mA = mfem::Read(mat.GetMemoryData(), nnz, false);
+
+   // Sort the rows by decreasing length within each window.
+   nchunks = (height + C - 1) / C;
+   perm.SetSize(nchunks*C);
+   for (int i = 0; i < perm.Size(); i++) { perm[i] = (i < height) ? i : -1; }
+   int *p = perm.GetData();
+   for (int w0 = 0; w0 < height; w0 += sigma)
+   {
+      const int w1 = std::min(w0 + sigma, height);
+      std::stable_sort(p + w0, p + w1, [mI](int r1, int r2)
+      { return mI[r1+1] - mI[r1] > mI[r2+1] - mI[r2]; });
+   }
+
+   // Chunk lengths and offsets
+   chunk_ptr.SetSize(nchunks+1);
+   chunk_ptr[0] = 0;
+   for (int k = 0; k < nchunks; k++)
+   {
+      int len = 0;
+      for (int r = 0; r < C; r++)
+      {
+         const int row = perm[k*C + r];
+         if (row >= 0) { len = std::max(len, mI[row+1] - mI[row]); }
+      }
+      chunk_ptr[k+1] = chunk_ptr[k] + C*len;
+   }
+
+   // Fill the chunks. The padding entries repeat the last column index of
+   // their row, so they do not touch new entries of the input vector.
+   col.SetSize(chunk_ptr[nchunks]);
+   val.SetSize(chunk_ptr[nchunks]);
+   double *h_val = val.HostWrite();
+   for (int k = 0; k < nchunks; k++)
+   {
+      const int len = (chunk_ptr[k+1] - chunk_ptr[k]) / C;
+      for (int r = 0; r < C; r++)
+      {
+         const int row = perm[k*C + r];
+         const int j0 = (row >= 0) ? mI[row] : 0;
+         const int rlen = (row >= 0) ? mI[row+1] - j0 : 0;
+         for (int l = 0; l < len; l++)
+         {
+            const int idx = chunk_ptr[k] + l*C + r;
+            if (l < rlen)
+            {
+               col[idx] = mJ[j0 + l];
+               h_val[idx] = mA[j0 + l];
+            }
+            else
+            {
+               col[idx] = (rlen > 0) ? mJ[j0 + rlen - 1] : 0;
+               h_val[idx] = 0.0;
+            }
+         }
+      }
+   }
+}
+
+// y += a * A * x using one thread per chunk, with the chunk height known at
+// compile time. The inner loop over the C rows of a chunk has unit stride.
+template <int T_C>
+static void SellAddMultChunk(const int nchunks, const Array<int> &perm,
+                             const Array<int> &chunk_ptr,
+                             const Array<int> &col, const Vector &val,
+                             const Vector &x, Vector &y, const double a)
+{
+   constexpr int C = T_C;
+   auto d_perm = perm.Read();
+   auto d_ptr = chunk_ptr.Read();
+   auto d_col = col.Read();
+   auto d_val = val.Read();
+   auto d_x = x.Read();
+   auto d_y = y.ReadWrite();
+   MFEM_FORALL(k, nchunks,
+   {
+      double s[C];
+      for (int r = 0; r < C; r++) { s[r] = 0.0; }
+      const int end = d_ptr[k+1];
+      for (int j = d_ptr[k]; j < end; j += C)
+      {
+         for (int r = 0; r < C; r++)
+         {
+            s[r] += d_val[j + r] * d_x[d_col[j + r]];
+         }
+      }
+      for (int r = 0; r < C; r++)
+      {
+         const int row = d_perm[k*C + r];
+         if (row >= 0) { d_y[row] += a * s[r]; }
+      }
+   });
+}
+
+// y += a * A * x using one thread per (sorted) row. On devices, consecutive
+// threads read consecutive entries.
+static void SellAddMultRow(const int nchunks, const int C,
+                           const Array<int> &perm,
+                           const Array<int> &chunk_ptr,
+                           const Array<int> &col, const Vector &val,
+                           const Vector &x, Vector &y, const double a)
+{
+   auto d_perm = perm.Read();
+   auto d_ptr = chunk_ptr.Read();
+   auto d_col = col.Read();
+   auto d_val = val.Read();
+   auto d_x = x.Read();
+   auto d_y = y.ReadWrite();
+   MFEM_FORALL(i, nchunks*C,
+   {
+      const int row = d_perm[i];
+      if (row >= 0)
+      {
+         const int k = i / C;
+         const int end = d_ptr[k+1];
+         double s = 0.0;
+         for (int j = d_ptr[k] + i % C; j < end; j += C)
+         {
+            s += d_val[j] * d_x[d_col[j]];
+         }
+         d_y[row] += a * s;
+      }
+   });
+}
+
+void SellCSigmaMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y.UseDevice(true);
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void SellCSigmaMatrix::AddMult(const Vector &x, Vector &y,
+                               const double a) const
+{
+   MFEM_ASSERT(width == x.Size(), "Input vector size (" << x.Size()
+               << ") must match matrix width (" << width << ")");
+   MFEM_ASSERT(height == y.Size(), "Output vector size (" << y.Size()
+               << ") must match matrix height (" << height << ")");
+
+   if (!Device::Allows(Backend::DEVICE_MASK))
+   {
+      switch (C)
+      {
+         case 4:
+            return SellAddMultChunk<4>(nchunks, perm, chunk_ptr, col, val,
+                                       x, y, a);
+         case 8:
+            return SellAddMultChunk<8>(nchunks, perm, chunk_ptr, col, val,
+                                       x, y, a);
+         case 16:
+            return SellAddMultChunk<16>(nchunks, perm, chunk_ptr, col, val,
+                                        x, y, a);
+         case 32:
+            return SellAddMultChunk<32>(nchunks, perm, chunk_ptr, col, val,
+                                        x, y, a);
+      }
+   }
+   SellAddMultRow(nchunks, C, perm, chunk_ptr, col, val, x, y, a);
+}
+
+void SellCSigmaMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMultTranspose(x, y);
+}
+
+void SellCSigmaMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                        const double a) const
+{
+   MFEM_ASSERT(height == x.Size(), "Input vector size (" << x.Size()
+               << ") must match matrix height (" << height << ")");
+   MFEM_ASSERT(width == y.Size(), "Output vector size (" << y.Size()
+               << ") must match matrix width (" << width << ")");
+
+   // The scatter to the columns is done on the host.
+   const int *h_perm = perm.HostRead();
+   const int *h_ptr = chunk_ptr.HostRead();
+   const int *h_col = col.HostRead();
+   const double *h_val = val.HostRead();
+   const double *h_x = x.HostRead();
+   double *h_y = y.HostReadWrite();
+   for (int k = 0; k < nchunks; k++)
+   {
+      for (int r = 0; r < C; r++)
+      {
+         const int row = h_perm[k*C + r];
+         if (row < 0) { continue; }
+         const double axr = a * h_x[row];
+         for (int j = h_ptr[k] + r; j < h_ptr[k+1]; j += C)
+         {
+            h_y[h_col[j]] += h_val[j] * axr;
+         }
+      }
+   }
+}
+
+}
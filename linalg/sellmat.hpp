@@ -0,0 +1,97 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SELLMAT
+#define MFEM_SELLMAT
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix in the SELL-C-sigma (sliced ELLPACK) format.
+
+    The rows of a finalized SparseMatrix are sorted by decreasing length within
+    windows of #sigma consecutive rows and the sorted rows are grouped in chunks
+    of #C rows. Each chunk is stored as a dense C x L array in column-major
+    order, where L is the length of its longest row; shorter rows are padded
+    with zeros. The entries of the C rows in a chunk are then contiguous, so the
+    action can use wide vector loads (on the host) or coalesced loads (on the
+    device). A larger #sigma reduces the padding but makes the access to the
+    output vector less local. */
+class SellCSigmaMatrix : public Operator
+{
+protected:
+   /// Chunk height.
+   int C;
+   /// Size of the sorting window.
+   int sigma;
+   /// Number of chunks.
+   int nchunks;
+   /** @brief Original row of each sorted row, or -1 for the padding rows of the
+       last chunk, size #nchunks * #C. */
+   Array<int> perm;
+   /// Offsets of the chunks in #col and #val, size #nchunks+1.
+   Array<int> chunk_ptr;
+   /// Column indices, size chunk_ptr[#nchunks].
+   Array<int> col;
+   /// Matrix entries, size chunk_ptr[#nchunks].
+   Vector val;
+   /// Number of entries of the original SparseMatrix.
+   int nnz;
+
+public:
+   /** @brief Create the SELL-C-sigma copy of the finalized SparseMatrix
+       @a mat with chunk height @a chunk_size and sorting window @a window.
+
+       With @a window = 1 the rows are not sorted (SELL-C); with @a window
+       equal to the height of @a mat all rows are sorted globally. */
+   SellCSigmaMatrix(const SparseMatrix &mat, int chunk_size = 8,
+                    int window = 256);
+
+   /// Return the chunk height C.
+   int GetChunkSize() const { return C; }
+
+   /// Return the size of the sorting window sigma.
+   int GetSortingWindow() const { return sigma; }
+
+   /// Return the number of entries of the original SparseMatrix.
+   int NumNonZeroElems() const { return nnz; }
+
+   /// Return the number of stored entries, including the padding.
+   int NumStoredEntries() const { return val.Size(); }
+
+   /// Original row of each sorted row, see #perm.
+   const Array<int> &GetRowPermutation() const { return perm; }
+
+   virtual MemoryClass GetMemoryClass() const
+   { return Device::GetMemoryClass(); }
+
+   /// y = A * x
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a * A * x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// y = A^t * x
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a * A^t * x
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double a = 1.0) const;
+};
+
+}
+
+#endif
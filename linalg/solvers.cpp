@@ -10,6 +10,7 @@
 // Software Foundation) version 2.1 dated February 1999.
 
 #include "linalg.hpp"
+#include "../general/forall.hpp"
 #include "../general/globals.hpp"
 #include <iostream>
 #include <iomanip>
@@ -64,6 +65,27 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::ReduceSums(double *v, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, v, n, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+}
+
+void IterativeSolver::Dots(const Array<Vector *> &x,
+                           const Array<Vector *> &y, double *dots) const
+{
+   MFEM_ASSERT(x.Size() == y.Size(), "incompatible arrays");
+   for (int i = 0; i < x.Size(); i++)
+   {
+      dots[i] = (*x[i]) * (*y[i]);
+   }
+   ReduceSums(dots, x.Size());
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -280,6 +302,55 @@ void SLI(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
+// Select the vectors vecs[list[i]], e.g. those of the unconverged systems in
+// the multiple right-hand side solvers.
+template <typename V>
+static void SelectVectors(const Array<int> &list, const Array<V *> &vecs,
+                          Array<const Vector *> &sel)
+{
+   sel.SetSize(list.Size());
+   for (int i = 0; i < list.Size(); i++) { sel[i] = vecs[list[i]]; }
+}
+
+static void SelectVectors(const Array<int> &list, const Array<Vector *> &vecs,
+                          Array<Vector *> &sel)
+{
+   sel.SetSize(list.Size());
+   for (int i = 0; i < list.Size(); i++) { sel[i] = vecs[list[i]]; }
+}
+
+// Print the summary of a solve with multiple right-hand sides.
+static void PrintArraySummary(const char *name, int print_level, int nv,
+                              int num_converged, int final_iter)
+{
+   if (print_level == 2 || (print_level >= 1 && num_converged == nv))
+   {
+      mfem::out << name << ": Number of iterations: " << final_iter
+                << " (maximum over " << nv << " systems)\n";
+   }
+   if (print_level >= 0 && num_converged < nv)
+   {
+      mfem::out << name << ": No convergence for " << nv - num_converged
+                << " of " << nv << " systems!\n";
+   }
+}
+
+// Fused CG update: x = x + alpha d, r = r - alpha z.
+static void CGUpdate(const double alpha, const Vector &d, const Vector &z,
+                     Vector &x, Vector &r)
+{
+   const int N = x.Size();
+   auto d_d = d.Read();
+   auto d_z = z.Read();
+   auto d_x = x.ReadWrite();
+   auto d_r = r.ReadWrite();
+   MFEM_FORALL(i, N,
+   {
+      d_x[i] += alpha * d_d[i];
+      d_r[i] -= alpha * d_z[i];
+   });
+}
+
 void CGSolver::UpdateVectors()
 {
    r.SetSize(width);
@@ -355,8 +426,7 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    for (i = 1; true; )
    {
       alpha = nom/den;
-      add(x,  alpha, d, x);     //  x = x + alpha d
-      add(r, -alpha, z, r);     //  r = r - alpha A d
+      CGUpdate(alpha, d, z, x, r); // x = x + alpha d, r = r - alpha A d
 
       if (prec)
       {
@@ -445,6 +515,446 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    final_norm = sqrt(betanom);
 }
 
+// Host loops of the fused kernels below can also compute the local parts of
+// inner products in the same pass; the device kernels cannot.
+static inline bool FusedHostReductions()
+{
+   return !Device::Allows(Backend::DEVICE_MASK);
+}
+
+// Local parts of the inner products dots[0] = (x1, y1) and dots[1] = (x2, y2).
+static void LocalDots(const Vector &x1, const Vector &y1,
+                      const Vector &x2, const Vector &y2, double *dots)
+{
+   if (!FusedHostReductions())
+   {
+      dots[0] = x1 * y1;
+      dots[1] = x2 * y2;
+      return;
+   }
+   const int N = x1.Size();
+   const double *h_x1 = x1.HostRead(), *h_y1 = y1.HostRead();
+   const double *h_x2 = x2.HostRead(), *h_y2 = y2.HostRead();
+   double dot1 = 0.0, dot2 = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:dot1,dot2) \
+   if (Device::Allows(Backend::OMP_MASK))
+#endif
+   for (int i = 0; i < N; i++)
+   {
+      dot1 += h_x1[i] * h_y1[i];
+      dot2 += h_x2[i] * h_y2[i];
+   }
+   dots[0] = dot1;
+   dots[1] = dot2;
+}
+
+// All vector updates of one pipelined PCG iteration:
+//    z = n + beta z,  q = m + beta q,  s = w + beta s,  p = u + beta p,
+//    x = x + alpha p, r = r - alpha s, u = u - alpha q, w = w - alpha z,
+// followed by the local parts of dots = { (r, u), (w, u) }. Without
+// preconditioner, u = r, m = w and q = s, so these vectors are not used.
+static void PipelinedCGUpdate(const bool prec, const double alpha,
+                              const double beta, const Vector &n,
+                              const Vector &m, Vector &z, Vector &q,
+                              Vector &s, Vector &p, Vector &x, Vector &r,
+                              Vector &u, Vector &w, double *dots)
+{
+   const int N = x.Size();
+   if (FusedHostReductions())
+   {
+      const double *h_n = n.HostRead(), *h_m = m.HostRead();
+      double *h_z = z.HostReadWrite(), *h_q = q.HostReadWrite();
+      double *h_s = s.HostReadWrite(), *h_p = p.HostReadWrite();
+      double *h_x = x.HostReadWrite(), *h_r = r.HostReadWrite();
+      double *h_u = u.HostReadWrite(), *h_w = w.HostReadWrite();
+      double dot1 = 0.0, dot2 = 0.0;
+      if (prec)
+      {
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel for reduction(+:dot1,dot2) \
+         if (Device::Allows(Backend::OMP_MASK))
+#endif
+         for (int i = 0; i < N; i++)
+         {
+            const double zi = h_n[i] + beta * h_z[i];
+            const double qi = h_m[i] + beta * h_q[i];
+            const double si = h_w[i] + beta * h_s[i];
+            const double pi = h_u[i] + beta * h_p[i];
+            h_z[i] = zi; h_q[i] = qi; h_s[i] = si; h_p[i] = pi;
+            h_x[i] += alpha * pi;
+            const double ri = h_r[i] - alpha * si;
+            const double ui = h_u[i] - alpha * qi;
+            const double wi = h_w[i] - alpha * zi;
+            h_r[i] = ri; h_u[i] = ui; h_w[i] = wi;
+            dot1 += ri * ui;
+            dot2 += wi * ui;
+         }
+      }
+      else
+      {
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel for reduction(+:dot1,dot2) \
+         if (Device::Allows(Backend::OMP_MASK))
+#endif
+         for (int i = 0; i < N; i++)
+         {
+            const double zi = h_n[i] + beta * h_z[i];
+            const double si = h_w[i] + beta * h_s[i];
+            const double pi = h_r[i] + beta * h_p[i];
+            h_z[i] = zi; h_s[i] = si; h_p[i] = pi;
+            h_x[i] += alpha * pi;
+            const double ri = h_r[i] - alpha * si;
+            const double wi = h_w[i] - alpha * zi;
+            h_r[i] = ri; h_w[i] = wi;
+            dot1 += ri * ri;
+            dot2 += wi * ri;
+         }
+      }
+      dots[0] = dot1;
+      dots[1] = dot2;
+      return;
+   }
+
+   auto d_n = n.Read();
+   auto d_z = z.ReadWrite();
+   auto d_s = s.ReadWrite();
+   auto d_p = p.ReadWrite();
+   auto d_x = x.ReadWrite();
+   auto d_r = r.ReadWrite();
+   auto d_w = w.ReadWrite();
+   if (prec)
+   {
+      auto d_m = m.Read();
+      auto d_q = q.ReadWrite();
+      auto d_u = u.ReadWrite();
+      MFEM_FORALL(i, N,
+      {
+         const double zi = d_n[i] + beta * d_z[i];
+         const double qi = d_m[i] + beta * d_q[i];
+         const double si = d_w[i] + beta * d_s[i];
+         const double pi = d_u[i] + beta * d_p[i];
+         d_z[i] = zi; d_q[i] = qi; d_s[i] = si; d_p[i] = pi;
+         d_x[i] += alpha * pi;
+         d_r[i] -= alpha * si;
+         d_u[i] -= alpha * qi;
+         d_w[i] -= alpha * zi;
+      });
+      LocalDots(r, u, w, u, dots);
+   }
+   else
+   {
+      MFEM_FORALL(i, N,
+      {
+         const double zi = d_n[i] + beta * d_z[i];
+         const double si = d_w[i] + beta * d_s[i];
+         const double pi = d_r[i] + beta * d_p[i];
+         d_z[i] = zi; d_s[i] = si; d_p[i] = pi;
+         d_x[i] += alpha * pi;
+         d_r[i] -= alpha * si;
+         d_w[i] -= alpha * zi;
+      });
+      LocalDots(r, r, w, r, dots);
+   }
+}
+
+void PipelinedCGSolver::UpdateVectors()
+{
+   Vector *vecs[] = { &r, &u, &w, &m, &n, &z, &q, &s, &p };
+   for (int i = 0; i < 9; i++)
+   {
+      vecs[i]->SetSize(width, Device::GetMemoryType());
+      vecs[i]->UseDevice(true);
+   }
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   double dots[2], r0 = 0.0, nom0 = 0.0, nom = 0.0, alpha = 0.0;
+   const bool have_prec = (prec != NULL);
+   // Without preconditioner, u = r and m = w
+   const Vector &U = have_prec ? u : r;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   if (have_prec) { prec->Mult(r, u); } // u = B r
+   oper->Mult(U, w);                     // w = A u
+   LocalDots(r, U, w, U, dots);
+   // The first update uses beta = 0, so z, q, s and p must not hold NaNs
+   z = 0.0;
+   s = 0.0;
+   p = 0.0;
+   if (have_prec) { q = 0.0; }
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      // Global reduction of gamma = (r, u) and delta = (w, u), overlapped with
+      // m = B w and n = A m.
+#if defined(MFEM_USE_MPI) && MPI_VERSION >= 3
+      MPI_Request request;
+      const bool overlap = (dot_prod_type != 0);
+      if (overlap)
+      {
+         MPI_Iallreduce(MPI_IN_PLACE, dots, 2, MPI_DOUBLE, MPI_SUM, comm,
+                        &request);
+      }
+#else
+      ReduceSums(dots, 2);
+#endif
+      if (have_prec)
+      {
+         prec->Mult(w, m);
+         oper->Mult(m, n);
+      }
+      else
+      {
+         oper->Mult(w, n);
+      }
+#if defined(MFEM_USE_MPI) && MPI_VERSION >= 3
+      if (overlap) { MPI_Wait(&request, MPI_STATUS_IGNORE); }
+#endif
+      const double gamma = dots[0], delta = dots[1];
+      MFEM_ASSERT(IsFinite(gamma) && IsFinite(delta),
+                  "gamma = " << gamma << ", delta = " << delta);
+
+      if (i == 0)
+      {
+         nom0 = nom = gamma;
+         if (print_level == 1 || print_level == 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom << (print_level == 3 ? " ...\n" : "\n");
+         }
+         r0 = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+         if (nom <= r0)
+         {
+            converged = 1;
+            final_iter = 0;
+            final_norm = sqrt(nom);
+            return;
+         }
+      }
+      else
+      {
+         if (print_level == 1)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << gamma << '\n';
+         }
+         if (gamma < r0)
+         {
+            if (print_level == 2)
+            {
+               mfem::out << "Number of PCG iterations: " << i << '\n';
+            }
+            else if (print_level == 3)
+            {
+               mfem::out << "   Iteration : " << setw(3) << i
+                         << "  (B r, r) = " << gamma << '\n';
+            }
+            converged = 1;
+            final_iter = i;
+            nom = gamma;
+            break;
+         }
+         if (i >= max_iter)
+         {
+            nom = gamma;
+            break;
+         }
+      }
+
+      // (A p, p) for the new search direction p = u + beta p
+      const double beta = (i == 0) ? 0.0 : gamma/nom;
+      const double den = (i == 0) ? delta : delta - beta*gamma/alpha;
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "PCG: The operator is not positive definite. (Ad, d) = "
+                      << den << '\n';
+         }
+         final_iter = i;
+         nom = gamma;
+         break;
+      }
+      alpha = gamma/den;
+      nom = gamma;
+      PipelinedCGUpdate(have_prec, alpha, beta, n, have_prec ? m : w,
+                        z, q, s, p, x, r, u, w, dots);
+   }
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter << "  (B r, r) = "
+                   << nom << '\n';
+      }
+      mfem::out << "PCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (nom/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(nom);
+}
+
+void CGSolver::ArrayMult(const Array<const Vector *> &B,
+                         Array<Vector *> &X) const
+{
+   const int nv = B.Size();
+   MFEM_ASSERT(X.Size() == nv, "incompatible batch sizes");
+   if (nv == 0) { return; }
+
+   Array<Vector *> R(nv), D(nv), Z(nv);
+   for (int l = 0; l < nv; l++)
+   {
+      R[l] = new Vector(width);
+      D[l] = new Vector(width);
+      Z[l] = new Vector(width);
+   }
+   Vector nom(nv), den(nv), betanom(nv), r0(nv), dots(nv);
+   Array<int> its(nv), conv(nv), all(nv), active, next;
+   its = 0;
+   conv = 0;
+   for (int l = 0; l < nv; l++) { all[l] = l; }
+   Array<const Vector *> in;
+   Array<Vector *> out, sel1;
+
+   if (iterative_mode)
+   {
+      SelectVectors(all, X, in);
+      oper->ArrayMult(in, R);
+      for (int l = 0; l < nv; l++) { subtract(*B[l], *R[l], *R[l]); }
+   }
+   else
+   {
+      for (int l = 0; l < nv; l++) { *R[l] = *B[l]; *X[l] = 0.0; }
+   }
+   if (prec)
+   {
+      SelectVectors(all, R, in);
+      prec->ArrayMult(in, Z);
+      for (int l = 0; l < nv; l++) { *D[l] = *Z[l]; }
+   }
+   else
+   {
+      for (int l = 0; l < nv; l++) { *D[l] = *R[l]; }
+   }
+   Dots(D, R, nom.GetData());
+   for (int l = 0; l < nv; l++)
+   {
+      MFEM_ASSERT(IsFinite(nom(l)), "nom = " << nom(l));
+      betanom(l) = nom(l);
+      r0(l) = std::max(nom(l)*rel_tol*rel_tol, abs_tol*abs_tol);
+      if (nom(l) <= r0(l)) { conv[l] = 1; }
+      else { active.Append(l); }
+   }
+
+   for (int i = 1; active.Size() > 0; )
+   {
+      // z = A d, den = (A d, d)
+      SelectVectors(active, D, in);
+      SelectVectors(active, Z, out);
+      oper->ArrayMult(in, out);
+      SelectVectors(active, D, sel1);
+      Dots(out, sel1, dots.GetData());
+      next.SetSize(0);
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int l = active[a];
+         den(l) = dots(a);
+         MFEM_ASSERT(IsFinite(den(l)), "den = " << den(l));
+         if (den(l) <= 0.0 && print_level >= 0)
+         {
+            mfem::out << "PCG: The operator is not positive definite. (Ad, d) = "
+                      << den(l) << '\n';
+         }
+         if (den(l) == 0.0) { its[l] = i-1; }
+         else { next.Append(l); }
+      }
+      Swap(active, next);
+
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int l = active[a];
+         CGUpdate(nom(l)/den(l), *D[l], *Z[l], *X[l], *R[l]);
+      }
+      SelectVectors(active, R, sel1);
+      if (prec)
+      {
+         SelectVectors(active, R, in);
+         SelectVectors(active, Z, out);
+         prec->ArrayMult(in, out);
+         Dots(sel1, out, dots.GetData());
+      }
+      else
+      {
+         Dots(sel1, sel1, dots.GetData());
+      }
+      next.SetSize(0);
+      double max_betanom = 0.0;
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int l = active[a];
+         betanom(l) = dots(a);
+         MFEM_ASSERT(IsFinite(betanom(l)), "betanom = " << betanom(l));
+         max_betanom = std::max(max_betanom, betanom(l));
+         its[l] = i;
+         if (betanom(l) < r0(l)) { conv[l] = 1; }
+         else { next.Append(l); }
+      }
+      Swap(active, next);
+      if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  max (B r, r) = "
+                   << max_betanom << "  unconverged systems: "
+                   << active.Size() << '\n';
+      }
+
+      if (++i > max_iter) { break; }
+
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int l = active[a];
+         const double beta = betanom(l)/nom(l);
+         add(prec ? *Z[l] : *R[l], beta, *D[l], *D[l]); // d = z + beta d
+         nom(l) = betanom(l);
+      }
+   }
+
+   int num_converged = 0;
+   final_iter = 0;
+   final_norm = 0.0;
+   for (int l = 0; l < nv; l++)
+   {
+      num_converged += conv[l];
+      final_iter = std::max(final_iter, its[l]);
+      final_norm = std::max(final_norm, sqrt(betanom(l)));
+      delete R[l];
+      delete D[l];
+      delete Z[l];
+   }
+   converged = (num_converged == nv);
+   PrintArraySummary("PCG", print_level, nv, num_converged, final_iter);
+}
+
 void CG(const Operator &A, const Vector &b, Vector &x,
         int print_iter, int max_num_iter,
         double RTOLERANCE, double ATOLERANCE)
@@ -703,6 +1213,223 @@ finish:
    }
 }
 
+void GMRESSolver::ArrayMult(const Array<const Vector *> &B,
+                            Array<Vector *> &X) const
+{
+   const int nv = B.Size();
+   MFEM_ASSERT(X.Size() == nv, "incompatible batch sizes");
+   if (nv == 0) { return; }
+   const int n = width;
+
+   // Hessenberg matrices, rotations, Krylov bases and work vectors of all
+   // systems
+   Array<DenseMatrix *> H(nv);
+   Array<Vector *> S(nv), CS(nv), SN(nv), R(nv), W(nv), T(nv);
+   Array<Array<Vector *> *> V(nv);
+   for (int l = 0; l < nv; l++)
+   {
+      H[l] = new DenseMatrix(m+1, m);
+      S[l] = new Vector(m+1);
+      CS[l] = new Vector(m+1);
+      SN[l] = new Vector(m+1);
+      R[l] = new Vector(n);
+      W[l] = new Vector(n);
+      T[l] = new Vector(n);
+      V[l] = new Array<Vector *>(m+1);
+      *V[l] = NULL;
+   }
+   Vector beta(nv), tol(nv), resid(nv), dots(nv);
+   Array<int> its(nv), conv(nv), all(nv), active, cycle, next;
+   its = 0;
+   conv = 0;
+   for (int l = 0; l < nv; l++) { all[l] = l; }
+   Array<const Vector *> in;
+   Array<Vector *> out, sel1, sel2;
+
+   // r = B (b - A x) and beta = ||r|| for the systems in the list
+   auto residuals = [&](const Array<int> &list, bool zero_x)
+   {
+      SelectVectors(list, T, out);
+      if (zero_x)
+      {
+         for (int a = 0; a < list.Size(); a++) { *T[list[a]] = *B[list[a]]; }
+      }
+      else
+      {
+         SelectVectors(list, X, in);
+         oper->ArrayMult(in, out);
+         for (int a = 0; a < list.Size(); a++)
+         {
+            const int l = list[a];
+            subtract(*B[l], *T[l], *T[l]);
+         }
+      }
+      SelectVectors(list, R, sel1);
+      if (prec)
+      {
+         SelectVectors(list, T, in);
+         prec->ArrayMult(in, sel1);
+      }
+      else
+      {
+         for (int a = 0; a < list.Size(); a++) { *R[list[a]] = *T[list[a]]; }
+      }
+      Dots(sel1, sel1, dots.GetData());
+      for (int a = 0; a < list.Size(); a++)
+      {
+         beta(list[a]) = sqrt(dots(a));
+         MFEM_ASSERT(IsFinite(beta(list[a])), "beta = " << beta(list[a]));
+      }
+   };
+
+   if (!iterative_mode)
+   {
+      for (int l = 0; l < nv; l++) { *X[l] = 0.0; }
+   }
+   residuals(all, !iterative_mode);
+   for (int l = 0; l < nv; l++)
+   {
+      tol(l) = std::max(rel_tol*beta(l), abs_tol);
+      resid(l) = beta(l);
+      if (beta(l) <= tol(l)) { conv[l] = 1; }
+      else { active.Append(l); }
+   }
+
+   for (int j = 1; active.Size() > 0 && j <= max_iter; )
+   {
+      for (int a = 0; a < active.Size(); a++)
+      {
+         const int l = active[a];
+         Array<Vector *> &v = *V[l];
+         if (v[0] == NULL) { v[0] = new Vector(n); }
+         v[0]->Set(1.0/beta(l), *R[l]);
+         *S[l] = 0.0;
+         (*S[l])(0) = beta(l);
+      }
+      cycle = active;
+
+      int i;
+      for (i = 0; i < m && j <= max_iter && cycle.Size() > 0; i++, j++)
+      {
+         // w = B A v[i]
+         in.SetSize(cycle.Size());
+         for (int a = 0; a < cycle.Size(); a++) { in[a] = (*V[cycle[a]])[i]; }
+         SelectVectors(cycle, W, sel1);
+         if (prec)
+         {
+            SelectVectors(cycle, T, out);
+            oper->ArrayMult(in, out);
+            SelectVectors(cycle, T, in);
+            prec->ArrayMult(in, sel1);
+         }
+         else
+         {
+            oper->ArrayMult(in, sel1);
+         }
+
+         // Modified Gram-Schmidt, with one reduction for all systems per step
+         sel2.SetSize(cycle.Size());
+         for (int k = 0; k <= i; k++)
+         {
+            for (int a = 0; a < cycle.Size(); a++)
+            {
+               sel2[a] = (*V[cycle[a]])[k];
+            }
+            Dots(sel1, sel2, dots.GetData());
+            for (int a = 0; a < cycle.Size(); a++)
+            {
+               const int l = cycle[a];
+               (*H[l])(k,i) = dots(a);
+               W[l]->Add(-dots(a), *sel2[a]);
+            }
+         }
+         Dots(sel1, sel1, dots.GetData());
+
+         next.SetSize(0);
+         for (int a = 0; a < cycle.Size(); a++)
+         {
+            const int l = cycle[a];
+            DenseMatrix &h = *H[l];
+            Vector &s = *S[l], &cs = *CS[l], &sn = *SN[l];
+            Array<Vector *> &v = *V[l];
+            h(i+1,i) = sqrt(dots(a));
+            MFEM_ASSERT(IsFinite(h(i+1,i)), "Norm(w) = " << h(i+1,i));
+            if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
+            v[i+1]->Set(1.0/h(i+1,i), *W[l]);
+
+            for (int k = 0; k < i; k++)
+            {
+               ApplyPlaneRotation(h(k,i), h(k+1,i), cs(k), sn(k));
+            }
+            GeneratePlaneRotation(h(i,i), h(i+1,i), cs(i), sn(i));
+            ApplyPlaneRotation(h(i,i), h(i+1,i), cs(i), sn(i));
+            ApplyPlaneRotation(s(i), s(i+1), cs(i), sn(i));
+
+            resid(l) = fabs(s(i+1));
+            MFEM_ASSERT(IsFinite(resid(l)), "resid = " << resid(l));
+            its[l] = j;
+            if (resid(l) <= tol(l))
+            {
+               Update(*X[l], i, h, s, v);
+               conv[l] = 1;
+            }
+            else
+            {
+               next.Append(l);
+            }
+         }
+         Swap(cycle, next);
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << (j-1)/m+1
+                      << "   Iteration : " << setw(3) << j
+                      << "  max ||B r|| = " << resid.Max()
+                      << "  unconverged systems: " << cycle.Size() << '\n';
+         }
+      }
+
+      // Restart the systems that did not converge in this cycle
+      for (int a = 0; a < cycle.Size(); a++)
+      {
+         const int l = cycle[a];
+         Update(*X[l], i-1, *H[l], *S[l], *V[l]);
+      }
+      if (cycle.Size() > 0)
+      {
+         residuals(cycle, false);
+      }
+      active.SetSize(0);
+      for (int a = 0; a < cycle.Size(); a++)
+      {
+         const int l = cycle[a];
+         resid(l) = beta(l);
+         if (beta(l) <= tol(l)) { conv[l] = 1; }
+         else { active.Append(l); }
+      }
+   }
+
+   int num_converged = 0;
+   final_iter = 0;
+   final_norm = 0.0;
+   for (int l = 0; l < nv; l++)
+   {
+      num_converged += conv[l];
+      final_iter = std::max(final_iter, its[l]);
+      final_norm = std::max(final_norm, resid(l));
+      for (int k = 0; k < V[l]->Size(); k++) { delete (*V[l])[k]; }
+      delete V[l];
+      delete H[l];
+      delete S[l];
+      delete CS[l];
+      delete SN[l];
+      delete R[l];
+      delete W[l];
+      delete T[l];
+   }
+   converged = (num_converged == nv);
+   PrintArraySummary("GMRES", print_level, nv, num_converged, final_iter);
+}
+
 void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 {
    DenseMatrix H(m+1,m);
@@ -1677,6 +2404,231 @@ slbqp_done:
    }
 }
 
+OperatorJacobiSmoother::OperatorJacobiSmoother(const Vector &diag,
+                                               const Array<int> &ess_tdof_list,
+                                               double damping_)
+   : Solver(diag.Size()), oper(NULL),
+     dinv(diag.Size(), Device::GetMemoryType()), damping(damping_)
+{
+   const int n = height;
+   const double *d_diag = diag.Read();
+   double *d_dinv = dinv.Write();
+   MFEM_FORALL(i, n, d_dinv[i] = 1.0 / d_diag[i];);
+   const int ness = ess_tdof_list.Size();
+   const int *d_ess = ess_tdof_list.Read();
+   MFEM_FORALL(i, ness, d_dinv[d_ess[i]] = 1.0;);
+}
+
+void OperatorJacobiSmoother::SetOperator(const Operator &op)
+{
+   MFEM_VERIFY(op.Height() == height && op.Width() == width,
+               "the Operator size does not match the diagonal");
+   oper = &op;
+}
+
+void OperatorJacobiSmoother::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == height && y.Size() == height,
+               "invalid vector sizes");
+   const int n = height;
+   const double w = damping;
+   const double *d_dinv = dinv.Read();
+   const double *d_x = x.Read();
+   if (!iterative_mode)
+   {
+      double *d_y = y.Write();
+      MFEM_FORALL(i, n, d_y[i] = w * d_dinv[i] * d_x[i];);
+      return;
+   }
+   MFEM_VERIFY(oper, "the Operator is not set, see SetOperator()");
+   r.SetSize(n, Device::GetMemoryType());
+   oper->Mult(y, r);
+   const double *d_r = r.Read();
+   double *d_y = y.ReadWrite();
+   MFEM_FORALL(i, n, d_y[i] += w * d_dinv[i] * (d_x[i] - d_r[i]););
+}
+
+
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(
+   const Operator &oper_, const Vector &diag, const Array<int> &ess_tdof_list,
+   int order_, double max_eig_estimate_)
+   : Solver(diag.Size()), oper(&oper_), order(order_),
+     max_eig_estimate(max_eig_estimate_)
+{
+#ifdef MFEM_USE_MPI
+   comm = MPI_COMM_NULL;
+#endif
+   Init(diag, ess_tdof_list);
+}
+
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(
+   const Operator &oper_, const Vector &diag, const Array<int> &ess_tdof_list,
+   int order_, const PowerIterations &power)
+   : Solver(diag.Size()), oper(&oper_), order(order_)
+{
+#ifdef MFEM_USE_MPI
+   comm = MPI_COMM_NULL;
+#endif
+   Init(diag, ess_tdof_list);
+   max_eig_estimate = EstimateLargestEigenvalue(power.max_iter,
+                                                power.rel_tol);
+}
+
+#ifdef MFEM_USE_MPI
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(
+   MPI_Comm comm_, const Operator &oper_, const Vector &diag,
+   const Array<int> &ess_tdof_list, int order_, const PowerIterations &power)
+   : Solver(diag.Size()), oper(&oper_), order(order_), comm(comm_)
+{
+   Init(diag, ess_tdof_list);
+   max_eig_estimate = EstimateLargestEigenvalue(power.max_iter,
+                                                power.rel_tol);
+}
+#endif
+
+void OperatorChebyshevSmoother::Init(const Vector &diag,
+                                     const Array<int> &ess_tdof_list)
+{
+   MFEM_VERIFY(order >= 1, "invalid order: " << order);
+   MFEM_VERIFY(oper->Height() == height && oper->Width() == width,
+               "the Operator size does not match the diagonal");
+   const int n = height;
+   dinv.SetSize(n, Device::GetMemoryType());
+   r.SetSize(n, Device::GetMemoryType());
+   z.SetSize(n, Device::GetMemoryType());
+   d.SetSize(n, Device::GetMemoryType());
+   r.UseDevice(true);
+   z.UseDevice(true);
+   d.UseDevice(true);
+   const double *d_diag = diag.Read();
+   double *d_dinv = dinv.Write();
+   MFEM_FORALL(i, n, d_dinv[i] = 1.0 / d_diag[i];);
+   const int ness = ess_tdof_list.Size();
+   const int *d_ess = ess_tdof_list.Read();
+   MFEM_FORALL(i, ness, d_dinv[d_ess[i]] = 1.0;);
+}
+
+double OperatorChebyshevSmoother::Dot(const Vector &x, const Vector &y) const
+{
+#ifdef MFEM_USE_MPI
+   if (comm != MPI_COMM_NULL) { return InnerProduct(comm, x, y); }
+#endif
+   return x * y;
+}
+
+double OperatorChebyshevSmoother::EstimateLargestEigenvalue(int iterations,
+                                                            double tolerance)
+{
+   // Power iterations for D^{-1} A with vectors v normalized in the D-inner
+   // product, so that the Rayleigh quotient is (v, A v). The vector d stores v
+   // and r stores D^{-1} A v (or v at the start), with z = D r.
+   MFEM_VERIFY(iterations > 0, "invalid number of power iterations");
+   const int n = height;
+   r.HostWrite();
+   r.Randomize(1);
+   const double *d_dinv = dinv.Read();
+   {
+      const double *d_r = r.Read();
+      double *d_z = z.Write();
+      MFEM_FORALL(i, n, d_z[i] = d_r[i] / d_dinv[i];);
+   }
+   double lambda = 0.0;
+   for (int it = 0; it <= iterations; it++)
+   {
+      // v = r / |r|_D
+      const double s = 1.0 / std::sqrt(Dot(r, z));
+      {
+         const double *d_r = r.Read();
+         double *d_v = d.Write();
+         MFEM_FORALL(i, n, d_v[i] = s * d_r[i];);
+      }
+      if (it == iterations) { break; }
+      oper->Mult(d, z);
+      const double lambda_new = Dot(d, z);
+      {
+         const double *d_z = z.Read();
+         double *d_r = r.Write();
+         MFEM_FORALL(i, n, d_r[i] = d_dinv[i] * d_z[i];);
+      }
+      const bool done = std::abs(lambda_new - lambda) <=
+                        tolerance * std::abs(lambda_new);
+      lambda = lambda_new;
+      if (done) { break; }
+   }
+   return lambda;
+}
+
+void OperatorChebyshevSmoother::SetOperator(const Operator &op)
+{
+   MFEM_VERIFY(op.Height() == height && op.Width() == width,
+               "the Operator size does not match the diagonal");
+   oper = &op;
+}
+
+void OperatorChebyshevSmoother::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == height && y.Size() == height,
+               "invalid vector sizes");
+   // Chebyshev iteration for D^{-1} A on the interval [lower, upper], see e.g.
+   // Y. Saad, "Iterative methods for sparse linear systems", Algorithm 12.1.
+   const double upper = 1.2 * max_eig_estimate;
+   const double lower = 0.3 * max_eig_estimate;
+   const double theta = 0.5 * (upper + lower);
+   const double delta = 0.5 * (upper - lower);
+   const double sigma = theta / delta;
+   double rho = 1.0 / sigma;
+
+   const int n = height;
+   const double *d_dinv = dinv.Read();
+   const double *d_x = x.Read();
+   // r = D^{-1} (b - A y), d = r / theta, y += d
+   if (iterative_mode)
+   {
+      oper->Mult(y, z);
+      const double *d_z = z.Read();
+      double *d_r = r.Write();
+      MFEM_FORALL(i, n, d_r[i] = d_dinv[i] * (d_x[i] - d_z[i]););
+   }
+   else
+   {
+      double *d_r = r.Write();
+      MFEM_FORALL(i, n, d_r[i] = d_dinv[i] * d_x[i];);
+   }
+   {
+      const double ith = 1.0 / theta;
+      const double *d_r = r.Read();
+      double *d_d = d.Write();
+      double *d_y = iterative_mode ? y.ReadWrite() : y.Write();
+      if (iterative_mode)
+      {
+         MFEM_FORALL(i, n, { d_d[i] = ith * d_r[i]; d_y[i] += d_d[i]; });
+      }
+      else
+      {
+         MFEM_FORALL(i, n, { d_d[i] = ith * d_r[i]; d_y[i] = d_d[i]; });
+      }
+   }
+   for (int k = 1; k < order; k++)
+   {
+      oper->Mult(d, z);
+      const double rho_new = 1.0 / (2.0 * sigma - rho);
+      const double c1 = rho_new * rho, c2 = 2.0 * rho_new / delta;
+      rho = rho_new;
+      // r -= D^{-1} A d, d = c1 d + c2 r, y += d
+      const double *d_z = z.Read();
+      double *d_r = r.ReadWrite();
+      double *d_d = d.ReadWrite();
+      double *d_y = y.ReadWrite();
+      MFEM_FORALL(i, n,
+      {
+         d_r[i] -= d_dinv[i] * d_z[i];
+         d_d[i] = c1 * d_d[i] + c2 * d_r[i];
+         d_y[i] += d_d[i];
+      });
+   }
+}
+
+
 #ifdef MFEM_USE_SUITESPARSE
 
 void UMFPackSolver::Init()
@@ -32,7 +32,7 @@ namespace mfem
 class IterativeSolver : public Solver
 {
 #ifdef MFEM_USE_MPI
-private:
+protected:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
 #endif
@@ -51,6 +51,15 @@ protected:
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
 
+   /** @brief Sum the @a n local values @a v, e.g. local parts of inner
+       products, over all ranks when the inner products are global. */
+   void ReduceSums(double *v, int n) const;
+
+   /** @brief Compute the inner products dots[i] = (*x[i], *y[i]) with a single
+       global reduction. */
+   void Dots(const Array<Vector *> &x, const Array<Vector *> &y,
+             double *dots) const;
+
 public:
    IterativeSolver();
 
@@ -126,6 +135,51 @@ public:
    { IterativeSolver::SetOperator(op); UpdateVectors(); }
 
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Solve with multiple right-hand sides *B[i], see Operator::ArrayMult().
+   /** The CG iterations for all right-hand sides are advanced together, so
+       that the operator and the preconditioner are applied with ArrayMult() to
+       the vectors of all unconverged systems, and the inner products of all
+       systems are computed with one global reduction. Each system has its own
+       convergence test; GetNumIterations() and GetFinalNorm() return the
+       maximum over the systems and GetConverged() is true only if all of them
+       converged. */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const;
+};
+
+/// Pipelined preconditioned conjugate gradient method
+/** This is the variant of CG by P. Ghysels and W. Vanroose, "Hiding global
+    synchronization latency in the preconditioned conjugate gradient
+    algorithm", Parallel Computing 40 (2014). The two inner products of each
+    iteration are combined in a single global reduction which, with MPI-3, is
+    overlapped with the application of the preconditioner and the operator. All
+    vector updates of an iteration are done in a single pass over the vectors,
+    which on the host also computes the local inner products.
+
+    The method uses six more work vectors than CGSolver and one extra
+    application of the preconditioner and the operator at convergence. Its
+    recurrences are less stable, so the attainable accuracy can be lower for
+    ill-conditioned systems. The convergence criterion and the print levels are
+    the same as in CGSolver. */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, m, n, z, q, s, p;
+
+   void UpdateVectors();
+
+public:
+   PipelinedCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
 };
 
 /// Conjugate gradient method. (tolerances are squared)
@@ -156,6 +210,11 @@ public:
    void SetKDim(int dim) { m = dim; }
 
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve with multiple right-hand sides *B[i], advancing the GMRES
+       iterations of all systems together, as in CGSolver::ArrayMult(). */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const;
 };
 
 /// FGMRES method
@@ -338,6 +397,113 @@ public:
 };
 
 
+/// Jacobi smoother that requires only the diagonal and the action of an Operator
+/** The smoother applies damped Jacobi steps, x <- x + damping D^{-1} (b - A x),
+    where the diagonal D is given as a Vector, e.g. computed with
+    BilinearForm::AssembleDiagonal() for partially assembled forms. The entries
+    of D at the dofs in @a ess_tdof_list are replaced by 1, which matches the
+    operators constrained by BilinearForm::FormSystemMatrix().
+
+    With iterative_mode = false (the default), Mult() applies one step from a
+    zero initial guess, i.e. y = damping D^{-1} x, which does not need the
+    action of A. Otherwise, the Operator must be set with SetOperator(). */
+class OperatorJacobiSmoother : public Solver
+{
+protected:
+   const Operator *oper; // not owned
+   Vector dinv;
+   double damping;
+   mutable Vector r;
+
+public:
+   OperatorJacobiSmoother(const Vector &diag, const Array<int> &ess_tdof_list,
+                          double damping_ = 1.0);
+
+   /// Set the Operator A, used only when iterative_mode is true.
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+
+/// Chebyshev polynomial smoother that requires only the action of an Operator
+/// and its diagonal
+/** Applies the Chebyshev polynomial of the given @a order to the Jacobi
+    preconditioned operator D^{-1} A, targeting the eigenvalues in the interval
+    [0.3, 1.2] * lambda_max, where lambda_max is an estimate of the largest
+    eigenvalue of D^{-1} A. The estimate can be given or computed with a few
+    power iterations on D^{-1} A, using the D-inner product, in which D^{-1} A
+    is self-adjoint for symmetric A and positive D. As in
+    OperatorJacobiSmoother, the entries of D at the dofs in @a ess_tdof_list are
+    replaced by 1.
+
+    Each call to Mult() uses @a order applications of A (one less when
+    iterative_mode is false). All vector updates are done with MFEM_FORALL
+    kernels, so the smoother runs on the device backends together with
+    partially assembled or matrix-free operators. */
+class OperatorChebyshevSmoother : public Solver
+{
+protected:
+   const Operator *oper; // not owned
+   Vector dinv;
+   int order;
+   double max_eig_estimate;
+   mutable Vector r, z, d;
+#ifdef MFEM_USE_MPI
+   MPI_Comm comm; // MPI_COMM_NULL for local inner products
+#endif
+
+   void Init(const Vector &diag, const Array<int> &ess_tdof_list);
+   double Dot(const Vector &x, const Vector &y) const;
+   double EstimateLargestEigenvalue(int iterations, double tolerance);
+
+public:
+   /** @brief Parameters of the power iterations that estimate the largest
+       eigenvalue: at most @a max_iter iterations, stopping when the relative
+       change of the estimate is below @a rel_tol. */
+   /** The constructor is explicit, so that an integer argument of the
+       OperatorChebyshevSmoother constructors is never taken as the number of
+       power iterations. */
+   struct PowerIterations
+   {
+      int max_iter;
+      double rel_tol;
+
+      explicit PowerIterations(int max_iter_ = 10, double rel_tol_ = 1e-8)
+         : max_iter(max_iter_), rel_tol(rel_tol_) { }
+   };
+
+   /// Create a smoother using the given estimate of the largest eigenvalue.
+   OperatorChebyshevSmoother(const Operator &oper_, const Vector &diag,
+                             const Array<int> &ess_tdof_list, int order_,
+                             double max_eig_estimate_);
+
+   /** @brief Create a smoother, estimating the largest eigenvalue with the
+       given @a power iterations. */
+   OperatorChebyshevSmoother(const Operator &oper_, const Vector &diag,
+                             const Array<int> &ess_tdof_list, int order_,
+                             const PowerIterations &power = PowerIterations());
+
+#ifdef MFEM_USE_MPI
+   /** Parallel version of the above constructor: the inner products of the
+       power iterations are reduced over @a comm_. */
+   OperatorChebyshevSmoother(MPI_Comm comm_, const Operator &oper_,
+                             const Vector &diag,
+                             const Array<int> &ess_tdof_list, int order_,
+                             const PowerIterations &power = PowerIterations());
+#endif
+
+   /// Return the estimate of the largest eigenvalue of D^{-1} A.
+   double GetMaxEigenvalueEstimate() const { return max_eig_estimate; }
+
+   /** @brief Replace the Operator, keeping the diagonal and the eigenvalue
+       estimate. */
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+
 #ifdef MFEM_USE_SUITESPARSE
 
 /// Direct sparse solver using UMFPACK
@@ -23,11 +23,56 @@
 #include <limits>
 #include <cstring>
 
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
+
 namespace mfem
 {
 
 using namespace std;
 
+// Return true if the host OpenMP backend is used for the finalized
+// SparseMatrix kernels, i.e. when MFEM_FORALL dispatches to OmpWrap().
+static inline bool UseOmpBackend()
+{
+#ifdef MFEM_USE_OPENMP
+   return (Device::Allows(Backend::OMP_MASK) &&
+           !Device::Allows(Backend::DEVICE_MASK));
+#else
+   return false;
+#endif
+}
+
+#ifdef MFEM_USE_OPENMP
+// Return the range of rows [r0,r1) of part p, out of np parts, in a partition
+// of the rows of a CSR matrix with row offsets I, balancing the number of
+// nonzeros plus the number of rows in each part. The partition depends only on
+// I and np, so that threads using it in different methods, e.g. Finalize() and
+// AddMult(), touch the same rows.
+static void GetBalancedRowRange(const int *I, int height, int p, int np,
+                                int &r0, int &r1)
+{
+   const long total = (long) I[height] + height;
+   const long t[2] = { (total*p)/np, (total*(p+1))/np };
+   int r[2];
+   for (int k = 0; k < 2; k++)
+   {
+      // first row i with I[i] + i >= t[k]
+      int lo = 0, hi = height;
+      while (lo < hi)
+      {
+         const int mid = lo + (hi - lo)/2;
+         if ((long) I[mid] + mid < t[k]) { lo = mid + 1; }
+         else { hi = mid; }
+      }
+      r[k] = lo;
+   }
+   r0 = (p == 0) ? 0 : r[0];
+   r1 = (p == np-1) ? height : r[1];
+}
+#endif
+
 SparseMatrix::SparseMatrix(int nrows, int ncols)
    : AbstractSparseMatrix(nrows, (ncols >= 0) ? ncols : nrows),
      Rows(new RowNode *[nrows]),
@@ -584,6 +629,29 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
    auto d_A = Read(A, nnz);
    auto d_x = x.Read();
    auto d_y = y.ReadWrite();
+#ifdef MFEM_USE_OPENMP
+   if (UseOmpBackend())
+   {
+      // Use the same nonzero-balanced row partition as Finalize().
+      #pragma omp parallel
+      {
+         int r0, r1;
+         GetBalancedRowRange(d_I, height, omp_get_thread_num(),
+                             omp_get_num_threads(), r0, r1);
+         for (int i = r0; i < r1; i++)
+         {
+            double d = 0.0;
+            const int end = d_I[i+1];
+            for (int j = d_I[i]; j < end; j++)
+            {
+               d += d_A[j] * d_x[d_J[j]];
+            }
+            d_y[i] += a * d;
+         }
+      }
+      return;
+   }
+#endif
    MFEM_FORALL(i, height,
    {
       double d = 0.0;
@@ -613,6 +681,119 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
 #endif
 }
 
+// Product of the rows [r0,r1) of a CSR matrix with NB vectors: y[b] = A x[b].
+template <int NB>
+static inline void SpMMRows(const int r0, const int r1, const int *I,
+                            const int *J, const double *A,
+                            const double *const *x, double *const *y)
+{
+   for (int i = r0; i < r1; i++)
+   {
+      double d[NB];
+      for (int b = 0; b < NB; b++) { d[b] = 0.0; }
+      const int end = I[i+1];
+      for (int j = I[i]; j < end; j++)
+      {
+         const double a = A[j];
+         const int c = J[j];
+         for (int b = 0; b < NB; b++) { d[b] += a * x[b][c]; }
+      }
+      for (int b = 0; b < NB; b++) { y[b][i] = d[b]; }
+   }
+}
+
+template <int NB>
+static void SpMM(const int height, const int *d_I, const int *d_J,
+                 const double *d_A, const double *const *d_x,
+                 double *const *d_y)
+{
+#ifdef MFEM_USE_OPENMP
+   if (UseOmpBackend())
+   {
+      // Use the same nonzero-balanced row partition as Finalize().
+      #pragma omp parallel
+      {
+         int r0, r1;
+         GetBalancedRowRange(d_I, height, omp_get_thread_num(),
+                             omp_get_num_threads(), r0, r1);
+         SpMMRows<NB>(r0, r1, d_I, d_J, d_A, d_x, d_y);
+      }
+      return;
+   }
+#endif
+   if (!Device::Allows(Backend::DEVICE_MASK))
+   {
+      SpMMRows<NB>(0, height, d_I, d_J, d_A, d_x, d_y);
+      return;
+   }
+   MFEM_FORALL(i, height,
+   {
+      double d[NB];
+      for (int b = 0; b < NB; b++) { d[b] = 0.0; }
+      const int end = d_I[i+1];
+      for (int j = d_I[i]; j < end; j++)
+      {
+         const double a = d_A[j];
+         const int c = d_J[j];
+         for (int b = 0; b < NB; b++) { d[b] += a * d_x[b][c]; }
+      }
+      for (int b = 0; b < NB; b++) { d_y[b][i] = d[b]; }
+   });
+}
+
+void SparseMatrix::ArrayMult(const Array<const Vector *> &X,
+                             Array<Vector *> &Y) const
+{
+   MFEM_ASSERT(X.Size() == Y.Size(), "incompatible batch sizes");
+#ifndef MFEM_USE_LEGACY_OPENMP
+   const bool use_spmm = Finalized();
+#else
+   const bool use_spmm = false;
+#endif
+   if (!use_spmm)
+   {
+      Operator::ArrayMult(X, Y);
+      return;
+   }
+
+   const int nnz = J.Capacity();
+   auto d_I = Read(I, height+1);
+   auto d_J = Read(J, nnz);
+   auto d_A = Read(A, nnz);
+   const int max_nb = 8;
+   Array<const double *> xp(max_nb);
+   Array<double *> yp(max_nb);
+   for (int v0 = 0; v0 < X.Size(); v0 += max_nb)
+   {
+      const int nb = std::min(max_nb, X.Size() - v0);
+      for (int b = 0; b < nb; b++)
+      {
+         MFEM_ASSERT(X[v0+b]->Size() == width && Y[v0+b]->Size() == height,
+                     "invalid vector sizes");
+         Y[v0+b]->UseDevice(true);
+         xp[b] = X[v0+b]->Read();
+         yp[b] = Y[v0+b]->Write();
+      }
+      // The arrays of (device) pointers are copied to the device, if needed.
+      auto d_x = xp.Read();
+      auto d_y = yp.Read();
+      switch (nb)
+      {
+         case 1: SpMM<1>(height, d_I, d_J, d_A, d_x, d_y); break;
+         case 2: SpMM<2>(height, d_I, d_J, d_A, d_x, d_y); break;
+         case 3: SpMM<3>(height, d_I, d_J, d_A, d_x, d_y); break;
+         case 4: SpMM<4>(height, d_I, d_J, d_A, d_x, d_y); break;
+         case 5: SpMM<5>(height, d_I, d_J, d_A, d_x, d_y); break;
+         case 6: SpMM<6>(height, d_I, d_J, d_A, d_x, d_y); break;
+         case 7: SpMM<7>(height, d_I, d_J, d_A, d_x, d_y); break;
+         case 8: SpMM<8>(height, d_I, d_J, d_A, d_x, d_y); break;
+      }
+      // The host copies of the pointer arrays are modified in the next pass.
+      xp.HostWrite();
+      yp.HostWrite();
+   }
+}
+
 void SparseMatrix::MultTranspose(const Vector &x, Vector &y) const
 {
    if (Finalized()) { y.UseDevice(true); }
@@ -648,10 +829,16 @@ void SparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
    {
       At->AddMult(x, y, a);
    }
+#ifdef MFEM_USE_OPENMP
+   else if (UseOmpBackend() && omp_get_max_threads() > 1)
+   {
+      OmpAddMultTranspose(x, y, a);
+   }
+#endif
    else
    {
-      MFEM_VERIFY(Device::IsDisabled(), "transpose action on device is not "
-                  "enabled; see BuildTranspose() for details.");
+      MFEM_VERIFY(Device::IsDisabled() || UseOmpBackend(), "transpose action "
+                  "on device is not enabled; see BuildTranspose() for details.");
       for (int i = 0; i < height; i++)
       {
          const double xi = a * x[i];
@@ -665,6 +852,66 @@ void SparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
    }
 }
 
+#ifdef MFEM_USE_OPENMP
+void SparseMatrix::OmpAddMultTranspose(const Vector &x, Vector &y,
+                                       const double a) const
+{
+   const int height = this->height, width = this->width;
+   const int nnz = J.Capacity();
+   const int *d_I = Read(I, height+1);
+   const int *d_J = Read(J, nnz);
+   const double *d_A = Read(A, nnz);
+   const double *d_x = x.Read();
+   double *d_y = y.ReadWrite();
+
+   // Each thread accumulates the contributions of its rows in a private buffer
+   // covering the range of columns of these rows; the buffers are then summed
+   // into y, with the columns split between the threads.
+   const int max_threads = omp_get_max_threads();
+   Array<double*> buf(max_threads);
+   Array<int> col_begin(max_threads), col_end(max_threads);
+   #pragma omp parallel
+   {
+      const int p = omp_get_thread_num(), np = omp_get_num_threads();
+      int r0, r1;
+      GetBalancedRowRange(d_I, height, p, np, r0, r1);
+      int c0 = width, c1 = 0;
+      for (int j = d_I[r0]; j < d_I[r1]; j++)
+      {
+         c0 = std::min(c0, d_J[j]);
+         c1 = std::max(c1, d_J[j] + 1);
+      }
+      c1 = std::max(c0, c1);
+      double *b = new double[c1 - c0];
+      for (int c = 0; c < c1 - c0; c++) { b[c] = 0.0; }
+      for (int i = r0; i < r1; i++)
+      {
+         const double xi = a * d_x[i];
+         const int end = d_I[i+1];
+         for (int j = d_I[i]; j < end; j++)
+         {
+            b[d_J[j] - c0] += d_A[j] * xi;
+         }
+      }
+      buf[p] = b;
+      col_begin[p] = c0;
+      col_end[p] = c1;
+      #pragma omp barrier
+      const int cc0 = (int) (((long) width*p)/np);
+      const int cc1 = (int) (((long) width*(p+1))/np);
+      for (int t = 0; t < np; t++)
+      {
+         const int lo = std::max(cc0, col_begin[t]);
+         const int hi = std::min(cc1, col_end[t]);
+         const double *bt = buf[t] - col_begin[t];
+         for (int c = lo; c < hi; c++) { d_y[c] += bt[c]; }
+      }
+      #pragma omp barrier
+      delete [] b;
+   }
+}
+#endif
+
 void SparseMatrix::BuildTranspose() const
 {
    if (At == NULL)
@@ -927,9 +1174,6 @@ void SparseMatrix::Threshold(double tol, bool fix_empty_rows)
 
 void SparseMatrix::Finalize(int skip_zeros, bool fix_empty_rows)
 {
-   int i, j, nr, nz;
-   RowNode *aux;
-
    if (Finalized())
    {
       return;
@@ -938,71 +1182,97 @@ void SparseMatrix::Finalize(int skip_zeros, bool fix_empty_rows)
    delete [] ColPtrNode;
    ColPtrNode = NULL;
 
+   // With the OpenMP backend, the rows are processed in parallel using the
+   // same partition as in AddMult(), so that the pages of J and A are first
+   // touched by the threads that will use them.
+#ifdef MFEM_USE_OPENMP
+   const bool use_omp = UseOmpBackend();
+#endif
+   const int height = this->height;
+   RowNode **Rows = this->Rows;
+
    I.New(height+1);
-   I[0] = 0;
-   for (i = 1; i <= height; i++)
+   int *Ip = I;
+   Ip[0] = 0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for if (use_omp)
+#endif
+   for (int i = 0; i < height; i++)
    {
-      nr = 0;
-      for (aux = Rows[i-1]; aux != NULL; aux = aux->Prev)
+      int nr = 0;
+      for (RowNode *aux = Rows[i]; aux != NULL; aux = aux->Prev)
       {
          if (!skip_zeros || aux->Value != 0.0) { nr++; }
       }
       if (fix_empty_rows && !nr) { nr = 1; }
-      I[i] = I[i-1] + nr;
+      Ip[i+1] = nr;
+   }
+   for (int i = 0; i < height; i++)
+   {
+      Ip[i+1] += Ip[i];
    }
 
-   nz = I[height];
+   const int nz = Ip[height];
    J.New(nz);
    A.New(nz);
+   int *Jp = J;
+   double *Ap = A;
    // Assume we're sorted until we find out otherwise
-   isSorted = true;
-   for (j = i = 0; i < height; i++)
+   bool sorted = true;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (use_omp) reduction(&&:sorted)
+#endif
    {
-      int lastCol = -1;
-      nr = 0;
-      for (aux = Rows[i]; aux != NULL; aux = aux->Prev)
+      int r0 = 0, r1 = height;
+#ifdef MFEM_USE_OPENMP
+      GetBalancedRowRange(Ip, height, omp_get_thread_num(),
+                          omp_get_num_threads(), r0, r1);
+#endif
+      for (int i = r0; i < r1; i++)
       {
-         if (!skip_zeros || aux->Value != 0.0)
+         int j = Ip[i];
+         int lastCol = -1;
+         for (RowNode *aux = Rows[i]; aux != NULL; aux = aux->Prev)
          {
-            J[j] = aux->Column;
-            A[j] = aux->Value;
-
-            if ( lastCol > J[j] )
+            if (!skip_zeros || aux->Value != 0.0)
             {
-               isSorted = false;
-            }
-            lastCol = J[j];
+               Jp[j] = aux->Column;
+               Ap[j] = aux->Value;
 
-            j++;
-            nr++;
+               if ( lastCol > Jp[j] )
+               {
+                  sorted = false;
+               }
+               lastCol = Jp[j];
+
+               j++;
+            }
          }
-      }
-      if (fix_empty_rows && !nr)
-      {
-         J[j] = i;
-         A[j] = 1.0;
-         j++;
+         if (fix_empty_rows && j == Ip[i])
+         {
+            Jp[j] = i;
+            Ap[j] = 1.0;
+         }
+#ifndef MFEM_USE_MEMALLOC
+         RowNode *node_p = Rows[i];
+         while (node_p != NULL)
+         {
+            RowNode *aux = node_p;
+            node_p = node_p->Prev;
+            delete aux;
+         }
+#endif
       }
    }
+   isSorted = sorted;
 
 #ifdef MFEM_USE_MEMALLOC
    delete NodesMem;
    NodesMem = NULL;
-#else
-   for (i = 0; i < height; i++)
-   {
-      RowNode *node_p = Rows[i];
-      while (node_p != NULL)
-      {
-         aux = node_p;
-         node_p = node_p->Prev;
-         delete aux;
-      }
-   }
 #endif
 
-   delete [] Rows;
-   Rows = NULL;
+   delete [] this->Rows;
+   this->Rows = NULL;
 }
 
 void SparseMatrix::GetBlocks(Array2D<SparseMatrix *> &blocks) const
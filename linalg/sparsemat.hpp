@@ -80,6 +80,11 @@ protected:
    void Destroy();   // Delete all owned data
    void SetEmpty();  // Init all entries with empty values
 
+#ifdef MFEM_USE_OPENMP
+   /// Threaded AddMultTranspose() without the internal transpose.
+   void OmpAddMultTranspose(const Vector &x, Vector &y, const double a) const;
+#endif
+
 public:
    /// Create an empty SparseMatrix.
    SparseMatrix() { SetEmpty(); }
@@ -152,6 +157,21 @@ public:
    /// Return the element data, i.e. the array #A, const version.
    inline const double *GetData() const { return A; }
 
+   /// Return the Memory object of the array #I.
+   Memory<int> &GetMemoryI() { return I; }
+   /// Return the Memory object of the array #I, const version.
+   const Memory<int> &GetMemoryI() const { return I; }
+
+   /// Return the Memory object of the array #J.
+   Memory<int> &GetMemoryJ() { return J; }
+   /// Return the Memory object of the array #J, const version.
+   const Memory<int> &GetMemoryJ() const { return J; }
+
+   /// Return the Memory object of the array #A.
+   Memory<double> &GetMemoryData() { return A; }
+   /// Return the Memory object of the array #A, const version.
+   const Memory<double> &GetMemoryData() const { return A; }
+
    /// Returns the number of elements in row @a i.
    int RowSize(const int i) const;
 
@@ -219,6 +239,11 @@ public:
    /// y += A * x (default)  or  y += a * A * x
    void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
+   /** @brief Matrix multiplication with a batch of vectors, *Y[i] = A *X[i],
+       reading each nonzero once for up to 8 vectors (SpMM). */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
    /// Multiply a vector with the transposed matrix. y = At * x
    void MultTranspose(const Vector &x, Vector &y) const;
 
@@ -237,12 +262,14 @@ public:
        call to this method. If the internal transpose is already built, this
        method has no effect.
 
-       When any non-default backend is enabled, i.e. Device::IsEnabled() is
-       true, the methods AddMultTranspose(), and MultTranspose(), require the
-       internal transpose to be built. If that is not the case (i.e. the
-       internal transpose is not built), these methods will raise an error with
-       an appropriate message pointing to this method. When using the default
-       backend, calling this method is optional.
+       When any non-default device backend is enabled, e.g. CUDA, the methods
+       AddMultTranspose(), and MultTranspose(), require the internal transpose
+       to be built. If that is not the case (i.e. the internal transpose is not
+       built), these methods will raise an error with an appropriate message
+       pointing to this method. When using the default backend, or the OpenMP
+       backend, calling this method is optional: without the internal
+       transpose, the OpenMP backend accumulates the contributions of the rows
+       handled by each thread in a private buffer.
 
        This method can only be used when the sparse matrix is finalized. */
    void BuildTranspose() const;
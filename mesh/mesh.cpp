@@ -16,6 +16,7 @@
 #include "../general/sort_pairs.hpp"
 #include "../general/text.hpp"
 #include "../general/device.hpp"
+#include "../general/forall.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -781,6 +782,25 @@ void Mesh::DeleteGeometricFactors()
    geom_factors.SetSize(0);
 }
 
+const PointLocator* Mesh::GetPointLocator()
+{
+   if (point_locator && point_locator->sequence != sequence)
+   {
+      DeletePointLocator();
+   }
+   if (!point_locator)
+   {
+      point_locator = new PointLocator(this);
+   }
+   return point_locator;
+}
+
+void Mesh::DeletePointLocator()
+{
+   delete point_locator;
+   point_locator = NULL;
+}
+
 void Mesh::GetLocalFaceTransformation(
    int face_type, int elem_type, IsoparametricTransformation &Transf, int info)
 {
@@ -974,6 +994,7 @@ void Mesh::Init()
    NURBSext = NULL;
    ncmesh = NULL;
    last_operation = Mesh::NONE;
+   point_locator = NULL;
 }
 
 void Mesh::InitTables()
@@ -994,6 +1015,7 @@ void Mesh::DestroyTables()
    delete el_to_face;
    delete el_to_el;
    DeleteGeometricFactors();
+   DeletePointLocator();
 
    if (Dim == 3)
    {
@@ -1064,6 +1086,7 @@ void Mesh::DeleteLazyTables()
    delete face_edge;    face_edge = NULL;
    delete edge_vertex;  edge_vertex = NULL;
    DeleteGeometricFactors();
+   DeletePointLocator();
 }
 
 void Mesh::SetAttributes()
@@ -2646,6 +2669,7 @@ Mesh::Mesh(const Mesh &mesh, bool copy_nodes)
    // Create the new Mesh instance without a record of its refinement history
    sequence = 0;
    last_operation = Mesh::NONE;
+   point_locator = NULL;
 
    // Duplicate the elements
    elements.SetSize(NumOfElements);
@@ -3028,6 +3052,11 @@ void Mesh::Loader(std::istream &input, int generate_edges,
    {
       ReadGmshMesh(input);
    }
+   else if (mesh_type == "MFEM binary mesh v1.0")
+   {
+      BinaryReader bin_input(input, mesh_type);
+      ReadMFEMBinaryMesh(bin_input, curved, read_gf, finalize_topo);
+   }
    else if
    ((mesh_type.size() > 2 &&
      mesh_type[0] == 'C' && mesh_type[1] == 'D' && mesh_type[2] == 'F') ||
@@ -3627,6 +3656,7 @@ void Mesh::SetNodalFESpace(FiniteElementSpace *nfes)
 void Mesh::EnsureNodes()
 {
    if (Nodes) { return; }
+   DeletePointLocator();
    SetCurvature(1, false, -1, Ordering::byVDIM);
 }
 
@@ -3643,6 +3673,7 @@ const FiniteElementSpace *Mesh::GetNodalFESpace() const
 
 void Mesh::SetCurvature(int order, bool discont, int space_dim, int ordering)
 {
+   DeletePointLocator();
    space_dim = (space_dim == -1) ? spaceDim : space_dim;
    FiniteElementCollection* nfec;
    if (discont)
@@ -5756,6 +5787,7 @@ void Mesh::CheckDisplacements(const Vector &displacements, double &tmax)
 
 void Mesh::MoveVertices(const Vector &displacements)
 {
+   DeletePointLocator();
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
       {
@@ -5776,6 +5808,7 @@ void Mesh::GetVertices(Vector &vert_coord) const
 
 void Mesh::SetVertices(const Vector &vert_coord)
 {
+   DeletePointLocator();
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
       {
@@ -5804,6 +5837,7 @@ void Mesh::GetNode(int i, double *coord)
 
 void Mesh::SetNode(int i, const double *coord)
 {
+   DeletePointLocator();
    if (Nodes)
    {
       FiniteElementSpace *fes = Nodes->FESpace();
@@ -5824,6 +5858,7 @@ void Mesh::SetNode(int i, const double *coord)
 
 void Mesh::MoveNodes(const Vector &displacements)
 {
+   DeletePointLocator();
    if (Nodes)
    {
       (*Nodes) += displacements;
@@ -5848,6 +5883,7 @@ void Mesh::GetNodes(Vector &node_coord) const
 
 void Mesh::SetNodes(const Vector &node_coord)
 {
+   DeletePointLocator();
    if (Nodes)
    {
       (*Nodes) = node_coord;
@@ -5860,6 +5896,7 @@ void Mesh::SetNodes(const Vector &node_coord)
 
 void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
 {
+   DeletePointLocator();
    if (own_nodes) { delete Nodes; }
    Nodes = &nodes;
    spaceDim = Nodes->FESpace()->GetVDim();
@@ -5874,6 +5911,7 @@ void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
 
 void Mesh::SwapNodes(GridFunction *&nodes, int &own_nodes_)
 {
+   DeletePointLocator();
    mfem::Swap<GridFunction*>(Nodes, nodes);
    mfem::Swap<int>(own_nodes, own_nodes_);
    // TODO:
@@ -7103,6 +7141,7 @@ void Mesh::Swap(Mesh& other, bool non_geometry)
    mfem::Swap(bdr_attributes, other.bdr_attributes);
 
    mfem::Swap(geom_factors, other.geom_factors);
+   mfem::Swap(point_locator, other.point_locator);
 
    if (non_geometry)
    {
@@ -8015,6 +8054,61 @@ void Mesh::Printer(std::ostream &out, std::string section_delimiter) const
    }
 }
 
+// Store the geometries, attributes and vertices of the elements in 'elems'
+static void GetElementArrays(const Array<Element*> &elems, Array<int> &geoms,
+                             Array<int> &attribs, Array<int> &verts)
+{
+   geoms.SetSize(elems.Size());
+   attribs.SetSize(elems.Size());
+   verts.SetSize(0);
+   for (int i = 0; i < elems.Size(); i++)
+   {
+      geoms[i] = elems[i]->GetGeometryType();
+      attribs[i] = elems[i]->GetAttribute();
+      verts.Append(elems[i]->GetVertices(), elems[i]->GetNVertices());
+   }
+}
+
+void Mesh::PrintBinary(std::ostream &out) const
+{
+   MFEM_VERIFY(!NURBSext && !ncmesh, "NURBS and non-conforming meshes are "
+               "not supported by the binary mesh format");
+
+   BinaryWriter bin_out(out, "MFEM binary mesh v1.0");
+   const int dims[2] = { Dim, spaceDim };
+   bin_out.Write("dimension", dims, 2);
+
+   Array<int> geoms, attribs, verts;
+   GetElementArrays(elements, geoms, attribs, verts);
+   bin_out.Write("element_geometries", geoms);
+   bin_out.Write("element_attributes", attribs);
+   bin_out.Write("element_vertices", verts);
+   GetElementArrays(boundary, geoms, attribs, verts);
+   bin_out.Write("boundary_geometries", geoms);
+   bin_out.Write("boundary_attributes", attribs);
+   bin_out.Write("boundary_vertices", verts);
+
+   Vector coords(NumOfVertices*spaceDim);
+   for (int i = 0; i < NumOfVertices; i++)
+   {
+      for (int j = 0; j < spaceDim; j++)
+      {
+         coords(i*spaceDim + j) = vertices[i](j);
+      }
+   }
+   bin_out.Write("vertices", coords.GetData(), coords.Size());
+
+   if (Nodes)
+   {
+      std::ostringstream fes_header;
+      Nodes->FESpace()->Save(fes_header);
+      bin_out.Write("nodes_fespace", fes_header.str());
+      bin_out.Write("nodes", Nodes->HostRead(), Nodes->Size());
+   }
+   bin_out.Finish();
+   out.flush();
+}
+
 void Mesh::PrintTopo(std::ostream &out,const Array<int> &e_to_k) const
 {
    int i;
@@ -9179,6 +9273,7 @@ void Mesh::ScaleElements(double sf)
 
 void Mesh::Transform(void (*f)(const Vector&, Vector&))
 {
+   DeletePointLocator();
    // TODO: support for different new spaceDim.
    if (Nodes == NULL)
    {
@@ -9206,6 +9301,7 @@ void Mesh::Transform(VectorCoefficient &deformation)
 {
    MFEM_VERIFY(spaceDim == deformation.GetVDim(),
                "incompatible vector dimensions");
+   DeletePointLocator();
    if (Nodes == NULL)
    {
       LinearFECollection fec;
@@ -9459,99 +9555,46 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
    if (!GetNE()) { return 0; }
 
    double *data = point_mat.GetData();
-   InverseElementTransformation *inv_tr = inv_trans;
-   inv_tr = inv_tr ? inv_tr : new InverseElementTransformation;
-
-   // For each point in 'point_mat', find the element whose center is closest.
-   Vector min_dist(npts);
-   Array<int> e_idx(npts);
-   min_dist = std::numeric_limits<double>::max();
-   e_idx = -1;
-
-   Vector pt(spaceDim);
-   for (int i = 0; i < GetNE(); i++)
-   {
-      GetElementTransformation(i)->Transform(
-         Geometries.GetCenter(GetElementBaseGeometry(i)), pt);
-      for (int k = 0; k < npts; k++)
-      {
-         double dist = pt.DistanceTo(data+k*spaceDim);
-         if (dist < min_dist(k))
-         {
-            min_dist(k) = dist;
-            e_idx[k] = i;
-         }
-      }
-   }
+   const PointLocator &locator = *GetPointLocator();
+   if (Nodes) { Nodes->HostRead(); }
 
-   // Checks if the points lie in the closest element
+   // For each point in 'point_mat', try the elements whose bounding boxes
+   // contain the point. A user-provided 'inv_trans' cannot be shared between
+   // threads, and neither can the NURBS finite elements, which store the
+   // current element.
    int pts_found = 0;
-   pt.NewDataAndSize(NULL, spaceDim);
-   for (int k = 0; k < npts; k++)
-   {
-      pt.SetData(data+k*spaceDim);
-      inv_tr->SetTransformation(*GetElementTransformation(e_idx[k]));
-      int res = inv_tr->Transform(pt, ips[k]);
-      if (res == InverseElementTransformation::Inside)
-      {
-         elem_ids[k] = e_idx[k];
-         pts_found++;
-      }
-   }
-   if (pts_found != npts)
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+   const bool use_threads = (inv_trans == NULL && NURBSext == NULL);
+   #pragma omp parallel if (use_threads) reduction(+:pts_found)
+#endif
    {
-      Array<int> vertices;
-      Table *vtoel = GetVertexToElementTable();
+      InverseElementTransformation def_inv_tr;
+      InverseElementTransformation *inv_tr =
+         inv_trans ? inv_trans : &def_inv_tr;
+      IsoparametricTransformation T;
+      Array<int> candidates;
+      Vector pt(NULL, spaceDim);
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+      #pragma omp for schedule(dynamic, 64)
+#endif
       for (int k = 0; k < npts; k++)
       {
-         if (elem_ids[k] != -1) { continue; }
-         // Try all vertex-neighbors of element e_idx[k]
          pt.SetData(data+k*spaceDim);
-         GetElementVertices(e_idx[k], vertices);
-         for (int v = 0; v < vertices.Size(); v++)
-         {
-            int vv = vertices[v];
-            int ne = vtoel->RowSize(vv);
-            const int* els = vtoel->GetRow(vv);
-            for (int e = 0; e < ne; e++)
-            {
-               if (els[e] == e_idx[k]) { continue; }
-               inv_tr->SetTransformation(*GetElementTransformation(els[e]));
-               int res = inv_tr->Transform(pt, ips[k]);
-               if (res == InverseElementTransformation::Inside)
-               {
-                  elem_ids[k] = els[e];
-                  pts_found++;
-                  goto next_point;
-               }
-            }
-         }
-         // Try neighbours for non-conforming meshes
-         if (ncmesh)
+         locator.GetCandidates(pt.GetData(), candidates);
+         for (int i = 0; i < candidates.Size(); i++)
          {
-            Array<int> neigh;
-            int le = ncmesh->leaf_elements[e_idx[k]];
-            ncmesh->FindNeighbors(le,neigh);
-            for (int e = 0; e < neigh.Size(); e++)
+            GetElementTransformation(candidates[i], &T);
+            inv_tr->SetTransformation(T);
+            int res = inv_tr->Transform(pt, ips[k]);
+            if (res == InverseElementTransformation::Inside)
             {
-               int nn = neigh[e];
-               if (ncmesh->IsGhost(ncmesh->elements[nn])) { continue; }
-               int el = ncmesh->elements[nn].index;
-               inv_tr->SetTransformation(*GetElementTransformation(el));
-               int res = inv_tr->Transform(pt, ips[k]);
-               if (res == InverseElementTransformation::Inside)
-               {
-                  elem_ids[k] = el;
-                  pts_found++;
-                  goto next_point;
-               }
+               elem_ids[k] = candidates[i];
+               pts_found++;
+               break;
             }
          }
-      next_point: ;
       }
-      delete vtoel;
    }
-   if (inv_trans == NULL) { delete inv_tr; }
 
    if (warn && pts_found != npts)
    {
@@ -9560,7 +9603,6 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
    return pts_found;
 }
 
-
 GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
                                    int flags)
 {
@@ -9577,10 +9619,31 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
    const int NQ   = ir.GetNPoints();
 
    Vector Enodes(vdim*ND*NE);
-   // For now, we are not using tensor product evaluation
    const Operator *elem_restr = fespace->GetElementRestriction(
                                    ElementDofOrdering::NATIVE);
-   elem_restr->Mult(*nodes, Enodes);
+   if (elem_restr)
+   {
+      elem_restr->Mult(*nodes, Enodes);
+   }
+   else
+   {
+      // Discontinuous nodes, e.g. of periodic meshes, have no element
+      // restriction: gather the element vdofs on the host.
+      Array<int> vdofs;
+      auto E = Reshape(Enodes.HostWrite(), ND, vdim, NE);
+      nodes->HostRead();
+      for (int e = 0; e < NE; e++)
+      {
+         fespace->GetElementVDofs(e, vdofs);
+         for (int c = 0; c < vdim; c++)
+         {
+            for (int d = 0; d < ND; d++)
+            {
+               E(d, c, e) = (*nodes)(vdofs[d + c*ND]);
+            }
+         }
+      }
+   }
 
    unsigned eval_flags = 0;
    if (flags & GeometricFactors::COORDINATES)
@@ -9600,12 +9663,200 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
    }
 
    const QuadratureInterpolator *qi = fespace->GetQuadratureInterpolator(ir);
-   // For now, we are not using tensor product evaluation (not implemented)
-   qi->DisableTensorProducts();
    qi->Mult(Enodes, eval_flags, X, J, detJ);
 }
 
 
+PointLocator::PointLocator(Mesh *mesh)
+{
+   this->mesh = mesh;
+   sequence = mesh->GetSequence();
+
+   const int NE = mesh->GetNE();
+   const int sdim = mesh->SpaceDimension();
+   const GridFunction *nodes = mesh->GetNodes();
+
+   // Element bounding boxes.
+   el_min.SetSize(sdim, NE);
+   el_max.SetSize(sdim, NE);
+   IsoparametricTransformation T;
+   DenseMatrix pts;
+   for (int e = 0; e < NE; e++)
+   {
+      mesh->GetElementTransformation(e, &T);
+      const DenseMatrix &pm = T.GetPointMat();
+      for (int d = 0; d < sdim; d++)
+      {
+         el_min(d,e) = el_max(d,e) = pm(d,0);
+         for (int j = 1; j < pm.Width(); j++)
+         {
+            el_min(d,e) = std::min(el_min(d,e), pm(d,j));
+            el_max(d,e) = std::max(el_max(d,e), pm(d,j));
+         }
+      }
+      const int order = nodes ? nodes->FESpace()->GetOrder(e) : 1;
+      const bool curved = (order > 1 || mesh->NURBSext);
+      if (curved)
+      {
+         RefinedGeometry *RefG =
+            GlobGeometryRefiner.Refine(mesh->GetElementBaseGeometry(e),
+                                       2*std::max(order, 1));
+         T.Transform(RefG->RefPts, pts);
+         for (int d = 0; d < sdim; d++)
+         {
+            for (int j = 0; j < pts.Width(); j++)
+            {
+               el_min(d,e) = std::min(el_min(d,e), pts(d,j));
+               el_max(d,e) = std::max(el_max(d,e), pts(d,j));
+            }
+         }
+      }
+      double size = 0.0;
+      for (int d = 0; d < sdim; d++)
+      {
+         size = std::max(size, el_max(d,e) - el_min(d,e));
+      }
+      const double pad = (curved ? 0.05 : 1e-6)*size;
+      for (int d = 0; d < sdim; d++)
+      {
+         el_min(d,e) -= pad;
+         el_max(d,e) += pad;
+      }
+   }
+
+   Setup();
+}
+
+PointLocator::PointLocator(const DenseMatrix &box_min,
+                           const DenseMatrix &box_max)
+{
+   MFEM_VERIFY(box_min.Height() == box_max.Height() &&
+               box_min.Width() == box_max.Width(), "invalid boxes");
+   mesh = NULL;
+   sequence = 0;
+   el_min = box_min;
+   el_max = box_max;
+   Setup();
+}
+
+void PointLocator::Setup()
+{
+   const int sdim = el_min.Height();
+   const int NE = el_min.Width();
+
+   // Bin sizes: approximately the average size of the boxes, limiting the
+   // total number of bins to a small multiple of the number of boxes.
+   bb_min.SetSize(sdim);
+   bb_max.SetSize(sdim);
+   nbins.SetSize(sdim);
+   h.SetSize(sdim);
+   double total_bins = 1.0;
+   for (int d = 0; d < sdim; d++)
+   {
+      double avg_size = 0.0;
+      bb_min(d) = bb_max(d) = (NE > 0) ? el_min(d,0) : 0.0;
+      for (int e = 0; e < NE; e++)
+      {
+         bb_min(d) = std::min(bb_min(d), el_min(d,e));
+         bb_max(d) = std::max(bb_max(d), el_max(d,e));
+         avg_size += el_max(d,e) - el_min(d,e);
+      }
+      avg_size /= std::max(NE, 1);
+      const double len = bb_max(d) - bb_min(d);
+      nbins[d] = (avg_size > 0.0) ? (int) std::ceil(len/avg_size) : 1;
+      nbins[d] = std::max(1, std::min(nbins[d], NE));
+      total_bins *= nbins[d];
+   }
+   const double max_bins = 8.0*std::max(NE, 1);
+   if (total_bins > max_bins)
+   {
+      const double scale = std::pow(total_bins/max_bins, 1.0/sdim);
+      for (int d = 0; d < sdim; d++)
+      {
+         nbins[d] = std::max(1, (int) std::floor(nbins[d]/scale));
+      }
+   }
+   int num_bins = 1;
+   for (int d = 0; d < sdim; d++)
+   {
+      h(d) = (bb_max(d) - bb_min(d))/nbins[d];
+      num_bins *= nbins[d];
+   }
+
+   // Bin to element table, constructed in two passes: count, then fill.
+   int b0[3] = { 0, 0, 0 }, b1[3] = { 0, 0, 0 };
+   const int nx = nbins[0];
+   const int ny = (sdim > 1) ? nbins[1] : 1;
+   bin_elements.MakeI(num_bins);
+   for (int pass = 0; pass < 2; pass++)
+   {
+      for (int e = 0; e < NE; e++)
+      {
+         for (int d = 0; d < sdim; d++)
+         {
+            GetBinRange(d, el_min(d,e), el_max(d,e), b0[d], b1[d]);
+         }
+         for (int k = b0[2]; k <= b1[2]; k++)
+         {
+            for (int j = b0[1]; j <= b1[1]; j++)
+            {
+               for (int i = b0[0]; i <= b1[0]; i++)
+               {
+                  const int b = i + nx*(j + ny*k);
+                  if (pass == 0) { bin_elements.AddAColumnInRow(b); }
+                  else { bin_elements.AddConnection(b, e); }
+               }
+            }
+         }
+      }
+      if (pass == 0) { bin_elements.MakeJ(); }
+   }
+   bin_elements.ShiftUpI();
+}
+
+void PointLocator::GetBinRange(int d, double lo, double hi,
+                               int &b0, int &b1) const
+{
+   if (h(d) == 0.0) { b0 = b1 = 0; return; }
+   b0 = (int) std::floor((lo - bb_min(d))/h(d));
+   b1 = (int) std::floor((hi - bb_min(d))/h(d));
+   b0 = std::max(0, std::min(b0, nbins[d]-1));
+   b1 = std::max(0, std::min(b1, nbins[d]-1));
+}
+
+int PointLocator::GetBin(const double *x) const
+{
+   int b = 0;
+   for (int d = nbins.Size()-1; d >= 0; d--)
+   {
+      if (x[d] < bb_min(d) || x[d] > bb_max(d)) { return -1; }
+      int b0, b1;
+      GetBinRange(d, x[d], x[d], b0, b1);
+      b = b*nbins[d] + b0;
+   }
+   return b;
+}
+
+void PointLocator::GetCandidates(const double *x, Array<int> &elems) const
+{
+   elems.SetSize(0);
+   const int b = GetBin(x);
+   if (b < 0) { return; }
+   const int sdim = nbins.Size();
+   const int *row = bin_elements.GetRow(b);
+   for (int i = 0; i < bin_elements.RowSize(b); i++)
+   {
+      const int e = row[i];
+      bool inside = true;
+      for (int d = 0; d < sdim; d++)
+      {
+         inside &= (x[d] >= el_min(d,e) && x[d] <= el_max(d,e));
+      }
+      if (inside) { elems.Append(e); }
+   }
+}
+
+
 NodeExtrudeCoefficient::NodeExtrudeCoefficient(const int dim, const int _n,
                                                const double _s)
    : VectorCoefficient(dim), n(_n), s(_s), tip(p, dim-1)
@@ -22,6 +22,7 @@
 #include "../fem/eltrans.hpp"
 #include "../fem/coefficient.hpp"
 #include "../general/gzstream.hpp"
+#include "../general/binaryio.hpp"
 #include <iostream>
 
 namespace mfem
@@ -30,6 +31,7 @@ namespace mfem
 // Data type mesh
 
 class GeometricFactors;
+class PointLocator;
 class KnotVector;
 class NURBSExtension;
 class FiniteElementSpace;
@@ -181,6 +183,7 @@ public:
    NURBSExtension *NURBSext; ///< Optional NURBS mesh extension.
    NCMesh *ncmesh;           ///< Optional non-conforming mesh extension.
    Array<GeometricFactors*> geom_factors; ///< Optional geometric factors.
+   PointLocator *point_locator; ///< Optional point location structure.
 
    // Global parameter that can be used to control the removal of unused
    // vertices performed when reading a mesh in MFEM format. The default value
@@ -217,6 +220,8 @@ protected:
    void ReadNURBSMesh(std::istream &input, int &curved, int &read_gf);
    void ReadInlineMesh(std::istream &input, bool generate_edges = false);
    void ReadGmshMesh(std::istream &input);
+   void ReadMFEMBinaryMesh(const BinaryReader &input, int &curved,
+                           int &read_gf, bool &finalize_topo);
    /* Note NetCDF (optional library) is used for reading cubit files */
 #ifdef MFEM_USE_NETCDF
    void ReadCubit(const char *filename, int &curved, int &read_gf);
@@ -703,6 +708,20 @@ public:
        for example, after the mesh nodes are modified externally. */
    void DeleteGeometricFactors();
 
+   /** @brief Return the point location structure of the mesh, used by
+       FindPoints(), constructing it if necessary. */
+   /** The structure is rebuilt automatically after the mesh is modified by
+       refinement, derefinement or rebalancing, see GetSequence(), and after the
+       nodes are modified through Mesh methods such as MoveNodes(), SetNodes(),
+       or Transform(). */
+   const PointLocator* GetPointLocator();
+
+   /// Destroy the point location structure stored by the Mesh.
+   /** This method must be called after the mesh nodes are modified externally,
+       e.g. through the GridFunction returned by GetNodes(), in order to force
+       the reconstruction of the structure in the next call to FindPoints(). */
+   void DeletePointLocator();
+
    /// Equals 1 + num_holes - num_loops
    inline int EulerNumber() const
    { return NumOfVertices - NumOfEdges + NumOfFaces - NumOfElements; }
@@ -1155,6 +1174,14 @@ public:
    /// \see mfem::ogzstream() for on-the-fly compression of ascii outputs
    virtual void Print(std::ostream &out = mfem::out) const { Printer(out); }
 
+   /** @brief Print the mesh to the given stream using MFEM's binary mesh
+       format, see BinaryWriter. */
+   /** The element connectivity and attributes, the vertices and the nodes are
+       stored as arrays that are read without parsing. The format is detected
+       by Load() and the Mesh constructors reading from files and streams.
+       NURBS and non-conforming meshes are not supported. */
+   void PrintBinary(std::ostream &out) const;
+
    /// Print the mesh in VTK format (linear and quadratic meshes only).
    /// \see mfem::ogzstream() for on-the-fly compression of ascii outputs
    void PrintVTK(std::ostream &out);
@@ -1262,6 +1289,12 @@ public:
 
        @returns The total number of points that were found.
 
+       The candidate elements for each point are obtained from the PointLocator
+       of the mesh, see GetPointLocator(), so that the cost per point does not
+       depend on the number of elements. When MFEM is built with OpenMP and
+       MFEM_THREAD_SAFE, and @a inv_trans is NULL, the points are processed in
+       parallel.
+
        @note This method is not 100 percent reliable, i.e. it is not guaranteed
        to find a point, even if it lies inside a mesh element. */
    virtual int FindPoints(DenseMatrix& point_mat, Array<int>& elem_ids,
@@ -1322,6 +1355,66 @@ public:
 };
 
 
+/** @brief Uniform grid of bins covering the bounding box of a Mesh, storing
+    for each bin the elements whose bounding boxes intersect it. */
+/** Typically objects of this type are constructed and owned by objects of class
+    Mesh. See Mesh::GetPointLocator() and Mesh::FindPoints().
+
+    The bounding box of each element contains its nodes and, for curved
+    elements, a set of sample points obtained by refining the element; it is
+    enlarged by a small fraction of its size to account for the parts of curved
+    elements that bulge out between the sample points. The number of bins in
+    each direction is chosen so that a bin has approximately the size of the
+    average element bounding box.
+
+    The structure can also be constructed from a given set of boxes, e.g. the
+    bounding boxes of the ranks of a ParMesh, see ParMesh::FindPointsGlobal();
+    in this case the "elements" below refer to the given boxes. */
+class PointLocator
+{
+public:
+   const Mesh *mesh; ///< NULL when constructed from a set of boxes.
+   long sequence; ///< The Mesh sequence when the structure was built.
+
+   PointLocator(Mesh *mesh);
+
+   /** @brief Construct the structure for the boxes with lower and upper
+       corners given by the columns of @a box_min and @a box_max. */
+   PointLocator(const DenseMatrix &box_min, const DenseMatrix &box_max);
+
+   /// Lower corner of the bounding box of the mesh.
+   Vector bb_min;
+   /// Upper corner of the bounding box of the mesh.
+   Vector bb_max;
+   /// Number of bins in each direction.
+   Array<int> nbins;
+   /// Size of the bins in each direction.
+   Vector h;
+
+   /** @brief Lower and upper corners of the element bounding boxes, arrays of
+       dimensions (SDIM x NE). */
+   DenseMatrix el_min, el_max;
+
+   /// Bin to element table; bins are ordered lexicographically.
+   Table bin_elements;
+
+   /** @brief Return the index of the bin containing the point @a x, or -1 if
+       @a x is outside of the mesh bounding box. */
+   int GetBin(const double *x) const;
+
+   /** @brief Set @a elems to the list of elements whose bounding boxes contain
+       the point @a x. */
+   void GetCandidates(const double *x, Array<int> &elems) const;
+
+protected:
+   /// Construct the bins from the boxes #el_min and #el_max.
+   void Setup();
+
+   /// Range of bins, in direction @a d, intersecting the interval [lo,hi].
+   void GetBinRange(int d, double lo, double hi, int &b0, int &b1) const;
+};
+
+
 /// Class used to extrude the nodes of a mesh
 class NodeExtrudeCoefficient : public VectorCoefficient
 {
@@ -15,6 +15,8 @@
 
 #include <iostream>
 #include <cstdio>
+#include <sstream>
+#include <algorithm>
 
 #ifdef MFEM_USE_NETCDF
 #include "netcdf.h"
@@ -113,6 +115,77 @@ void Mesh::ReadMFEMMesh(std::istream &input, bool mfem_v11, int &curved)
    if (remove_unused_vertices) { RemoveUnusedVertices(); }
 }
 
+// Create the elements stored in the binary arrays with the given prefix
+static void ReadBinaryElements(Mesh &mesh, const BinaryReader &input,
+                               const string &prefix, Array<Element*> &elems)
+{
+   Array<int> geoms, attribs, verts;
+   input.Get(prefix + "_geometries", geoms);
+   input.Get(prefix + "_attributes", attribs);
+   input.Get(prefix + "_vertices", verts);
+   MFEM_VERIFY(attribs.Size() == geoms.Size(), "invalid binary mesh");
+
+   elems.SetSize(geoms.Size());
+   int offset = 0;
+   for (int i = 0; i < geoms.Size(); i++)
+   {
+      elems[i] = mesh.NewElement(geoms[i]);
+      const int nv = elems[i]->GetNVertices();
+      MFEM_VERIFY(offset + nv <= verts.Size(), "invalid binary mesh");
+      elems[i]->SetVertices(verts.GetData() + offset);
+      elems[i]->SetAttribute(attribs[i]);
+      offset += nv;
+   }
+   MFEM_VERIFY(offset == verts.Size(), "invalid binary mesh");
+}
+
+void Mesh::ReadMFEMBinaryMesh(const BinaryReader &input, int &curved,
+                              int &read_gf, bool &finalize_topo)
+{
+   Array<int> dims;
+   input.Get("dimension", dims);
+   MFEM_VERIFY(dims.Size() == 2, "invalid binary mesh");
+   Dim = dims[0];
+   spaceDim = dims[1];
+
+   ReadBinaryElements(*this, input, "element", elements);
+   NumOfElements = elements.Size();
+   ReadBinaryElements(*this, input, "boundary", boundary);
+   NumOfBdrElements = boundary.Size();
+
+   int size;
+   const double *coords = input.GetData<double>("vertices", size);
+   NumOfVertices = size / spaceDim;
+   vertices.SetSize(NumOfVertices);
+   for (int i = 0; i < NumOfVertices; i++)
+   {
+      for (int j = 0; j < spaceDim; j++)
+      {
+         vertices[i](j) = coords[i*spaceDim + j];
+      }
+   }
+
+   if (input.Has("nodes"))
+   {
+      // The nodal FE space needs the edges and faces of the mesh
+      FinalizeTopology();
+      finalize_topo = false;
+
+      istringstream fes_header(input.GetString("nodes_fespace"));
+      FiniteElementSpace *fes = new FiniteElementSpace;
+      FiniteElementCollection *fec = fes->Load(this, fes_header);
+      Nodes = new GridFunction(fes);
+      Nodes->MakeOwner(fec); // Nodes will destroy 'fec' and 'fes'
+      own_nodes = 1;
+
+      const double *nodes = input.GetData<double>("nodes", size);
+      MFEM_VERIFY(size == Nodes->Size(), "invalid binary mesh");
+      std::copy(nodes, nodes + size, Nodes->HostWrite());
+      curved = 1;
+      read_gf = 0;
+   }
+}
+
 void Mesh::ReadLineMesh(std::istream &input)
 {
    int j,p1,p2,a;
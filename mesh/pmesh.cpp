@@ -19,9 +19,11 @@
 #include "../general/sort_pairs.hpp"
 #include "../general/text.hpp"
 #include "../general/globals.hpp"
+#include "../general/binaryio.hpp"
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 using namespace std;
 
@@ -5042,6 +5044,15 @@ void ParMesh::ParPrint(ostream &out) const
    out << "\nmfem_mesh_end" << endl;
 }
 
+void ParMesh::PrintShared(const std::string &filename, int precision) const
+{
+   std::ostringstream out;
+   out.precision(precision);
+   ParPrint(out);
+   const bool ok = WriteSharedFile(MyComm, filename, out.str());
+   MFEM_VERIFY(ok, "error writing shared mesh file " << filename);
+}
+
 int ParMesh::FindPoints(DenseMatrix& point_mat, Array<int>& elem_id,
                         Array<IntegrationPoint>& ip, bool warn,
                         InverseElementTransformation *inv_trans)
@@ -5082,6 +5093,311 @@ int ParMesh::FindPoints(DenseMatrix& point_mat, Array<int>& elem_id,
    return pts_found;
 }
 
+/** A message to another rank containing points to be located in its elements.
+    Used by ParMesh::LocatePoints(). */
+class PointQueryMessage : public VarMessage<411>
+{
+public:
+   /// Indices of the points in the point matrix of the sending rank.
+   Array<int> ids;
+   /// The point coordinates, one point per column.
+   DenseMatrix points;
+
+   typedef std::map<int, PointQueryMessage> Map;
+
+protected:
+   virtual void Encode(int)
+   {
+      std::ostringstream stream;
+      bin_io::write<int>(stream, points.Height());
+      bin_io::write<int>(stream, points.Width());
+      stream.write((const char*) points.Data(),
+                   points.Height()*points.Width()*sizeof(double));
+      data = stream.str();
+   }
+
+   virtual void Decode(int)
+   {
+      std::istringstream stream(data);
+      const int sdim = bin_io::read<int>(stream);
+      const int npts = bin_io::read<int>(stream);
+      points.SetSize(sdim, npts);
+      stream.read((char*) points.Data(), sdim*npts*sizeof(double));
+   }
+};
+
+/** A reply to a PointQueryMessage: for each point of the query, the local
+    element containing it (-1 if not found), its reference coordinates, and
+    optionally the values of a GridFunction at the point. Used by
+    ParMesh::LocatePoints(). */
+class PointReplyMessage : public VarMessage<412>
+{
+public:
+   Array<int> elem_ids;
+   Array<IntegrationPoint> ips;
+   DenseMatrix values; ///< Dimensions (vdim x npts); vdim may be 0.
+
+   typedef std::map<int, PointReplyMessage> Map;
+
+protected:
+   virtual void Encode(int)
+   {
+      std::ostringstream stream;
+      const int npts = elem_ids.Size();
+      bin_io::write<int>(stream, npts);
+      bin_io::write<int>(stream, values.Height());
+      for (int k = 0; k < npts; k++)
+      {
+         bin_io::write<int>(stream, elem_ids[k]);
+         if (elem_ids[k] < 0) { continue; }
+         bin_io::write<double>(stream, ips[k].x);
+         bin_io::write<double>(stream, ips[k].y);
+         bin_io::write<double>(stream, ips[k].z);
+         for (int i = 0; i < values.Height(); i++)
+         {
+            bin_io::write<double>(stream, values(i,k));
+         }
+      }
+      data = stream.str();
+   }
+
+   virtual void Decode(int)
+   {
+      std::istringstream stream(data);
+      const int npts = bin_io::read<int>(stream);
+      const int vdim = bin_io::read<int>(stream);
+      elem_ids.SetSize(npts);
+      ips.SetSize(npts);
+      values.SetSize(vdim, npts);
+      for (int k = 0; k < npts; k++)
+      {
+         elem_ids[k] = bin_io::read<int>(stream);
+         if (elem_ids[k] < 0) { continue; }
+         ips[k].x = bin_io::read<double>(stream);
+         ips[k].y = bin_io::read<double>(stream);
+         ips[k].z = bin_io::read<double>(stream);
+         for (int i = 0; i < vdim; i++)
+         {
+            values(i,k) = bin_io::read<double>(stream);
+         }
+      }
+   }
+};
+
+// Locate the points of a query in the local elements of 'mesh' and evaluate
+// 'gf' (if not NULL) at the points that are found.
+static void LocalPointSearch(Mesh &mesh, const GridFunction *gf,
+                             DenseMatrix &points, PointReplyMessage &reply)
+{
+   const int n = points.Width();
+   reply.elem_ids.SetSize(n);
+   reply.ips.SetSize(n);
+   reply.values.SetSize(gf ? gf->VectorDim() : 0, n);
+   if (n == 0) { return; }
+   mesh.Mesh::FindPoints(points, reply.elem_ids, reply.ips, false);
+   if (!gf) { return; }
+   Vector val;
+   for (int k = 0; k < n; k++)
+   {
+      if (reply.elem_ids[k] < 0) { continue; }
+      reply.values.GetColumnReference(k, val);
+      gf->GetVectorValue(reply.elem_ids[k], reply.ips[k], val);
+   }
+}
+
+int ParMesh::FindPointsGlobal(const DenseMatrix &point_mat, Array<int> &ranks,
+                              Array<int> &elem_ids,
+                              Array<IntegrationPoint> &ips, bool warn)
+{
+   DenseMatrix values;
+   return LocatePoints(point_mat, NULL, ranks, elem_ids, ips, values, warn);
+}
+
+int ParMesh::LocatePoints(const DenseMatrix &point_mat, const GridFunction *gf,
+                          Array<int> &ranks, Array<int> &elem_ids,
+                          Array<IntegrationPoint> &ips, DenseMatrix &values,
+                          bool warn)
+{
+   const int npts = point_mat.Width();
+   const int sdim = spaceDim;
+   const int vdim = gf ? gf->VectorDim() : 0;
+   MFEM_VERIFY(npts == 0 || point_mat.Height() == sdim,
+               "Invalid points matrix");
+   MFEM_VERIFY(!gf || gf->FESpace()->GetMesh() == this,
+               "the GridFunction must be defined on this mesh");
+   ranks.SetSize(npts);
+   elem_ids.SetSize(npts);
+   ips.SetSize(npts);
+   values.SetSize(vdim, npts);
+   ranks = -1;
+   elem_ids = -1;
+   values = 0.0;
+
+   // Exchange the bounding boxes of the ranks; empty ranks are marked with
+   // an inverted box.
+   Vector my_box(2*sdim), all_boxes(2*sdim*NRanks);
+   if (GetNE() > 0)
+   {
+      const PointLocator &locator = *GetPointLocator();
+      for (int d = 0; d < sdim; d++)
+      {
+         my_box(d) = locator.bb_min(d);
+         my_box(sdim+d) = locator.bb_max(d);
+      }
+   }
+   else
+   {
+      my_box = 0.0;
+      my_box(0) = 1.0;
+      my_box(sdim) = -1.0;
+   }
+   MPI_Allgather(my_box.GetData(), 2*sdim, MPI_DOUBLE, all_boxes.GetData(),
+                 2*sdim, MPI_DOUBLE, MyComm);
+
+   Array<int> box_rank;
+   for (int r = 0; r < NRanks; r++)
+   {
+      if (all_boxes(2*sdim*r) <= all_boxes(2*sdim*r+sdim))
+      {
+         box_rank.Append(r);
+      }
+   }
+   DenseMatrix box_min(sdim, box_rank.Size()), box_max(sdim, box_rank.Size());
+   for (int i = 0; i < box_rank.Size(); i++)
+   {
+      const double *box = all_boxes.GetData() + 2*sdim*box_rank[i];
+      for (int d = 0; d < sdim; d++)
+      {
+         box_min(d,i) = box[d];
+         box_max(d,i) = box[sdim+d];
+      }
+   }
+
+   // Route each point to the ranks whose bounding boxes contain it; the points
+   // for this rank are kept in 'local'.
+   PointQueryMessage::Map send_queries;
+   PointQueryMessage local;
+   if (box_rank.Size() > 0)
+   {
+      PointLocator rank_locator(box_min, box_max);
+      Array<int> candidates;
+      Array<int> num_pts(NRanks);
+      num_pts = 0;
+      for (int k = 0; k < npts; k++)
+      {
+         rank_locator.GetCandidates(point_mat.GetColumn(k), candidates);
+         for (int i = 0; i < candidates.Size(); i++)
+         {
+            const int r = box_rank[candidates[i]];
+            PointQueryMessage &msg = (r == MyRank) ? local : send_queries[r];
+            msg.ids.Append(k);
+            num_pts[r]++;
+         }
+      }
+      for (int r = 0; r < NRanks; r++)
+      {
+         if (num_pts[r] == 0) { continue; }
+         PointQueryMessage &msg = (r == MyRank) ? local : send_queries[r];
+         msg.points.SetSize(sdim, num_pts[r]);
+         for (int i = 0; i < num_pts[r]; i++)
+         {
+            for (int d = 0; d < sdim; d++)
+            {
+               msg.points(d,i) = point_mat(d,msg.ids[i]);
+            }
+         }
+      }
+   }
+
+   // Number of incoming queries: sum over the ranks of the destination flags.
+   Array<int> dest(NRanks);
+   dest = 0;
+   for (PointQueryMessage::Map::iterator it = send_queries.begin();
+        it != send_queries.end(); ++it)
+   {
+      dest[it->first] = 1;
+   }
+   int num_incoming;
+   MPI_Reduce_scatter_block(dest.GetData(), &num_incoming, 1, MPI_INT,
+                            MPI_SUM, MyComm);
+
+   PointQueryMessage::IsendAll(send_queries, MyComm);
+
+   // Locate the points of the received queries in the local elements and send
+   // back the replies; the local query is processed while the messages are in
+   // flight.
+   PointQueryMessage::Map recv_queries;
+   for (int i = 0; i < num_incoming; i++)
+   {
+      int rank, size;
+      PointQueryMessage::Probe(rank, size, MyComm);
+      recv_queries[rank].Recv(rank, size, MyComm);
+   }
+   PointReplyMessage::Map send_replies;
+   for (PointQueryMessage::Map::iterator it = recv_queries.begin();
+        it != recv_queries.end(); ++it)
+   {
+      LocalPointSearch(*this, gf, it->second.points, send_replies[it->first]);
+   }
+   PointReplyMessage::IsendAll(send_replies, MyComm);
+
+   PointReplyMessage local_reply;
+   LocalPointSearch(*this, gf, local.points, local_reply);
+
+   // Receive the replies and combine them with the local results; if several
+   // ranks found a point, choose the one with the minimal rank.
+   PointReplyMessage::Map recv_replies;
+   for (PointQueryMessage::Map::iterator it = send_queries.begin();
+        it != send_queries.end(); ++it)
+   {
+      recv_replies[it->first];
+   }
+   PointReplyMessage::RecvAll(recv_replies, MyComm);
+   for (int r = 0; r < NRanks; r++)
+   {
+      const PointReplyMessage *reply;
+      const Array<int> *ids;
+      if (r == MyRank)
+      {
+         reply = &local_reply;
+         ids = &local.ids;
+      }
+      else
+      {
+         PointReplyMessage::Map::iterator it = recv_replies.find(r);
+         if (it == recv_replies.end()) { continue; }
+         reply = &it->second;
+         ids = &send_queries[r].ids;
+      }
+      for (int i = 0; i < ids->Size(); i++)
+      {
+         const int k = (*ids)[i];
+         if (reply->elem_ids[i] < 0 || ranks[k] >= 0) { continue; }
+         ranks[k] = r;
+         elem_ids[k] = reply->elem_ids[i];
+         ips[k] = reply->ips[i];
+         for (int j = 0; j < vdim; j++)
+         {
+            values(j,k) = reply->values(j,i);
+         }
+      }
+   }
+
+   PointQueryMessage::WaitAllSent(send_queries);
+   PointReplyMessage::WaitAllSent(send_replies);
+
+   int pts_found = 0;
+   for (int k = 0; k < npts; k++)
+   {
+      if (ranks[k] >= 0) { pts_found++; }
+   }
+   if (warn && pts_found != npts)
+   {
+      MFEM_WARNING((npts-pts_found) << " points were not found");
+   }
+   return pts_found;
+}
+
 static void PrintVertex(const Vertex &v, int space_dim, ostream &out)
 {
    out << v(0);
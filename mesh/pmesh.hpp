@@ -190,6 +190,13 @@ protected:
    void BuildSharedVertMapping(int nvert, const Table* vert_element,
                                const Array<int> &vert_global_local);
 
+   /** @brief Implementation of FindPointsGlobal(); when @a gf is not NULL, the
+       GridFunction @a gf, defined on this mesh, is also evaluated at the found
+       points and the values are returned in the columns of @a values. */
+   int LocatePoints(const DenseMatrix &point_mat, const GridFunction *gf,
+                    Array<int> &ranks, Array<int> &elem_ids,
+                    Array<IntegrationPoint> &ips, DenseMatrix &values,
+                    bool warn);
 
 public:
    /** Copy constructor. Performs a deep copy of (almost) all data, so that the
@@ -319,16 +326,49 @@ public:
    /// Save the mesh in a parallel mesh format.
    void ParPrint(std::ostream &out) const;
 
+   /** @brief Collectively save the mesh in the parallel mesh format of
+       ParPrint() into the single file @a filename, see WriteSharedFile(). */
+   /** The partition of each rank can be read back on the same number of ranks
+       with ReadSharedFile() and the constructor ParMesh(MPI_Comm,
+       std::istream &), without repartitioning. */
+   void PrintShared(const std::string &filename, int precision = 16) const;
+
    virtual int FindPoints(DenseMatrix& point_mat, Array<int>& elem_ids,
                           Array<IntegrationPoint>& ips, bool warn = true,
                           InverseElementTransformation *inv_trans = NULL);
 
+   /** @brief Find the ranks, elements and reference coordinates of the given
+       points, which may be different on each rank. */
+   /** The DenseMatrix @a point_mat contains the local points to be located,
+       one point per column; it should have SpaceDimension() rows. Unlike
+       FindPoints(), each rank may specify its own set of points. The bounding
+       boxes of all ranks are exchanged and each point is sent only to the
+       ranks whose bounding boxes contain it. These ranks search their local
+       elements using the PointLocator of the mesh and send back the results.
+
+       On return, for the i-th point, @a ranks[i] is the rank owning the element
+       containing the point, @a elem_ids[i] is the local index of that element
+       on rank @a ranks[i], and @a ips[i] is the point in the reference space of
+       the element. If the point is found by multiple ranks, the minimal rank is
+       chosen. If the point is not found, @a ranks[i] and @a elem_ids[i] are set
+       to -1.
+
+       This method must be called by all ranks of the mesh communicator.
+
+       @returns The number of local points that were found.
+
+       See also ParGridFunction::GetValuesAtPoints(). */
+   int FindPointsGlobal(const DenseMatrix &point_mat, Array<int> &ranks,
+                        Array<int> &elem_ids, Array<IntegrationPoint> &ips,
+                        bool warn = true);
+
    /// Debugging method
    void PrintSharedEntities(const char *fname_prefix) const;
 
    virtual ~ParMesh();
 
    friend class ParNCMesh;
+   friend class ParGridFunction;
 #ifdef MFEM_USE_PUMI
    friend class ParPumiMesh;
 #endif
@@ -29,6 +29,7 @@
 #include "general/socketstream.hpp"
 #include "general/optparser.hpp"
 #include "general/gzstream.hpp"
+#include "general/binaryio.hpp"
 #include "general/version.hpp"
 #include "general/globals.hpp"
 #ifdef MFEM_USE_MPI
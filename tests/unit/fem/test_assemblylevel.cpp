@@ -0,0 +1,907 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace assemblylevel
+{
+
+double coeff(const Vector &x)
+{
+   return 1.0 + x[0]*x[0] + 0.5*x[1];
+}
+
+void matcoeff(const Vector &x, DenseMatrix &m)
+{
+   const int dim = x.Size();
+   m.SetSize(dim);
+   for (int i = 0; i < dim; i++)
+   {
+      for (int j = 0; j < dim; j++)
+      {
+         m(i,j) = (i == j) ? 2.0 + x[i] : 0.1*(x[0] + x[1]);
+      }
+   }
+}
+
+void velocity(const Vector &x, Vector &v)
+{
+   const int dim = x.Size();
+   v.SetSize(dim);
+   v(0) = 1.0 + 0.5*x[1];
+   v(1) = -0.5 + x[0]*x[0];
+   if (dim == 3) { v(2) = 0.25 - x[0]*x[1]; }
+}
+
+Mesh *MakeMesh(int dim)
+{
+   Mesh *mesh;
+   if (dim == 2) { mesh = new Mesh(3, 3, Element::QUADRILATERAL, true); }
+   else { mesh = new Mesh(2, 2, 2, Element::HEXAHEDRON, true); }
+   // Perturb the vertices to get non-affine elements
+   mesh->EnsureNodes();
+   GridFunction *nodes = mesh->GetNodes();
+   for (int i = 0; i < nodes->Size(); i++)
+   {
+      (*nodes)(i) += 0.02*std::sin(7.0*i);
+   }
+   for (int i = 0; i < mesh->GetNE(); i++)
+   {
+      mesh->SetAttribute(i, 1 + i%3);
+   }
+   return mesh;
+}
+
+// Same as MakeMesh, with the local vertex orderings of the elements rotated,
+// so that the orientations of the edges and faces of neighbors differ.
+Mesh *MakeRotatedMesh(int dim)
+{
+   Mesh *orig = MakeMesh(dim);
+   Mesh *mesh = new Mesh(dim, orig->GetNV(), orig->GetNE(), 0, dim);
+   for (int i = 0; i < orig->GetNV(); i++)
+   {
+      mesh->AddVertex(orig->GetVertex(i));
+   }
+   for (int e = 0; e < orig->GetNE(); e++)
+   {
+      const int *v = orig->GetElement(e)->GetVertices();
+      int rv[8];
+      for (int k = 0; k < 4; k++)
+      {
+         rv[k] = v[(k + e) % 4];
+         if (dim == 3) { rv[k+4] = v[4 + (k + e) % 4]; }
+      }
+      if (dim == 2) { mesh->AddQuad(rv, orig->GetAttribute(e)); }
+      else { mesh->AddHex(rv, orig->GetAttribute(e)); }
+   }
+   if (dim == 2) { mesh->FinalizeQuadMesh(1, 1, true); }
+   else { mesh->FinalizeHexMesh(1, 1, true); }
+   // Copy the perturbed nodes
+   mesh->EnsureNodes();
+   *mesh->GetNodes() = *orig->GetNodes();
+   delete orig;
+   return mesh;
+}
+
+// Compare the action of a bilinear form using the given assembly level with
+// the action of the fully assembled form. The diffusion term uses the matrix
+// coefficient @a mq when it is not NULL and @a q otherwise.
+double CompareAction(AssemblyLevel level, FiniteElementSpace &fes,
+                     Coefficient *q, MatrixCoefficient *mq,
+                     bool mass, bool diffusion)
+{
+   BilinearForm a_full(&fes), a_test(&fes);
+   if (mass)
+   {
+      a_full.AddDomainIntegrator(new MassIntegrator(*q));
+      a_test.AddDomainIntegrator(new MassIntegrator(*q));
+   }
+   if (diffusion && mq)
+   {
+      a_full.AddDomainIntegrator(new DiffusionIntegrator(*mq));
+      a_test.AddDomainIntegrator(new DiffusionIntegrator(*mq));
+   }
+   else if (diffusion)
+   {
+      a_full.AddDomainIntegrator(new DiffusionIntegrator(*q));
+      a_test.AddDomainIntegrator(new DiffusionIntegrator(*q));
+   }
+   a_test.SetAssemblyLevel(level);
+   a_full.Assemble();
+   a_full.Finalize();
+   a_test.Assemble();
+
+   GridFunction x(&fes), y_full(&fes), y_test(&fes);
+   x.Randomize(1);
+   a_full.Mult(x, y_full);
+   Array<int> no_bc;
+   OperatorHandle A;
+   a_test.FormSystemMatrix(no_bc, A);
+   A->Mult(x, y_test);
+   y_test -= y_full;
+   return y_test.Normlinf() / y_full.Normlinf();
+}
+
+double CompareAction(AssemblyLevel level, int dim, int order,
+                     Coefficient &q, bool mass, bool diffusion)
+{
+   Mesh *mesh = MakeMesh(dim);
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec);
+   const double err = CompareAction(level, fes, &q, NULL, mass, diffusion);
+   delete mesh;
+   return err;
+}
+
+TEST_CASE("Element assembly", "[AssemblyLevel]")
+{
+   ConstantCoefficient one(1.0);
+   FunctionCoefficient fcoeff(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 3; order++)
+      {
+         SECTION("Constant coefficient, dim = " + std::to_string(dim) +
+                 ", order = " + std::to_string(order))
+         {
+            REQUIRE(CompareAction(AssemblyLevel::ELEMENT, dim, order, one,
+                                  true, true) < 1e-12);
+         }
+         SECTION("Function coefficient, dim = " + std::to_string(dim) +
+                 ", order = " + std::to_string(order))
+         {
+            REQUIRE(CompareAction(AssemblyLevel::ELEMENT, dim, order, fcoeff,
+                                  true, true) < 1e-12);
+         }
+      }
+   }
+}
+
+TEST_CASE("Full assembly", "[AssemblyLevel]")
+{
+   ConstantCoefficient one(1.0);
+   FunctionCoefficient fcoeff(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 3; order++)
+      {
+         SECTION("Constant coefficient, dim = " + std::to_string(dim) +
+                 ", order = " + std::to_string(order))
+         {
+            REQUIRE(CompareAction(AssemblyLevel::DEVICEFULL, dim, order, one,
+                                  true, true) < 1e-12);
+         }
+         SECTION("Function coefficient, dim = " + std::to_string(dim) +
+                 ", order = " + std::to_string(order))
+         {
+            REQUIRE(CompareAction(AssemblyLevel::DEVICEFULL, dim, order, fcoeff,
+                                  true, false) < 1e-12);
+         }
+      }
+   }
+
+   SECTION("Re-assembly reuses the sparsity pattern")
+   {
+      Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      ConstantCoefficient c(2.0);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(c));
+      a.SetAssemblyLevel(AssemblyLevel::DEVICEFULL);
+      a.Assemble();
+      const int *I = a.SpMat().GetI();
+      const double norm = a.SpMat().MaxNorm();
+      c.constant = 4.0;
+      a.Update();
+      a.Assemble();
+      REQUIRE(a.SpMat().GetI() == I);
+      REQUIRE(std::abs(a.SpMat().MaxNorm() - 2.0*norm) < 1e-12*norm);
+   }
+
+   for (int ordering = Ordering::byNODES; ordering <= Ordering::byVDIM;
+        ordering++)
+   {
+      SECTION("Vector space, ordering = " + std::to_string(ordering))
+      {
+         Mesh mesh(3, 3, Element::QUADRILATERAL, true);
+         H1_FECollection fec(2, 2);
+         FiniteElementSpace fes(&mesh, &fec, 2, ordering);
+         ConstantCoefficient one(1.0);
+         BilinearForm a_full(&fes), a_dev(&fes);
+         BilinearForm *forms[2] = { &a_full, &a_dev };
+         for (int k = 0; k < 2; k++)
+         {
+            forms[k]->AddDomainIntegrator(new VectorMassIntegrator);
+            forms[k]->AddDomainIntegrator(new ElasticityIntegrator(one, one));
+         }
+         a_dev.SetAssemblyLevel(AssemblyLevel::DEVICEFULL);
+         a_full.Assemble();
+         a_full.Finalize();
+         a_dev.Assemble();
+         REQUIRE(a_dev.SpMat().Height() == fes.GetVSize());
+
+         GridFunction x(&fes), y_full(&fes), y_dev(&fes);
+         x.Randomize(1);
+         a_full.SpMat().Mult(x, y_full);
+         a_dev.SpMat().Mult(x, y_dev);
+         y_dev -= y_full;
+         REQUIRE(y_dev.Normlinf() < 1e-12*y_full.Normlinf());
+      }
+   }
+}
+
+TEST_CASE("Partial assembly coefficients", "[AssemblyLevel]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 3; order++)
+      {
+         Mesh *mesh = MakeMesh(dim);
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(mesh, &fec);
+         const std::string name = "dim = " + std::to_string(dim) +
+                                  ", order = " + std::to_string(order);
+
+         SECTION("No coefficient, " + name)
+         {
+            BilinearForm a_full(&fes), a_pa(&fes);
+            a_full.AddDomainIntegrator(new MassIntegrator);
+            a_full.AddDomainIntegrator(new DiffusionIntegrator);
+            a_pa.AddDomainIntegrator(new MassIntegrator);
+            a_pa.AddDomainIntegrator(new DiffusionIntegrator);
+            a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            a_full.Assemble();
+            a_full.Finalize();
+            a_pa.Assemble();
+            GridFunction x(&fes), y_full(&fes), y_pa(&fes);
+            x.Randomize(1);
+            a_full.Mult(x, y_full);
+            Array<int> no_bc;
+            OperatorHandle A;
+            a_pa.FormSystemMatrix(no_bc, A);
+            A->Mult(x, y_pa);
+            y_pa -= y_full;
+            REQUIRE(y_pa.Normlinf() < 1e-12*y_full.Normlinf());
+         }
+         SECTION("FunctionCoefficient, " + name)
+         {
+            FunctionCoefficient fcoeff(coeff);
+            REQUIRE(CompareAction(AssemblyLevel::PARTIAL, fes, &fcoeff, NULL,
+                                  true, true) < 1e-12);
+         }
+         SECTION("GridFunctionCoefficient, " + name)
+         {
+            H1_FECollection gf_fec(2, dim);
+            FiniteElementSpace gf_fes(mesh, &gf_fec);
+            GridFunction gf(&gf_fes);
+            FunctionCoefficient fcoeff(coeff);
+            gf.ProjectCoefficient(fcoeff);
+            GridFunctionCoefficient gf_coeff(&gf);
+            REQUIRE(CompareAction(AssemblyLevel::PARTIAL, fes, &gf_coeff, NULL,
+                                  true, true) < 1e-12);
+         }
+         SECTION("L2 GridFunctionCoefficient, " + name)
+         {
+            L2_FECollection gf_fec(1, dim);
+            FiniteElementSpace gf_fes(mesh, &gf_fec);
+            GridFunction gf(&gf_fes);
+            FunctionCoefficient fcoeff(coeff);
+            gf.ProjectCoefficient(fcoeff);
+            GridFunctionCoefficient gf_coeff(&gf);
+            REQUIRE(CompareAction(AssemblyLevel::PARTIAL, fes, &gf_coeff, NULL,
+                                  true, true) < 1e-12);
+         }
+         SECTION("PWConstCoefficient, " + name)
+         {
+            Vector vals(3);
+            vals(0) = 1.0; vals(1) = 5.0; vals(2) = 0.5;
+            PWConstCoefficient pw_coeff(vals);
+            REQUIRE(CompareAction(AssemblyLevel::PARTIAL, fes, &pw_coeff, NULL,
+                                  true, true) < 1e-12);
+            REQUIRE(CompareAction(AssemblyLevel::ELEMENT, fes, &pw_coeff, NULL,
+                                  true, true) < 1e-12);
+         }
+         SECTION("MatrixCoefficient, " + name)
+         {
+            MatrixFunctionCoefficient mcoeff(dim, matcoeff);
+            REQUIRE(CompareAction(AssemblyLevel::PARTIAL, fes, NULL, &mcoeff,
+                                  false, true) < 1e-12);
+            REQUIRE(CompareAction(AssemblyLevel::ELEMENT, fes, NULL, &mcoeff,
+                                  false, true) < 1e-12);
+         }
+         delete mesh;
+      }
+   }
+}
+
+TEST_CASE("Matrix-free action", "[AssemblyLevel]")
+{
+   ConstantCoefficient c(2.5);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 3; order++)
+      {
+         SECTION("dim = " + std::to_string(dim) +
+                 ", order = " + std::to_string(order))
+         {
+            REQUIRE(CompareAction(AssemblyLevel::NONE, dim, order, c,
+                                  true, false) < 1e-12);
+            REQUIRE(CompareAction(AssemblyLevel::NONE, dim, order, c,
+                                  false, true) < 1e-12);
+            REQUIRE(CompareAction(AssemblyLevel::NONE, dim, order, c,
+                                  true, true) < 1e-12);
+         }
+      }
+   }
+}
+
+// Compare the action and the transpose action of the partially assembled DG
+// advection operator of example 9 with the fully assembled matrix.
+double CompareDGAdvection(FiniteElementSpace &fes, bool transpose_trace,
+                          Coefficient *rho)
+{
+   const int dim = fes.GetMesh()->Dimension();
+   VectorFunctionCoefficient vel(dim, velocity);
+   BilinearForm a_full(&fes), a_pa(&fes);
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   BilinearForm *forms[2] = { &a_full, &a_pa };
+   for (int i = 0; i < 2; i++)
+   {
+      forms[i]->AddDomainIntegrator(new ConvectionIntegrator(vel, -1.0));
+      for (int bdr = 0; bdr < 2; bdr++)
+      {
+         BilinearFormIntegrator *bfi = rho ?
+                                       new DGTraceIntegrator(*rho, vel, 1.0, -0.5) :
+                                       new DGTraceIntegrator(vel, 1.0, -0.5);
+         if (transpose_trace) { bfi = new TransposeIntegrator(bfi); }
+         if (bdr) { forms[i]->AddBdrFaceIntegrator(bfi); }
+         else { forms[i]->AddInteriorFaceIntegrator(bfi); }
+      }
+   }
+   a_full.Assemble(0);
+   a_full.Finalize(0);
+   a_pa.Assemble();
+
+   Array<int> no_bc;
+   OperatorHandle A;
+   a_pa.FormSystemMatrix(no_bc, A);
+   GridFunction x(&fes), y_full(&fes), y_pa(&fes);
+   x.Randomize(1);
+   a_full.Mult(x, y_full);
+   A->Mult(x, y_pa);
+   y_pa -= y_full;
+   double err = y_pa.Normlinf() / y_full.Normlinf();
+   a_full.MultTranspose(x, y_full);
+   A->MultTranspose(x, y_pa);
+   y_pa -= y_full;
+   return std::max(err, y_pa.Normlinf() / y_full.Normlinf());
+}
+
+TEST_CASE("Partial assembly of DG advection", "[AssemblyLevel]")
+{
+   FunctionCoefficient rho(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 3; order++)
+      {
+         Mesh *mesh = MakeMesh(dim);
+         const std::string name = "dim = " + std::to_string(dim) +
+                                  ", order = " + std::to_string(order);
+
+         SECTION("GaussLegendre basis, " + name)
+         {
+            L2_FECollection fec(order, dim, BasisType::GaussLegendre);
+            FiniteElementSpace fes(mesh, &fec);
+            REQUIRE(CompareDGAdvection(fes, true, NULL) < 1e-12);
+            REQUIRE(CompareDGAdvection(fes, false, &rho) < 1e-12);
+         }
+         SECTION("GaussLobatto basis, " + name)
+         {
+            L2_FECollection fec(order, dim, BasisType::GaussLobatto);
+            FiniteElementSpace fes(mesh, &fec);
+            REQUIRE(CompareDGAdvection(fes, true, NULL) < 1e-12);
+            REQUIRE(CompareDGAdvection(fes, false, &rho) < 1e-12);
+         }
+         SECTION("Continuous space, " + name)
+         {
+            H1_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            REQUIRE(CompareDGAdvection(fes, true, NULL) < 1e-12);
+         }
+         delete mesh;
+      }
+   }
+
+   SECTION("Face restriction")
+   {
+      Mesh mesh(3, 2, Element::QUADRILATERAL, true);
+      L2_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      const Operator *R_int = fes.GetFaceRestriction(FaceType::Interior);
+      const Operator *R_bdr = fes.GetFaceRestriction(FaceType::Boundary);
+      // 7 interior and 10 boundary edges with 3 nodes each
+      REQUIRE(R_int->Height() == 7*2*3);
+      REQUIRE(R_bdr->Height() == 10*3);
+      // The traces of a continuous function match on the interior faces
+      FunctionCoefficient fcoeff(coeff);
+      GridFunction x(&fes);
+      x.ProjectCoefficient(fcoeff);
+      Vector xf(R_int->Height());
+      R_int->Mult(x, xf);
+      double jump = 0.0;
+      for (int f = 0; f < 7; f++)
+      {
+         for (int k = 0; k < 3; k++)
+         {
+            jump = std::max(jump, std::abs(xf(k + 3*2*f) - xf(k + 3*(2*f+1))));
+         }
+      }
+      REQUIRE(jump < 1e-12);
+      // MultTranspose is the transpose of Mult
+      Vector yf(R_int->Height()), y(fes.GetVSize());
+      yf.Randomize(2);
+      R_int->MultTranspose(yf, y);
+      REQUIRE(std::abs((y*x) - (yf*xf)) < 1e-12*std::abs(yf*xf));
+   }
+}
+
+// Compare the diagonal of a bilinear form using the given assembly level with
+// the diagonal of the fully assembled matrix.
+double CompareDiagonal(AssemblyLevel level, FiniteElementSpace &fes,
+                       Coefficient *q, MatrixCoefficient *mq,
+                       bool mass, bool diffusion)
+{
+   BilinearForm a_full(&fes), a_test(&fes);
+   if (mass)
+   {
+      a_full.AddDomainIntegrator(new MassIntegrator(*q));
+      a_test.AddDomainIntegrator(new MassIntegrator(*q));
+   }
+   if (diffusion && mq)
+   {
+      a_full.AddDomainIntegrator(new DiffusionIntegrator(*mq));
+      a_test.AddDomainIntegrator(new DiffusionIntegrator(*mq));
+   }
+   else if (diffusion)
+   {
+      a_full.AddDomainIntegrator(new DiffusionIntegrator(*q));
+      a_test.AddDomainIntegrator(new DiffusionIntegrator(*q));
+   }
+   a_test.SetAssemblyLevel(level);
+   a_full.Assemble();
+   a_full.Finalize();
+   a_test.Assemble();
+
+   Vector d_full, d_test;
+   a_full.SpMat().GetDiag(d_full);
+   a_test.AssembleDiagonal(d_test);
+   REQUIRE(d_test.Size() == fes.GetTrueVSize());
+   d_test -= d_full;
+   return d_test.Normlinf() / d_full.Normlinf();
+}
+
+TEST_CASE("Operator diagonal", "[AssemblyLevel]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 4; order++)
+      {
+         Mesh *mesh = MakeMesh(dim);
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(mesh, &fec);
+         FunctionCoefficient fcoeff(coeff);
+         MatrixFunctionCoefficient mcoeff(dim, matcoeff);
+         const std::string name = "dim = " + std::to_string(dim) +
+                                  ", order = " + std::to_string(order);
+
+         SECTION("Partial assembly, " + name)
+         {
+            REQUIRE(CompareDiagonal(AssemblyLevel::PARTIAL, fes, &fcoeff,
+                                    NULL, true, false) < 1e-12);
+            REQUIRE(CompareDiagonal(AssemblyLevel::PARTIAL, fes, &fcoeff,
+                                    NULL, false, true) < 1e-12);
+            REQUIRE(CompareDiagonal(AssemblyLevel::PARTIAL, fes, &fcoeff,
+                                    &mcoeff, true, true) < 1e-12);
+         }
+         SECTION("Element and legacy assembly, " + name)
+         {
+            REQUIRE(CompareDiagonal(AssemblyLevel::ELEMENT, fes, &fcoeff,
+                                    &mcoeff, true, true) < 1e-12);
+            REQUIRE(CompareDiagonal(AssemblyLevel::FULL, fes, &fcoeff,
+                                    NULL, true, true) < 1e-12);
+         }
+         delete mesh;
+      }
+   }
+
+   SECTION("Non-conforming mesh")
+   {
+      Mesh mesh(2, 2, Element::QUADRILATERAL, true);
+      mesh.EnsureNCMesh();
+      Array<int> refs;
+      refs.Append(0);
+      mesh.GeneralRefinement(refs);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      REQUIRE(fes.GetTrueVSize() < fes.GetVSize());
+      ConstantCoefficient one(1.0);
+      BilinearForm a_pa(&fes), a_full(&fes);
+      a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      a_pa.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_full.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_pa.Assemble();
+      a_full.Assemble();
+      Vector d_pa, d_full;
+      a_pa.AssembleDiagonal(d_pa);
+      a_full.AssembleDiagonal(d_full);
+      REQUIRE(d_pa.Size() == fes.GetTrueVSize());
+      d_pa -= d_full;
+      REQUIRE(d_pa.Normlinf() < 1e-12*d_full.Normlinf());
+   }
+}
+
+// Compare the action of the partially assembled H(curl) mass and curl-curl
+// operators with the fully assembled matrices.
+double CompareHcurl(FiniteElementSpace &fes, Coefficient &q, bool mass,
+                    bool curlcurl)
+{
+   BilinearForm a_full(&fes), a_pa(&fes);
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   BilinearForm *forms[2] = { &a_full, &a_pa };
+   for (int i = 0; i < 2; i++)
+   {
+      if (mass)
+      {
+         forms[i]->AddDomainIntegrator(new VectorFEMassIntegrator(q));
+      }
+      if (curlcurl)
+      {
+         forms[i]->AddDomainIntegrator(new CurlCurlIntegrator(q));
+      }
+   }
+   a_full.Assemble();
+   a_full.Finalize();
+   a_pa.Assemble();
+
+   Array<int> no_bc;
+   OperatorHandle A;
+   a_pa.FormSystemMatrix(no_bc, A);
+   GridFunction x(&fes), y_full(&fes), y_pa(&fes);
+   x.Randomize(1);
+   a_full.Mult(x, y_full);
+   A->Mult(x, y_pa);
+   y_pa -= y_full;
+   return y_pa.Normlinf() / y_full.Normlinf();
+}
+
+TEST_CASE("Partial assembly in H(curl)", "[AssemblyLevel]")
+{
+   FunctionCoefficient fcoeff(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 3; order++)
+      {
+         const std::string name = "dim = " + std::to_string(dim) +
+                                  ", order = " + std::to_string(order);
+         ND_FECollection fec(order, dim);
+
+         SECTION("Aligned elements, " + name)
+         {
+            Mesh *mesh = MakeMesh(dim);
+            FiniteElementSpace fes(mesh, &fec);
+            REQUIRE(CompareHcurl(fes, fcoeff, true, false) < 1e-12);
+            REQUIRE(CompareHcurl(fes, fcoeff, false, true) < 1e-12);
+            delete mesh;
+         }
+         SECTION("Rotated elements, " + name)
+         {
+            Mesh *mesh = MakeRotatedMesh(dim);
+            FiniteElementSpace fes(mesh, &fec);
+            REQUIRE(CompareHcurl(fes, fcoeff, true, true) < 1e-12);
+            delete mesh;
+         }
+      }
+   }
+}
+
+
+// Compare the action and the diagonal of the partially assembled H(div) mass
+// and div-div operators with the fully assembled matrices.
+double CompareHdiv(FiniteElementSpace &fes, Coefficient &q, bool mass,
+                   bool divdiv)
+{
+   BilinearForm a_full(&fes), a_pa(&fes);
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   BilinearForm *forms[2] = { &a_full, &a_pa };
+   for (int i = 0; i < 2; i++)
+   {
+      if (mass)
+      {
+         forms[i]->AddDomainIntegrator(new VectorFEMassIntegrator(q));
+      }
+      if (divdiv)
+      {
+         forms[i]->AddDomainIntegrator(new DivDivIntegrator(q));
+      }
+   }
+   a_full.Assemble();
+   a_full.Finalize();
+   a_pa.Assemble();
+
+   GridFunction x(&fes), y_full(&fes), y_pa(&fes);
+   x.Randomize(1);
+   a_full.Mult(x, y_full);
+   a_pa.Mult(x, y_pa);
+   y_pa -= y_full;
+   double err = y_pa.Normlinf() / y_full.Normlinf();
+   if (!divdiv)
+   {
+      Vector diag_full, diag_pa;
+      a_full.SpMat().GetDiag(diag_full);
+      a_pa.AssembleDiagonal(diag_pa);
+      diag_pa -= diag_full;
+      err = std::max(err, diag_pa.Normlinf() / diag_full.Normlinf());
+   }
+   return err;
+}
+
+// Compare the action, the transposed action and the diagonal of B D B^T of
+// the partially assembled mixed H(div)-L2 divergence operator B with the
+// fully assembled matrix.
+double CompareMixedDivergence(FiniteElementSpace &rt_fes,
+                              FiniteElementSpace &l2_fes, Coefficient &q)
+{
+   MixedBilinearForm b_full(&rt_fes, &l2_fes), b_pa(&rt_fes, &l2_fes);
+   b_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   b_full.AddDomainIntegrator(new VectorFEDivergenceIntegrator(q));
+   b_pa.AddDomainIntegrator(new VectorFEDivergenceIntegrator(q));
+   b_full.Assemble();
+   b_full.Finalize();
+   b_pa.Assemble();
+
+   Vector x(rt_fes.GetVSize()), y_full(l2_fes.GetVSize()),
+          y_pa(l2_fes.GetVSize());
+   x.Randomize(1);
+   b_full.Mult(x, y_full);
+   b_pa.Mult(x, y_pa);
+   y_pa -= y_full;
+   double err = y_pa.Normlinf() / y_full.Normlinf();
+
+   Vector z(l2_fes.GetVSize()), w_full(rt_fes.GetVSize()),
+          w_pa(rt_fes.GetVSize());
+   z.Randomize(2);
+   b_full.MultTranspose(z, w_full);
+   b_pa.MultTranspose(z, w_pa);
+   w_pa -= w_full;
+   err = std::max(err, w_pa.Normlinf() / w_full.Normlinf());
+
+   Vector D(rt_fes.GetVSize()), s_full, s_pa;
+   D.Randomize(3);
+   b_full.AssembleDiagonal_ADAt(D, s_full);
+   b_pa.AssembleDiagonal_ADAt(D, s_pa);
+   s_pa -= s_full;
+   return std::max(err, s_pa.Normlinf() / s_full.Normlinf());
+}
+
+TEST_CASE("Partial assembly in H(div)", "[AssemblyLevel]")
+{
+   FunctionCoefficient fcoeff(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 0; order <= 2; order++)
+      {
+         const std::string name = "dim = " + std::to_string(dim) +
+                                  ", order = " + std::to_string(order);
+         RT_FECollection rt_fec(order, dim);
+         L2_FECollection l2_fec(order, dim);
+
+         SECTION("Aligned elements, " + name)
+         {
+            Mesh *mesh = MakeMesh(dim);
+            FiniteElementSpace rt_fes(mesh, &rt_fec), l2_fes(mesh, &l2_fec);
+            REQUIRE(CompareHdiv(rt_fes, fcoeff, true, false) < 1e-12);
+            REQUIRE(CompareHdiv(rt_fes, fcoeff, false, true) < 1e-12);
+            REQUIRE(CompareMixedDivergence(rt_fes, l2_fes, fcoeff) < 1e-12);
+            delete mesh;
+         }
+         SECTION("Rotated elements, " + name)
+         {
+            Mesh *mesh = MakeRotatedMesh(dim);
+            FiniteElementSpace rt_fes(mesh, &rt_fec), l2_fes(mesh, &l2_fec);
+            REQUIRE(CompareHdiv(rt_fes, fcoeff, true, true) < 1e-12);
+            REQUIRE(CompareMixedDivergence(rt_fes, l2_fes, fcoeff) < 1e-12);
+            delete mesh;
+         }
+      }
+   }
+}
+
+// Compare the partially assembled action on the elements split into two
+// subsets with the action on all elements at once, and check that
+// ElementRestriction::MultSubset() updates the listed DOFs only.
+double CompareElementSubsets(FiniteElementSpace &fes, Coefficient &q)
+{
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new MassIntegrator(q));
+   a.AddDomainIntegrator(new DiffusionIntegrator(q));
+   a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a.Assemble();
+   Array<BilinearFormIntegrator*> &integs = *a.GetDBFI();
+
+   const ElementRestriction *R = dynamic_cast<const ElementRestriction*>(
+                                    fes.GetElementRestriction(
+                                       ElementDofOrdering::LEXICOGRAPHIC));
+   REQUIRE(R != NULL);
+   Array<int> even, odd;
+   for (int e = 0; e < fes.GetNE(); e++)
+   {
+      ((e % 2) ? odd : even).Append(e);
+   }
+
+   Vector x(fes.GetVSize()), xE(R->Height());
+   Vector yE_all(R->Height()), yE_sub(R->Height());
+   x.Randomize(1);
+   R->Mult(x, xE);
+   yE_all = 0.0;
+   yE_sub = 0.0;
+   for (int i = 0; i < integs.Size(); i++)
+   {
+      integs[i]->AddMultPA(xE, yE_all);
+      integs[i]->AddMultPAElements(xE, yE_sub, odd);
+      integs[i]->AddMultPAElements(xE, yE_sub, even);
+   }
+   yE_sub -= yE_all;
+   double err = yE_sub.Normlinf() / yE_all.Normlinf();
+
+   // Change the DOFs of the first element and update the E-vector
+   Array<int> dofs;
+   fes.GetElementDofs(0, dofs);
+   for (int j = 0; j < dofs.Size(); j++) { x(dofs[j]) += 1.0 + j; }
+   R->MultSubset(dofs, x, xE);
+   Vector xE_new(R->Height());
+   R->Mult(x, xE_new);
+   xE_new -= xE;
+   return std::max(err, xE_new.Normlinf());
+}
+
+TEST_CASE("Partial assembly on element subsets", "[AssemblyLevel]")
+{
+   FunctionCoefficient fcoeff(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 3; order++)
+      {
+         Mesh *mesh = MakeMesh(dim);
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(mesh, &fec);
+         REQUIRE(CompareElementSubsets(fes, fcoeff) < 1e-12);
+         delete mesh;
+      }
+   }
+}
+
+} // namespace assemblylevel
+
+#ifdef MFEM_USE_MPI
+
+namespace assemblylevel
+{
+
+// Return the maximum difference between the system operators and the linear
+// systems formed with and without overlapping communication.
+double CompareOverlap(ParFiniteElementSpace &pfes, Coefficient &q)
+{
+   Array<int> ess_bdr(pfes.GetParMesh()->bdr_attributes.Max()), ess_tdofs;
+   ess_bdr = 0;
+   ess_bdr[0] = 1;
+   pfes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+   ParBilinearForm a(&pfes), a_ovlp(&pfes);
+   ParBilinearForm *forms[2] = { &a, &a_ovlp };
+   for (int k = 0; k < 2; k++)
+   {
+      forms[k]->SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      forms[k]->AddDomainIntegrator(new MassIntegrator(q));
+      forms[k]->AddDomainIntegrator(new DiffusionIntegrator(q));
+   }
+   a_ovlp.OverlapCommunication();
+   a.Assemble();
+   a_ovlp.Assemble();
+
+   // The vectors depend on the rank, so that the shared dofs receive values
+   // different from the local ones
+   int myid;
+   MPI_Comm_rank(pfes.GetComm(), &myid);
+   ParGridFunction x(&pfes), b(&pfes);
+   x.Randomize(1 + myid);
+   b.Randomize(10 + myid);
+
+   double err = 0.0;
+   OperatorHandle A, A_ovlp;
+   Vector X, B, X_ovlp, B_ovlp;
+   ParGridFunction x_ovlp(x), b_ovlp(b);
+   a.FormLinearSystem(ess_tdofs, x, b, A, X, B);
+   a_ovlp.FormLinearSystem(ess_tdofs, x_ovlp, b_ovlp, A_ovlp, X_ovlp, B_ovlp);
+   X_ovlp -= X;
+   B_ovlp -= B;
+   err = std::max(err, X_ovlp.Normlinf());
+   err = std::max(err, B_ovlp.Normlinf());
+
+   Vector y(A->Height()), y_ovlp(A->Height());
+   X.Randomize(20 + myid);
+   A->Mult(X, y);
+   A_ovlp->Mult(X, y_ovlp);
+   y_ovlp -= y;
+   err = std::max(err, y_ovlp.Normlinf()/y.Normlinf());
+
+   // Repeated applications reuse the work vectors
+   X.Randomize(30 + myid);
+   A->Mult(X, y);
+   A_ovlp->Mult(X, y_ovlp);
+   y_ovlp -= y;
+   err = std::max(err, y_ovlp.Normlinf()/y.Normlinf());
+
+   double glob_err;
+   MPI_Allreduce(&err, &glob_err, 1, MPI_DOUBLE, MPI_MAX, pfes.GetComm());
+   return glob_err;
+}
+
+TEST_CASE("Overlapping communication in parallel partial assembly",
+          "[AssemblyLevel][Parallel]")
+{
+   int nranks;
+   MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+   FunctionCoefficient fcoeff(coeff);
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int order = 1; order <= 3; order++)
+      {
+         SECTION("dim = " + std::to_string(dim) +
+                 ", order = " + std::to_string(order))
+         {
+            Mesh *mesh = (dim == 2) ?
+                         new Mesh(8, 8, Element::QUADRILATERAL, true) :
+                         new Mesh(4, 4, 4, Element::HEXAHEDRON, true);
+            const int ne = mesh->GetNE();
+            Array<int> partitioning(ne);
+            for (int e = 0; e < ne; e++) { partitioning[e] = e*nranks/ne; }
+            ParMesh pmesh(MPI_COMM_WORLD, *mesh, partitioning);
+            delete mesh;
+            H1_FECollection fec(order, dim);
+            ParFiniteElementSpace pfes(&pmesh, &fec);
+
+            ParBilinearForm a(&pfes);
+            a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            a.AddDomainIntegrator(new MassIntegrator(fcoeff));
+            a.Assemble();
+            ParPAOverlapOperator A(a);
+            REQUIRE(A.GetInteriorElements().Size() +
+                    A.GetBoundaryElements().Size() == pmesh.GetNE());
+            REQUIRE(A.GetInteriorElements().Size() > 0);
+            // With several ranks, some elements have dofs owned by neighbors
+            int nbdr = A.GetBoundaryElements().Size(), glob_nbdr;
+            MPI_Allreduce(&nbdr, &glob_nbdr, 1, MPI_INT, MPI_SUM,
+                          MPI_COMM_WORLD);
+            REQUIRE((glob_nbdr > 0) == (nranks > 1));
+
+            REQUIRE(CompareOverlap(pfes, fcoeff) < 1e-12);
+         }
+      }
+   }
+}
+
+} // namespace assemblylevel
+
+#endif // MFEM_USE_MPI
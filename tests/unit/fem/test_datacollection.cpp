@@ -103,6 +103,44 @@ TEST_CASE("Save and load from collections", "[DataCollection]")
          REQUIRE(rmdir("base_00005") == 0);
       }
 
+      SECTION("Asynchronous save")
+      {
+         VisItDataCollection dc("base", mesh);
+         dc.RegisterField("u", u);
+         dc.RegisterField("v", v);
+         dc.SetCycle(5);
+         dc.SetTime(8.0);
+         dc.SetPadDigits(5);
+
+         //Save in the background, then change the field and the cycle: the
+         //files should contain the data at the time of SaveAsync()
+         Vector u_saved(*u);
+         dc.SaveAsync();
+         *u = 0.0;
+         dc.SetCycle(6);
+         dc.Wait();
+         REQUIRE(!dc.IsSaving());
+         REQUIRE(dc.Error() == DataCollection::NO_ERROR);
+
+         VisItDataCollection dc_new("base");
+         dc_new.SetPadDigits(5);
+         dc_new.Load(5);
+         REQUIRE(dc_new.Error() == DataCollection::NO_ERROR);
+         REQUIRE(dc_new.GetTime() == 8.0);
+         GridFunction *u_new = dc_new.GetField("u");
+         REQUIRE(u_new);
+         Vector u_diff(*u_new);
+         u_diff -= u_saved;
+         REQUIRE(u_diff.Normlinf() < 1e-10);
+
+         //Cleanup all the files
+         REQUIRE(remove("base_00005.mfem_root") == 0);
+         REQUIRE(remove("base_00005/mesh.00000") == 0);
+         REQUIRE(remove("base_00005/u.00000") == 0);
+         REQUIRE(remove("base_00005/v.00000") == 0);
+         REQUIRE(rmdir("base_00005") == 0);
+      }
+
 #ifdef MFEM_USE_GZSTREAM
       SECTION("Compressed MFEM format")
       {
@@ -170,3 +208,105 @@ TEST_CASE("Save and load from collections", "[DataCollection]")
 #endif
    }
 }
+
+#ifdef MFEM_USE_MPI
+
+TEST_CASE("Save and load shared files", "[DataCollection][Parallel]")
+{
+   int myid, nranks;
+   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+   MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+   //Set up a small parallel mesh, partitioned in blocks of elements
+   Mesh mesh(4, 3, Element::QUADRILATERAL, 0, 2.0, 3.0);
+   const int ne = mesh.GetNE();
+   Array<int> partitioning(ne);
+   for (int e = 0; e < ne; e++) { partitioning[e] = e*nranks/ne; }
+   ParMesh *pmesh = new ParMesh(MPI_COMM_WORLD, mesh, partitioning);
+   H1_FECollection fec(2, 2);
+   ParFiniteElementSpace fes(pmesh, &fec);
+   ParGridFunction u(&fes);
+   for (int i = 0; i < u.Size(); i++) { u(i) = 100.0*myid + i; }
+
+   SECTION("Mesh and grid function")
+   {
+      pmesh->PrintShared("pmesh_shared.mesh");
+      u.SaveShared("u_shared.gf");
+
+      std::string buffer;
+      REQUIRE(ReadSharedFile(MPI_COMM_WORLD, "pmesh_shared.mesh", buffer));
+      std::istringstream in(buffer);
+      ParMesh pmesh_new(MPI_COMM_WORLD, in);
+      REQUIRE(pmesh_new.GetNE() == pmesh->GetNE());
+      REQUIRE(pmesh_new.GetNV() == pmesh->GetNV());
+      REQUIRE(pmesh_new.GetNSharedFaces() == pmesh->GetNSharedFaces());
+      Vector vert, vert_diff;
+      pmesh->GetVertices(vert);
+      pmesh_new.GetVertices(vert_diff);
+      vert_diff -= vert;
+      REQUIRE(vert_diff.Normlinf() == 0.0);
+
+      ParFiniteElementSpace fes_new(&pmesh_new, &fec);
+      ParGridFunction u_new(&fes_new);
+      u_new.LoadShared("u_shared.gf");
+      Vector u_diff(u_new);
+      u_diff -= u;
+      REQUIRE(u_diff.Normlinf() == 0.0);
+
+      //Cleanup all the files
+      MPI_Barrier(MPI_COMM_WORLD);
+      if (myid == 0)
+      {
+         REQUIRE(remove("pmesh_shared.mesh") == 0);
+         REQUIRE(remove("u_shared.gf") == 0);
+      }
+   }
+
+   SECTION("VisIt shared format")
+   {
+      VisItDataCollection dc(MPI_COMM_WORLD, "pbase", pmesh);
+      dc.RegisterField("u", &u);
+      dc.SetCycle(5);
+      dc.SetTime(8.0);
+      dc.SetPadDigits(5);
+      dc.SetFormat(DataCollection::SHARED_FORMAT);
+      dc.Save();
+      REQUIRE(dc.Error() == DataCollection::NO_ERROR);
+      //The root file is written by rank 0 only
+      MPI_Barrier(MPI_COMM_WORLD);
+
+      VisItDataCollection dc_new(MPI_COMM_WORLD, "pbase");
+      dc_new.SetPadDigits(5);
+      dc_new.Load(5);
+      REQUIRE(dc_new.Error() == DataCollection::NO_ERROR);
+      REQUIRE(dc_new.GetTime() == 8.0);
+      ParMesh *pmesh_new = dynamic_cast<ParMesh*>(dc_new.GetMesh());
+      REQUIRE(pmesh_new);
+      REQUIRE(pmesh_new->GetNE() == pmesh->GetNE());
+      Vector vert, vert_diff;
+      pmesh->GetVertices(vert);
+      pmesh_new->GetVertices(vert_diff);
+      vert_diff -= vert;
+      REQUIRE(vert_diff.Normlinf() < 1e-10);
+
+      GridFunction *u_new = dc_new.GetField("u");
+      REQUIRE(u_new);
+      Vector u_diff(*u_new);
+      u_diff -= u;
+      REQUIRE(u_diff.Normlinf() < 1e-10);
+
+      //Cleanup all the files: one per field for all the ranks
+      MPI_Barrier(MPI_COMM_WORLD);
+      if (myid == 0)
+      {
+         REQUIRE(remove("pbase_00005.mfem_root") == 0);
+         REQUIRE(remove("pbase_00005/pmesh") == 0);
+         REQUIRE(remove("pbase_00005/u") == 0);
+         REQUIRE(rmdir("pbase_00005") == 0);
+      }
+   }
+
+   delete pmesh;
+}
+
+#endif // MFEM_USE_MPI
@@ -0,0 +1,250 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace multigrid
+{
+
+double linear(const Vector &x)
+{
+   return 1.0 + x[0] - 2.0*x[1];
+}
+
+// Check that P is the transpose of P^t and that P interpolates exactly the
+// linear functions.
+void CheckProlongation(FiniteElementSpace &coarse_fes,
+                       FiniteElementSpace &fine_fes, const Operator &P)
+{
+   REQUIRE(P.Width() == coarse_fes.GetTrueVSize());
+   REQUIRE(P.Height() == fine_fes.GetTrueVSize());
+
+   Vector xc(P.Width()), yc(P.Width()), xf(P.Height()), yf(P.Height());
+   xc.Randomize(1);
+   xf.Randomize(2);
+   P.Mult(xc, yf);
+   P.MultTranspose(xf, yc);
+   REQUIRE(std::abs((yf*xf) - (yc*xc)) < 1e-12 * std::abs(yf*xf));
+
+   FunctionCoefficient f(linear);
+   GridFunction gc(&coarse_fes), gf(&fine_fes);
+   gc.ProjectCoefficient(f);
+   gf.ProjectCoefficient(f);
+   P.Mult(gc, yf);
+   yf -= gf;
+   REQUIRE(yf.Normlinf() < 1e-12);
+}
+
+TEST_CASE("Multigrid transfer operators",
+          "[Multigrid]")
+{
+   for (int type = 0; type < 2; type++)
+   {
+      const Element::Type el = type ? Element::TRIANGLE :
+                               Element::QUADRILATERAL;
+      Mesh *mesh = new Mesh(3, 2, el, true);
+      H1_FECollection fec1(1, 2), fec3(3, 2);
+      FiniteElementSpace *fes = new FiniteElementSpace(mesh, &fec1);
+      FiniteElementSpaceHierarchy hierarchy(mesh, fes, true, true);
+      hierarchy.AddUniformlyRefinedLevel();
+      hierarchy.AddOrderRefinedLevel(&fec3);
+      hierarchy.AddUniformlyRefinedLevel();
+      REQUIRE(hierarchy.GetNumLevels() == 4);
+      REQUIRE(hierarchy.GetMeshAtLevel(2).GetNE() == 4*mesh->GetNE());
+      for (int l = 1; l < hierarchy.GetNumLevels(); l++)
+      {
+         CheckProlongation(hierarchy.GetFESpaceAtLevel(l-1),
+                           hierarchy.GetFESpaceAtLevel(l),
+                           *hierarchy.GetProlongationAtLevel(l));
+      }
+   }
+}
+
+TEST_CASE("Geometric multigrid",
+          "[Multigrid]")
+{
+   const int dim = 2;
+   // The mesh is owned by the hierarchy of each section.
+   Mesh *mesh = new Mesh(3, 3, Element::QUADRILATERAL, true);
+   Array<int> ess_bdr(mesh->bdr_attributes.Max());
+   ess_bdr = 1;
+   ConstantCoefficient one(1.0);
+
+   SECTION("h-multigrid, assembled levels")
+   {
+      H1_FECollection fec(2, dim);
+      FiniteElementSpaceHierarchy hierarchy(
+         mesh, new FiniteElementSpace(mesh, &fec), true, true);
+      const int nlevels = 4;
+      for (int l = 1; l < nlevels; l++) { hierarchy.AddUniformlyRefinedLevel(); }
+
+      GeometricMultigrid mg(hierarchy, ess_bdr);
+      Array<BilinearForm*> forms;
+      SparseMatrix A[nlevels];
+      for (int l = 0; l < nlevels; l++)
+      {
+         forms.Append(new BilinearForm(&hierarchy.GetFESpaceAtLevel(l)));
+         forms[l]->AddDomainIntegrator(new DiffusionIntegrator(one));
+         forms[l]->Assemble();
+         forms[l]->FormSystemMatrix(mg.GetEssentialTrueDofs(l), A[l]);
+      }
+      GSSmoother coarse_prec(A[0]);
+      CGSolver *coarse_solver = new CGSolver;
+      coarse_solver->SetRelTol(1e-14);
+      coarse_solver->SetMaxIter(500);
+      coarse_solver->SetOperator(A[0]);
+      coarse_solver->SetPreconditioner(coarse_prec);
+      mg.AddLevel(&A[0], coarse_solver, false, true);
+      for (int l = 1; l < nlevels; l++)
+      {
+         mg.AddLevel(&A[l], new GSSmoother(A[l]), false, true);
+      }
+      REQUIRE(mg.NumLevels() == nlevels);
+
+      const int fl = nlevels - 1;
+      FiniteElementSpace &fes = hierarchy.GetFinestFESpace();
+      GridFunction x(&fes);
+      x = 0.0;
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new DomainLFIntegrator(one));
+      b.Assemble();
+      Vector X, B;
+      SparseMatrix Af;
+      forms[fl]->FormLinearSystem(mg.GetEssentialTrueDofs(fl), x, b, Af, X,
+                                  B);
+
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(100);
+      cg.SetOperator(Af);
+      cg.SetPreconditioner(mg);
+      cg.Mult(B, X);
+      REQUIRE(cg.GetConverged());
+      REQUIRE(cg.GetNumIterations() <= 12);
+
+      // A W-cycle converges at least as fast
+      mg.SetCycle(Multigrid::WCYCLE, 1, 1);
+      X = 0.0;
+      const int v_its = cg.GetNumIterations();
+      cg.Mult(B, X);
+      REQUIRE(cg.GetConverged());
+      REQUIRE(cg.GetNumIterations() <= v_its);
+
+      // As a stand-alone iterative solver
+      mg.SetCycle(Multigrid::VCYCLE, 2, 2);
+      mg.iterative_mode = true;
+      Vector Y(X.Size()), R(X.Size());
+      Y = 0.0;
+      for (int it = 0; it < 10; it++) { mg.Mult(B, Y); }
+      Af.Mult(Y, R);
+      R -= B;
+      REQUIRE(R.Norml2() < 1e-8 * B.Norml2());
+
+      for (int l = 0; l < nlevels; l++) { delete forms[l]; }
+   }
+
+   SECTION("p-multigrid, partially assembled levels")
+   {
+      mesh->UniformRefinement();
+      const int orders[] = { 1, 2, 4 };
+      const int nlevels = 3;
+      H1_FECollection *fec[nlevels];
+      for (int l = 0; l < nlevels; l++)
+      {
+         fec[l] = new H1_FECollection(orders[l], dim);
+      }
+      {
+         FiniteElementSpaceHierarchy hierarchy(
+            mesh, new FiniteElementSpace(mesh, fec[0]), true, true);
+         for (int l = 1; l < nlevels; l++)
+         {
+            hierarchy.AddOrderRefinedLevel(fec[l]);
+         }
+         GeometricMultigrid mg(hierarchy, ess_bdr);
+
+         // Coarse level: assembled matrix and sparse solver. Fine levels:
+         // partial assembly, smoothed with damped Jacobi.
+         Array<BilinearForm*> forms, full_forms;
+         OperatorHandle A[nlevels];
+         SparseMatrix diag_mat[nlevels];
+         for (int l = 0; l < nlevels; l++)
+         {
+            FiniteElementSpace &fes = hierarchy.GetFESpaceAtLevel(l);
+            const Array<int> &ess_tdofs = mg.GetEssentialTrueDofs(l);
+            forms.Append(new BilinearForm(&fes));
+            if (l > 0) { forms[l]->SetAssemblyLevel(AssemblyLevel::PARTIAL); }
+            forms[l]->AddDomainIntegrator(new DiffusionIntegrator(one));
+            forms[l]->Assemble();
+            forms[l]->FormSystemMatrix(ess_tdofs, A[l]);
+            if (l == 0) { continue; }
+            // Assembled matrix for the Jacobi smoother
+            full_forms.Append(new BilinearForm(&fes));
+            full_forms.Last()->AddDomainIntegrator(new DiffusionIntegrator(one));
+            full_forms.Last()->Assemble();
+            full_forms.Last()->FormSystemMatrix(ess_tdofs, diag_mat[l]);
+         }
+         GSSmoother coarse_prec(*A[0].As<SparseMatrix>());
+         CGSolver *coarse_solver = new CGSolver;
+         coarse_solver->SetRelTol(1e-14);
+         coarse_solver->SetMaxIter(500);
+         coarse_solver->SetOperator(*A[0]);
+         coarse_solver->SetPreconditioner(coarse_prec);
+         mg.AddLevel(A[0].Ptr(), coarse_solver, false, true);
+         for (int l = 1; l < nlevels; l++)
+         {
+            mg.AddLevel(A[l].Ptr(), new DSmoother(diag_mat[l], 0, 0.6),
+                        false, true);
+         }
+         mg.SetCycle(Multigrid::VCYCLE, 2, 2);
+
+         FiniteElementSpace &fes = hierarchy.GetFinestFESpace();
+         GridFunction x(&fes);
+         x = 0.0;
+         LinearForm b(&fes);
+         b.AddDomainIntegrator(new DomainLFIntegrator(one));
+         b.Assemble();
+         Vector X, B;
+         OperatorHandle Af;
+         forms[nlevels-1]->FormLinearSystem(
+            mg.GetEssentialTrueDofs(nlevels-1), x, b, Af, X, B);
+
+         CGSolver cg;
+         cg.SetRelTol(1e-10);
+         cg.SetMaxIter(200);
+         cg.SetOperator(*Af);
+         cg.Mult(B, X);
+         REQUIRE(cg.GetConverged());
+         const int cg_its = cg.GetNumIterations();
+
+         X = 0.0;
+         cg.SetPreconditioner(mg);
+         cg.Mult(B, X);
+         REQUIRE(cg.GetConverged());
+         REQUIRE(cg.GetNumIterations() <= 20);
+         REQUIRE(cg.GetNumIterations() < cg_its / 2);
+
+         // Compare with the assembled solution
+         Vector R(X.Size());
+         diag_mat[nlevels-1].Mult(X, R);
+         R -= B;
+         REQUIRE(R.Norml2() < 1e-8 * B.Norml2());
+
+         for (int l = 0; l < nlevels; l++) { delete forms[l]; }
+         for (int l = 0; l < nlevels-1; l++) { delete full_forms[l]; }
+      }
+      for (int l = 0; l < nlevels; l++) { delete fec[l]; }
+   }
+}
+
+} // namespace multigrid
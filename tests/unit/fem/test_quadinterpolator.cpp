@@ -0,0 +1,226 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace quadinterpolator
+{
+
+Mesh *MakeMesh(int dim)
+{
+   Mesh *mesh;
+   if (dim == 2) { mesh = new Mesh(3, 2, Element::QUADRILATERAL, true); }
+   else { mesh = new Mesh(2, 2, 1, Element::HEXAHEDRON, true); }
+   mesh->EnsureNodes();
+   GridFunction *nodes = mesh->GetNodes();
+   for (int i = 0; i < nodes->Size(); i++)
+   {
+      (*nodes)(i) += 0.03*std::sin(5.0*i);
+   }
+   return mesh;
+}
+
+// Return the maximum difference between the tensor-product and the generic
+// evaluation of a random E-vector of the space @a fes.
+double CompareTensorEval(const FiniteElementSpace &fes,
+                         const IntegrationRule &ir)
+{
+   const int dim = fes.GetMesh()->Dimension();
+   const int vdim = fes.GetVDim();
+   const int ne = fes.GetNE();
+   const FiniteElement &fe = *fes.GetFE(0);
+   const int nq = ir.GetNPoints();
+
+   Vector e_vec(fe.GetDof()*vdim*ne);
+   e_vec.Randomize(3);
+
+   unsigned flags = QuadratureInterpolator::VALUES |
+                    QuadratureInterpolator::DERIVATIVES;
+   if (vdim == dim) { flags |= QuadratureInterpolator::DETERMINANTS; }
+
+   Vector val[2], der[2], det[2];
+   const QuadratureInterpolator *qi = fes.GetQuadratureInterpolator(ir);
+   for (int i = 0; i < 2; i++)
+   {
+      val[i].SetSize(nq*vdim*ne);
+      der[i].SetSize(nq*vdim*dim*ne);
+      det[i].SetSize(vdim == dim ? nq*ne : 0);
+      qi->DisableTensorProducts(i == 1);
+      qi->Mult(e_vec, flags, val[i], der[i], det[i]);
+   }
+   qi->DisableTensorProducts(false);
+
+   double err = 0.0;
+   val[0] -= val[1];
+   der[0] -= der[1];
+   err = std::max(err, val[0].Normlinf());
+   err = std::max(err, der[0].Normlinf());
+   if (vdim == dim)
+   {
+      det[0] -= det[1];
+      err = std::max(err, det[0].Normlinf());
+   }
+   return err;
+}
+
+double CompareTensorEval(const FiniteElementSpace &fes, int ir_order)
+{
+   const Geometry::Type geom = fes.GetFE(0)->GetGeomType();
+   return CompareTensorEval(fes, IntRules.Get(geom, ir_order));
+}
+
+// Return the relative error in the identity <B x, y> = <x, B^T y>, where B is
+// the QuadratureInterpolator with the given @a flags, for random x and y.
+double CheckTranspose(const FiniteElementSpace &fes, int ir_order,
+                      unsigned flags, bool use_tensor)
+{
+   const int dim = fes.GetMesh()->Dimension();
+   const int vdim = fes.GetVDim();
+   const int ne = fes.GetNE();
+   const FiniteElement &fe = *fes.GetFE(0);
+   const IntegrationRule &ir = IntRules.Get(fe.GetGeomType(), ir_order);
+   const int nq = ir.GetNPoints();
+
+   Vector x(fe.GetDof()*vdim*ne), xt(x.Size());
+   Vector val(nq*vdim*ne), der(nq*vdim*dim*ne), det;
+   Vector yval(val.Size()), yder(der.Size());
+   x.Randomize(1);
+   yval.Randomize(2);
+   yder.Randomize(3);
+   if (!(flags & QuadratureInterpolator::VALUES)) { val = 0.0; yval = 0.0; }
+   if (!(flags & QuadratureInterpolator::DERIVATIVES))
+   {
+      der = 0.0;
+      yder = 0.0;
+   }
+
+   const QuadratureInterpolator *qi = fes.GetQuadratureInterpolator(ir);
+   qi->DisableTensorProducts(!use_tensor);
+   qi->Mult(x, flags, val, der, det);
+   qi->MultTranspose(flags, yval, yder, xt);
+   qi->DisableTensorProducts(false);
+
+   const double lhs = (val*yval) + (der*yder);
+   const double rhs = x*xt;
+   return std::abs(lhs - rhs)/std::max(std::abs(lhs), 1.0);
+}
+
+TEST_CASE("QuadratureInterpolator transpose",
+          "[QuadratureInterpolator]")
+{
+   const unsigned flags[3] =
+   {
+      QuadratureInterpolator::VALUES,
+      QuadratureInterpolator::DERIVATIVES,
+      QuadratureInterpolator::VALUES | QuadratureInterpolator::DERIVATIVES
+   };
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = MakeMesh(dim);
+      for (int order = 1; order <= 4; order++)
+      {
+         SECTION("dim = " + std::to_string(dim) +
+                 ", order = " + std::to_string(order))
+         {
+            H1_FECollection h1_fec(order, dim);
+            L2_FECollection l2_fec(order, dim);
+            FiniteElementSpace h1_fes(mesh, &h1_fec);
+            FiniteElementSpace h1_vfes(mesh, &h1_fec, dim);
+            FiniteElementSpace l2_fes(mesh, &l2_fec);
+            for (int f = 0; f < 3; f++)
+            {
+               const unsigned fl = flags[f];
+               for (int t = 0; t < 2; t++)
+               {
+                  REQUIRE(CheckTranspose(h1_fes, 2*order, fl, t) < 1e-12);
+                  REQUIRE(CheckTranspose(h1_fes, 2*order+3, fl, t) < 1e-12);
+                  REQUIRE(CheckTranspose(h1_vfes, 2*order, fl, t) < 1e-12);
+                  REQUIRE(CheckTranspose(l2_fes, 2*order+1, fl, t) < 1e-12);
+               }
+            }
+         }
+      }
+      delete mesh;
+   }
+}
+
+TEST_CASE("QuadratureInterpolator tensor evaluation",
+          "[QuadratureInterpolator]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = MakeMesh(dim);
+      for (int order = 1; order <= 4; order++)
+      {
+         SECTION("H1, dim = " + std::to_string(dim) +
+                 ", order = " + std::to_string(order))
+         {
+            H1_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            REQUIRE(CompareTensorEval(fes, 2*order) < 1e-12);
+            REQUIRE(CompareTensorEval(fes, 2*order + 3) < 1e-12);
+            FiniteElementSpace vfes(mesh, &fec, dim);
+            REQUIRE(CompareTensorEval(vfes, 2*order) < 1e-12);
+         }
+         SECTION("L2, dim = " + std::to_string(dim) +
+                 ", order = " + std::to_string(order))
+         {
+            L2_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            REQUIRE(CompareTensorEval(fes, 2*order + 1) < 1e-12);
+         }
+      }
+      SECTION("Non-tensor rule, dim = " + std::to_string(dim))
+      {
+         // A tensor rule with its first two points swapped: the point count
+         // matches a tensor rule, the structure does not.
+         const IntegrationRule &tir =
+            IntRules.Get(mesh->GetElementBaseGeometry(0), 4);
+         const int nq = tir.GetNPoints();
+         IntegrationRule ir(nq);
+         for (int q = 0; q < nq; q++) { ir.IntPoint(q) = tir.IntPoint(q); }
+         std::swap(ir.IntPoint(0), ir.IntPoint(1));
+         REQUIRE(tir.IsTensorProduct(dim));
+         REQUIRE(!ir.IsTensorProduct(dim));
+         H1_FECollection fec(2, dim);
+         FiniteElementSpace fes(mesh, &fec);
+         REQUIRE(CompareTensorEval(fes, ir) < 1e-12);
+         FiniteElementSpace vfes(mesh, &fec, dim);
+         REQUIRE(CompareTensorEval(vfes, ir) < 1e-12);
+      }
+      SECTION("Geometric factors, dim = " + std::to_string(dim))
+      {
+         const IntegrationRule &ir =
+            IntRules.Get(mesh->GetElementBaseGeometry(0), 5);
+         const GeometricFactors *geom =
+            mesh->GetGeometricFactors(ir, GeometricFactors::DETERMINANTS);
+         double err = 0.0;
+         for (int e = 0; e < mesh->GetNE(); e++)
+         {
+            ElementTransformation *T = mesh->GetElementTransformation(e);
+            for (int q = 0; q < ir.GetNPoints(); q++)
+            {
+               T->SetIntPoint(&ir.IntPoint(q));
+               const double detJ = T->Weight();
+               err = std::max(err, std::abs(geom->detJ(q + e*ir.GetNPoints()) -
+                                            detJ));
+            }
+         }
+         REQUIRE(err < 1e-12);
+      }
+      delete mesh;
+   }
+}
+
+} // namespace quadinterpolator
@@ -0,0 +1,161 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace threaded_assembly
+{
+
+double coeff(const Vector &x)
+{
+   return 1.0 + x[0]*x[0] + 0.5*x[1];
+}
+
+void vcoeff(const Vector &x, Vector &v)
+{
+   v.SetSize(x.Size());
+   for (int i = 0; i < x.Size(); i++) { v(i) = 1.0 + x[i]*(i+1); }
+}
+
+Mesh *MakeMesh(int dim, Element::Type type)
+{
+   if (dim == 2) { return new Mesh(4, 3, type, true); }
+   Mesh *mesh = new Mesh(2, 3, 2, type, true);
+   // Needed by the Nedelec spaces on tetrahedra
+   if (type == Element::TETRAHEDRON) { mesh->ReorientTetMesh(); }
+   return mesh;
+}
+
+// Check that the elements of each color do not share dofs and that every
+// element has exactly one color.
+void CheckColoring(const FiniteElementSpace &fes)
+{
+   const Table &colors = fes.GetElementColoring();
+   Array<int> elem_count(fes.GetNE()), dof_color(fes.GetNDofs());
+   elem_count = 0;
+   dof_color = -1;
+   Array<int> dofs;
+   for (int c = 0; c < colors.Size(); c++)
+   {
+      for (int j = 0; j < colors.RowSize(c); j++)
+      {
+         const int e = colors.GetRow(c)[j];
+         elem_count[e]++;
+         fes.GetElementDofs(e, dofs);
+         for (int k = 0; k < dofs.Size(); k++)
+         {
+            const int d = (dofs[k] >= 0) ? dofs[k] : -1-dofs[k];
+            REQUIRE(dof_color[d] != c);
+            dof_color[d] = c;
+         }
+      }
+   }
+   REQUIRE(elem_count.Min() == 1);
+   REQUIRE(elem_count.Max() == 1);
+}
+
+// Compare the matrices and the right-hand sides assembled serially and with
+// threads.
+double CompareThreaded(FiniteElementSpace &fes, bool vector_fe)
+{
+   FunctionCoefficient q(coeff);
+   VectorFunctionCoefficient vq(fes.GetMesh()->Dimension(), vcoeff);
+
+   BilinearForm a_serial(&fes), a_threaded(&fes);
+   LinearForm b_serial(&fes), b_threaded(&fes);
+   a_threaded.UseThreadedAssembly();
+   b_threaded.UseThreadedAssembly();
+   BilinearForm *a[2] = { &a_serial, &a_threaded };
+   LinearForm *b[2] = { &b_serial, &b_threaded };
+   for (int i = 0; i < 2; i++)
+   {
+      if (vector_fe)
+      {
+         a[i]->AddDomainIntegrator(new CurlCurlIntegrator(q));
+         a[i]->AddDomainIntegrator(new VectorFEMassIntegrator(q));
+         b[i]->AddDomainIntegrator(new VectorFEDomainLFIntegrator(vq));
+      }
+      else
+      {
+         a[i]->AddDomainIntegrator(new DiffusionIntegrator(q));
+         a[i]->AddDomainIntegrator(new MassIntegrator(q));
+         a[i]->AddBoundaryIntegrator(new MassIntegrator(q));
+         b[i]->AddDomainIntegrator(new DomainLFIntegrator(q));
+      }
+      a[i]->Assemble();
+      a[i]->Finalize();
+      b[i]->Assemble();
+   }
+
+   Vector x(fes.GetVSize()), y_serial(fes.GetVSize()),
+          y_threaded(fes.GetVSize());
+   x.Randomize(1);
+   a_serial.Mult(x, y_serial);
+   a_threaded.Mult(x, y_threaded);
+   y_threaded -= y_serial;
+   b_threaded -= b_serial;
+   return std::max(y_threaded.Normlinf() / y_serial.Normlinf(),
+                   b_threaded.Normlinf() / b_serial.Normlinf());
+}
+
+TEST_CASE("Element coloring", "[ThreadedAssembly]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Element::Type types[2] =
+      {
+         (dim == 2) ? Element::TRIANGLE : Element::TETRAHEDRON,
+         (dim == 2) ? Element::QUADRILATERAL : Element::HEXAHEDRON
+      };
+      for (int t = 0; t < 2; t++)
+      {
+         Mesh *mesh = MakeMesh(dim, types[t]);
+         H1_FECollection h1_fec(2, dim);
+         ND_FECollection nd_fec(1, dim);
+         L2_FECollection l2_fec(1, dim);
+         FiniteElementSpace h1_fes(mesh, &h1_fec), nd_fes(mesh, &nd_fec),
+                            l2_fes(mesh, &l2_fec);
+         CheckColoring(h1_fes);
+         CheckColoring(nd_fes);
+         CheckColoring(l2_fes);
+         // Elements of a discontinuous space do not share dofs.
+         REQUIRE(l2_fes.GetElementColoring().Size() == 1);
+         delete mesh;
+      }
+   }
+}
+
+TEST_CASE("Threaded assembly", "[ThreadedAssembly]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Element::Type types[2] =
+      {
+         (dim == 2) ? Element::TRIANGLE : Element::TETRAHEDRON,
+         (dim == 2) ? Element::QUADRILATERAL : Element::HEXAHEDRON
+      };
+      for (int t = 0; t < 2; t++)
+      {
+         Mesh *mesh = MakeMesh(dim, types[t]);
+         H1_FECollection h1_fec(2, dim);
+         ND_FECollection nd_fec(2, dim);
+         FiniteElementSpace h1_fes(mesh, &h1_fec), nd_fes(mesh, &nd_fec);
+         REQUIRE(CompareThreaded(h1_fes, false) < 1e-12);
+         REQUIRE(CompareThreaded(nd_fes, true) < 1e-12);
+         delete mesh;
+      }
+   }
+}
+
+} // namespace threaded_assembly
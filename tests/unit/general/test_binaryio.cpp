@@ -0,0 +1,299 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace mfem;
+
+namespace binaryio
+{
+
+double func(const Vector &x)
+{
+   return 1.0 + x[0]*x[0] - 0.5*x[1];
+}
+
+// Store the value @a v at position @a pos of @a s with reversed byte order
+template <typename T>
+void PutSwapped(std::string &s, int pos, T v)
+{
+   char *bytes = (char *) &v;
+   std::reverse(bytes, bytes + sizeof(T));
+   s.replace(pos, sizeof(T), bytes, sizeof(T));
+}
+
+TEST_CASE("Binary container", "[BinaryIO]")
+{
+   const int ints[3] = { 1, -2, 3 };
+   const double doubles[2] = { 0.5, -1e300 };
+   std::ostringstream out;
+   {
+      BinaryWriter bin_out(out, "MFEM binary test v1.0");
+      bin_out.Write("ints", ints, 3);
+      bin_out.Write("doubles", doubles, 2);
+      bin_out.Write("string", std::string("some text"));
+      bin_out.Write("empty", ints, 0);
+   }
+
+   SECTION("Stream input")
+   {
+      std::istringstream in(out.str());
+      BinaryReader bin_in(in);
+      REQUIRE(bin_in.GetType() == "MFEM binary test v1.0");
+      Array<int> a;
+      bin_in.Get("ints", a);
+      REQUIRE(a.Size() == 3);
+      REQUIRE(a[1] == -2);
+      int size;
+      const double *d = bin_in.GetData<double>("doubles", size);
+      REQUIRE(size == 2);
+      REQUIRE(d[1] == -1e300);
+      REQUIRE(bin_in.GetString("string") == "some text");
+      bin_in.GetData<int>("empty", size);
+      REQUIRE(size == 0);
+      REQUIRE(!bin_in.Has("missing"));
+   }
+
+   SECTION("Mapped file")
+   {
+      const char *fname = "binaryio_test.bin";
+      {
+         std::ofstream file(fname, std::ios::binary);
+         file << out.str();
+      }
+      {
+         BinaryReader bin_in(fname);
+         int size;
+         const int *a = bin_in.GetData<int>("ints", size);
+         REQUIRE(size == 3);
+         REQUIRE(a[2] == 3);
+         // The data is 8-byte aligned in the mapped file
+         const double *d = bin_in.GetData<double>("doubles", size);
+         REQUIRE(reinterpret_cast<size_t>(d) % 8 == 0);
+         REQUIRE(d[0] == 0.5);
+      }
+      std::remove(fname);
+   }
+
+   SECTION("Opposite byte order")
+   {
+      // Header and records written with the opposite byte order
+      std::string bin(64, '\0');
+      const std::string type = "MFEM binary test v1.0\n";
+      bin.replace(0, type.size(), type);
+      PutSwapped(bin, 48, 0x01020304);
+      PutSwapped(bin, 52, 1);
+      std::string record(48, '\0');
+      record[0] = 'x';
+      PutSwapped(record, 32, int(BinaryReader::INT32));
+      PutSwapped(record, 40, (long long) 2);
+      bin += record;
+      std::string data(8, '\0');
+      PutSwapped(data, 0, 7);
+      PutSwapped(data, 4, -256);
+      bin += data + std::string(48, '\0');
+
+      std::istringstream in(bin);
+      BinaryReader bin_in(in);
+      int size;
+      const int *x = bin_in.GetData<int>("x", size);
+      REQUIRE(size == 2);
+      REQUIRE(x[0] == 7);
+      REQUIRE(x[1] == -256);
+   }
+}
+
+TEST_CASE("Binary mesh and grid functions", "[BinaryIO]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(3, 2, Element::TRIANGLE, true) :
+                   new Mesh(2, 2, 1, Element::HEXAHEDRON, true);
+      mesh->SetCurvature(2);
+      for (int i = 0; i < mesh->GetNE(); i++)
+      {
+         mesh->SetAttribute(i, 1 + i%3);
+      }
+
+      // Mesh through a stream
+      std::ostringstream mesh_out;
+      mesh->PrintBinary(mesh_out);
+      std::istringstream mesh_in(mesh_out.str());
+      Mesh mesh2(mesh_in, 1, 0);
+      REQUIRE(mesh2.Dimension() == dim);
+      REQUIRE(mesh2.GetNE() == mesh->GetNE());
+      REQUIRE(mesh2.GetNBE() == mesh->GetNBE());
+      REQUIRE(mesh2.GetNV() == mesh->GetNV());
+      Array<int> v1, v2;
+      for (int i = 0; i < mesh->GetNE(); i++)
+      {
+         REQUIRE(mesh2.GetAttribute(i) == mesh->GetAttribute(i));
+         mesh->GetElementVertices(i, v1);
+         mesh2.GetElementVertices(i, v2);
+         for (int j = 0; j < v1.Size(); j++) { REQUIRE(v1[j] == v2[j]); }
+      }
+      REQUIRE(mesh2.GetNodes() != NULL);
+      Vector diff(*mesh->GetNodes());
+      diff -= *mesh2.GetNodes();
+      REQUIRE(diff.Normlinf() == 0.0);
+
+      // Mesh through a file
+      const char *mesh_name = "binaryio_test.mesh";
+      {
+         std::ofstream mesh_file(mesh_name, std::ios::binary);
+         mesh->PrintBinary(mesh_file);
+      }
+      Mesh mesh3(mesh_name, 1, 0);
+      REQUIRE(mesh3.GetNE() == mesh->GetNE());
+      REQUIRE(mesh3.GetNodes() != NULL);
+      std::remove(mesh_name);
+
+      // GridFunction and QuadratureFunction through mapped files
+      H1_FECollection fec(2, dim);
+      FiniteElementSpace fes(mesh, &fec, 2);
+      GridFunction x(&fes);
+      FunctionCoefficient f(func);
+      VectorArrayCoefficient vf(2);
+      vf.Set(0, &f, false);
+      vf.Set(1, &f, false);
+      x.ProjectCoefficient(vf);
+
+      QuadratureSpace qspace(mesh, 3);
+      QuadratureFunction q(&qspace, 2);
+      q.Randomize(1);
+
+      const char *gf_name = "binaryio_test.gf", *qf_name = "binaryio_test.qf";
+      {
+         std::ofstream gf_out(gf_name, std::ios::binary);
+         x.SaveBinary(gf_out);
+         std::ofstream qf_out(qf_name, std::ios::binary);
+         q.SaveBinary(qf_out);
+      }
+      {
+         BinaryReader gf_in(gf_name), qf_in(qf_name);
+         GridFunction x2(mesh, gf_in);
+         REQUIRE(x2.FESpace()->GetVDim() == 2);
+         x2 -= x;
+         REQUIRE(x2.Normlinf() == 0.0);
+
+         QuadratureFunction q2(mesh, qf_in);
+         REQUIRE(q2.GetVDim() == 2);
+         q2 -= q;
+         REQUIRE(q2.Normlinf() == 0.0);
+      }
+      std::remove(gf_name);
+      std::remove(qf_name);
+      delete mesh;
+   }
+}
+
+} // namespace binaryio
+
+#ifdef MFEM_USE_MPI
+
+namespace binaryio
+{
+
+void vfunc(const Vector &x, Vector &v)
+{
+   v.SetSize(x.Size());
+   for (int i = 0; i < x.Size(); i++) { v(i) = func(x) + i*x(i); }
+}
+
+TEST_CASE("Parallel binary grid functions", "[BinaryIO][Parallel]")
+{
+   int myid, nranks;
+   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+   MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(6, 4, Element::TRIANGLE, true) :
+                   new Mesh(3, 3, 2, Element::TETRAHEDRON, true);
+      const int ne = mesh->GetNE();
+      Array<int> partitioning(ne);
+      for (int e = 0; e < ne; e++) { partitioning[e] = e*nranks/ne; }
+      ParMesh pmesh(MPI_COMM_WORLD, *mesh, partitioning);
+      delete mesh;
+
+      // In 3D, the RT space has shared dofs with negative signs, which
+      // SaveBinary() changes
+      H1_FECollection h1_fec(2, dim);
+      ND_FECollection nd_fec(1, dim);
+      RT_FECollection rt_fec(1, dim);
+      ParFiniteElementSpace h1_fes(&pmesh, &h1_fec, 2);
+      ParFiniteElementSpace nd_fes(&pmesh, &nd_fec);
+      ParFiniteElementSpace rt_fes(&pmesh, &rt_fec);
+      ParFiniteElementSpace *spaces[3] = { &h1_fes, &nd_fes, &rt_fes };
+      VectorFunctionCoefficient vf(dim, vfunc);
+      FunctionCoefficient f(func);
+      VectorArrayCoefficient vf2(2);
+      vf2.Set(0, &f, false);
+      vf2.Set(1, &f, false);
+
+      for (int s = 0; s < 3; s++)
+      {
+         SECTION("dim = " + std::to_string(dim) +
+                 ", space = " + std::to_string(s))
+         {
+            ParGridFunction x(spaces[s]);
+            if (s == 0) { x.ProjectCoefficient(vf2); }
+            else { x.ProjectCoefficient(vf); }
+
+            // Through a stream
+            std::ostringstream out;
+            x.SaveBinary(out);
+            {
+               std::istringstream in(out.str());
+               BinaryReader bin_in(in);
+               ParGridFunction x2(&pmesh, bin_in);
+               REQUIRE(x2.ParFESpace()->GetVDim() == x.ParFESpace()->GetVDim());
+               REQUIRE(x2.ParFESpace()->GetTrueVSize() ==
+                       x.ParFESpace()->GetTrueVSize());
+               x2 -= x;
+               REQUIRE(x2.Normlinf() == 0.0);
+            }
+
+            // Through a mapped file, one per rank
+            const std::string gf_name =
+               "pbinaryio_test.gf." + std::to_string(myid);
+            {
+               std::ofstream gf_out(gf_name.c_str(), std::ios::binary);
+               x.SaveBinary(gf_out);
+            }
+            {
+               // The data of the reader is not modified by the constructor
+               BinaryReader gf_in(gf_name.c_str());
+               for (int k = 0; k < 2; k++)
+               {
+                  ParGridFunction x2(&pmesh, gf_in);
+                  Vector diff(x2);
+                  diff -= x;
+                  REQUIRE(diff.Normlinf() == 0.0);
+               }
+            }
+            std::remove(gf_name.c_str());
+         }
+      }
+   }
+}
+
+} // namespace binaryio
+
+#endif // MFEM_USE_MPI
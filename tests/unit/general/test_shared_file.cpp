@@ -0,0 +1,89 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+#include <cstdio>
+
+#ifdef MFEM_USE_MPI
+
+using namespace mfem;
+
+namespace sharedfile
+{
+
+// A buffer with rank-dependent size and contents; the last rank writes an
+// empty buffer.
+std::string MakeBuffer(int rank, int nranks, int scale)
+{
+   if (nranks > 1 && rank == nranks-1) { return std::string(); }
+   std::string buffer(scale*(rank+1) + 17, ' ');
+   for (std::size_t i = 0; i < buffer.size(); i++)
+   {
+      buffer[i] = char((i*7 + rank) % 256);
+   }
+   return buffer;
+}
+
+TEST_CASE("Shared files", "[SharedFile][Parallel]")
+{
+   int myid, nranks;
+   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+   MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+   const std::string fname = "shared_file_test.bin";
+
+   SECTION("Round trip")
+   {
+      std::string in;
+      const std::string out = MakeBuffer(myid, nranks, 1000);
+      REQUIRE(WriteSharedFile(MPI_COMM_WORLD, fname, out));
+      REQUIRE(ReadSharedFile(MPI_COMM_WORLD, fname, in));
+      REQUIRE(in == out);
+
+      // Overwrite with smaller buffers: the old contents are discarded
+      const std::string out2 = MakeBuffer(nranks-1-myid, nranks, 10);
+      REQUIRE(WriteSharedFile(MPI_COMM_WORLD, fname, out2));
+      REQUIRE(ReadSharedFile(MPI_COMM_WORLD, fname, in));
+      REQUIRE(in == out2);
+
+      MPI_Barrier(MPI_COMM_WORLD);
+      if (myid == 0) { std::remove(fname.c_str()); }
+   }
+
+   SECTION("Missing file")
+   {
+      std::string in("old data");
+      REQUIRE(!ReadSharedFile(MPI_COMM_WORLD, "missing_shared_file.bin", in));
+      REQUIRE(in.empty());
+   }
+
+   SECTION("Different number of ranks")
+   {
+      // Written by rank 0 only
+      if (myid == 0)
+      {
+         REQUIRE(WriteSharedFile(MPI_COMM_SELF, fname, "rank 0 data"));
+      }
+      MPI_Barrier(MPI_COMM_WORLD);
+      std::string in;
+      const bool ok = ReadSharedFile(MPI_COMM_WORLD, fname, in);
+      REQUIRE(ok == (nranks == 1));
+      if (ok) { REQUIRE(in == "rank 0 data"); }
+
+      MPI_Barrier(MPI_COMM_WORLD);
+      if (myid == 0) { std::remove(fname.c_str()); }
+   }
+}
+
+} // namespace sharedfile
+
+#endif // MFEM_USE_MPI
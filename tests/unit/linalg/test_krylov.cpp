@@ -0,0 +1,271 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace krylov
+{
+
+TEST_CASE("Pipelined CG", "[Krylov]")
+{
+   Mesh mesh(10, 10, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.AddDomainIntegrator(new MassIntegrator(one));
+   a.Assemble();
+   SparseMatrix A;
+   a.FormSystemMatrix(ess_tdofs, A);
+   const int n = A.Height();
+
+   Vector b(n), x_cg(n), x_pcg(n);
+   b.Randomize(1);
+   for (int i = 0; i < ess_tdofs.Size(); i++) { b(ess_tdofs[i]) = 0.0; }
+
+   for (int with_prec = 0; with_prec < 2; with_prec++)
+   {
+      SECTION(with_prec ? "With preconditioner" : "Without preconditioner")
+      {
+         DSmoother jacobi(A);
+         CGSolver cg;
+         PipelinedCGSolver pcg;
+         IterativeSolver *solvers[2] = { &cg, &pcg };
+         for (int k = 0; k < 2; k++)
+         {
+            solvers[k]->SetRelTol(1e-10);
+            solvers[k]->SetMaxIter(500);
+            solvers[k]->SetOperator(A);
+            if (with_prec) { solvers[k]->SetPreconditioner(jacobi); }
+         }
+         x_cg = 0.0;
+         x_pcg = 0.0;
+         cg.Mult(b, x_cg);
+         pcg.Mult(b, x_pcg);
+         REQUIRE(cg.GetConverged());
+         REQUIRE(pcg.GetConverged());
+         // In exact arithmetic, the iterates are the same as in CG.
+         REQUIRE(std::abs(pcg.GetNumIterations() - cg.GetNumIterations()) <= 2);
+
+         Vector res(n);
+         A.Mult(x_pcg, res);
+         res -= b;
+         REQUIRE(res.Norml2() < 1e-8 * b.Norml2());
+
+         // Nonzero initial guess
+         pcg.iterative_mode = true;
+         x_pcg.Randomize(2);
+         pcg.Mult(b, x_pcg);
+         REQUIRE(pcg.GetConverged());
+         A.Mult(x_pcg, res);
+         res -= b;
+         REQUIRE(res.Norml2() < 1e-8 * b.Norml2());
+      }
+   }
+}
+
+TEST_CASE("Pipelined CG repeated solves", "[Krylov]")
+{
+   Mesh mesh(8, 8, Element::QUADRILATERAL, true);
+   H1_FECollection fec(1, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+   SparseMatrix A;
+   a.FormSystemMatrix(ess_tdofs, A);
+   const int n = A.Height();
+
+   DSmoother jacobi(A);
+   CGSolver cg;
+   PipelinedCGSolver pcg;
+   IterativeSolver *solvers[2] = { &cg, &pcg };
+   for (int k = 0; k < 2; k++)
+   {
+      solvers[k]->SetRelTol(1e-12);
+      solvers[k]->SetMaxIter(500);
+      solvers[k]->SetOperator(A);
+      solvers[k]->SetPreconditioner(jacobi);
+   }
+
+   // The second solve starts from the work vectors left by the first one
+   Vector b(n), x_cg(n), x_pcg(n);
+   for (int solve = 0; solve < 2; solve++)
+   {
+      b.Randomize(solve+1);
+      for (int i = 0; i < ess_tdofs.Size(); i++) { b(ess_tdofs[i]) = 0.0; }
+      x_cg = 0.0;
+      x_pcg = 0.0;
+      cg.Mult(b, x_cg);
+      pcg.Mult(b, x_pcg);
+      REQUIRE(cg.GetConverged());
+      REQUIRE(pcg.GetConverged());
+      x_pcg -= x_cg;
+      REQUIRE(x_pcg.Normlinf() < 1e-8 * x_cg.Normlinf());
+   }
+}
+
+TEST_CASE("Multiple right-hand sides", "[Krylov]")
+{
+   Mesh mesh(8, 8, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+   SparseMatrix A;
+   a.FormSystemMatrix(ess_tdofs, A);
+   const int n = A.Height();
+
+   // More vectors than the SpMM batch size
+   const int nv = 11;
+   Array<Vector *> B(nv), X(nv);
+   Array<const Vector *> cB(nv);
+   for (int l = 0; l < nv; l++)
+   {
+      B[l] = new Vector(n);
+      B[l]->Randomize(l+1);
+      for (int i = 0; i < ess_tdofs.Size(); i++) { (*B[l])(ess_tdofs[i]) = 0.0; }
+      X[l] = new Vector(n);
+      *X[l] = 0.0;
+      cB[l] = B[l];
+   }
+   Vector y(n), res(n);
+
+   SECTION("Batched operators")
+   {
+      A.ArrayMult(cB, X);
+      for (int l = 0; l < nv; l++)
+      {
+         A.Mult(*B[l], y);
+         y -= *X[l];
+         REQUIRE(y.Normlinf() < 1e-12);
+      }
+
+      BilinearForm a_pa(&fes);
+      a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      a_pa.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_pa.Assemble();
+      OperatorHandle A_pa;
+      a_pa.FormSystemMatrix(ess_tdofs, A_pa);
+      for (int l = 0; l < nv; l++) { B[l]->Randomize(l+1); }
+      A_pa->ArrayMult(cB, X);
+      for (int l = 0; l < nv; l++)
+      {
+         A_pa->Mult(*B[l], y);
+         y -= *X[l];
+         REQUIRE(y.Normlinf() < 1e-12);
+      }
+
+      // Complex operator with real and imaginary parts of size n/2
+      ComplexOperator Z(&A, &A, false, false, ComplexOperator::BLOCK_SYMMETRIC);
+      SparseMatrix Ai(A);
+      Ai *= 0.5;
+      ComplexOperator W(&A, &Ai, false, false);
+      ComplexOperator *ops[2] = { &Z, &W };
+      Vector z(2*n);
+      Array<Vector *> ZB(nv), ZX(nv);
+      Array<const Vector *> cZB(nv);
+      for (int l = 0; l < nv; l++)
+      {
+         ZB[l] = new Vector(2*n);
+         ZB[l]->Randomize(l+1);
+         ZX[l] = new Vector(2*n);
+         cZB[l] = ZB[l];
+      }
+      for (int k = 0; k < 2; k++)
+      {
+         ops[k]->ArrayMult(cZB, ZX);
+         for (int l = 0; l < nv; l++)
+         {
+            ops[k]->Mult(*ZB[l], z);
+            z -= *ZX[l];
+            REQUIRE(z.Normlinf() < 1e-12);
+         }
+      }
+      for (int l = 0; l < nv; l++) { delete ZB[l]; delete ZX[l]; }
+   }
+
+   SECTION("CG")
+   {
+      DSmoother jacobi(A);
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(500);
+      cg.SetOperator(A);
+      cg.SetPreconditioner(jacobi);
+      cg.ArrayMult(cB, X);
+      REQUIRE(cg.GetConverged());
+      const int batch_its = cg.GetNumIterations();
+      int max_its = 0;
+      for (int l = 0; l < nv; l++)
+      {
+         A.Mult(*X[l], res);
+         res -= *B[l];
+         REQUIRE(res.Norml2() < 1e-8 * B[l]->Norml2());
+         y = 0.0;
+         cg.Mult(*B[l], y);
+         max_its = std::max(max_its, cg.GetNumIterations());
+      }
+      // The systems are solved with the same iterations as one at a time.
+      REQUIRE(batch_its == max_its);
+   }
+
+   SECTION("GMRES")
+   {
+      // Nonsymmetric operator: diffusion plus convection
+      Vector vel(2);
+      vel(0) = 1.0;
+      vel(1) = 0.5;
+      VectorConstantCoefficient velocity(vel);
+      BilinearForm c(&fes);
+      c.AddDomainIntegrator(new DiffusionIntegrator(one));
+      c.AddDomainIntegrator(new ConvectionIntegrator(velocity));
+      c.Assemble();
+      SparseMatrix C;
+      c.FormSystemMatrix(ess_tdofs, C);
+
+      DSmoother jacobi(C);
+      GMRESSolver gmres;
+      gmres.SetRelTol(1e-10);
+      gmres.SetMaxIter(500);
+      gmres.SetKDim(20);
+      gmres.SetOperator(C);
+      gmres.SetPreconditioner(jacobi);
+      gmres.ArrayMult(cB, X);
+      REQUIRE(gmres.GetConverged());
+      for (int l = 0; l < nv; l++)
+      {
+         C.Mult(*X[l], res);
+         res -= *B[l];
+         REQUIRE(res.Norml2() < 1e-8 * B[l]->Norml2());
+      }
+   }
+
+   for (int l = 0; l < nv; l++) { delete B[l]; delete X[l]; }
+}
+
+} // namespace krylov
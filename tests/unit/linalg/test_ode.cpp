@@ -0,0 +1,242 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace ode
+{
+
+// The linear system dx/dt = L x, counting the evaluations of the right-hand
+// side.
+class LinearODE : public TimeDependentOperator
+{
+protected:
+   DenseMatrix L;
+   mutable DenseMatrix M;
+
+public:
+   mutable int num_evals;
+
+   LinearODE(const DenseMatrix &L_)
+      : TimeDependentOperator(L_.Height()), L(L_), num_evals(0) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      num_evals++;
+      L.Mult(x, y);
+   }
+
+   // Solve k = L (x + dt k)
+   virtual void ImplicitSolve(const double dt, const Vector &x, Vector &k)
+   {
+      Vector Lx(x.Size());
+      L.Mult(x, Lx);
+      M = L;
+      M *= -dt;
+      for (int i = 0; i < M.Height(); i++) { M(i,i) += 1.0; }
+      M.Invert();
+      M.Mult(Lx, k);
+   }
+};
+
+// Harmonic oscillator with x(0) = (1, 0), x(t) = (cos t, -sin t).
+DenseMatrix Oscillator()
+{
+   DenseMatrix L(2);
+   L = 0.0;
+   L(0,1) = 1.0;
+   L(1,0) = -1.0;
+   return L;
+}
+
+TEST_CASE("ODE error estimates", "[ODE]")
+{
+   DenseMatrix L = Oscillator();
+   LinearODE op(L);
+   BogackiShampineSolver bs;
+   DormandPrinceSolver dp;
+   SDIRK23Solver sdirk23;
+   SDIRK33Solver sdirk33;
+   SDIRK34Solver sdirk34;
+   ODESolver *solvers[5] = { &bs, &dp, &sdirk23, &sdirk33, &sdirk34 };
+
+   for (int k = 0; k < 5; k++)
+   {
+      ODESolver &solver = *solvers[k];
+      const int q = solver.GetErrorEstimateOrder();
+      REQUIRE(q > 0);
+      solver.Init(op);
+      double err[2];
+      for (int r = 0; r < 2; r++)
+      {
+         Vector x(2);
+         x(0) = 1.0;
+         x(1) = 0.0;
+         double t = 0.0, dt = 0.1/(1 << r);
+         solver.Step(x, t, dt);
+         err[r] = solver.GetErrorEstimate()->Norml2();
+      }
+      // The estimate of the local error is O(dt^(q+1))
+      const double rate = log(err[0]/err[1])/log(2.0);
+      REQUIRE(std::abs(rate - (q+1)) < 0.2);
+   }
+}
+
+TEST_CASE("Low-storage Runge-Kutta", "[ODE]")
+{
+   DenseMatrix L = Oscillator();
+   LinearODE op(L);
+   WilliamsonRK3Solver rk3;
+   CarpenterKennedyRK4Solver rk4;
+   ODESolver *solvers[2] = { &rk3, &rk4 };
+   const int orders[2] = { 3, 4 };
+   const int stages[2] = { 3, 5 };
+
+   for (int k = 0; k < 2; k++)
+   {
+      ODESolver &solver = *solvers[k];
+      solver.Init(op);
+      double err[2];
+      for (int r = 0; r < 2; r++)
+      {
+         Vector x(2);
+         x(0) = 1.0;
+         x(1) = 0.0;
+         double t = 0.0, dt = 0.1/(1 << r);
+         op.num_evals = 0;
+         solver.Run(x, t, dt, 1.0 - 1e-12);
+         REQUIRE(op.num_evals == stages[k]*10*(1 << r));
+         err[r] = hypot(x(0) - cos(t), x(1) + sin(t));
+      }
+      const double rate = log(err[0]/err[1])/log(2.0);
+      REQUIRE(std::abs(rate - orders[k]) < 0.2);
+   }
+}
+
+TEST_CASE("Embedded RK stage reuse", "[ODE]")
+{
+   DenseMatrix L = Oscillator();
+   LinearODE op(L);
+   DormandPrinceSolver dp;
+   dp.Init(op);
+
+   Vector x0(2), x1(2), y(2);
+   x0(0) = 1.0;
+   x0(1) = 0.0;
+   x1(0) = 0.5;
+   x1(1) = 2.0;
+
+   // A reference step from x1
+   double t = 0.0, dt = 0.1;
+   y = x1;
+   dp.Step(y, t, dt);
+
+   // A step from the same time, but a different solution, must not reuse the
+   // first stage of the previous step
+   Vector x = x0;
+   t = 0.0;
+   dp.Init(op);
+   dp.Step(x, t, dt);
+   x = x1;
+   t = 0.0;
+   dp.Step(x, t, dt);
+   x -= y;
+   REQUIRE(x.Normlinf() < 1e-14);
+
+   // An announced repeat reuses it
+   x = x1;
+   t = 0.0;
+   op.num_evals = 0;
+   dp.RepeatStep();
+   dp.Step(x, t, dt);
+   REQUIRE(op.num_evals == 6);
+   x -= y;
+   REQUIRE(x.Normlinf() < 1e-14);
+}
+
+TEST_CASE("Adaptive time stepping", "[ODE]")
+{
+   SECTION("Explicit, oscillator")
+   {
+      DenseMatrix L = Oscillator();
+      LinearODE op(L);
+      DormandPrinceSolver dp;
+      AdaptiveODESolver ode(dp);
+      ode.SetTolerances(1e-8, 1e-10);
+      ode.Init(op);
+
+      Vector x(2);
+      x(0) = 1.0;
+      x(1) = 0.0;
+      double t = 0.0, dt = 1e-3;
+      const double tf = 10.0;
+      ode.Run(x, t, dt, tf);
+      REQUIRE(t == tf);
+      REQUIRE(std::abs(x(0) - cos(tf)) < 1e-6);
+      REQUIRE(std::abs(x(1) + sin(tf)) < 1e-6);
+      // FSAL: 6 evaluations per attempted step, plus the first one
+      const int num_attempts = ode.GetNumSteps() + ode.GetNumRejectedSteps();
+      REQUIRE(op.num_evals <= 6*num_attempts + 1);
+      REQUIRE(ode.GetNumSteps() < 200);
+   }
+
+   SECTION("Explicit, decaying solution")
+   {
+      DenseMatrix L(2);
+      L = 0.0;
+      L(0,0) = -1.0;
+      L(1,1) = -10.0;
+      LinearODE op(L);
+      BogackiShampineSolver bs;
+      AdaptiveODESolver ode(bs);
+      ode.SetTolerances(1e-6, 1e-6);
+      ode.Init(op);
+
+      Vector x(2);
+      x = 1.0;
+      double t = 0.0, dt = 1e-3;
+      const double tf = 30.0;
+      ode.Run(x, t, dt, tf);
+      REQUIRE(std::abs(x(0) - exp(-tf)) < 1e-5);
+      REQUIRE(std::abs(x(1)) < 1e-5);
+      // The steps grow as the solution decays
+      REQUIRE(dt > 0.1);
+      REQUIRE(ode.GetNumSteps() < 300);
+   }
+
+   SECTION("Implicit, stiff")
+   {
+      DenseMatrix L(2);
+      L = 0.0;
+      L(0,0) = -1.0;
+      L(1,1) = -1e4;
+      LinearODE op(L);
+      SDIRK33Solver sdirk;
+      AdaptiveODESolver ode(sdirk);
+      ode.SetTolerances(1e-6, 1e-8);
+      ode.Init(op);
+
+      Vector x(2);
+      x = 1.0;
+      double t = 0.0, dt = 1e-6;
+      const double tf = 5.0;
+      ode.Run(x, t, dt, tf);
+      REQUIRE(std::abs(x(0) - exp(-tf)) < 1e-5);
+      REQUIRE(std::abs(x(1)) < 1e-5);
+      // Far fewer steps than the explicit stability limit, dt < 3e-4
+      REQUIRE(ode.GetNumSteps() < 1000);
+   }
+}
+
+} // namespace ode
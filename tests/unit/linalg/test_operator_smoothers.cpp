@@ -0,0 +1,120 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace operator_smoothers
+{
+
+TEST_CASE("Operator smoothers", "[OperatorSmoothers]")
+{
+   Mesh mesh(8, 8, Element::QUADRILATERAL, true);
+   H1_FECollection fec(3, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+   ConstantCoefficient one(1.0);
+
+   BilinearForm a_pa(&fes), a_full(&fes);
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a_pa.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a_full.AddDomainIntegrator(new DiffusionIntegrator(one));
+   // The constrained PA operator is the identity at the essential dofs
+   a_full.SetDiagonalPolicy(Matrix::DIAG_ONE);
+   a_pa.Assemble();
+   a_full.Assemble();
+   OperatorHandle A_pa;
+   SparseMatrix A_full;
+   a_pa.FormSystemMatrix(ess_tdofs, A_pa);
+   a_full.FormSystemMatrix(ess_tdofs, A_full);
+   Vector diag;
+   a_pa.AssembleDiagonal(diag);
+   const int n = A_full.Height();
+
+   SECTION("Jacobi")
+   {
+      OperatorJacobiSmoother jacobi(diag, ess_tdofs, 0.6);
+      jacobi.SetOperator(*A_pa);
+      DSmoother dsmoother(A_full, 0, 0.6);
+      Vector b(n), x(n), y(n);
+      b.Randomize(1);
+      x.Randomize(2);
+      y = x;
+      jacobi.iterative_mode = dsmoother.iterative_mode = true;
+      jacobi.Mult(b, x);
+      dsmoother.Mult(b, y);
+      y -= x;
+      REQUIRE(y.Normlinf() < 1e-12 * x.Normlinf());
+   }
+
+   SECTION("Chebyshev")
+   {
+      OperatorChebyshevSmoother cheb(*A_pa, diag, ess_tdofs, 3);
+      OperatorChebyshevSmoother::PowerIterations power(200, 0.0);
+      OperatorChebyshevSmoother cheb_ref(*A_pa, diag, ess_tdofs, 3, power);
+      const double eig = cheb.GetMaxEigenvalueEstimate();
+      const double eig_ref = cheb_ref.GetMaxEigenvalueEstimate();
+      REQUIRE(eig <= eig_ref * (1.0 + 1e-12));
+      REQUIRE(eig > 0.9 * eig_ref);
+
+      // An integer after the order is the eigenvalue estimate
+      OperatorChebyshevSmoother cheb_given(*A_pa, diag, ess_tdofs, 3, 2);
+      REQUIRE(cheb_given.GetMaxEigenvalueEstimate() == 2.0);
+
+      // With a zero initial guess, the smoother is a symmetric operator.
+      Vector x(n), y(n), Sx(n), Sy(n);
+      x.Randomize(1);
+      y.Randomize(2);
+      cheb.Mult(x, Sx);
+      cheb.Mult(y, Sy);
+      REQUIRE(std::abs((Sx*y) - (Sy*x)) < 1e-12 * std::abs(Sx*y));
+
+      // Correction form: the same result as one step from zero.
+      cheb.iterative_mode = true;
+      Vector z(n);
+      z = 0.0;
+      cheb.Mult(x, z);
+      z -= Sx;
+      REQUIRE(z.Normlinf() < 1e-12 * Sx.Normlinf());
+      cheb.iterative_mode = false;
+
+      // As a preconditioner, Chebyshev needs fewer iterations than Jacobi.
+      Vector b(n), X(n);
+      b.Randomize(3);
+      for (int i = 0; i < ess_tdofs.Size(); i++) { b(ess_tdofs[i]) = 0.0; }
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(1000);
+      cg.SetOperator(*A_pa);
+      OperatorJacobiSmoother jacobi(diag, ess_tdofs);
+      cg.SetPreconditioner(jacobi);
+      X = 0.0;
+      cg.Mult(b, X);
+      REQUIRE(cg.GetConverged());
+      const int jacobi_its = cg.GetNumIterations();
+      cg.SetPreconditioner(cheb);
+      X = 0.0;
+      cg.Mult(b, X);
+      REQUIRE(cg.GetConverged());
+      REQUIRE(cg.GetNumIterations() < jacobi_its / 2);
+
+      Vector R(n);
+      A_full.Mult(X, R);
+      R -= b;
+      REQUIRE(R.Norml2() < 1e-8 * b.Norml2());
+   }
+}
+
+} // namespace operator_smoothers
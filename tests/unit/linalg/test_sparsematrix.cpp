@@ -0,0 +1,221 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace sparsematrix
+{
+
+// Fill the (not finalized) matrix S and the dense matrix D with the same
+// entries, including explicit zeros, empty rows and unsorted columns.
+void MakeMatrix(int height, int width, SparseMatrix &S, DenseMatrix &D)
+{
+   D.SetSize(height, width);
+   D = 0.0;
+   for (int i = 0; i < height; i++)
+   {
+      if (i % 7 == 3) { continue; } // empty row
+      const int nnz = 1 + (5*i) % 9;
+      for (int k = 0; k < nnz; k++)
+      {
+         const int j = (i*13 + k*(width/3 + 1)) % width;
+         const double v = (k % 4 == 2) ? 0.0 : std::sin(1.0 + i + 7.0*k);
+         S.Add(i, j, v);
+         D(i, j) += v;
+      }
+   }
+}
+
+TEST_CASE("SparseMatrix Finalize and actions",
+          "[SparseMatrix]")
+{
+   const double tol = 1e-12;
+   const int height = 100, width = 77;
+
+   for (int skip_zeros = 0; skip_zeros <= 1; skip_zeros++)
+   {
+      SparseMatrix S(height, width);
+      DenseMatrix D;
+      MakeMatrix(height, width, S, D);
+      S.Finalize(skip_zeros);
+
+      SECTION("Finalize, skip_zeros = " + std::to_string(skip_zeros))
+      {
+         DenseMatrix SD;
+         S.ToDenseMatrix(SD);
+         SD -= D;
+         REQUIRE(SD.MaxMaxNorm() < tol);
+         // The rows contain the zeros only if they are not skipped.
+         int nnz = 0;
+         for (int i = 0; i < height; i++)
+         {
+            for (int j = 0; j < width; j++) { nnz += (D(i,j) != 0.0); }
+         }
+         if (skip_zeros) { REQUIRE(S.NumNonZeroElems() == nnz); }
+         else { REQUIRE(S.NumNonZeroElems() >= nnz); }
+      }
+
+      SECTION("Actions, skip_zeros = " + std::to_string(skip_zeros))
+      {
+         Vector x(width), y(height), yd(height);
+         Vector xt(height), yt(width), ytd(width);
+         x.Randomize(1);
+         xt.Randomize(2);
+         y.Randomize(3);
+         yt.Randomize(4);
+         yd = y;
+         ytd = yt;
+
+         S.AddMult(x, y, 2.0);
+         D.AddMult_a(2.0, x, yd);
+         yd -= y;
+         REQUIRE(yd.Normlinf() < tol);
+
+         S.AddMultTranspose(xt, yt, -0.5);
+         D.AddMultTranspose_a(-0.5, xt, ytd);
+         ytd -= yt;
+         REQUIRE(ytd.Normlinf() < tol);
+
+         // Same result with the internal transpose
+         S.BuildTranspose();
+         S.MultTranspose(xt, yt);
+         D.MultTranspose(xt, ytd);
+         ytd -= yt;
+         REQUIRE(ytd.Normlinf() < tol);
+         S.ResetTranspose();
+      }
+   }
+
+   SECTION("Finalize with empty rows")
+   {
+      SparseMatrix S(height, width);
+      DenseMatrix D;
+      MakeMatrix(height, width, S, D);
+      S.Finalize(1, true);
+      for (int i = 0; i < height; i++)
+      {
+         if (i % 7 == 3)
+         {
+            REQUIRE(S.RowSize(i) == 1);
+            REQUIRE(S.GetRowColumns(i)[0] == i);
+            REQUIRE(S.GetRowEntries(i)[0] == 1.0);
+         }
+      }
+   }
+
+   SECTION("Sorted columns flag")
+   {
+      SparseMatrix S(3, 3);
+      S.Add(0, 0, 1.0);
+      S.Add(1, 1, 1.0);
+      S.Add(2, 2, 1.0);
+      S.Finalize();
+      REQUIRE(S.areColumnsSorted());
+
+      SparseMatrix U(3, 3);
+      U.Add(0, 0, 1.0);
+      U.Add(0, 2, 1.0);
+      U.Add(1, 1, 1.0);
+      U.Finalize();
+      // New entries are prepended to the row lists, see SparseMatrix::Add()
+      REQUIRE(!U.areColumnsSorted());
+      U.SortColumnIndices();
+      REQUIRE(U.areColumnsSorted());
+      REQUIRE(U.GetRowColumns(0)[0] == 0);
+      REQUIRE(U.GetRowColumns(0)[1] == 2);
+   }
+}
+
+TEST_CASE("SparseMatrix block and sliced formats",
+          "[SparseMatrix]")
+{
+   const double tol = 1e-12;
+   const int height = 90, width = 60;
+
+   SparseMatrix S(height, width);
+   DenseMatrix D;
+   MakeMatrix(height, width, S, D);
+   S.Finalize();
+
+   Vector x(width), y(height), yd(height);
+   Vector xt(height), yt(width), ytd(width);
+   x.Randomize(1);
+   xt.Randomize(2);
+   S.Mult(x, yd);
+   S.MultTranspose(xt, ytd);
+
+   SECTION("BCSRMatrix")
+   {
+      const int bsizes[] = { 1, 2, 3, 5 };
+      for (int bs : bsizes)
+      {
+         BCSRMatrix B(S, bs);
+         REQUIRE(B.NumStoredEntries() >= S.NumNonZeroElems());
+         REQUIRE(B.NumStoredEntries() == bs*bs*B.NumBlocks());
+
+         B.Mult(x, y);
+         y -= yd;
+         REQUIRE(y.Normlinf() < tol);
+
+         B.MultTranspose(xt, yt);
+         yt -= ytd;
+         REQUIRE(yt.Normlinf() < tol);
+
+         y.Randomize(3);
+         Vector y0(y);
+         B.AddMult(x, y, -2.0);
+         y0.Add(-2.0, yd);
+         y -= y0;
+         REQUIRE(y.Normlinf() < tol);
+
+         SparseMatrix *SB = B.ToSparseMatrix();
+         DenseMatrix SD;
+         SB->ToDenseMatrix(SD);
+         SD -= D;
+         REQUIRE(SD.MaxMaxNorm() < tol);
+         delete SB;
+      }
+   }
+
+   SECTION("SellCSigmaMatrix")
+   {
+      const int csizes[] = { 1, 4, 5, 8, 32 };
+      const int windows[] = { 1, 16, height };
+      for (int c : csizes)
+      {
+         for (int w : windows)
+         {
+            SellCSigmaMatrix M(S, c, w);
+            REQUIRE(M.NumNonZeroElems() == S.NumNonZeroElems());
+            REQUIRE(M.NumStoredEntries() >= S.NumNonZeroElems());
+
+            M.Mult(x, y);
+            y -= yd;
+            REQUIRE(y.Normlinf() < tol);
+
+            M.MultTranspose(xt, yt);
+            yt -= ytd;
+            REQUIRE(yt.Normlinf() < tol);
+         }
+      }
+      // Sorting all rows does not need more padding than no sorting.
+      SellCSigmaMatrix M1(S, 8, 1), M2(S, 8, height);
+      REQUIRE(M2.NumStoredEntries() <= M1.NumStoredEntries());
+      // With C = 1 there is no padding.
+      SellCSigmaMatrix M3(S, 1, 1);
+      REQUIRE(M3.NumStoredEntries() == S.NumNonZeroElems());
+   }
+}
+
+} // namespace sparsematrix
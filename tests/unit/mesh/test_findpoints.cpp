@@ -0,0 +1,265 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace findpoints
+{
+
+void curve(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1*std::sin(3.0*x(1));
+   y(1) += 0.1*std::sin(2.0*x(0));
+}
+
+// Generate @a npts points inside the mesh: the images of random reference
+// points in random elements.
+void MakePoints(Mesh &mesh, int npts, DenseMatrix &points)
+{
+   const int sdim = mesh.SpaceDimension();
+   points.SetSize(sdim, npts);
+   Vector pt;
+   for (int k = 0; k < npts; k++)
+   {
+      const int e = (7919*k) % mesh.GetNE();
+      IntegrationPoint ip;
+      ip.Set3(0.1 + 0.8*std::abs(std::sin(1.0*k)),
+              0.1 + 0.8*std::abs(std::sin(2.0*k)),
+              0.1 + 0.8*std::abs(std::sin(3.0*k)));
+      if (!Geometry::CheckPoint(mesh.GetElementBaseGeometry(e), ip))
+      {
+         // Map the point into the simplex.
+         const double s = ip.x + ip.y + ip.z;
+         ip.Set3(0.9*ip.x/s, 0.9*ip.y/s, 0.9*ip.z/s);
+      }
+      ElementTransformation *T = mesh.GetElementTransformation(e);
+      T->Transform(ip, pt);
+      points.SetCol(k, pt);
+   }
+}
+
+// Return the maximum distance between the given points and the images of the
+// integration points found by Mesh::FindPoints(); all points must be found.
+double CheckFindPoints(Mesh &mesh, DenseMatrix &points)
+{
+   const int npts = points.Width();
+   Array<int> elem_ids;
+   Array<IntegrationPoint> ips;
+   REQUIRE(mesh.FindPoints(points, elem_ids, ips) == npts);
+   double err = 0.0;
+   Vector pt, x;
+   for (int k = 0; k < npts; k++)
+   {
+      REQUIRE(elem_ids[k] >= 0);
+      REQUIRE(elem_ids[k] < mesh.GetNE());
+      ElementTransformation *T = mesh.GetElementTransformation(elem_ids[k]);
+      T->Transform(ips[k], pt);
+      points.GetColumnReference(k, x);
+      err = std::max(err, pt.DistanceTo(x));
+   }
+   return err;
+}
+
+TEST_CASE("Mesh::FindPoints", "[Mesh]")
+{
+   const int npts = 200;
+   Element::Type types[4] =
+   {
+      Element::QUADRILATERAL, Element::TRIANGLE,
+      Element::HEXAHEDRON, Element::TETRAHEDRON
+   };
+   for (int t = 0; t < 4; t++)
+   {
+      const int dim = (t < 2) ? 2 : 3;
+      Mesh *mesh = (dim == 2) ? new Mesh(7, 5, types[t], true) :
+                   new Mesh(4, 3, 5, types[t], true);
+      SECTION("Straight, type = " + std::to_string(t))
+      {
+         DenseMatrix points;
+         MakePoints(*mesh, npts, points);
+         REQUIRE(CheckFindPoints(*mesh, points) < 1e-10);
+      }
+      SECTION("Curved, type = " + std::to_string(t))
+      {
+         mesh->SetCurvature(3);
+         mesh->Transform(curve);
+         DenseMatrix points;
+         MakePoints(*mesh, npts, points);
+         REQUIRE(CheckFindPoints(*mesh, points) < 1e-10);
+
+         // Reinterpolate the nodes: the curved geometry is replaced
+         mesh->SetCurvature(1);
+         MakePoints(*mesh, npts, points);
+         REQUIRE(CheckFindPoints(*mesh, points) < 1e-10);
+      }
+      SECTION("Outside, type = " + std::to_string(t))
+      {
+         DenseMatrix points(dim, 3);
+         points = 0.5;
+         points(0,0) = -0.1;
+         points(1,1) = 1.2;
+         points(dim-1,2) = 1.0 + 1e-3;
+         Array<int> elem_ids;
+         Array<IntegrationPoint> ips;
+         REQUIRE(mesh->FindPoints(points, elem_ids, ips, false) == 0);
+         REQUIRE(elem_ids.Max() == -1);
+      }
+      SECTION("Updated mesh, type = " + std::to_string(t))
+      {
+         DenseMatrix points;
+         MakePoints(*mesh, npts, points);
+         REQUIRE(CheckFindPoints(*mesh, points) < 1e-10);
+
+         // Translate the mesh and the points
+         Vector disp(dim*mesh->GetNV());
+         disp = 0.0;
+         for (int i = 0; i < mesh->GetNV(); i++) { disp(i) = 2.0; }
+         mesh->MoveVertices(disp);
+         for (int k = 0; k < npts; k++) { points(0,k) += 2.0; }
+         REQUIRE(CheckFindPoints(*mesh, points) < 1e-10);
+
+         // Refine the mesh: the point locator is rebuilt
+         mesh->UniformRefinement();
+         REQUIRE(CheckFindPoints(*mesh, points) < 1e-10);
+
+         // Move the nodes externally
+         mesh->EnsureNodes();
+         GridFunction &nodes = *mesh->GetNodes();
+         const int ndofs = nodes.FESpace()->GetNDofs();
+         for (int i = 0; i < ndofs; i++)
+         {
+            nodes(nodes.FESpace()->DofToVDof(i, 0)) -= 2.0;
+         }
+         mesh->DeletePointLocator();
+         for (int k = 0; k < npts; k++) { points(0,k) -= 2.0; }
+         REQUIRE(CheckFindPoints(*mesh, points) < 1e-10);
+      }
+      delete mesh;
+   }
+}
+
+} // namespace findpoints
+
+#ifdef MFEM_USE_MPI
+
+namespace findpoints
+{
+
+double func(const Vector &x)
+{
+   return x(0)*x(1) + 2.0*x(0) - x(1);
+}
+
+TEST_CASE("ParMesh::FindPointsGlobal", "[Mesh][Parallel]")
+{
+   int myid, nranks;
+   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+   MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+   // Partition the elements in contiguous blocks, so that the owner of each
+   // element is known on all ranks
+   Mesh mesh(8, 6, Element::QUADRILATERAL, true, 2.0, 3.0);
+   const int ne = mesh.GetNE();
+   Array<int> partitioning(ne);
+   for (int e = 0; e < ne; e++) { partitioning[e] = e*nranks/ne; }
+   ParMesh pmesh(MPI_COMM_WORLD, mesh, partitioning);
+
+   // Each rank asks for a different set of points, spread over the whole
+   // domain, so most of them are owned by other ranks
+   const int npts = 40;
+   DenseMatrix points(2, npts+1);
+   for (int k = 0; k < npts; k++)
+   {
+      points(0,k) = 2.0*(0.013 + 0.97*std::abs(std::sin(1.0*(k + 7*myid))));
+      points(1,k) = 3.0*(0.017 + 0.96*std::abs(std::sin(2.0*(k + 7*myid))));
+   }
+   // The last point is outside of the mesh
+   points(0,npts) = 2.5;
+   points(1,npts) = 1.0;
+
+   // The expected owners, from the serial mesh
+   DenseMatrix serial_points(points);
+   Array<int> serial_ids;
+   Array<IntegrationPoint> serial_ips;
+   REQUIRE(mesh.FindPoints(serial_points, serial_ids, serial_ips, false) ==
+           npts);
+
+   SECTION("Ranks and elements")
+   {
+      Array<int> ranks, elem_ids;
+      Array<IntegrationPoint> ips;
+      REQUIRE(pmesh.FindPointsGlobal(points, ranks, elem_ids, ips, false) ==
+              npts);
+      REQUIRE(ranks.Size() == npts+1);
+      int nremote = 0;
+      for (int k = 0; k < npts; k++)
+      {
+         REQUIRE(ranks[k] == partitioning[serial_ids[k]]);
+         REQUIRE(elem_ids[k] >= 0);
+         if (ranks[k] != myid) { nremote++; }
+      }
+      if (nranks > 1) { REQUIRE(nremote > 0); }
+      REQUIRE(ranks[npts] == -1);
+      REQUIRE(elem_ids[npts] == -1);
+   }
+
+   SECTION("Values at points")
+   {
+      // A quadratic function, represented exactly
+      H1_FECollection fec(2, 2);
+      ParFiniteElementSpace fes(&pmesh, &fec);
+      ParGridFunction u(&fes);
+      FunctionCoefficient u_coeff(func);
+      u.ProjectCoefficient(u_coeff);
+
+      DenseMatrix values;
+      Array<int> ranks;
+      REQUIRE(u.GetValuesAtPoints(points, values, ranks, false) == npts);
+      REQUIRE(values.Height() == 1);
+      REQUIRE(values.Width() == npts+1);
+      Vector pt;
+      for (int k = 0; k < npts; k++)
+      {
+         REQUIRE(ranks[k] == partitioning[serial_ids[k]]);
+         points.GetColumnReference(k, pt);
+         REQUIRE(std::abs(values(0,k) - func(pt)) < 1e-12);
+      }
+      REQUIRE(ranks[npts] == -1);
+      REQUIRE(values(0,npts) == 0.0);
+   }
+
+   SECTION("Vector values at points")
+   {
+      // The coordinates, as a vector H1 function
+      H1_FECollection fec(1, 2);
+      ParFiniteElementSpace fes(&pmesh, &fec, 2);
+      ParGridFunction x(&fes);
+      pmesh.GetNodes(x);
+
+      DenseMatrix values;
+      Array<int> ranks;
+      REQUIRE(x.GetValuesAtPoints(points, values, ranks, false) == npts);
+      REQUIRE(values.Height() == 2);
+      for (int k = 0; k < npts; k++)
+      {
+         REQUIRE(std::abs(values(0,k) - points(0,k)) < 1e-12);
+         REQUIRE(std::abs(values(1,k) - points(1,k)) < 1e-12);
+      }
+   }
+}
+
+} // namespace findpoints
+
+#endif // MFEM_USE_MPI
@@ -0,0 +1,25 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#define CATCH_CONFIG_RUNNER
+#include "mfem.hpp"
+#include "catch.hpp"
+
+int main(int argc, char *argv[])
+{
+   mfem::MPI_Session mpi(argc, argv);
+   Catch::Session session;
+   const int result = session.applyCommandLine(argc, argv);
+   if (result != 0) { return result; }
+   // Only the tests tagged [Parallel]
+   session.configData().testsOrTags.push_back("[Parallel]");
+   return session.run();
+}
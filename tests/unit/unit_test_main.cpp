@@ -9,5 +9,15 @@
 // terms of the GNU Lesser General Public License (as published by the Free
 // Software Foundation) version 2.1 dated February 1999.
 
-#define CATCH_CONFIG_MAIN     // This tells Catch to provide a main() - only do this in one cpp file
+#define CATCH_CONFIG_RUNNER
 #include "catch.hpp"
+
+int main(int argc, char *argv[])
+{
+   Catch::Session session;
+   const int result = session.applyCommandLine(argc, argv);
+   if (result != 0) { return result; }
+   // The tests tagged [Parallel] are run by punit_tests
+   session.configData().testsOrTags.push_back("~[Parallel]");
+   return session.run();
+}